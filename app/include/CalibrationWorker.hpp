@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of IrisCC, a C++ UI for camera calibration               //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// IrisCC is free software; you can redistribute it and/or                    //
+// modify it under the terms of the GNU  General Public License               //
+// as published by the Free Software Foundation; either version 3             //
+// of the License, or (at your option) any later version.                     //
+//                                                                            //
+// IrisCC is distributed in the hope that it will be useful,                  //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of             //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU General Public License          //
+// along with IrisCC. If not, see <http://www.gnu.org/licenses/>.             //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <QObject>
+#include <QString>
+
+#include <iris/CameraCalibration.hpp>
+
+
+// runs a calibration on a copy of the camera set in its own thread, the
+// detection results and the progress are posted back through queued signals
+class CalibrationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    CalibrationWorker( std::shared_ptr<iris::CameraCalibration> calibration,
+                       std::shared_ptr<iris::Finder> finder,
+                       const iris::CameraSet_d& cs );
+
+    iris::CameraCalibration& calibration();
+
+    // the calibrated set, only valid after finished was emitted
+    const iris::CameraSet_d& cameraSet() const;
+
+    // called from the detection threads, emit the signals below
+    void reportPose( size_t id, bool found );
+    void reportProgress( const iris::Progress& progress );
+
+public slots:
+    void run();
+
+signals:
+    // a pose went through the finder
+    void poseDetected( qulonglong id, bool found );
+
+    // throttled by the library, the snapshot of the calibration may have changed
+    void progress( QString stage, int done, int steps );
+
+    // error is empty on success
+    void finished( QString error );
+
+protected:
+    std::shared_ptr<iris::CameraCalibration> m_calibration;
+    iris::CameraSet_d m_cs;
+};
+
@@ -22,16 +22,23 @@
 #pragma once
 
 #include <cstdint>
+#include <map>
 #include <memory>
 
 #include <opencv/cv.h>
 #include <opencv/highgui.h>
 
+#include <QCache>
 #include <QDialog>
 #include <QMainWindow>
+#include <QPixmap>
+#include <QProgressDialog>
+#include <QThread>
 
 #include <iris/CameraCalibration.hpp>
 
+#include <CalibrationWorker.hpp>
+
 //#include <nox/plot.hpp>
 
 
@@ -63,10 +70,15 @@ public:
 protected:
 
     void calibrate();
+    std::shared_ptr<iris::Finder> createFinder();
+    bool isCalibrating() const;
+    void setCalibrating( bool calibrating );
 
     void updateImageList();
     void updateErrorPlot();
+    void updateErrorPlot( const iris::CameraSet_d& cs );
     void updateImage( int row );
+    QPixmap imagePixmap( const iris::Pose_d& pose );
     //void updatePosesPlot();
     //void updatePosesPlotCurrent();
     void updateCameraList();
@@ -102,6 +114,12 @@ protected slots:
 
     void on_detectedImageChanged( int idx );
 
+    // posted by the calibration worker
+    void on_poseDetected( qulonglong id, bool found );
+    void on_calibrationProgress( QString stage, int done, int steps );
+    void on_calibrationFinished( QString error );
+    void on_cancelCalibration();
+
 protected:
     // ui's
     Ui::IrisCC *ui;
@@ -122,6 +140,22 @@ protected:
     // camera set
     iris::CameraSet_d m_cs;
 
+    // background calibration, works on a copy of the camera set
+    QThread m_calibrationThread;
+    CalibrationWorker* m_calibrationWorker;
+    std::shared_ptr<QProgressDialog> m_calibrationProgress;
+    std::shared_ptr<const iris::CameraSet_d> m_calibrationSnapshot;
+
+    // background of the image plot per pose, valid as long as the pose has the same image;
+    // the least recently shown pixmaps are dropped once the cache exceeds its size in bytes
+    struct CachedImage
+    {
+        std::weak_ptr< cimg_library::CImg<uint8_t> > image;
+        QPixmap pixmap;
+    };
+    static const int ImageCacheBytes = 256*1024*1024;
+    QCache< qulonglong, CachedImage > m_imageCache;
+
     // indices
     std::vector< size_t > m_poseIndices;
     std::vector< size_t > m_cameraIndices;
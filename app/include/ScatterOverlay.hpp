@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of IrisCC, a C++ UI for camera calibration               //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// IrisCC is free software; you can redistribute it and/or                    //
+// modify it under the terms of the GNU  General Public License               //
+// as published by the Free Software Foundation; either version 3             //
+// of the License, or (at your option) any later version.                     //
+//                                                                            //
+// IrisCC is distributed in the hope that it will be useful,                  //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of             //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU General Public License          //
+// along with IrisCC. If not, see <http://www.gnu.org/licenses/>.             //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <QColor>
+#include <QVector>
+
+#include <qcustomplot.h>
+
+
+// scatter plottable with one color per point, draws any number of points
+// with a single plottable instead of one graph per point
+class ScatterOverlay : public QCPAbstractPlottable
+{
+    Q_OBJECT
+
+public:
+    enum Style
+    {
+        Plus,
+        Circle
+    };
+
+    ScatterOverlay( QCPAxis* keyAxis, QCPAxis* valueAxis );
+    virtual ~ScatterOverlay();
+
+    void setStyle( Style style );
+    void setSize( double size );
+    void setWidth( double width );
+
+    void reserve( int count );
+    void addData( double key, double value, const QColor& color );
+    int size() const;
+
+    virtual void clearData();
+    virtual double selectTest( double key, double value ) const;
+
+protected:
+    virtual void draw( QPainter* painter ) const;
+    virtual void drawLegendIcon( QPainter* painter, const QRect& rect ) const;
+    virtual QCPRange getKeyRange( bool& validRange, SignDomain inSignDomain=sdBoth ) const;
+    virtual QCPRange getValueRange( bool& validRange, SignDomain inSignDomain=sdBoth ) const;
+
+    void drawSymbol( QPainter* painter, double x, double y ) const;
+    static QCPRange range( const QVector<double>& data, bool& validRange, SignDomain inSignDomain );
+
+protected:
+    Style m_style;
+    double m_size;
+    double m_width;
+
+    QVector<double> m_keys;
+    QVector<double> m_values;
+    QVector<QColor> m_colors;
+};
+
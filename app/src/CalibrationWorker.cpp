@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of IrisCC, a C++ UI for camera calibration               //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// IrisCC is free software; you can redistribute it and/or                    //
+// modify it under the terms of the GNU  General Public License               //
+// as published by the Free Software Foundation; either version 3             //
+// of the License, or (at your option) any later version.                     //
+//                                                                            //
+// IrisCC is distributed in the hope that it will be useful,                  //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of             //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU General Public License          //
+// along with IrisCC. If not, see <http://www.gnu.org/licenses/>.             //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+
+#include <CalibrationWorker.hpp>
+
+
+namespace {
+
+// passes every detection result on to the worker, the clones for the other
+// detection threads report to the same worker
+class ReportingFinder : public iris::Finder
+{
+public:
+    ReportingFinder( std::shared_ptr<iris::Finder> finder, CalibrationWorker* worker ) :
+        m_finder( finder ),
+        m_worker( worker )
+    {
+        m_configured = true;
+        m_useOpenMP = finder->useOpenMP();
+        m_pattern = finder->pattern();
+    }
+
+    virtual bool find( iris::Pose_d& pose )
+    {
+        bool found = m_finder->find( pose );
+        m_worker->reportPose( pose.id, found );
+        return found;
+    }
+
+    virtual bool find( iris::Pose_f& pose )
+    {
+        bool found = m_finder->find( pose );
+        m_worker->reportPose( pose.id, found );
+        return found;
+    }
+
+    virtual std::shared_ptr<iris::Finder> clone() const
+    {
+        // without a clone of the wrapped finder the detection stays serial
+        std::shared_ptr<iris::Finder> finder = m_finder->clone();
+        if( !finder )
+            return std::shared_ptr<iris::Finder>();
+        return std::make_shared<ReportingFinder>( finder, m_worker );
+    }
+
+protected:
+    std::shared_ptr<iris::Finder> m_finder;
+    CalibrationWorker* m_worker;
+};
+
+
+// forwards the progress of the library as a signal of the worker
+class SignalSink : public iris::Progress::Sink
+{
+public:
+    SignalSink( CalibrationWorker* worker ) :
+        m_worker( worker )
+    {
+    }
+
+    virtual void report( const iris::Progress& progress )
+    {
+        m_worker->reportProgress( progress );
+    }
+
+protected:
+    CalibrationWorker* m_worker;
+};
+
+} // end anonymous namespace
+
+
+CalibrationWorker::CalibrationWorker( std::shared_ptr<iris::CameraCalibration> calibration,
+                                      std::shared_ptr<iris::Finder> finder,
+                                      const iris::CameraSet_d& cs ) :
+    m_calibration( calibration ),
+    m_cs( cs )
+{
+    if( !calibration || !finder )
+        throw std::runtime_error("CalibrationWorker::CalibrationWorker: calibration or finder not set.");
+
+    m_calibration->setFinder( std::make_shared<ReportingFinder>( finder, this ) );
+    m_calibration->setProgressSink( std::make_shared<SignalSink>( this ) );
+
+    // the error plot follows the snapshots, they are only kept once asked for
+    m_calibration->snapshot();
+}
+
+
+iris::CameraCalibration& CalibrationWorker::calibration()
+{
+    return *m_calibration;
+}
+
+
+const iris::CameraSet_d& CalibrationWorker::cameraSet() const
+{
+    return m_cs;
+}
+
+
+void CalibrationWorker::reportPose( size_t id, bool found )
+{
+    emit poseDetected( static_cast<qulonglong>( id ), found );
+}
+
+
+void CalibrationWorker::reportProgress( const iris::Progress& progress )
+{
+    emit this->progress( QString::fromStdString( progress.stage() ),
+                         static_cast<int>( progress.done() ),
+                         static_cast<int>( progress.steps() ) );
+}
+
+
+void CalibrationWorker::run()
+{
+    // the exception stays in this thread, only its message crosses over
+    QString error;
+    try
+    {
+        m_calibration->calibrate( m_cs );
+    }
+    catch( std::exception& e )
+    {
+        error = QString::fromStdString( e.what() );
+        if( error.isEmpty() )
+            error = "CalibrationWorker::run: calibration failed.";
+    }
+
+    emit finished( error );
+}
+
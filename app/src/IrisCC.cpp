@@ -19,10 +19,14 @@
 //                                                                            //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
 #include <iostream>
 #include <stdexcept>
-#include <cmath>
 
+#include <QCoreApplication>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QMessageBox>
@@ -42,8 +46,10 @@
 #include "ui_OpenCVStereoCalibration.h"
 
 #include <IrisCC.hpp>
+#include <ScatterOverlay.hpp>
 
 #include <iris/ChessboardFinder.hpp>
+#include <iris/FrameSource.hpp>
 #include <iris/RandomFeatureFinder.hpp>
 
 #include <iris/OpenCVSingleCalibration.hpp>
@@ -58,7 +64,9 @@ IrisCC::IrisCC(QWidget *parent) :
     ui_ChessboardFinder( new Ui::ChessboardFinder ),
     ui_RandomFeatureFinder( new Ui::RandomFeatureFinder ),
     ui_OpenCVSingleCalibration( new Ui::OpenCVSingleCalibration ),
-    ui_OpenCVStereoCalibration( new Ui::OpenCVStereoCalibration )
+    ui_OpenCVStereoCalibration( new Ui::OpenCVStereoCalibration ),
+    m_calibrationWorker( 0 ),
+    m_imageCache( ImageCacheBytes )
 {
     ui->setupUi(this);
 
@@ -124,6 +132,9 @@ IrisCC::IrisCC(QWidget *parent) :
     ui->plot_error->xAxis->setTickStep( 0.5 );
     ui->plot_error->yAxis->setTickStep( 0.5 );
 
+    // the calibration worker lives in this thread
+    m_calibrationThread.start();
+
     // fresh start
     clear();
 }
@@ -131,6 +142,13 @@ IrisCC::IrisCC(QWidget *parent) :
 
 IrisCC::~IrisCC()
 {
+    // stop a running calibration, the thread quits once it returned
+    if( m_calibrationWorker )
+        m_calibrationWorker->calibration().cancel();
+    m_calibrationThread.quit();
+    m_calibrationThread.wait();
+    delete m_calibrationWorker;
+
     delete ui;
     delete ui_CameraConfig;
     delete ui_CameraInfo;
@@ -146,82 +164,13 @@ void IrisCC::calibrate()
     try
     {
         // check poses
+        if( isCalibrating() )
+            throw std::runtime_error( "IrisCC::update: Calibration running already." );
         if( m_cs.poseCount() == 0 )
             throw std::runtime_error( "IrisCC::update: No Images" );
 
         // configure finder
-        std::shared_ptr<iris::Finder> f;
-        switch( ui->select_finder->currentIndex() )
-        {
-            // none
-            case 0:
-                throw std::runtime_error("IrisCC::update: No Finder selected.");
-
-            // chessboard
-            case 1 :
-            {
-                ui->configure_finder->setEnabled(true);
-                iris::ChessboardFinder* finder = new iris::ChessboardFinder();
-                finder->setScale( ui_ChessboardFinder->scale->value() );
-                finder->configure( static_cast<size_t>( ui_ChessboardFinder->columns->value() ),
-                                   static_cast<size_t>( ui_ChessboardFinder->rows->value() ),
-                                   0.001 * ui_ChessboardFinder->square_size->value() );
-                finder->setFastCheck( ui_ChessboardFinder->fastCheck->isChecked() );
-                finder->setAdaptiveThreshold( ui_ChessboardFinder->adaptiveThreshold->isChecked() );
-                finder->setNormalizeImage( ui_ChessboardFinder->normalizeImage->isChecked() );
-                finder->setSubpixelCorner( ui_ChessboardFinder->subpixel_corner->isChecked() );
-                f = std::shared_ptr<iris::Finder>(finder);
-                break;
-            }
-
-            // random feature descriptor
-            case 2 :
-            {
-                iris::RandomFeatureFinder* finder = new iris::RandomFeatureFinder();
-                if( ui_RandomFeatureFinder->custom_pattern->isChecked() )
-                {
-                    finder->setScale( ui_RandomFeatureFinder->scale->value() );
-                    finder->configure( ui_RandomFeatureFinder->points->toPlainText().toStdString() );
-                }
-                else
-                {
-                    switch( ui_RandomFeatureFinder->preset->currentIndex() )
-                    {
-                        case 0 : // A4 150 dots
-                            finder->setScale( 0.000094736800000 );
-                            finder->configure( "2359 1487 390 718 240 439 1048 667 1931 643 1900 1367 1896 1544 2476 1252 2307 986 530 357 184 1378 2503 1447 2069 709 452 163 1159 1647 632 432 2242 1644 1743 1501 1089 1129 1494 292 356 1154 800 1033 155 1575 1181 1397 663 823 2088 959 529 1392 891 356 1534 681 391 344 618 1539 985 1230 1164 162 2188 384 1319 792 984 953 2074 1399 1345 1166 1503 1061 873 798 1563 939 1604 499 2348 147 788 620 1960 1201 234 669 1966 379 933 1396 1638 188 2387 335 2537 1141 2394 604 2278 483 1309 507 879 1141 836 1307 330 1426 1448 449 730 1368 1159 333 1774 652 1745 795 266 901 2231 1320 2163 253 1742 1023 347 508 524 580 1676 1302 2101 1641 1956 522 1132 1009 1466 1368 2011 1069 1808 912 1370 1573 629 1667 995 227 1184 818 1029 1529 1933 926 487 920 2563 838 130 1130 1471 817 695 327 1840 483 120 1255 1340 920 1217 1121 2387 1350 609 1118 2197 615 498 1594 989 546 243 224 1306 1350 2517 276 1333 168 2368 744 778 180 2523 399 2230 798 428 1038 1853 283 1348 291 769 1636 1917 790 2442 1001 2424 1667 1813 162 1768 1620 1484 1244 1467 149 2431 849 1513 1489 1277 1471 1702 1167 1720 279 1010 380 907 1602 1553 1624 575 228 2030 134 284 1044 2324 1190 348 1619 1163 456 665 571 1875 1053 1271 631 516 1259 605 699 2118 522 2548 553 124 314 1409 703 277 1254 173 991 2044 269 897 141 795 491 2208 1459 2579 170 910 644 612 945 2568 1637 2563 1023 531 795 743 1222" );
-                            break;
-                        case 1 : // A4 200 dots
-                            finder->setScale( 0.0001 );
-                            finder->configure( "2502 1190 1993 785 1438 708 2412 1567 202 782 1711 1107 1972 538 1059 1305 2402 1358 1274 1628 2339 721 2254 924 1074 1471 196 448 1901 1697 1476 237 1410 1180 878 471 2513 680 2413 919 1915 388 1222 319 435 106 844 983 1910 711 2089 887 1664 170 2237 260 595 206 695 533 984 303 1855 811 1172 1183 1444 1477 2031 303 255 1459 1907 102 251 631 2181 1488 2294 1164 998 952 443 295 1710 1289 2351 203 1994 1025 221 220 1093 610 1342 533 2158 669 1894 996 2475 1042 985 764 1757 1677 1541 1155 952 1330 1583 852 1065 234 1212 569 2571 1434 1700 710 2540 211 2447 327 472 1655 582 887 435 461 2097 183 704 1357 2102 1231 2574 868 1585 550 215 320 141 914 1760 961 1495 931 1292 856 1608 365 1507 403 2074 1358 859 1586 2557 1539 1279 1405 1183 169 137 1474 1408 1601 970 166 2333 571 545 323 1589 689 874 881 1583 1453 610 1485 621 651 834 605 505 1308 1698 523 2432 1458 2500 548 793 201 1807 1222 1170 732 1422 1056 850 1204 1906 1497 1336 169 280 860 2506 1648 312 1020 2263 1307 1363 931 368 1321 1761 1465 2572 1333 107 236 1239 423 917 1109 1940 216 1573 1045 2048 1564 106 1189 159 1349 1222 989 688 1160 593 1055 491 1106 2315 1628 192 1692 1315 1138 1682 1596 1072 1670 1136 414 365 1164 660 397 2182 1036 2062 471 2216 1662 1102 848 1528 113 146 1050 871 771 715 689 419 955 133 595 1919 1158 574 470 2183 357 1834 1328 698 806 330 1644 1818 444 606 1664 1090 114 978 583 1179 1663 546 790 1409 804 1196 1303 1821 342 250 1287 749 1525 1136 1569 1325 693 360 581 1045 465 2383 410 2542 423 1713 377 2102 1679 2567 315 1440 1332 812 1424 2590 1007 441 1438 485 568 1807 639 1129 1088 755 1056 2329 1069 235 1104 1183 1460 2397 1174 2282 1472 326 756 2263 655 1302 1513 310 105 331 1539 2267 481 2297 346 760 353 961 1520 2169 1141 304 417 2056 664 1103 980 1630 952 2447 166 1373 434 1306 1248 924 671 487 699" );
-                            break;
-                        case 2 : // A3 800 dots
-                            finder->setScale( 0.0001 );
-                            finder->configure( "2343 1712 2620 1734 2078 1453 3431 2511 3365 2453 1947 1149 2529 1205 2632 1622 542 779 593 1201 2854 1613 1328 2288 1700 904 137 1042 809 2536 739 193 95 2155 2996 2142 2813 120 2396 1584 2586 874 1622 2298 3349 1913 1866 645 3012 1501 3222 2610 2059 637 447 1871 1536 2273 3426 292 3117 1294 1839 2340 1781 1549 3449 805 3019 91 351 1360 2095 1308 1242 1955 467 1542 1020 2105 1180 1597 1124 1036 295 1955 1424 2098 1405 327 85 2366 2375 1489 577 206 2562 2451 335 2405 3007 393 636 291 2350 1275 1336 1894 1740 2137 1614 944 1514 703 567 427 2651 1528 530 912 2307 324 3467 101 279 1848 3235 2263 3164 1597 1864 2050 571 2451 1286 1535 492 1094 3026 1833 505 2165 2763 1842 3018 2009 1284 761 1915 1306 1168 1332 2551 2218 2684 2525 3183 1720 2525 698 763 1969 271 345 2984 186 2966 1661 2124 992 219 770 1859 2584 1016 227 2470 2159 967 1373 3239 251 1441 2565 2225 490 822 478 3346 2294 3455 2092 710 1757 897 529 2917 2186 2533 1772 976 1016 1432 1073 667 1521 976 2489 3303 469 2775 959 887 945 2264 2153 581 2044 740 1446 608 2592 447 860 591 1043 812 1103 3175 1186 215 1953 136 835 945 354 1796 1186 1651 820 3301 1378 1628 2618 1631 1877 3372 732 452 533 1267 347 3153 359 155 333 326 946 1900 2449 1294 1443 739 351 1265 257 1485 1839 2790 510 3033 2342 2315 205 2134 2298 427 1316 1720 257 1256 1810 128 1756 1577 493 510 1253 3365 2075 1390 2435 3433 678 1077 2042 274 1466 1019 895 1739 669 2771 2013 2216 206 2846 1819 1990 2155 1501 1122 2945 578 1776 110 2177 1612 2035 357 187 686 661 889 2150 1789 1240 2251 2626 1255 1302 2567 3106 610 378 682 683 1972 1190 319 2278 574 125 1141 1152 2244 2201 772 2613 1409 2448 190 358 2084 853 1507 2795 1391 2788 1190 250 868 2169 1200 1715 1615 2353 723 646 747 1088 614 1176 1692 2205 2545 3061 772 2172 1712 98 214 3144 1096 474 251 1968 1476 1013 2562 2602 2362 2492 2582 336 490 2525 1605 2667 966 3235 679 2740 2280 546 1520 3321 1736 1615 592 919 2567 1587 2090 1414 2331 2168 1482 2803 1686 2491 301 2239 1413 1804 271 1955 1843 2122 451 2020 2238 2296 1851 1129 1839 3178 2130 689 2451 1884 1570 1687 555 360 1827 754 1284 1016 1902 862 1199 2251 2011 1294 111 1644 1269 3427 568 712 430 1253 674 3448 1339 1343 406 3010 1036 2916 2308 1539 2585 2370 973 2199 125 818 2301 1776 1709 1118 1217 406 1618 2581 2579 1965 1981 1992 1647 88 1884 2526 1876 1884 803 2448 1760 238 2372 1933 416 2678 405 1034 1550 2487 1363 2084 2127 2181 1894 243 1028 2692 85 2730 1339 1652 2189 3409 478 2647 1962 3188 513 857 178 104 1395 2595 564 962 1817 1379 1313 2619 1039 1514 1214 2582 248 2672 2130 2583 112 2009 1743 3263 1489 1628 738 1258 1360 835 1660 126 1672 691 2113 3432 2382 897 1915 398 1962 1924 1730 3264 2104 747 2204 1057 1101 1849 1762 1537 292 246 560 641 94 3413 1213 1047 1397 3018 507 1022 1244 2775 2398 2979 300 1695 342 2636 636 2793 803 2876 506 1402 1609 142 2045 859 1761 3082 2428 2111 90 430 2317 3318 631 1389 162 336 2203 745 869 2884 2539 3318 876 1893 1916 3295 1062 2522 2302 257 429 393 2501 3371 2206 2717 1770 464 2577 88 474 2957 821 1509 2109 1869 338 1754 1082 1943 718 3185 174 2768 1577 1436 898 232 2586 1164 838 2550 1970 3491 1253 1103 2446 3273 2430 1820 930 1698 2374 304 179 1193 496 3043 2579 2922 2428 3333 295 849 2100 404 149 2888 342 1334 2070 302 1260 407 999 3509 2218 2436 1907 1498 1561 2322 1086 3194 778 2476 2441 3235 962 1862 518 705 1608 2404 520 2696 525 390 422 1379 667 2347 2495 2637 1878 2686 850 1615 1992 3441 1771 2386 2268 1246 1129 2918 654 667 2312 3468 999 661 597 361 303 1533 581 3409 891 95 965 3140 2270 1441 989 568 1778 2881 1002 785 985 3313 2010 230 1682 2181 2370 3504 478 165 1849 2409 386 444 1416 208 1193 1795 2503 2553 495 528 2296 2406 2080 2236 388 2950 1111 1892 1420 2597 1154 482 1971 2756 256 931 624 939 132 3493 1546 952 2314 1657 470 1488 1369 3495 2306 1637 1431 639 2175 2205 1272 353 2598 769 689 993 536 1097 423 1264 577 3193 1442 1915 2204 2528 419 1269 1627 2374 83 924 745 2027 2462 587 1432 2484 943 140 2540 1784 1903 1405 579 3035 1375 2548 803 1730 430 3124 1857 3485 1111 3501 1981 2050 2014 1730 1986 2997 1302 2794 2606 1578 1514 1211 1500 1311 2163 2769 2100 1032 813 661 1330 2449 1653 2425 838 3065 2237 938 878 2301 461 549 346 1526 165 1614 2527 3196 2518 3011 938 2064 1803 1610 1100 1073 2172 182 2213 356 1532 495 642 3184 1965 1150 244 1390 488 3349 1155 455 1687 2350 1386 299 632 1379 776 3094 891 1368 1792 1317 952 2456 2354 2824 1069 2695 182 686 1047 3326 1826 763 1172 1178 740 2250 1663 2535 1033 2769 351 2466 105 2892 1724 3334 1280 703 1850 2860 2087 2311 1591 210 116 2126 2197 1252 2107 1949 952 2538 1452 1741 1411 308 1706 1999 2546 2096 560 2666 2227 2122 370 1604 397 3083 1679 1062 1758 2343 1193 2221 2242 3100 508 1923 1043 816 2421 2246 676 731 2564 911 2197 3327 1590 1352 258 1851 2154 782 276 2874 781 3300 173 2224 966 904 1277 2939 2050 2454 1104 3435 2616 2875 1980 569 604 1167 2025 202 1540 83 1221 1637 231 2711 1473 1288 2481 1872 222 2062 2596 3266 555 2818 2206 3108 1004 753 1534 1981 2359 3048 1212 294 2498 217 1386 94 392 184 208 1501 419 550 510 1082 732 1852 726 2576 963 1678 1514 1298 502 1484 1944 2739 686 1596 1652 3501 896 2146 651 1282 2370 2450 652 83 700 2457 1257 1211 180 3513 1434 912 1619 2681 1138 1563 1799 1117 934 3437 1649 2404 2605 1797 1281 246 2060 1678 1354 3252 402 2010 512 1279 1230 2859 865 2892 2619 1975 210 1649 97 3100 1777 1155 1922 1016 2259 2060 814 2087 1159 385 1198 2827 634 1142 1425 1441 1706 1562 793 256 2286 2701 2354 1055 157 2918 1539 1771 792 3222 1263 3499 1863 2812 1920 3231 870 607 1905 2101 268 2074 1695 1168 2537 418 2163 1016 2401 2537 2066 2377 1812 3133 1521 83 2479 356 1063 2892 1349 1233 981 474 734 1460 766 782 1798 2079 1584 154 1266 1084 1300 209 945 2253 1134 1779 2234 973 1727 575 1681 1028 346 2111 2476 2611 736 463 380 1382 1471 2973 2494 3344 87 1649 1727 2997 1753 2161 867 3033 662 1112 1516 165 2324 1812 1462 1594 1341 3494 355 166 2441 3495 185 1550 2463 2867 424 3241 1895 787 793 86 1486 1330 1128 206 2134 3057 1576 1456 2174 3129 2576 2203 315 2295 2606 492 1803 1416 1179 2880 1186 868 2020 2289 2430 173 484 3373 218 1735 1788 1461 226 2028 1877 1910 122 828 1366 1596 1180 2606 364 847 354 3040 1115 935 2080 3359 406 3516 2428 2679 2444 1665 1020 2299 2284 2017 1014 2281 802 1122 2328 3119 2046 1958 319 608 2380 1117 2608 3389 982 794 597 2812 2470 524 1615 1938 2082 994 1624 682 1185 2036 1221 556 85 1156 2117 3292 2571 1987 851 2455 1512 726 2370 942 259 2381 257 3035 1916 495 2486 3166 92 980 1124 2710 1646 120 593 1989 107 1380 2226 975 1974 2085 2367 3143 701 1757 2580 3412 1471 2332 1943 847 712 2989 729 1535 1008 1655 2448 630 1114 2916 107 2290 85 3187 2336 3192 1808 90 1315 1494 1449 536 1355 2046 166 2161 2016 288 1577 472 2065 1199 92 477 105 1109 516 340 820 2946 1929 2225 1053 1693 171 211 1110 1971 1368 81 1988 1856 1658 356 1441 1213 2604 3513 672 935 1508 2063 912 1347 1711 3120 1405 3065 176 330 2320 2377 2408 2847 1499 516 2388 1960 612 729 534 1320 840 1501 2370 2253 1770 922 2390 1196 2433 1475 525 864 838 1166 636 1096 1632 812 105 2297 1010 997 695 2168 1119 1782 2412 633 378 1054 991 361 567 3275 785 860 1844 3279 1203 2804 1282 1891 1218 1845 1115 1144 1115 1549 1896 81 1590 2906 214 2527 1687 1411 1998 1291 1043 295 1132 2453 2014 496 996 3422 1997 105 128 1801 1017 2697 1217 2473 575 257 265 641 488 2985 2249 2680 2612 3271 2340 2186 569 626 1590 2945 462 1863 1841 619 968 2341 2175 1783 587 3516 2575 1996 1553 1438 90" );
-                            break;
-                        case 3 : // A2 800 dots
-                            finder->setScale( 0.0001 );
-                            finder->configure( "3891 2388 663 1430 1141 709 4106 511 3233 1919 2489 3196 3272 520 3524 3336 1502 3021 2429 2631 260 1590 1496 2907 3233 2478 3482 1595 3478 2578 1088 2048 3242 216 1354 1218 1788 354 4936 2291 2643 1625 1475 1793 2415 3026 1513 491 3351 692 183 3501 4962 3299 2373 2530 4853 2310 4863 1658 4753 635 4748 764 526 2346 1024 2664 3755 1297 3897 1837 2707 289 5095 3352 987 1598 4127 3121 1706 1429 1522 831 1082 1492 3607 1195 3729 235 434 2821 1240 871 2740 870 1676 2843 4434 2326 3955 576 1002 398 1065 159 4244 3052 3132 2710 4301 2405 1336 2937 2600 2058 4769 3043 5221 2656 5123 1638 560 2193 4170 2238 5101 743 1206 1861 3401 1225 2686 1286 3589 2500 2971 3508 1612 605 3567 187 751 1542 3005 2999 231 2703 3722 2500 3883 1343 3220 1782 4450 179 1173 3021 3491 2403 2798 491 4135 3015 3648 2587 1082 3514 1646 1705 3354 2847 4048 2803 3542 1465 3258 344 2034 2513 1590 2590 4791 165 4428 275 2132 3219 4914 679 350 1409 4681 2428 4552 2698 4652 1848 833 2212 2942 497 4426 2774 3132 2445 4415 1454 3934 159 1785 2116 2261 2332 2911 1633 4156 2489 1462 2753 1396 2406 3422 1900 2310 2619 457 2257 2519 1518 5201 3109 2827 641 1457 935 2690 1160 1650 3010 3911 780 5134 907 2777 353 2479 952 4023 1361 1167 2662 2493 657 3024 1102 3623 2404 4249 2025 5244 2885 2141 1997 5078 136 3872 1220 1831 2500 2608 3480 5299 3100 3453 1102 1760 214 2153 1073 3098 3439 4218 1785 803 1476 172 537 1749 587 3419 1712 5104 465 2695 1432 984 1011 1746 1350 2893 2694 4390 2866 4407 458 703 2194 529 3152 539 853 3605 3433 2504 3479 4313 769 3226 1343 4142 346 1556 2438 623 3276 1252 3185 3289 84 899 269 2774 2195 913 1674 4892 3210 1598 3259 388 1098 3022 1673 1134 1200 2703 1021 4327 2662 2621 660 1600 2215 5264 1484 2558 1878 4241 2735 3151 760 1049 2504 245 2530 3217 3499 4105 2699 4939 1075 1979 1654 3160 1514 895 1812 3049 1885 4862 2654 4352 1982 2468 2113 814 1884 3931 2535 2479 2978 1500 687 5137 3273 1443 3187 1206 216 4576 939 5224 3311 1844 1452 2531 1432 2384 1582 4455 1995 1495 1008 1569 1770 1986 969 356 129 416 1233 4640 105 4464 1129 4936 1578 936 674 5094 1872 735 3086 1851 893 2313 3370 347 2382 1282 2590 1499 2035 3385 2733 4271 1147 1274 2764 1183 1342 5144 2057 1577 1345 710 1319 1360 552 4326 283 4206 1343 4655 3387 2137 3019 387 1640 271 1369 2356 363 473 1646 408 3257 5088 2314 975 2980 3688 1556 4564 3051 116 283 4259 2596 4454 3116 3908 959 4942 2380 518 247 5140 2544 1291 2038 222 780 1376 1769 3205 1591 4672 683 882 1206 2351 764 303 3430 1417 471 244 2782 417 2558 1944 626 288 2002 580 1822 3430 3363 956 900 323 703 4961 219 3535 2281 513 1879 3659 761 306 1214 5310 2551 2936 921 2400 3500 4514 433 3032 348 3798 3289 1674 2298 790 1000 5274 354 3140 2800 1353 904 1324 3030 4801 1149 4951 590 3826 2222 1892 159 3781 1601 204 1205 4116 1154 2568 2231 1882 1770 810 2618 4374 1035 2106 2680 2820 1335 1494 2629 1369 2767 4284 1624 4649 2791 2994 3281 663 1031 4512 1868 2620 878 3238 2892 3645 1884 4888 389 474 3418 2394 2147 3328 3129 1789 137 872 2872 5294 2769 3412 2303 1972 2438 3752 724 2229 1860 3378 2930 3367 3011 1045 2277 4820 1493 2227 1380 827 1122 3466 227 4566 596 3814 2483 4659 877 4496 2250 4363 1384 2619 1232 4856 3466 2998 2636 4713 1712 3524 3104 3074 2210 1760 1849 471 89 4866 600 2478 186 5272 2013 3306 2416 3860 3084 3576 900 4088 3398 3808 2063 5174 1517 3523 2705 957 140 3358 2112 1560 1917 4523 1951 2339 1110 4416 2225 2961 746 2842 173 274 165 3770 3408 3334 1736 3621 1280 2440 1924 5007 861 4182 575 3079 3276 4272 1047 1316 321 371 2093 3529 2060 2588 3338 4549 1359 3723 2810 204 3319 251 856 1273 985 933 764 2674 2747 293 1076 4530 1721 2671 2865 2200 801 329 317 4645 2902 1186 627 1087 1077 1828 2740 3601 507 1091 628 4055 667 188 155 758 351 1945 506 4501 877 3154 2263 1434 2840 1812 695 1209 1745 4070 2583 3531 3009 1938 1108 5250 1098 4495 3241 2610 184 2915 1424 4212 1949 969 2501 1442 560 2580 293 3583 2908 4018 1188 2973 657 2403 435 3400 605 4895 1978 4127 771 1519 1439 832 567 1676 685 1442 1309 3153 1704 1296 1097 4620 1697 4421 704 2710 445 3502 1293 535 350 5095 2462 3924 1502 5084 3056 4872 763 5086 989 2945 1707 2035 2248 3046 2009 1861 3240 3448 2100 377 392 2222 1127 3626 2168 4216 2347 3955 865 4585 2150 3873 1069 2786 3013 1591 2879 1786 3141 2405 1262 2987 2281 177 2461 1292 2341 3386 245 1613 128 3027 107 2884 1517 5309 1269 2153 1556 2710 1852 1093 2206 4375 874 1248 2429 3932 1922 2345 1202 4933 478 1728 2940 3368 3229 892 3180 1344 1355 1463 2121 2694 1934 2443 3283 590 573 1419 1571 4025 3299 4728 1393 3716 1738 4583 1501 4487 1496 3845 514 330 2726 1287 170 3308 2192 2350 2755 4766 2915 133 1396 4601 1247 1071 2882 2360 3154 3954 2885 2711 194 5293 454 1010 1826 1969 2081 3107 1811 1358 252 4098 1616 4459 3012 2641 385 4135 2388 5052 3179 1147 2933 2892 3466 4299 3189 4701 3198 3424 2218 3670 2738 4706 2711 669 775 4567 2782 5179 573 1638 956 3542 1959 859 3268 726 640 589 3050 2843 1766 4385 1652 199 3202 1618 1444 391 562 99 1600 2246 2192 2708 2092 2516 1704 1828 3363 84 359 1612 3085 411 790 4720 2255 4488 96 1536 1137 1594 2790 3520 621 2747 101 3583 816 2855 3279 3717 1032 3956 2611 5312 2944 5193 1374 1952 2616 5077 3491 1934 1436 3311 2017 3088 3103 1709 3191 3041 1535 1986 3322 5187 1768 4029 2655 5136 2863 2528 375 1791 832 2667 2455 1012 1138 629 178 2082 1496 2167 659 3401 1431 5248 1673 2475 1814 3892 389 1266 1611 2504 267 4847 1780 2273 260 2193 2059 1714 1243 2070 2900 3331 829 1861 2970 2817 3161 4802 252 4185 1699 921 2681 5305 2297 3146 590 2139 952 2248 1223 1210 2238 452 1409 663 308 280 2083 2282 3229 2527 2533 352 1951 4979 2769 990 3360 1828 2287 1117 3408 1221 2104 3045 2793 2069 199 2915 813 159 2294 2261 3471 1052 3097 743 2669 1876 2004 3930 1421 898 2039 3332 1023 5305 3249 3909 3181 4305 2090 2962 175 384 3361 5051 1109 3737 103 2208 885 1966 3092 1764 498 2137 2590 4196 2133 4615 440 921 3509 439 194 1817 1926 4725 1498 2010 2007 4563 1085 5157 262 2785 1612 725 1238 288 2239 3783 3146 4467 3507 443 3057 1842 1668 4432 2127 452 887 4375 2986 4230 1249 4433 2517 4345 1777 4580 725 4661 3049 3077 2535 4191 435 1375 2608 1122 2811 1164 1579 5275 908 2922 2893 1634 1134 384 1770 3917 1658 1061 1727 1888 354 4702 2974 3748 1954 529 1532 4771 550 3931 3039 3809 155 358 1856 4389 3441 3256 3192 1384 686 4196 3246 4582 2545 4780 422 4575 3292 2202 176 240 2884 1918 2300 2344 871 1540 1687 2290 2538 1040 479 4948 1828 1664 2673 4252 359 1439 1966 1126 276 1014 588 1715 2585 2805 2394 4682 229 826 3376 3643 2961 5259 1866 2274 2994 2040 1601 3777 339 2784 1036 702 3463 862 880 183 367 671 2754 285 983 1977 316 499 474 1223 3315 5187 1928 416 2918 3510 2808 5068 360 1242 416 597 1718 1271 1927 4518 2951 4111 1823 5196 1179 1074 1274 4167 964 1573 297 3825 2310 4773 2504 3945 2203 3127 2112 4733 3407 4908 1391 2156 295 2312 1817 93 3367 84 2721 3315 2626 3352 442 955 2350 2468 2388 2311 2871 3789 3033 1498 123 1981 2862 91 935 2983 1280 4339 679 1750 2455 2374 273 162 1910 3821 1494 1691 303 3767 943 3572 3514 2657 2185 4547 291 473 1016 335 3056 1889 3444 2799 2556 2073 2406 2646 1511 2271 107 2708 3295 1142 2476 4828 944 1177 2548 958 1460 1434 771 4986 1913 2751 3101 2185 1749 2894 2151 3285 1214 111 130 643 2535 372 2223 2936 1879 4366 1303 1405 2039 3626 425 1978 1291 2842 1681 2440 595 4735 2126 1901 1330 2600 1779 142 1016 5126 1319 117 3004 2811 2046 525 3315 849 336 3669 1477 2541 491 3997 2012 3824 2623 1826 1284 510 2476 617 3393 136 2643 1291 794 2463 1168 869 2788 544 3505 3606 1657 1458 3484 3211 2156 1675 2168 246 2975 449 2636 3657 3258 1511 1521 5150 2167 2090 517 585 2610 1682 1579 3618 287 527 2908 1905 1577 3566 1365" );
-                            break;
-                        case 4 : // A2 1600 dots
-                            finder->setScale( 0.0001 );
-                            finder->configure( "3865 945 630 2091 1209 2063 1495 3289 2212 2768 3672 2844 481 2661 306 2583 614 451 3503 721 2000 1935 1970 198 1761 184 2094 861 4791 3338 4609 234 1906 1391 1065 1493 1062 1337 1072 2490 4594 2670 133 354 4080 1522 1267 2307 5198 2779 2885 1011 956 3009 1762 2306 5016 1013 5118 121 1998 2484 3321 1597 1340 1307 3636 137 4196 541 3017 667 1923 1795 1786 3133 2938 1443 2910 1687 4867 3493 4311 2195 5182 2593 1645 1341 883 812 413 2246 160 861 3118 1085 526 511 2989 84 3659 2483 2335 2760 2594 564 3369 3265 2122 2621 2173 232 2412 873 5055 2009 3407 3131 721 217 3366 2992 1917 3042 4825 684 4536 2191 1503 2389 829 1817 2701 2677 3850 1743 1011 804 5122 1291 2795 349 556 3037 4836 281 2636 2784 1255 2172 740 3285 5081 2549 605 912 3033 1841 2355 1226 4343 2759 1767 961 3852 726 1323 2459 2479 1723 2951 3079 2698 2059 2398 2241 1830 1451 3708 3080 1147 556 866 1970 1345 269 1473 888 1978 596 2659 1845 407 2417 4130 2774 3935 100 95 1627 1582 2976 1972 838 2260 1532 1039 1602 5079 2460 4241 630 2747 1216 839 1642 2561 809 2645 471 5210 88 3972 472 2944 1126 4053 1838 1628 1797 3664 1790 4699 215 1686 2514 4942 2940 3143 848 1231 1452 4385 1689 1542 2175 3223 1316 5024 538 1828 1795 105 3499 918 2881 470 3184 2934 2554 3225 3112 3356 2204 316 946 4413 3276 4741 3033 4726 2112 549 1594 3341 1486 2502 2931 5315 2100 1257 333 5046 3116 441 3396 4374 493 252 878 2303 768 2082 2267 3175 2824 4547 888 1281 875 3877 2563 1618 2595 2851 2876 2232 591 4121 1317 951 1746 3542 3090 464 1690 818 1501 2349 115 302 1880 685 1168 5039 333 2041 1231 2290 1156 2415 3193 338 2008 1395 2989 4034 1249 459 924 2252 2996 3494 1728 4184 762 4242 228 1500 2735 1961 1690 328 2904 3389 2417 1151 167 2904 3404 1979 2254 1160 1852 2576 2362 926 968 4956 2171 4223 2055 1197 3323 3916 360 5289 361 4241 1488 1698 1980 2928 2461 444 2343 3096 332 146 1421 510 3324 206 2134 808 3027 4952 1487 4667 1279 3263 3494 1762 1043 1547 1850 364 2097 2186 2260 1376 2890 692 2508 885 2524 4305 1321 1186 792 4882 99 4288 106 593 1735 1282 1744 3195 492 781 789 2241 295 5189 1758 3663 2353 998 633 4561 384 1251 632 464 1603 391 386 3245 2107 2579 259 3009 185 2664 2346 730 1984 465 3059 1467 1835 4055 1691 3334 2002 3964 1168 4809 1664 3845 2912 3944 3002 540 1828 198 1854 4642 384 5050 2165 2552 3439 1608 3133 2326 426 1716 1641 3613 3195 3739 2178 2075 2417 4337 1765 3608 506 1747 1130 927 129 203 2554 2632 2463 4623 3202 3799 3493 2805 1740 188 3246 4012 2608 990 1200 1793 611 1785 2432 92 689 619 2720 3689 2100 3322 1035 5241 482 2122 1222 2127 3217 3592 879 2066 2696 3324 2711 2444 672 2722 3214 4280 761 1379 1835 4773 2278 2655 1965 221 1496 1242 2832 4587 1418 4071 868 5006 708 4470 3380 1457 422 3971 686 2489 3351 672 632 1227 460 3797 1234 688 379 1548 1463 1550 2466 3533 1612 380 1743 1711 2727 2201 690 4865 1837 2159 3045 5319 3087 4557 2274 4477 2281 3245 2297 399 847 3333 1152 5181 3160 2360 2353 1045 2411 1984 2575 279 1716 120 2640 585 3464 2852 1625 4605 2885 657 1266 3486 2320 5174 308 2436 1810 252 281 3348 718 1842 1632 4187 1896 3037 1313 1346 462 2054 1561 848 2790 4089 405 1102 392 3207 261 3252 99 1934 1190 179 87 2064 1037 2595 3269 4350 932 4578 3513 2213 1876 2534 1868 1457 596 2325 1634 1036 1787 1711 724 2340 584 4190 147 1266 188 1308 2941 1381 2055 2095 276 2372 987 2147 2050 1590 945 2781 461 3965 2483 3136 3313 3482 1345 266 3133 2108 537 265 1164 304 2271 3518 2886 1483 1546 2617 1383 1330 1411 2254 1342 3647 1245 1622 3468 1353 2249 4861 1387 4271 3163 4936 2801 2857 133 2643 1702 4733 788 369 1530 675 1819 2665 3135 2717 1771 178 2902 4401 839 656 1571 3677 2991 5213 2467 2219 2654 212 2451 4447 1395 4132 488 1796 3318 1027 3492 5171 3513 1058 1992 2672 2890 917 3356 4466 1519 1200 2525 3034 3036 4925 366 4278 1154 5186 2886 616 810 2962 2675 2347 2449 1697 1496 908 2399 3843 492 4277 2482 997 1868 488 1381 512 1177 1628 1698 3210 1590 2418 3030 3205 997 3215 783 671 115 3393 85 2793 973 3588 2617 231 2215 1417 1441 3802 1921 2380 2569 3709 3285 4061 2408 2339 1458 175 1975 877 1442 1439 702 3066 3376 4397 2824 2217 2524 4600 669 3072 2553 3502 3315 708 1427 5223 3088 2975 880 3990 2708 281 1584 554 3147 3100 2358 4255 1837 4941 2549 3735 1472 3634 3112 883 1227 718 3056 4048 2155 3718 2694 3172 1378 1222 3058 665 2986 2720 1633 1653 3249 1389 2399 954 1335 1921 715 357 1411 5164 563 1928 463 4832 2505 870 532 3770 566 3504 836 3480 576 209 3380 2721 1549 2578 112 5186 1857 1496 2950 935 2620 4922 1963 672 2297 1867 852 4100 3122 5242 2185 5290 201 953 2274 2224 3489 250 166 2011 1839 4378 151 3505 2214 1991 3193 5269 3018 3873 830 3152 3207 993 179 2235 3381 814 2108 3249 1924 5142 816 3001 368 3137 2012 2822 540 2683 2529 3767 2622 5316 1292 5311 627 5182 1064 3193 618 3297 3405 493 602 463 799 164 2381 1095 2331 914 229 4815 444 5035 1441 549 2172 741 700 2507 355 4463 322 2043 2972 544 2951 1388 1703 4114 2332 2557 2600 2857 1221 516 425 1185 1360 3046 2919 2191 2901 1587 705 4740 2362 3817 2787 4404 1088 2689 1103 4213 3246 934 1092 2794 1887 991 2759 743 2590 2624 1216 1073 2773 2657 3475 3344 545 3784 2013 3905 1824 425 1219 3619 995 3346 1806 3931 1924 858 3224 632 1084 2515 2696 2220 2406 1304 1985 342 3465 1890 2458 4448 666 3043 3290 4272 3069 1482 985 449 323 786 1365 2470 1578 1143 1128 2445 2817 2980 2066 4367 3371 1864 2167 1066 943 2561 2263 4417 2095 3575 2143 1665 202 5309 2368 2837 1330 1401 80 1022 2645 4644 1738 2078 3323 4379 2916 3159 2673 2408 2013 4999 1308 1882 3456 2428 1338 561 338 5136 1695 4388 3132 751 1241 84 439 4511 770 3850 621 389 766 226 1283 630 1001 1787 294 4045 3519 4477 981 2738 3402 4460 2692 3144 2456 5249 3322 1807 1908 2199 928 4192 1574 5267 1445 3263 3220 939 732 3957 3321 2801 1084 1169 662 2472 1136 1418 2128 2471 109 3115 1727 4013 1921 5301 2704 3114 524 86 902 5011 2319 260 761 3140 1475 2150 1482 4967 2393 3486 2097 3012 3450 3839 133 1610 1586 4187 2145 1334 605 2517 452 3497 3200 1101 3043 3420 3495 1991 2339 3238 3330 5066 1578 785 2214 276 2968 4654 743 5152 1944 1287 3504 1493 100 5193 1535 4010 174 4430 2433 3502 2454 2596 2126 4560 2402 3588 1387 708 2811 5040 837 5121 913 3504 3457 1157 1669 2137 366 3908 2638 2661 623 1453 181 4441 1953 4602 1623 3958 1001 1045 276 3253 1125 3403 894 3513 181 5087 3201 2013 3383 4327 583 1067 2086 478 109 81 148 2857 922 2415 274 2514 1285 4768 118 116 238 4664 2630 3789 1559 1162 3427 1936 1103 4385 1267 2915 2156 1118 2651 3224 1459 4119 712 3706 413 2615 2979 2433 1045 4247 2992 1935 3280 2231 1973 5310 2901 3960 910 4070 3271 237 2763 3928 2851 228 1066 1991 100 539 833 416 245 820 2931 4274 907 3974 266 2438 2375 2330 3095 1567 1213 129 1013 2333 253 1800 703 2230 501 3635 3339 737 533 1082 3218 1424 2665 4727 1177 696 914 4370 2604 2221 776 4288 2111 4652 2405 1745 1354 2895 1554 1518 237 4883 3252 3849 1044 1039 2989 3595 637 570 1485 3707 320 1562 2887 3606 415 2981 3213 3481 293 599 2381 4000 2089 4326 2351 2087 1299 3136 87 1736 3378 4700 1934 3089 1638 2844 270 1292 2624 719 1088 4701 618 1095 2918 854 1129 97 3261 4741 2898 4978 2063 3152 2099 3666 2257 1874 1301 4235 2870 1670 365 3930 582 3266 2519 756 999 822 617 1925 2039 2522 3518 3069 2154 2393 1525 460 2841 1023 3143 4310 3493 4818 1508 5099 1140 2477 950 4533 3236 5202 665 4803 1775 2287 3225 2943 1933 4893 1703 2337 2181 3766 1648 825 129 3288 250 130 2774 3789 867 2943 2871 3007 1602 2782 2319 5231 3240 4125 3518 1523 648 3583 2320 3456 422 3344 1385 523 1059 2253 3150 5306 1585 1651 517 4523 1306 3074 2781 2053 1473 108 3035 141 1285 1222 1159 3880 3198 4870 2662 3851 2444 926 2170 1615 2313 3059 2439 512 2555 3033 1726 4190 3430 5024 2776 1518 2090 2692 1004 374 3320 5298 1665 3451 959 4557 2579 4170 2644 2680 770 3694 1372 1878 2316 851 1015 3268 2782 457 2488 4900 1250 1718 1856 1528 1311 2576 959 1819 2729 2475 2450 835 1731 1315 3061 1107 1228 1336 1064 1029 2219 87 2338 4330 3299 4727 2804 4027 577 3742 722 2951 515 4614 2991 2779 2121 2623 1560 118 2166 3565 2956 2761 639 2688 1341 5005 1766 4571 1839 4979 453 762 1861 3099 1889 1002 2544 5122 2243 3200 1230 4497 3136 4709 2191 431 2947 4068 776 1886 2865 4272 2668 5275 923 3629 1545 2000 375 3493 1862 3441 2707 4872 841 5086 3317 2032 3484 3997 1576 214 483 3556 1153 2464 1422 4158 305 2473 217 1586 400 4932 3133 132 532 1993 1354 1584 1097 3748 1102 4846 2886 2136 2533 4452 1153 2739 2218 4726 348 2938 1251 4691 1039 3148 3046 330 197 2311 1958 4549 295 5170 1214 1909 1935 2506 2322 2091 656 729 3403 1043 3382 4560 1187 1191 1029 869 1343 4175 3317 2910 632 5295 1994 2367 1748 4274 3372 4143 3023 2051 1708 4641 1154 1296 2741 1456 2874 2831 2711 1388 3291 2963 783 2993 1056 1312 1207 3673 1140 2583 1647 3790 365 899 2718 1155 2826 3391 356 4893 2100 674 2647 1122 2179 549 2271 587 734 4140 1712 520 183 5195 1626 183 1741 3673 1658 1061 1686 1112 1567 4361 1874 2816 718 1477 1221 5304 96 1807 3507 2694 893 4961 237 1949 3507 1180 1973 4454 3484 3313 903 4972 1193 4793 1255 4415 397 2728 3063 894 3121 858 417 5106 2738 3282 1684 1634 618 3592 3460 3642 708 3862 1655 1861 1720 987 1419 569 112 3733 996 2388 3275 3494 2646 3614 1986 652 2216 552 258 4250 2759 4379 1595 482 1525 4723 1520 227 373 3314 171 4507 1748 1487 806 1713 861 3965 1313 4138 2073 3555 1308 5116 486 2096 1842 1459 1361 1535 2808 1530 3496 3368 1246 3697 907 2260 216 2419 1662 4650 930 4673 3103 3426 1180 2753 1466 1592 3324 382 2525 2316 2844 456 1946 1494 2580 4792 934 4081 3397 5318 2261 1777 2859 3309 2400 219 1657 3172 3393 3564 95 325 318 2573 1106 4591 1530 1664 2236 2199 1246 1646 2798 5119 2331 1316 1642 1107 90 3257 2609 2443 579 3975 1999 3172 1805 224 575 4183 2437 5004 1676 1445 3494 4031 3009 547 1268 5029 3446 681 3168 3745 2350 4898 755 3791 3080 3860 275 2313 883 305 513 2284 969 3059 1173 1025 2846 2937 3308 803 3477 2595 724 2677 312 2960 1778 3248 405 5306 1845 1855 425 1958 990 4956 2708 2511 3194 2252 1451 2106 2133 3022 948 281 3266 3756 253 1943 1483 4848 1030 5254 797 1674 3051 2830 2958 5170 3292 3574 253 2279 1819 4209 1230 2753 805 2555 1505 4034 2525 2949 434 1058 1117 4165 1437 1358 2578 702 1731 749 2418 3033 1977 2777 221 1456 2467 2922 347 978 2350 5038 198 2817 2503 3881 1351 444 2089 1252 1873 94 2534 3800 1388 1412 3158 3697 621 2504 1970 3835 2360 3506 1066 1407 3073 2375 2937 5065 1913 4611 816 4868 3041 1091 697 94 1190 3984 1394 3343 450 3357 636 3680 1888 280 1361 3805 3276 3361 2593 841 3400 4465 2893 4770 3142 3817 2102 1371 3451 3902 3082 1459 1948 1359 1516 3906 2298 3974 2354 4812 1995 3161 384 4383 298 1899 2683 1177 328 3426 1953 2193 1675 1763 2661 3651 1456 3971 823 1991 2089 4082 2911 4874 2242 3157 2275 3760 3355 4943 1371 4843 1151 2852 2611 1499 1641 1891 289 2075 1381 5095 622 3717 135 1575 297 3988 3202 220 2675 3378 2822 887 2050 3311 353 2512 3069 3059 750 5023 916 1512 3397 346 2686 3500 1502 258 3456 380 116 657 3309 4192 1053 407 608 1025 543 3436 1670 338 1050 1629 1896 3778 1822 2468 2141 4536 95 765 300 3435 204 3475 87 4950 3519 321 3049 2447 795 1121 3512 4393 744 151 3136 4515 475 1564 1946 5149 2051 4681 1642 3198 2184 4556 3415 1093 1020 2363 2080 3908 2135 5272 2595 405 2623 658 293 636 1904 5067 2887 5268 1363 813 3114 988 2046 4232 443 1376 983 3077 2264 4651 2072 4166 2252 750 1631 3640 2754 3461 3067 4000 1751 792 2489 4103 193 960 445 853 2647 4544 562 4697 3264 2229 1065 3531 1971 5237 3463 2424 3507 4737 1850 1776 2577 5157 2994 839 2336 433 2736 631 3077 1583 2710 951 342 3997 1087 4066 1987 1964 1590 4881 569 1981 2675 3646 816 4649 2299 4730 698 4785 2711 1114 3314 285 2351 962 1571 4298 1033 2655 1463 3975 2215 2152 99 5270 3170 1725 1242 1640 1157 1194 2351 2792 2402 4799 3247 1945 2956 4920 1126 4719 3495 3541 2742 3131 213 539 2865 2884 2252 1496 1064 3060 3126 296 620 5206 204 4299 1548 2782 3160 5128 3398 3614 1081 4532 2739 4124 937 1838 101 4379 2243 5097 1054 2991 2218 4985 1869 5078 1807 1905 3197 425 3518 4521 2029 2276 3311 4431 3028 96 786 1817 2087 5028 83 3078 449 530 2453 3904 1490 5302 713 2039 2788 2648 3365 1219 2665 3357 1714 1304 743 4229 978 1768 1720 4693 2705 303 2448 3585 1760 2794 3468 1164 2253 3896 3501 5077 1372 4925 941 4980 3018 1206 1594 1676 1029 4522 2487 3669 249 4534 2999 5132 398 1217 2938 3425 3401 1886 1029 2405 2647 4906 1617 2848 3234 1677 2074 4330 2037 4080 2248 2054 3082 2587 2890 1628 89 2354 3446 1008 1050 1354 175 2125 1939 4909 3366 4376 1010 2065 2043 4648 2496 1854 1540 1814 1189 4746 489 3701 3187 1318 3357 858 321 1157 877 2047 733 528 2051 3401 1865 914 3444 1551 3200 655 1662 4562 1054 2741 2807 686 767 4590 1984 1731 3463 3490 2560 3234 2024 1714 116 739 2902 1910 2780 2373 1130 3868 2030 4595 477 1539 3072 325 3188 3750 1730 1786 490 914 620 1074 1896 5078 3014 4447 2537 3309 3071 3704 2014 2135 3427 2792 1992 5317 2457 4789 1351 772 3211 1926 3383 682 3517 525 3409 4411 573 3288 2872 588 631 2514 2050 4134 2502 4596 2138 1890 631 2808 3059 5168 1410 375 1927 1310 3243 84 1888 3795 2517 2437 1258 1117 1415 5296 281 4979 3278 2920 2996 3205 173 3443 503 3308 796 5301 1073 3988 3430 2020 933 3421 2145 820 228 2677 145 3255 2951 4626 567 4158 839 185 655 2873 2043 3636 2918 4677 128 447 2169 2998 2341 4824 3415 4711 1399 1363 799 996 3273 4271 364 4111 1145 2021 508 921 1640 1770 3034 4462 1632 2236 2149 1395 2768 4521 2827 1705 2919 2871 2375 3591 336 4892 2451 625 2865 3047 1446 2388 1912 3809 2990 5082 2661 260 2067 4279 1950 411 1852 4647 3370 939 3205 3442 1792 3798 3164 4507 212 114 1101 4813 2186 2875 3139 1621 2006 1511 1726 1111 3131 4957 146 4831 172 3266 673 2125 3131 3276 1848 4083 1032 1473 309 3464 2975 3162 698 2180 1800 1642 799 626 213 1206 101 2807 3358 4432 913 1634 2441 434 1024 3081 1014 4733 2504 3883 2730 3683 2583 1205 3189 871 2249 4202 1770 3395 2504 2884 3501 3840 2217 1247 971 3366 2902 1560 850 1393 360 4018 3101 3378 272 312 2168 2761 1295 3469 2793 2316 2622 1837 1095 2058 2885 355 1136 306 3382 1479 515 3457 1262 173 2286 4221 3508 1807 1994 1813 3409 2754 2615 4085 2690 715 2114 5222 2386 419 528 4477 1230 203 3061 2501 2530 4112 1608 4486 1882 384 3122 4298 1415 3103 3490 1880 537 4229 2342 2876 837 602 1364 2137 1074 4864 2365 4849 3123 4570 3095 2989 1518 494 683 4197 1361 1640 1427 5192 2298 1782 802 1711 3173 3118 2962 896 1872 4717 2020 4905 670 3194 2384 3441 1441 1444 1128 306 1241 2122 975 4791 1917 350 2797 4241 1696 1156 1756 775 873 3748 2894 5318 2784 2277 2346 323 698 5277 1765 3108 636 2353 679 4064 101 3602 1866 2414 2737 3339 2301 1445 2220 3366 2081 4021 2785 758 2321 4723 1711 2294 2255 2152 1587 530 2758 602 2507 2852 1467 102 3354 2302 3513 84 2916 5083 3517 1854 2978 3411 1049 105 2028 199 953 5169 2149 608 3377 4629 3450 949 1932 2137 2740 3421 1532 4634 2780 3167 2574 1149 2729 1847 194 2100 457 2509 532 391 3237 5173 2686 2483 2234 1824 3217 1735 2158 3729 2440 3860 3348 4324 684 4992 3373 402 1301 1153 2434 2367 350 2621 2656 1289 2071 3080 2644 1433 2326 1353 1921 2724 3315 3704 519 4577 3329 4187 3134 522 3519 1009 89 713 1330 2828 2799 2400 506 5108 249 4397 1478 2545 2807 771 386 2282 1264 4775 1068 4953 823 2055 189 5068 762 864 896 1077 861 4143 2853 2254 390 4829 2592 2655 2233 1765 379 5236 2062 2777 123 4041 336 4900 477 2419 3391 592 1158 4576 974 3896 1218 2247 99 3069 1527" );
-                            break;
-                        default:
-                            throw std::runtime_error("IrisCC::update: Random Features, unknown preset.");
-                    }
-                }
-                finder->setMaxRadiusRatio( ui_RandomFeatureFinder->max_radius_ratio->value() );
-                finder->setMinRadius( ui_RandomFeatureFinder->min_radius->value() );
-                finder->setMeanAreaFac( ui_RandomFeatureFinder->mean_area->value() );
-                f = std::shared_ptr<iris::Finder>(finder);
-                break;
-            }
-
-            // not supported finder
-            default:
-                throw std::runtime_error("IrisCC::update: Finder not supported.");
-        }
+        std::shared_ptr<iris::Finder> f = createFinder();
 
         // configure calibration
         std::shared_ptr<iris::CameraCalibration> cc;
@@ -239,7 +188,9 @@ void IrisCC::calibrate()
                 calib->setFixAspectRatio( ui_OpenCVSingleCalibration->fixed_aspect_ratio->isChecked() );
                 calib->setTangentialDistortion( ui_OpenCVSingleCalibration->tangential_distortion->isChecked() );
                 calib->setIntrinsicGuess( static_cast<size_t>( ui_OpenCVSingleCalibration->intrinsic_guess->isChecked() ) );
+                calib->setRejectOutliers( ui_OpenCVSingleCalibration->reject_outliers->isChecked() );
                 calib->setMinCorrespondences( static_cast<size_t>( ui_OpenCVSingleCalibration->minCorrespondences->value() ) );
+                calib->setMaxPoses( static_cast<size_t>( ui_OpenCVSingleCalibration->maxPoses->value() ) );
                 cc = std::shared_ptr<iris::CameraCalibration>( calib );
                 break;
             }
@@ -255,6 +206,7 @@ void IrisCC::calibrate()
                 calib->setSameFocalLength( ui_OpenCVStereoCalibration->same_focal_length->isChecked() );
                 calib->setFixIntrinsic( static_cast<size_t>( ui_OpenCVStereoCalibration->fix_intrinsic->isChecked() ) );
                 calib->setIntrinsicGuess( static_cast<size_t>( ui_OpenCVStereoCalibration->intrinsic_guess->isChecked() ) );
+                calib->setRejectOutliers( ui_OpenCVStereoCalibration->reject_outliers->isChecked() );
                 calib->setMinCorrespondences( static_cast<size_t>( ui_OpenCVStereoCalibration->minCorrespondences->value() ) );
                 cc = std::shared_ptr<iris::CameraCalibration>( calib );
                 break;
@@ -265,15 +217,26 @@ void IrisCC::calibrate()
                 throw std::runtime_error("IrisCC::update: Calibration not supported.");
         }
 
-        // run the calibration
-        cc->setFinder(f);
-        cc->calibrate( m_cs );
-
-        // update the error plot
-        updateImageList();
-        updateErrorPlot();
-        //updatePosesPlot();
-        updateImage( ui->image_list->currentRow() );
+        // run the calibration on a copy in the worker thread, the results come back as signals
+        m_calibrationWorker = new CalibrationWorker( cc, f, m_cs );
+        m_calibrationWorker->moveToThread( &m_calibrationThread );
+        connect( m_calibrationWorker, SIGNAL(poseDetected(qulonglong,bool)), this, SLOT(on_poseDetected(qulonglong,bool)), Qt::QueuedConnection );
+        connect( m_calibrationWorker, SIGNAL(progress(QString,int,int)), this, SLOT(on_calibrationProgress(QString,int,int)), Qt::QueuedConnection );
+        connect( m_calibrationWorker, SIGNAL(finished(QString)), this, SLOT(on_calibrationFinished(QString)), Qt::QueuedConnection );
+
+        // the progress goes to a dialog, the window stays usable
+        m_calibrationProgress = std::shared_ptr<QProgressDialog>( new QProgressDialog( "Calibrating...", "Cancel", 0, 0, this ) );
+        m_calibrationProgress->setAutoClose( false );
+        m_calibrationProgress->setAutoReset( false );
+        connect( m_calibrationProgress.get(), SIGNAL(canceled(void)), this, SLOT(on_cancelCalibration(void)) );
+        m_calibrationProgress->show();
+
+        // the poses get colored as they are detected
+        for( int i=0; i<ui->image_list->count(); i++ )
+            ui->image_list->item( i )->setBackground( QBrush() );
+
+        setCalibrating( true );
+        QMetaObject::invokeMethod( m_calibrationWorker, "run", Qt::QueuedConnection );
     }
     catch( std::exception &e )
     {
@@ -282,6 +245,102 @@ void IrisCC::calibrate()
 }
 
 
+std::shared_ptr<iris::Finder> IrisCC::createFinder()
+{
+    std::shared_ptr<iris::Finder> f;
+    switch( ui->select_finder->currentIndex() )
+    {
+        // none
+        case 0:
+            throw std::runtime_error("IrisCC::createFinder: No Finder selected.");
+
+        // chessboard
+        case 1 :
+        {
+            ui->configure_finder->setEnabled(true);
+            iris::ChessboardFinder* finder = new iris::ChessboardFinder();
+            finder->setScale( ui_ChessboardFinder->scale->value() );
+            finder->configure( static_cast<size_t>( ui_ChessboardFinder->columns->value() ),
+                               static_cast<size_t>( ui_ChessboardFinder->rows->value() ),
+                               0.001 * ui_ChessboardFinder->square_size->value() );
+            finder->setFastCheck( ui_ChessboardFinder->fastCheck->isChecked() );
+            finder->setAdaptiveThreshold( ui_ChessboardFinder->adaptiveThreshold->isChecked() );
+            finder->setNormalizeImage( ui_ChessboardFinder->normalizeImage->isChecked() );
+            finder->setSubpixelCorner( ui_ChessboardFinder->subpixel_corner->isChecked() );
+            f = std::shared_ptr<iris::Finder>(finder);
+            break;
+        }
+
+        // random feature descriptor
+        case 2 :
+        {
+            iris::RandomFeatureFinder* finder = new iris::RandomFeatureFinder();
+            if( ui_RandomFeatureFinder->custom_pattern->isChecked() )
+            {
+                finder->setScale( ui_RandomFeatureFinder->scale->value() );
+                finder->configure( ui_RandomFeatureFinder->points->toPlainText().toStdString() );
+            }
+            else
+            {
+                switch( ui_RandomFeatureFinder->preset->currentIndex() )
+                {
+                    case 0 : // A4 150 dots
+                        finder->setScale( 0.000094736800000 );
+                        finder->configure( "2359 1487 390 718 240 439 1048 667 1931 643 1900 1367 1896 1544 2476 1252 2307 986 530 357 184 1378 2503 1447 2069 709 452 163 1159 1647 632 432 2242 1644 1743 1501 1089 1129 1494 292 356 1154 800 1033 155 1575 1181 1397 663 823 2088 959 529 1392 891 356 1534 681 391 344 618 1539 985 1230 1164 162 2188 384 1319 792 984 953 2074 1399 1345 1166 1503 1061 873 798 1563 939 1604 499 2348 147 788 620 1960 1201 234 669 1966 379 933 1396 1638 188 2387 335 2537 1141 2394 604 2278 483 1309 507 879 1141 836 1307 330 1426 1448 449 730 1368 1159 333 1774 652 1745 795 266 901 2231 1320 2163 253 1742 1023 347 508 524 580 1676 1302 2101 1641 1956 522 1132 1009 1466 1368 2011 1069 1808 912 1370 1573 629 1667 995 227 1184 818 1029 1529 1933 926 487 920 2563 838 130 1130 1471 817 695 327 1840 483 120 1255 1340 920 1217 1121 2387 1350 609 1118 2197 615 498 1594 989 546 243 224 1306 1350 2517 276 1333 168 2368 744 778 180 2523 399 2230 798 428 1038 1853 283 1348 291 769 1636 1917 790 2442 1001 2424 1667 1813 162 1768 1620 1484 1244 1467 149 2431 849 1513 1489 1277 1471 1702 1167 1720 279 1010 380 907 1602 1553 1624 575 228 2030 134 284 1044 2324 1190 348 1619 1163 456 665 571 1875 1053 1271 631 516 1259 605 699 2118 522 2548 553 124 314 1409 703 277 1254 173 991 2044 269 897 141 795 491 2208 1459 2579 170 910 644 612 945 2568 1637 2563 1023 531 795 743 1222" );
+                        break;
+                    case 1 : // A4 200 dots
+                        finder->setScale( 0.0001 );
+                        finder->configure( "2502 1190 1993 785 1438 708 2412 1567 202 782 1711 1107 1972 538 1059 1305 2402 1358 1274 1628 2339 721 2254 924 1074 1471 196 448 1901 1697 1476 237 1410 1180 878 471 2513 680 2413 919 1915 388 1222 319 435 106 844 983 1910 711 2089 887 1664 170 2237 260 595 206 695 533 984 303 1855 811 1172 1183 1444 1477 2031 303 255 1459 1907 102 251 631 2181 1488 2294 1164 998 952 443 295 1710 1289 2351 203 1994 1025 221 220 1093 610 1342 533 2158 669 1894 996 2475 1042 985 764 1757 1677 1541 1155 952 1330 1583 852 1065 234 1212 569 2571 1434 1700 710 2540 211 2447 327 472 1655 582 887 435 461 2097 183 704 1357 2102 1231 2574 868 1585 550 215 320 141 914 1760 961 1495 931 1292 856 1608 365 1507 403 2074 1358 859 1586 2557 1539 1279 1405 1183 169 137 1474 1408 1601 970 166 2333 571 545 323 1589 689 874 881 1583 1453 610 1485 621 651 834 605 505 1308 1698 523 2432 1458 2500 548 793 201 1807 1222 1170 732 1422 1056 850 1204 1906 1497 1336 169 280 860 2506 1648 312 1020 2263 1307 1363 931 368 1321 1761 1465 2572 1333 107 236 1239 423 917 1109 1940 216 1573 1045 2048 1564 106 1189 159 1349 1222 989 688 1160 593 1055 491 1106 2315 1628 192 1692 1315 1138 1682 1596 1072 1670 1136 414 365 1164 660 397 2182 1036 2062 471 2216 1662 1102 848 1528 113 146 1050 871 771 715 689 419 955 133 595 1919 1158 574 470 2183 357 1834 1328 698 806 330 1644 1818 444 606 1664 1090 114 978 583 1179 1663 546 790 1409 804 1196 1303 1821 342 250 1287 749 1525 1136 1569 1325 693 360 581 1045 465 2383 410 2542 423 1713 377 2102 1679 2567 315 1440 1332 812 1424 2590 1007 441 1438 485 568 1807 639 1129 1088 755 1056 2329 1069 235 1104 1183 1460 2397 1174 2282 1472 326 756 2263 655 1302 1513 310 105 331 1539 2267 481 2297 346 760 353 961 1520 2169 1141 304 417 2056 664 1103 980 1630 952 2447 166 1373 434 1306 1248 924 671 487 699" );
+                        break;
+                    case 2 : // A3 800 dots
+                        finder->setScale( 0.0001 );
+                        finder->configure( "2343 1712 2620 1734 2078 1453 3431 2511 3365 2453 1947 1149 2529 1205 2632 1622 542 779 593 1201 2854 1613 1328 2288 1700 904 137 1042 809 2536 739 193 95 2155 2996 2142 2813 120 2396 1584 2586 874 1622 2298 3349 1913 1866 645 3012 1501 3222 2610 2059 637 447 1871 1536 2273 3426 292 3117 1294 1839 2340 1781 1549 3449 805 3019 91 351 1360 2095 1308 1242 1955 467 1542 1020 2105 1180 1597 1124 1036 295 1955 1424 2098 1405 327 85 2366 2375 1489 577 206 2562 2451 335 2405 3007 393 636 291 2350 1275 1336 1894 1740 2137 1614 944 1514 703 567 427 2651 1528 530 912 2307 324 3467 101 279 1848 3235 2263 3164 1597 1864 2050 571 2451 1286 1535 492 1094 3026 1833 505 2165 2763 1842 3018 2009 1284 761 1915 1306 1168 1332 2551 2218 2684 2525 3183 1720 2525 698 763 1969 271 345 2984 186 2966 1661 2124 992 219 770 1859 2584 1016 227 2470 2159 967 1373 3239 251 1441 2565 2225 490 822 478 3346 2294 3455 2092 710 1757 897 529 2917 2186 2533 1772 976 1016 1432 1073 667 1521 976 2489 3303 469 2775 959 887 945 2264 2153 581 2044 740 1446 608 2592 447 860 591 1043 812 1103 3175 1186 215 1953 136 835 945 354 1796 1186 1651 820 3301 1378 1628 2618 1631 1877 3372 732 452 533 1267 347 3153 359 155 333 326 946 1900 2449 1294 1443 739 351 1265 257 1485 1839 2790 510 3033 2342 2315 205 2134 2298 427 1316 1720 257 1256 1810 128 1756 1577 493 510 1253 3365 2075 1390 2435 3433 678 1077 2042 274 1466 1019 895 1739 669 2771 2013 2216 206 2846 1819 1990 2155 1501 1122 2945 578 1776 110 2177 1612 2035 357 187 686 661 889 2150 1789 1240 2251 2626 1255 1302 2567 3106 610 378 682 683 1972 1190 319 2278 574 125 1141 1152 2244 2201 772 2613 1409 2448 190 358 2084 853 1507 2795 1391 2788 1190 250 868 2169 1200 1715 1615 2353 723 646 747 1088 614 1176 1692 2205 2545 3061 772 2172 1712 98 214 3144 1096 474 251 1968 1476 1013 2562 2602 2362 2492 2582 336 490 2525 1605 2667 966 3235 679 2740 2280 546 1520 3321 1736 1615 592 919 2567 1587 2090 1414 2331 2168 1482 2803 1686 2491 301 2239 1413 1804 271 1955 1843 2122 451 2020 2238 2296 1851 1129 1839 3178 2130 689 2451 1884 1570 1687 555 360 1827 754 1284 1016 1902 862 1199 2251 2011 1294 111 1644 1269 3427 568 712 430 1253 674 3448 1339 1343 406 3010 1036 2916 2308 1539 2585 2370 973 2199 125 818 2301 1776 1709 1118 1217 406 1618 2581 2579 1965 1981 1992 1647 88 1884 2526 1876 1884 803 2448 1760 238 2372 1933 416 2678 405 1034 1550 2487 1363 2084 2127 2181 1894 243 1028 2692 85 2730 1339 1652 2189 3409 478 2647 1962 3188 513 857 178 104 1395 2595 564 962 1817 1379 1313 2619 1039 1514 1214 2582 248 2672 2130 2583 112 2009 1743 3263 1489 1628 738 1258 1360 835 1660 126 1672 691 2113 3432 2382 897 1915 398 1962 1924 1730 3264 2104 747 2204 1057 1101 1849 1762 1537 292 246 560 641 94 3413 1213 1047 1397 3018 507 1022 1244 2775 2398 2979 300 1695 342 2636 636 2793 803 2876 506 1402 1609 142 2045 859 1761 3082 2428 2111 90 430 2317 3318 631 1389 162 336 2203 745 869 2884 2539 3318 876 1893 1916 3295 1062 2522 2302 257 429 393 2501 3371 2206 2717 1770 464 2577 88 474 2957 821 1509 2109 1869 338 1754 1082 1943 718 3185 174 2768 1577 1436 898 232 2586 1164 838 2550 1970 3491 1253 1103 2446 3273 2430 1820 930 1698 2374 304 179 1193 496 3043 2579 2922 2428 3333 295 849 2100 404 149 2888 342 1334 2070 302 1260 407 999 3509 2218 2436 1907 1498 1561 2322 1086 3194 778 2476 2441 3235 962 1862 518 705 1608 2404 520 2696 525 390 422 1379 667 2347 2495 2637 1878 2686 850 1615 1992 3441 1771 2386 2268 1246 1129 2918 654 667 2312 3468 999 661 597 361 303 1533 581 3409 891 95 965 3140 2270 1441 989 568 1778 2881 1002 785 985 3313 2010 230 1682 2181 2370 3504 478 165 1849 2409 386 444 1416 208 1193 1795 2503 2553 495 528 2296 2406 2080 2236 388 2950 1111 1892 1420 2597 1154 482 1971 2756 256 931 624 939 132 3493 1546 952 2314 1657 470 1488 1369 3495 2306 1637 1431 639 2175 2205 1272 353 2598 769 689 993 536 1097 423 1264 577 3193 1442 1915 2204 2528 419 1269 1627 2374 83 924 745 2027 2462 587 1432 2484 943 140 2540 1784 1903 1405 579 3035 1375 2548 803 1730 430 3124 1857 3485 1111 3501 1981 2050 2014 1730 1986 2997 1302 2794 2606 1578 1514 1211 1500 1311 2163 2769 2100 1032 813 661 1330 2449 1653 2425 838 3065 2237 938 878 2301 461 549 346 1526 165 1614 2527 3196 2518 3011 938 2064 1803 1610 1100 1073 2172 182 2213 356 1532 495 642 3184 1965 1150 244 1390 488 3349 1155 455 1687 2350 1386 299 632 1379 776 3094 891 1368 1792 1317 952 2456 2354 2824 1069 2695 182 686 1047 3326 1826 763 1172 1178 740 2250 1663 2535 1033 2769 351 2466 105 2892 1724 3334 1280 703 1850 2860 2087 2311 1591 210 116 2126 2197 1252 2107 1949 952 2538 1452 1741 1411 308 1706 1999 2546 2096 560 2666 2227 2122 370 1604 397 3083 1679 1062 1758 2343 1193 2221 2242 3100 508 1923 1043 816 2421 2246 676 731 2564 911 2197 3327 1590 1352 258 1851 2154 782 276 2874 781 3300 173 2224 966 904 1277 2939 2050 2454 1104 3435 2616 2875 1980 569 604 1167 2025 202 1540 83 1221 1637 231 2711 1473 1288 2481 1872 222 2062 2596 3266 555 2818 2206 3108 1004 753 1534 1981 2359 3048 1212 294 2498 217 1386 94 392 184 208 1501 419 550 510 1082 732 1852 726 2576 963 1678 1514 1298 502 1484 1944 2739 686 1596 1652 3501 896 2146 651 1282 2370 2450 652 83 700 2457 1257 1211 180 3513 1434 912 1619 2681 1138 1563 1799 1117 934 3437 1649 2404 2605 1797 1281 246 2060 1678 1354 3252 402 2010 512 1279 1230 2859 865 2892 2619 1975 210 1649 97 3100 1777 1155 1922 1016 2259 2060 814 2087 1159 385 1198 2827 634 1142 1425 1441 1706 1562 793 256 2286 2701 2354 1055 157 2918 1539 1771 792 3222 1263 3499 1863 2812 1920 3231 870 607 1905 2101 268 2074 1695 1168 2537 418 2163 1016 2401 2537 2066 2377 1812 3133 1521 83 2479 356 1063 2892 1349 1233 981 474 734 1460 766 782 1798 2079 1584 154 1266 1084 1300 209 945 2253 1134 1779 2234 973 1727 575 1681 1028 346 2111 2476 2611 736 463 380 1382 1471 2973 2494 3344 87 1649 1727 2997 1753 2161 867 3033 662 1112 1516 165 2324 1812 1462 1594 1341 3494 355 166 2441 3495 185 1550 2463 2867 424 3241 1895 787 793 86 1486 1330 1128 206 2134 3057 1576 1456 2174 3129 2576 2203 315 2295 2606 492 1803 1416 1179 2880 1186 868 2020 2289 2430 173 484 3373 218 1735 1788 1461 226 2028 1877 1910 122 828 1366 1596 1180 2606 364 847 354 3040 1115 935 2080 3359 406 3516 2428 2679 2444 1665 1020 2299 2284 2017 1014 2281 802 1122 2328 3119 2046 1958 319 608 2380 1117 2608 3389 982 794 597 2812 2470 524 1615 1938 2082 994 1624 682 1185 2036 1221 556 85 1156 2117 3292 2571 1987 851 2455 1512 726 2370 942 259 2381 257 3035 1916 495 2486 3166 92 980 1124 2710 1646 120 593 1989 107 1380 2226 975 1974 2085 2367 3143 701 1757 2580 3412 1471 2332 1943 847 712 2989 729 1535 1008 1655 2448 630 1114 2916 107 2290 85 3187 2336 3192 1808 90 1315 1494 1449 536 1355 2046 166 2161 2016 288 1577 472 2065 1199 92 477 105 1109 516 340 820 2946 1929 2225 1053 1693 171 211 1110 1971 1368 81 1988 1856 1658 356 1441 1213 2604 3513 672 935 1508 2063 912 1347 1711 3120 1405 3065 176 330 2320 2377 2408 2847 1499 516 2388 1960 612 729 534 1320 840 1501 2370 2253 1770 922 2390 1196 2433 1475 525 864 838 1166 636 1096 1632 812 105 2297 1010 997 695 2168 1119 1782 2412 633 378 1054 991 361 567 3275 785 860 1844 3279 1203 2804 1282 1891 1218 1845 1115 1144 1115 1549 1896 81 1590 2906 214 2527 1687 1411 1998 1291 1043 295 1132 2453 2014 496 996 3422 1997 105 128 1801 1017 2697 1217 2473 575 257 265 641 488 2985 2249 2680 2612 3271 2340 2186 569 626 1590 2945 462 1863 1841 619 968 2341 2175 1783 587 3516 2575 1996 1553 1438 90" );
+                        break;
+                    case 3 : // A2 800 dots
+                        finder->setScale( 0.0001 );
+                        finder->configure( "3891 2388 663 1430 1141 709 4106 511 3233 1919 2489 3196 3272 520 3524 3336 1502 3021 2429 2631 260 1590 1496 2907 3233 2478 3482 1595 3478 2578 1088 2048 3242 216 1354 1218 1788 354 4936 2291 2643 1625 1475 1793 2415 3026 1513 491 3351 692 183 3501 4962 3299 2373 2530 4853 2310 4863 1658 4753 635 4748 764 526 2346 1024 2664 3755 1297 3897 1837 2707 289 5095 3352 987 1598 4127 3121 1706 1429 1522 831 1082 1492 3607 1195 3729 235 434 2821 1240 871 2740 870 1676 2843 4434 2326 3955 576 1002 398 1065 159 4244 3052 3132 2710 4301 2405 1336 2937 2600 2058 4769 3043 5221 2656 5123 1638 560 2193 4170 2238 5101 743 1206 1861 3401 1225 2686 1286 3589 2500 2971 3508 1612 605 3567 187 751 1542 3005 2999 231 2703 3722 2500 3883 1343 3220 1782 4450 179 1173 3021 3491 2403 2798 491 4135 3015 3648 2587 1082 3514 1646 1705 3354 2847 4048 2803 3542 1465 3258 344 2034 2513 1590 2590 4791 165 4428 275 2132 3219 4914 679 350 1409 4681 2428 4552 2698 4652 1848 833 2212 2942 497 4426 2774 3132 2445 4415 1454 3934 159 1785 2116 2261 2332 2911 1633 4156 2489 1462 2753 1396 2406 3422 1900 2310 2619 457 2257 2519 1518 5201 3109 2827 641 1457 935 2690 1160 1650 3010 3911 780 5134 907 2777 353 2479 952 4023 1361 1167 2662 2493 657 3024 1102 3623 2404 4249 2025 5244 2885 2141 1997 5078 136 3872 1220 1831 2500 2608 3480 5299 3100 3453 1102 1760 214 2153 1073 3098 3439 4218 1785 803 1476 172 537 1749 587 3419 1712 5104 465 2695 1432 984 1011 1746 1350 2893 2694 4390 2866 4407 458 703 2194 529 3152 539 853 3605 3433 2504 3479 4313 769 3226 1343 4142 346 1556 2438 623 3276 1252 3185 3289 84 899 269 2774 2195 913 1674 4892 3210 1598 3259 388 1098 3022 1673 1134 1200 2703 1021 4327 2662 2621 660 1600 2215 5264 1484 2558 1878 4241 2735 3151 760 1049 2504 245 2530 3217 3499 4105 2699 4939 1075 1979 1654 3160 1514 895 1812 3049 1885 4862 2654 4352 1982 2468 2113 814 1884 3931 2535 2479 2978 1500 687 5137 3273 1443 3187 1206 216 4576 939 5224 3311 1844 1452 2531 1432 2384 1582 4455 1995 1495 1008 1569 1770 1986 969 356 129 416 1233 4640 105 4464 1129 4936 1578 936 674 5094 1872 735 3086 1851 893 2313 3370 347 2382 1282 2590 1499 2035 3385 2733 4271 1147 1274 2764 1183 1342 5144 2057 1577 1345 710 1319 1360 552 4326 283 4206 1343 4655 3387 2137 3019 387 1640 271 1369 2356 363 473 1646 408 3257 5088 2314 975 2980 3688 1556 4564 3051 116 283 4259 2596 4454 3116 3908 959 4942 2380 518 247 5140 2544 1291 2038 222 780 1376 1769 3205 1591 4672 683 882 1206 2351 764 303 3430 1417 471 244 2782 417 2558 1944 626 288 2002 580 1822 3430 3363 956 900 323 703 4961 219 3535 2281 513 1879 3659 761 306 1214 5310 2551 2936 921 2400 3500 4514 433 3032 348 3798 3289 1674 2298 790 1000 5274 354 3140 2800 1353 904 1324 3030 4801 1149 4951 590 3826 2222 1892 159 3781 1601 204 1205 4116 1154 2568 2231 1882 1770 810 2618 4374 1035 2106 2680 2820 1335 1494 2629 1369 2767 4284 1624 4649 2791 2994 3281 663 1031 4512 1868 2620 878 3238 2892 3645 1884 4888 389 474 3418 2394 2147 3328 3129 1789 137 872 2872 5294 2769 3412 2303 1972 2438 3752 724 2229 1860 3378 2930 3367 3011 1045 2277 4820 1493 2227 1380 827 1122 3466 227 4566 596 3814 2483 4659 877 4496 2250 4363 1384 2619 1232 4856 3466 2998 2636 4713 1712 3524 3104 3074 2210 1760 1849 471 89 4866 600 2478 186 5272 2013 3306 2416 3860 3084 3576 900 4088 3398 3808 2063 5174 1517 3523 2705 957 140 3358 2112 1560 1917 4523 1951 2339 1110 4416 2225 2961 746 2842 173 274 165 3770 3408 3334 1736 3621 1280 2440 1924 5007 861 4182 575 3079 3276 4272 1047 1316 321 371 2093 3529 2060 2588 3338 4549 1359 3723 2810 204 3319 251 856 1273 985 933 764 2674 2747 293 1076 4530 1721 2671 2865 2200 801 329 317 4645 2902 1186 627 1087 1077 1828 2740 3601 507 1091 628 4055 667 188 155 758 351 1945 506 4501 877 3154 2263 1434 2840 1812 695 1209 1745 4070 2583 3531 3009 1938 1108 5250 1098 4495 3241 2610 184 2915 1424 4212 1949 969 2501 1442 560 2580 293 3583 2908 4018 1188 2973 657 2403 435 3400 605 4895 1978 4127 771 1519 1439 832 567 1676 685 1442 1309 3153 1704 1296 1097 4620 1697 4421 704 2710 445 3502 1293 535 350 5095 2462 3924 1502 5084 3056 4872 763 5086 989 2945 1707 2035 2248 3046 2009 1861 3240 3448 2100 377 392 2222 1127 3626 2168 4216 2347 3955 865 4585 2150 3873 1069 2786 3013 1591 2879 1786 3141 2405 1262 2987 2281 177 2461 1292 2341 3386 245 1613 128 3027 107 2884 1517 5309 1269 2153 1556 2710 1852 1093 2206 4375 874 1248 2429 3932 1922 2345 1202 4933 478 1728 2940 3368 3229 892 3180 1344 1355 1463 2121 2694 1934 2443 3283 590 573 1419 1571 4025 3299 4728 1393 3716 1738 4583 1501 4487 1496 3845 514 330 2726 1287 170 3308 2192 2350 2755 4766 2915 133 1396 4601 1247 1071 2882 2360 3154 3954 2885 2711 194 5293 454 1010 1826 1969 2081 3107 1811 1358 252 4098 1616 4459 3012 2641 385 4135 2388 5052 3179 1147 2933 2892 3466 4299 3189 4701 3198 3424 2218 3670 2738 4706 2711 669 775 4567 2782 5179 573 1638 956 3542 1959 859 3268 726 640 589 3050 2843 1766 4385 1652 199 3202 1618 1444 391 562 99 1600 2246 2192 2708 2092 2516 1704 1828 3363 84 359 1612 3085 411 790 4720 2255 4488 96 1536 1137 1594 2790 3520 621 2747 101 3583 816 2855 3279 3717 1032 3956 2611 5312 2944 5193 1374 1952 2616 5077 3491 1934 1436 3311 2017 3088 3103 1709 3191 3041 1535 1986 3322 5187 1768 4029 2655 5136 2863 2528 375 1791 832 2667 2455 1012 1138 629 178 2082 1496 2167 659 3401 1431 5248 1673 2475 1814 3892 389 1266 1611 2504 267 4847 1780 2273 260 2193 2059 1714 1243 2070 2900 3331 829 1861 2970 2817 3161 4802 252 4185 1699 921 2681 5305 2297 3146 590 2139 952 2248 1223 1210 2238 452 1409 663 308 280 2083 2282 3229 2527 2533 352 1951 4979 2769 990 3360 1828 2287 1117 3408 1221 2104 3045 2793 2069 199 2915 813 159 2294 2261 3471 1052 3097 743 2669 1876 2004 3930 1421 898 2039 3332 1023 5305 3249 3909 3181 4305 2090 2962 175 384 3361 5051 1109 3737 103 2208 885 1966 3092 1764 498 2137 2590 4196 2133 4615 440 921 3509 439 194 1817 1926 4725 1498 2010 2007 4563 1085 5157 262 2785 1612 725 1238 288 2239 3783 3146 4467 3507 443 3057 1842 1668 4432 2127 452 887 4375 2986 4230 1249 4433 2517 4345 1777 4580 725 4661 3049 3077 2535 4191 435 1375 2608 1122 2811 1164 1579 5275 908 2922 2893 1634 1134 384 1770 3917 1658 1061 1727 1888 354 4702 2974 3748 1954 529 1532 4771 550 3931 3039 3809 155 358 1856 4389 3441 3256 3192 1384 686 4196 3246 4582 2545 4780 422 4575 3292 2202 176 240 2884 1918 2300 2344 871 1540 1687 2290 2538 1040 479 4948 1828 1664 2673 4252 359 1439 1966 1126 276 1014 588 1715 2585 2805 2394 4682 229 826 3376 3643 2961 5259 1866 2274 2994 2040 1601 3777 339 2784 1036 702 3463 862 880 183 367 671 2754 285 983 1977 316 499 474 1223 3315 5187 1928 416 2918 3510 2808 5068 360 1242 416 597 1718 1271 1927 4518 2951 4111 1823 5196 1179 1074 1274 4167 964 1573 297 3825 2310 4773 2504 3945 2203 3127 2112 4733 3407 4908 1391 2156 295 2312 1817 93 3367 84 2721 3315 2626 3352 442 955 2350 2468 2388 2311 2871 3789 3033 1498 123 1981 2862 91 935 2983 1280 4339 679 1750 2455 2374 273 162 1910 3821 1494 1691 303 3767 943 3572 3514 2657 2185 4547 291 473 1016 335 3056 1889 3444 2799 2556 2073 2406 2646 1511 2271 107 2708 3295 1142 2476 4828 944 1177 2548 958 1460 1434 771 4986 1913 2751 3101 2185 1749 2894 2151 3285 1214 111 130 643 2535 372 2223 2936 1879 4366 1303 1405 2039 3626 425 1978 1291 2842 1681 2440 595 4735 2126 1901 1330 2600 1779 142 1016 5126 1319 117 3004 2811 2046 525 3315 849 336 3669 1477 2541 491 3997 2012 3824 2623 1826 1284 510 2476 617 3393 136 2643 1291 794 2463 1168 869 2788 544 3505 3606 1657 1458 3484 3211 2156 1675 2168 246 2975 449 2636 3657 3258 1511 1521 5150 2167 2090 517 585 2610 1682 1579 3618 287 527 2908 1905 1577 3566 1365" );
+                        break;
+                    case 4 : // A2 1600 dots
+                        finder->setScale( 0.0001 );
+                        finder->configure( "3865 945 630 2091 1209 2063 1495 3289 2212 2768 3672 2844 481 2661 306 2583 614 451 3503 721 2000 1935 1970 198 1761 184 2094 861 4791 3338 4609 234 1906 1391 1065 1493 1062 1337 1072 2490 4594 2670 133 354 4080 1522 1267 2307 5198 2779 2885 1011 956 3009 1762 2306 5016 1013 5118 121 1998 2484 3321 1597 1340 1307 3636 137 4196 541 3017 667 1923 1795 1786 3133 2938 1443 2910 1687 4867 3493 4311 2195 5182 2593 1645 1341 883 812 413 2246 160 861 3118 1085 526 511 2989 84 3659 2483 2335 2760 2594 564 3369 3265 2122 2621 2173 232 2412 873 5055 2009 3407 3131 721 217 3366 2992 1917 3042 4825 684 4536 2191 1503 2389 829 1817 2701 2677 3850 1743 1011 804 5122 1291 2795 349 556 3037 4836 281 2636 2784 1255 2172 740 3285 5081 2549 605 912 3033 1841 2355 1226 4343 2759 1767 961 3852 726 1323 2459 2479 1723 2951 3079 2698 2059 2398 2241 1830 1451 3708 3080 1147 556 866 1970 1345 269 1473 888 1978 596 2659 1845 407 2417 4130 2774 3935 100 95 1627 1582 2976 1972 838 2260 1532 1039 1602 5079 2460 4241 630 2747 1216 839 1642 2561 809 2645 471 5210 88 3972 472 2944 1126 4053 1838 1628 1797 3664 1790 4699 215 1686 2514 4942 2940 3143 848 1231 1452 4385 1689 1542 2175 3223 1316 5024 538 1828 1795 105 3499 918 2881 470 3184 2934 2554 3225 3112 3356 2204 316 946 4413 3276 4741 3033 4726 2112 549 1594 3341 1486 2502 2931 5315 2100 1257 333 5046 3116 441 3396 4374 493 252 878 2303 768 2082 2267 3175 2824 4547 888 1281 875 3877 2563 1618 2595 2851 2876 2232 591 4121 1317 951 1746 3542 3090 464 1690 818 1501 2349 115 302 1880 685 1168 5039 333 2041 1231 2290 1156 2415 3193 338 2008 1395 2989 4034 1249 459 924 2252 2996 3494 1728 4184 762 4242 228 1500 2735 1961 1690 328 2904 3389 2417 1151 167 2904 3404 1979 2254 1160 1852 2576 2362 926 968 4956 2171 4223 2055 1197 3323 3916 360 5289 361 4241 1488 1698 1980 2928 2461 444 2343 3096 332 146 1421 510 3324 206 2134 808 3027 4952 1487 4667 1279 3263 3494 1762 1043 1547 1850 364 2097 2186 2260 1376 2890 692 2508 885 2524 4305 1321 1186 792 4882 99 4288 106 593 1735 1282 1744 3195 492 781 789 2241 295 5189 1758 3663 2353 998 633 4561 384 1251 632 464 1603 391 386 3245 2107 2579 259 3009 185 2664 2346 730 1984 465 3059 1467 1835 4055 1691 3334 2002 3964 1168 4809 1664 3845 2912 3944 3002 540 1828 198 1854 4642 384 5050 2165 2552 3439 1608 3133 2326 426 1716 1641 3613 3195 3739 2178 2075 2417 4337 1765 3608 506 1747 1130 927 129 203 2554 2632 2463 4623 3202 3799 3493 2805 1740 188 3246 4012 2608 990 1200 1793 611 1785 2432 92 689 619 2720 3689 2100 3322 1035 5241 482 2122 1222 2127 3217 3592 879 2066 2696 3324 2711 2444 672 2722 3214 4280 761 1379 1835 4773 2278 2655 1965 221 1496 1242 2832 4587 1418 4071 868 5006 708 4470 3380 1457 422 3971 686 2489 3351 672 632 1227 460 3797 1234 688 379 1548 1463 1550 2466 3533 1612 380 1743 1711 2727 2201 690 4865 1837 2159 3045 5319 3087 4557 2274 4477 2281 3245 2297 399 847 3333 1152 5181 3160 2360 2353 1045 2411 1984 2575 279 1716 120 2640 585 3464 2852 1625 4605 2885 657 1266 3486 2320 5174 308 2436 1810 252 281 3348 718 1842 1632 4187 1896 3037 1313 1346 462 2054 1561 848 2790 4089 405 1102 392 3207 261 3252 99 1934 1190 179 87 2064 1037 2595 3269 4350 932 4578 3513 2213 1876 2534 1868 1457 596 2325 1634 1036 1787 1711 724 2340 584 4190 147 1266 188 1308 2941 1381 2055 2095 276 2372 987 2147 2050 1590 945 2781 461 3965 2483 3136 3313 3482 1345 266 3133 2108 537 265 1164 304 2271 3518 2886 1483 1546 2617 1383 1330 1411 2254 1342 3647 1245 1622 3468 1353 2249 4861 1387 4271 3163 4936 2801 2857 133 2643 1702 4733 788 369 1530 675 1819 2665 3135 2717 1771 178 2902 4401 839 656 1571 3677 2991 5213 2467 2219 2654 212 2451 4447 1395 4132 488 1796 3318 1027 3492 5171 3513 1058 1992 2672 2890 917 3356 4466 1519 1200 2525 3034 3036 4925 366 4278 1154 5186 2886 616 810 2962 2675 2347 2449 1697 1496 908 2399 3843 492 4277 2482 997 1868 488 1381 512 1177 1628 1698 3210 1590 2418 3030 3205 997 3215 783 671 115 3393 85 2793 973 3588 2617 231 2215 1417 1441 3802 1921 2380 2569 3709 3285 4061 2408 2339 1458 175 1975 877 1442 1439 702 3066 3376 4397 2824 2217 2524 4600 669 3072 2553 3502 3315 708 1427 5223 3088 2975 880 3990 2708 281 1584 554 3147 3100 2358 4255 1837 4941 2549 3735 1472 3634 3112 883 1227 718 3056 4048 2155 3718 2694 3172 1378 1222 3058 665 2986 2720 1633 1653 3249 1389 2399 954 1335 1921 715 357 1411 5164 563 1928 463 4832 2505 870 532 3770 566 3504 836 3480 576 209 3380 2721 1549 2578 112 5186 1857 1496 2950 935 2620 4922 1963 672 2297 1867 852 4100 3122 5242 2185 5290 201 953 2274 2224 3489 250 166 2011 1839 4378 151 3505 2214 1991 3193 5269 3018 3873 830 3152 3207 993 179 2235 3381 814 2108 3249 1924 5142 816 3001 368 3137 2012 2822 540 2683 2529 3767 2622 5316 1292 5311 627 5182 1064 3193 618 3297 3405 493 602 463 799 164 2381 1095 2331 914 229 4815 444 5035 1441 549 2172 741 700 2507 355 4463 322 2043 2972 544 2951 1388 1703 4114 2332 2557 2600 2857 1221 516 425 1185 1360 3046 2919 2191 2901 1587 705 4740 2362 3817 2787 4404 1088 2689 1103 4213 3246 934 1092 2794 1887 991 2759 743 2590 2624 1216 1073 2773 2657 3475 3344 545 3784 2013 3905 1824 425 1219 3619 995 3346 1806 3931 1924 858 3224 632 1084 2515 2696 2220 2406 1304 1985 342 3465 1890 2458 4448 666 3043 3290 4272 3069 1482 985 449 323 786 1365 2470 1578 1143 1128 2445 2817 2980 2066 4367 3371 1864 2167 1066 943 2561 2263 4417 2095 3575 2143 1665 202 5309 2368 2837 1330 1401 80 1022 2645 4644 1738 2078 3323 4379 2916 3159 2673 2408 2013 4999 1308 1882 3456 2428 1338 561 338 5136 1695 4388 3132 751 1241 84 439 4511 770 3850 621 389 766 226 1283 630 1001 1787 294 4045 3519 4477 981 2738 3402 4460 2692 3144 2456 5249 3322 1807 1908 2199 928 4192 1574 5267 1445 3263 3220 939 732 3957 3321 2801 1084 1169 662 2472 1136 1418 2128 2471 109 3115 1727 4013 1921 5301 2704 3114 524 86 902 5011 2319 260 761 3140 1475 2150 1482 4967 2393 3486 2097 3012 3450 3839 133 1610 1586 4187 2145 1334 605 2517 452 3497 3200 1101 3043 3420 3495 1991 2339 3238 3330 5066 1578 785 2214 276 2968 4654 743 5152 1944 1287 3504 1493 100 5193 1535 4010 174 4430 2433 3502 2454 2596 2126 4560 2402 3588 1387 708 2811 5040 837 5121 913 3504 3457 1157 1669 2137 366 3908 2638 2661 623 1453 181 4441 1953 4602 1623 3958 1001 1045 276 3253 1125 3403 894 3513 181 5087 3201 2013 3383 4327 583 1067 2086 478 109 81 148 2857 922 2415 274 2514 1285 4768 118 116 238 4664 2630 3789 1559 1162 3427 1936 1103 4385 1267 2915 2156 1118 2651 3224 1459 4119 712 3706 413 2615 2979 2433 1045 4247 2992 1935 3280 2231 1973 5310 2901 3960 910 4070 3271 237 2763 3928 2851 228 1066 1991 100 539 833 416 245 820 2931 4274 907 3974 266 2438 2375 2330 3095 1567 1213 129 1013 2333 253 1800 703 2230 501 3635 3339 737 533 1082 3218 1424 2665 4727 1177 696 914 4370 2604 2221 776 4288 2111 4652 2405 1745 1354 2895 1554 1518 237 4883 3252 3849 1044 1039 2989 3595 637 570 1485 3707 320 1562 2887 3606 415 2981 3213 3481 293 599 2381 4000 2089 4326 2351 2087 1299 3136 87 1736 3378 4700 1934 3089 1638 2844 270 1292 2624 719 1088 4701 618 1095 2918 854 1129 97 3261 4741 2898 4978 2063 3152 2099 3666 2257 1874 1301 4235 2870 1670 365 3930 582 3266 2519 756 999 822 617 1925 2039 2522 3518 3069 2154 2393 1525 460 2841 1023 3143 4310 3493 4818 1508 5099 1140 2477 950 4533 3236 5202 665 4803 1775 2287 3225 2943 1933 4893 1703 2337 2181 3766 1648 825 129 3288 250 130 2774 3789 867 2943 2871 3007 1602 2782 2319 5231 3240 4125 3518 1523 648 3583 2320 3456 422 3344 1385 523 1059 2253 3150 5306 1585 1651 517 4523 1306 3074 2781 2053 1473 108 3035 141 1285 1222 1159 3880 3198 4870 2662 3851 2444 926 2170 1615 2313 3059 2439 512 2555 3033 1726 4190 3430 5024 2776 1518 2090 2692 1004 374 3320 5298 1665 3451 959 4557 2579 4170 2644 2680 770 3694 1372 1878 2316 851 1015 3268 2782 457 2488 4900 1250 1718 1856 1528 1311 2576 959 1819 2729 2475 2450 835 1731 1315 3061 1107 1228 1336 1064 1029 2219 87 2338 4330 3299 4727 2804 4027 577 3742 722 2951 515 4614 2991 2779 2121 2623 1560 118 2166 3565 2956 2761 639 2688 1341 5005 1766 4571 1839 4979 453 762 1861 3099 1889 1002 2544 5122 2243 3200 1230 4497 3136 4709 2191 431 2947 4068 776 1886 2865 4272 2668 5275 923 3629 1545 2000 375 3493 1862 3441 2707 4872 841 5086 3317 2032 3484 3997 1576 214 483 3556 1153 2464 1422 4158 305 2473 217 1586 400 4932 3133 132 532 1993 1354 1584 1097 3748 1102 4846 2886 2136 2533 4452 1153 2739 2218 4726 348 2938 1251 4691 1039 3148 3046 330 197 2311 1958 4549 295 5170 1214 1909 1935 2506 2322 2091 656 729 3403 1043 3382 4560 1187 1191 1029 869 1343 4175 3317 2910 632 5295 1994 2367 1748 4274 3372 4143 3023 2051 1708 4641 1154 1296 2741 1456 2874 2831 2711 1388 3291 2963 783 2993 1056 1312 1207 3673 1140 2583 1647 3790 365 899 2718 1155 2826 3391 356 4893 2100 674 2647 1122 2179 549 2271 587 734 4140 1712 520 183 5195 1626 183 1741 3673 1658 1061 1686 1112 1567 4361 1874 2816 718 1477 1221 5304 96 1807 3507 2694 893 4961 237 1949 3507 1180 1973 4454 3484 3313 903 4972 1193 4793 1255 4415 397 2728 3063 894 3121 858 417 5106 2738 3282 1684 1634 618 3592 3460 3642 708 3862 1655 1861 1720 987 1419 569 112 3733 996 2388 3275 3494 2646 3614 1986 652 2216 552 258 4250 2759 4379 1595 482 1525 4723 1520 227 373 3314 171 4507 1748 1487 806 1713 861 3965 1313 4138 2073 3555 1308 5116 486 2096 1842 1459 1361 1535 2808 1530 3496 3368 1246 3697 907 2260 216 2419 1662 4650 930 4673 3103 3426 1180 2753 1466 1592 3324 382 2525 2316 2844 456 1946 1494 2580 4792 934 4081 3397 5318 2261 1777 2859 3309 2400 219 1657 3172 3393 3564 95 325 318 2573 1106 4591 1530 1664 2236 2199 1246 1646 2798 5119 2331 1316 1642 1107 90 3257 2609 2443 579 3975 1999 3172 1805 224 575 4183 2437 5004 1676 1445 3494 4031 3009 547 1268 5029 3446 681 3168 3745 2350 4898 755 3791 3080 3860 275 2313 883 305 513 2284 969 3059 1173 1025 2846 2937 3308 803 3477 2595 724 2677 312 2960 1778 3248 405 5306 1845 1855 425 1958 990 4956 2708 2511 3194 2252 1451 2106 2133 3022 948 281 3266 3756 253 1943 1483 4848 1030 5254 797 1674 3051 2830 2958 5170 3292 3574 253 2279 1819 4209 1230 2753 805 2555 1505 4034 2525 2949 434 1058 1117 4165 1437 1358 2578 702 1731 749 2418 3033 1977 2777 221 1456 2467 2922 347 978 2350 5038 198 2817 2503 3881 1351 444 2089 1252 1873 94 2534 3800 1388 1412 3158 3697 621 2504 1970 3835 2360 3506 1066 1407 3073 2375 2937 5065 1913 4611 816 4868 3041 1091 697 94 1190 3984 1394 3343 450 3357 636 3680 1888 280 1361 3805 3276 3361 2593 841 3400 4465 2893 4770 3142 3817 2102 1371 3451 3902 3082 1459 1948 1359 1516 3906 2298 3974 2354 4812 1995 3161 384 4383 298 1899 2683 1177 328 3426 1953 2193 1675 1763 2661 3651 1456 3971 823 1991 2089 4082 2911 4874 2242 3157 2275 3760 3355 4943 1371 4843 1151 2852 2611 1499 1641 1891 289 2075 1381 5095 622 3717 135 1575 297 3988 3202 220 2675 3378 2822 887 2050 3311 353 2512 3069 3059 750 5023 916 1512 3397 346 2686 3500 1502 258 3456 380 116 657 3309 4192 1053 407 608 1025 543 3436 1670 338 1050 1629 1896 3778 1822 2468 2141 4536 95 765 300 3435 204 3475 87 4950 3519 321 3049 2447 795 1121 3512 4393 744 151 3136 4515 475 1564 1946 5149 2051 4681 1642 3198 2184 4556 3415 1093 1020 2363 2080 3908 2135 5272 2595 405 2623 658 293 636 1904 5067 2887 5268 1363 813 3114 988 2046 4232 443 1376 983 3077 2264 4651 2072 4166 2252 750 1631 3640 2754 3461 3067 4000 1751 792 2489 4103 193 960 445 853 2647 4544 562 4697 3264 2229 1065 3531 1971 5237 3463 2424 3507 4737 1850 1776 2577 5157 2994 839 2336 433 2736 631 3077 1583 2710 951 342 3997 1087 4066 1987 1964 1590 4881 569 1981 2675 3646 816 4649 2299 4730 698 4785 2711 1114 3314 285 2351 962 1571 4298 1033 2655 1463 3975 2215 2152 99 5270 3170 1725 1242 1640 1157 1194 2351 2792 2402 4799 3247 1945 2956 4920 1126 4719 3495 3541 2742 3131 213 539 2865 2884 2252 1496 1064 3060 3126 296 620 5206 204 4299 1548 2782 3160 5128 3398 3614 1081 4532 2739 4124 937 1838 101 4379 2243 5097 1054 2991 2218 4985 1869 5078 1807 1905 3197 425 3518 4521 2029 2276 3311 4431 3028 96 786 1817 2087 5028 83 3078 449 530 2453 3904 1490 5302 713 2039 2788 2648 3365 1219 2665 3357 1714 1304 743 4229 978 1768 1720 4693 2705 303 2448 3585 1760 2794 3468 1164 2253 3896 3501 5077 1372 4925 941 4980 3018 1206 1594 1676 1029 4522 2487 3669 249 4534 2999 5132 398 1217 2938 3425 3401 1886 1029 2405 2647 4906 1617 2848 3234 1677 2074 4330 2037 4080 2248 2054 3082 2587 2890 1628 89 2354 3446 1008 1050 1354 175 2125 1939 4909 3366 4376 1010 2065 2043 4648 2496 1854 1540 1814 1189 4746 489 3701 3187 1318 3357 858 321 1157 877 2047 733 528 2051 3401 1865 914 3444 1551 3200 655 1662 4562 1054 2741 2807 686 767 4590 1984 1731 3463 3490 2560 3234 2024 1714 116 739 2902 1910 2780 2373 1130 3868 2030 4595 477 1539 3072 325 3188 3750 1730 1786 490 914 620 1074 1896 5078 3014 4447 2537 3309 3071 3704 2014 2135 3427 2792 1992 5317 2457 4789 1351 772 3211 1926 3383 682 3517 525 3409 4411 573 3288 2872 588 631 2514 2050 4134 2502 4596 2138 1890 631 2808 3059 5168 1410 375 1927 1310 3243 84 1888 3795 2517 2437 1258 1117 1415 5296 281 4979 3278 2920 2996 3205 173 3443 503 3308 796 5301 1073 3988 3430 2020 933 3421 2145 820 228 2677 145 3255 2951 4626 567 4158 839 185 655 2873 2043 3636 2918 4677 128 447 2169 2998 2341 4824 3415 4711 1399 1363 799 996 3273 4271 364 4111 1145 2021 508 921 1640 1770 3034 4462 1632 2236 2149 1395 2768 4521 2827 1705 2919 2871 2375 3591 336 4892 2451 625 2865 3047 1446 2388 1912 3809 2990 5082 2661 260 2067 4279 1950 411 1852 4647 3370 939 3205 3442 1792 3798 3164 4507 212 114 1101 4813 2186 2875 3139 1621 2006 1511 1726 1111 3131 4957 146 4831 172 3266 673 2125 3131 3276 1848 4083 1032 1473 309 3464 2975 3162 698 2180 1800 1642 799 626 213 1206 101 2807 3358 4432 913 1634 2441 434 1024 3081 1014 4733 2504 3883 2730 3683 2583 1205 3189 871 2249 4202 1770 3395 2504 2884 3501 3840 2217 1247 971 3366 2902 1560 850 1393 360 4018 3101 3378 272 312 2168 2761 1295 3469 2793 2316 2622 1837 1095 2058 2885 355 1136 306 3382 1479 515 3457 1262 173 2286 4221 3508 1807 1994 1813 3409 2754 2615 4085 2690 715 2114 5222 2386 419 528 4477 1230 203 3061 2501 2530 4112 1608 4486 1882 384 3122 4298 1415 3103 3490 1880 537 4229 2342 2876 837 602 1364 2137 1074 4864 2365 4849 3123 4570 3095 2989 1518 494 683 4197 1361 1640 1427 5192 2298 1782 802 1711 3173 3118 2962 896 1872 4717 2020 4905 670 3194 2384 3441 1441 1444 1128 306 1241 2122 975 4791 1917 350 2797 4241 1696 1156 1756 775 873 3748 2894 5318 2784 2277 2346 323 698 5277 1765 3108 636 2353 679 4064 101 3602 1866 2414 2737 3339 2301 1445 2220 3366 2081 4021 2785 758 2321 4723 1711 2294 2255 2152 1587 530 2758 602 2507 2852 1467 102 3354 2302 3513 84 2916 5083 3517 1854 2978 3411 1049 105 2028 199 953 5169 2149 608 3377 4629 3450 949 1932 2137 2740 3421 1532 4634 2780 3167 2574 1149 2729 1847 194 2100 457 2509 532 391 3237 5173 2686 2483 2234 1824 3217 1735 2158 3729 2440 3860 3348 4324 684 4992 3373 402 1301 1153 2434 2367 350 2621 2656 1289 2071 3080 2644 1433 2326 1353 1921 2724 3315 3704 519 4577 3329 4187 3134 522 3519 1009 89 713 1330 2828 2799 2400 506 5108 249 4397 1478 2545 2807 771 386 2282 1264 4775 1068 4953 823 2055 189 5068 762 864 896 1077 861 4143 2853 2254 390 4829 2592 2655 2233 1765 379 5236 2062 2777 123 4041 336 4900 477 2419 3391 592 1158 4576 974 3896 1218 2247 99 3069 1527" );
+                        break;
+                    default:
+                        throw std::runtime_error("IrisCC::createFinder: Random Features, unknown preset.");
+                }
+            }
+            finder->setMaxRadiusRatio( ui_RandomFeatureFinder->max_radius_ratio->value() );
+            finder->setMinRadius( ui_RandomFeatureFinder->min_radius->value() );
+            finder->setMeanAreaFac( ui_RandomFeatureFinder->mean_area->value() );
+            f = std::shared_ptr<iris::Finder>(finder);
+            break;
+        }
+
+        // not supported finder
+        default:
+            throw std::runtime_error("IrisCC::createFinder: Finder not supported.");
+    }
+
+    return f;
+}
+
+
+bool IrisCC::isCalibrating() const
+{
+    return m_calibrationWorker != 0;
+}
+
+
+void IrisCC::setCalibrating( bool calibrating )
+{
+    // everything that changes the camera set waits for the calibration
+    ui->load->setEnabled( !calibrating );
+    ui->clear->setEnabled( !calibrating );
+    ui->erase->setEnabled( !calibrating );
+    ui->calibrate->setEnabled( !calibrating );
+    ui->configure_camera->setEnabled( !calibrating );
+}
+
+
 void IrisCC::updateImageList()
 {
     // init stuff
@@ -290,7 +349,8 @@ void IrisCC::updateImageList()
     m_poseIndices.clear();
 
     // run over all camera poses
-    for( auto camIt=m_cs.cameras().begin(); camIt != m_cs.cameras().end(); camIt++ )
+    const iris::CameraSet_d& cs = m_cs;
+    for( auto camIt=cs.cameras().begin(); camIt != cs.cameras().end(); camIt++ )
     {
         for( size_t p=0; p<camIt->second.poses.size(); p++ )
         {
@@ -323,6 +383,16 @@ void IrisCC::updateImageList()
 
 
 void IrisCC::updateErrorPlot()
+{
+    // while calibrating, show the latest results of the worker
+    if( m_calibrationSnapshot )
+        updateErrorPlot( *m_calibrationSnapshot );
+    else
+        updateErrorPlot( m_cs );
+}
+
+
+void IrisCC::updateErrorPlot( const iris::CameraSet_d& cs )
 {
     // init stuff
     double range = 1.5;
@@ -332,7 +402,7 @@ void IrisCC::updateErrorPlot()
     ui->plot_error->clearPlottables();
 
     // run over all camera poses
-    for( auto camIt=m_cs.cameras().begin(); camIt != m_cs.cameras().end(); camIt++ )
+    for( auto camIt=cs.cameras().begin(); camIt != cs.cameras().end(); camIt++ )
     {
         // update error
         if( camIt->second.error > range )
@@ -353,9 +423,12 @@ void IrisCC::updateErrorPlot()
                 col.setHslF( 0.5843, 1.0, 0.3 + 0.4*l );
 
                 // run over the points
-                for( size_t i=0; i<pose.points2D.size(); i++ )
-                    graph->addData( pose.projected2D[i](0) - pose.points2D[i](0),
-                                    pose.projected2D[i](1) - pose.points2D[i](1) );
+                if( pose.hasProjections() )
+                {
+                    iris::Correspondences<double>::Points diff = pose.projected2D - pose.correspondences.points();
+                    for( int i=0; i<diff.cols(); i++ )
+                        graph->addData( diff(0,i), diff(1,i) );
+                }
 
                 // plot the detected points
                 graph->setPen( col );
@@ -367,10 +440,10 @@ void IrisCC::updateErrorPlot()
     }
 
     // draw current camera
-    if( m_cs.hasCamera( getCameraId( ui->select_camera->currentIndex() ) ) )
+    if( cs.hasCamera( getCameraId( ui->select_camera->currentIndex() ) ) )
     {
         // run over all poses of the camera
-        const iris::Camera_d& cam = m_cs.camera( getCameraId( ui->select_camera->currentIndex() ) );
+        const iris::Camera_d& cam = cs.camera( getCameraId( ui->select_camera->currentIndex() ) );
         for( size_t p=0; p<cam.poses.size(); p++ )
         {
             if( !cam.poses[p].rejected )
@@ -385,9 +458,12 @@ void IrisCC::updateErrorPlot()
                 col.setHslF( 1.0, 1.0, 0.3 + 0.4*l );
 
                 // run over the points
-                for( size_t i=0; i<pose.points2D.size(); i++ )
-                    graph->addData( pose.projected2D[i](0) - pose.points2D[i](0),
-                                    pose.projected2D[i](1) - pose.points2D[i](1) );
+                if( pose.hasProjections() )
+                {
+                    iris::Correspondences<double>::Points diff = pose.projected2D - pose.correspondences.points();
+                    for( int i=0; i<diff.cols(); i++ )
+                        graph->addData( diff(0,i), diff(1,i) );
+                }
 
                 // plot the detected points
                 graph->setPen( col );
@@ -399,14 +475,18 @@ void IrisCC::updateErrorPlot()
     }
 
     // draw the current pose
-    if( m_cs.hasPose( getPoseId( ui->image_list->currentRow() ) ) )
+    if( cs.hasPose( getPoseId( ui->image_list->currentRow() ) ) )
     {
-        const iris::Pose_d& pose = m_cs.pose( getPoseId( ui->image_list->currentRow() ) );
+        const iris::Pose_d& pose = cs.pose( getPoseId( ui->image_list->currentRow() ) );
         if( !pose.rejected )
         {
+            iris::Correspondences<double>::Points diff;
+            if( pose.hasProjections() )
+                diff = pose.projected2D - pose.correspondences.points();
+
             // points background
             auto graphBg = ui->plot_error->addGraph();
-            for( size_t i=0; i<pose.points2D.size(); i++ ) graphBg->addData( pose.projected2D[i](0) - pose.points2D[i](0), pose.projected2D[i](1) - pose.points2D[i](1) );
+            for( int i=0; i<diff.cols(); i++ ) graphBg->addData( diff(0,i), diff(1,i) );
             graphBg->setPen( QPen( QBrush( QColor( Qt::black ) ), 3 ) );
             graphBg->setLineStyle(QCPGraph::lsNone);
             graphBg->setScatterStyle(QCPGraph::ssPlus);
@@ -414,7 +494,7 @@ void IrisCC::updateErrorPlot()
 
             // points
             auto graph = ui->plot_error->addGraph();
-            for( size_t i=0; i<pose.points2D.size(); i++ ) graph->addData( pose.projected2D[i](0) - pose.points2D[i](0), pose.projected2D[i](1) - pose.points2D[i](1) );
+            for( int i=0; i<diff.cols(); i++ ) graph->addData( diff(0,i), diff(1,i) );
             graph->setPen( QPen( QBrush( QColor( 115, 210, 22 ) ), 1.5 ) );
             graph->setLineStyle(QCPGraph::lsNone);
             graph->setScatterStyle(QCPGraph::ssPlus);
@@ -446,11 +526,13 @@ void IrisCC::updateImage( int row )
         ui->plot_image->clearGraphs();
         ui->plot_image->clearPlottables();
         ui->plot_image->setAxisBackground( QPixmap() );
-        ui->plot_image->replot();
 
         // check if there are any images
         if( m_cs.poseCount() == 0 )
+        {
+            ui->plot_image->replot();
             return;
+        }
 
         // check which index this is
         if( row < 0 || row >= m_cs.poseCount() )
@@ -458,68 +540,66 @@ void IrisCC::updateImage( int row )
 
         // get the image
         const iris::Pose_d& pose = m_cs.pose( getPoseId(row) );
-        const cimg_library::CImg<uint8_t>& image = *pose.image;
-
-        // convert image to Qt
-        QImage imageQt( image.width(), image.height(), QImage::Format_RGB888 );
-        for( int y=0; y<image.height(); y++ )
-        {
-            for( int x=0; x<image.width(); x++ )
-            {
-                QColor col( (255+ image(x,y,0,0)) / 2,
-                            (255+ image(x,y,0,1)) / 2,
-                            (255+ image(x,y,0,2)) / 2 );
-                imageQt.setPixel( x, y, col.rgb() );
-            }
-        }
+        QPixmap pixmap = imagePixmap( pose );
 
         // get the height of the image
-        double height = static_cast<double>(imageQt.height());
+        double height = static_cast<double>(pixmap.height());
 
         // set the images
-        ui->plot_image->setAxisBackground(QPixmap::fromImage(imageQt), true, Qt::IgnoreAspectRatio );
-        ui->plot_image->xAxis->setRange(0, imageQt.width() );
-        ui->plot_image->yAxis->setRange(0, imageQt.height() );
+        ui->plot_image->setAxisBackground( pixmap, true, Qt::IgnoreAspectRatio );
+        ui->plot_image->xAxis->setRange(0, pixmap.width() );
+        ui->plot_image->yAxis->setRange(0, pixmap.height() );
 
         // draw the detected points
         if( !pose.rejected )
         {
+            // one plottable per style, the colors are per point
+            ScatterOverlay* detectedBg = new ScatterOverlay( ui->plot_image->xAxis, ui->plot_image->yAxis );
+            detectedBg->setStyle( ScatterOverlay::Plus );
+            detectedBg->setWidth( 3 );
+            detectedBg->setSize( 12 );
+            ScatterOverlay* detected = new ScatterOverlay( ui->plot_image->xAxis, ui->plot_image->yAxis );
+            detected->setStyle( ScatterOverlay::Plus );
+            detected->setWidth( 1 );
+            detected->setSize( 12 );
+            ScatterOverlay* projected = new ScatterOverlay( ui->plot_image->xAxis, ui->plot_image->yAxis );
+            projected->setStyle( ScatterOverlay::Circle );
+            projected->setWidth( 1.5 );
+            projected->setSize( 8 );
+
+            // the backgrounds of the crosses are added first, so they end up below
+            int count = static_cast<int>( pose.correspondences.size() );
+            detectedBg->reserve( count );
+            detected->reserve( count );
+            if( pose.hasProjections() )
+                projected->reserve( count );
+
             // plot the points
-            for( size_t i=0; i<pose.points2D.size(); i++ )
+            for( size_t i=0; i<pose.correspondences.size(); i++ )
             {
                 // get the color hue
-                double hue = static_cast<double>(3*pose.pointIndices[i])/static_cast<double>(4*pose.pointsMax);
+                Eigen::Vector2d point = pose.correspondences.point(i);
+                double hue = static_cast<double>(3*pose.correspondences.index(i))/static_cast<double>(4*pose.pointsMax);
 
-                // plot the background of detected points
-                QCPGraph* detectedBg = ui->plot_image->addGraph();
-                detectedBg->addData( pose.points2D[i](0), height - pose.points2D[i](1) );
+                // the detected points and their background
                 QColor detectedBgCol;
                 detectedBgCol.setHslF( hue, 0.8, 0.8 );
-                detectedBg->setPen( QPen( QBrush( detectedBgCol ), 3 ) );
-                detectedBg->setLineStyle(QCPGraph::lsNone);
-                detectedBg->setScatterStyle(QCPGraph::ssPlus);
-                detectedBg->setScatterSize(12);
-
-                // plot the detected points
-                QCPGraph* detected = ui->plot_image->addGraph();
-                detected->addData( pose.points2D[i](0), height - pose.points2D[i](1) );
+                detectedBg->addData( point(0), height - point(1), detectedBgCol );
                 QColor detectedCol;
                 detectedCol.setHslF( hue, 0.8, 0.3 );
-                detected->setPen( QPen( QBrush( detectedCol ), 1 ) );
-                detected->setLineStyle(QCPGraph::lsNone);
-                detected->setScatterStyle(QCPGraph::ssPlus);
-                detected->setScatterSize(12);
-
-                // plot the reprojected points
-                QCPGraph* projected = ui->plot_image->addGraph();
-                projected->addData(pose.projected2D[i](0), height - pose.projected2D[i](1));
+                detected->addData( point(0), height - point(1), detectedCol );
+
+                // the reprojected points
+                if( !pose.hasProjections() )
+                    continue;
                 QColor projectedCol;
                 projectedCol.setHslF( hue, 0.8, 0.6 );
-                projected->setPen( QPen( QBrush( projectedCol ), 1.5 ) );
-                projected->setLineStyle(QCPGraph::lsNone);
-                projected->setScatterStyle(QCPGraph::ssCircle);
-                projected->setScatterSize(8);
+                projected->addData( pose.projected2D(0,i), height - pose.projected2D(1,i), projectedCol );
             }
+
+            ui->plot_image->addPlottable( detectedBg );
+            ui->plot_image->addPlottable( detected );
+            ui->plot_image->addPlottable( projected );
         }
 
         // redraw
@@ -532,6 +612,38 @@ void IrisCC::updateImage( int row )
 }
 
 
+QPixmap IrisCC::imagePixmap( const iris::Pose_d& pose )
+{
+    // reuse the conversion as long as the pose shows the same image
+    CachedImage* cached = m_imageCache.object( static_cast<qulonglong>( pose.id ) );
+    if( cached != 0 && cached->image.lock() == pose.image )
+        return cached->pixmap;
+
+    // convert image to Qt, brightened so the points stand out
+    const cimg_library::CImg<uint8_t>& image = *pose.image;
+    QImage imageQt( image.width(), image.height(), QImage::Format_RGB888 );
+    for( int y=0; y<image.height(); y++ )
+    {
+        uchar* line = imageQt.scanLine( y );
+        for( int x=0; x<image.width(); x++ )
+        {
+            line[3*x+0] = static_cast<uchar>( (255+ image(x,y,0,0)) / 2 );
+            line[3*x+1] = static_cast<uchar>( (255+ image(x,y,0,1)) / 2 );
+            line[3*x+2] = static_cast<uchar>( (255+ image(x,y,0,2)) / 2 );
+        }
+    }
+
+    // the cache does not keep the image itself alive, the cost is the size of the pixmap;
+    // an entry above the limit is deleted right away, so the pixmap is returned from here
+    QPixmap pixmap = QPixmap::fromImage( imageQt );
+    CachedImage* entry = new CachedImage();
+    entry->image = pose.image;
+    entry->pixmap = pixmap;
+    m_imageCache.insert( static_cast<qulonglong>( pose.id ), entry, std::max( 1, pixmap.width() * pixmap.height() * 4 ) );
+    return pixmap;
+}
+
+
 //void IrisCC::updatePosesPlot()
 //{
 //    // init stuff
@@ -614,7 +726,8 @@ void IrisCC::updateCameraList()
     ui->select_camera->clear();
 
     // run over all cameras and add their names
-    for( auto camIt=m_cs.cameras().begin(); camIt != m_cs.cameras().end(); camIt++ )
+    const iris::CameraSet_d& cs = m_cs;
+    for( auto camIt=cs.cameras().begin(); camIt != cs.cameras().end(); camIt++ )
         ui->select_camera->addItem( QString("Camera: \"") + QString::number(camIt->first) + QString("\"") );
 
     // set the current row
@@ -665,6 +778,7 @@ void IrisCC::clear()
 
     // clear images
     m_poseIndices.clear();
+    m_imageCache.clear();
 
     // clear the camera set
     m_cs.cameras().clear();
@@ -693,7 +807,8 @@ size_t IrisCC::getCameraId( int comboBoxIdx )
     // get the camera Id
     int camIdx = 0;
     size_t camId = 0;
-    for( auto camIt=m_cs.cameras().begin(); camIt != m_cs.cameras().end(); camIt++ )
+    const iris::CameraSet_d& cs = m_cs;
+    for( auto camIt=cs.cameras().begin(); camIt != cs.cameras().end(); camIt++ )
     {
         if( comboBoxIdx == camIdx )
         {
@@ -725,7 +840,8 @@ void IrisCC::on_configureCamera()
     if( ui->select_camera->currentIndex() >= 0 )
     {
         // get the camera
-        const iris::Camera_d& cam = m_cs.camera( getCameraId( ui->select_camera->currentIndex() ) );
+        const iris::CameraSet_d& cs = m_cs;
+        const iris::Camera_d& cam = cs.camera( getCameraId( ui->select_camera->currentIndex() ) );
 
         // update the dialog
         //ui_CameraConfig->camera_box->setTitle( QString("Camera: \"") + QString::number(cam.id) + QString("\"   (") + QString::number( cam.imageSize(0) ) + "x" + QString::number( cam.imageSize(1) ) + ")" );
@@ -747,7 +863,8 @@ void IrisCC::on_cameraInfo()
     if( m_cs.hasCamera( ui->select_camera->currentIndex() ) )
     {
         // get the camera
-        const iris::Camera_d& cam = m_cs.camera( getCameraId( ui->select_camera->currentIndex() ) );
+        const iris::CameraSet_d& cs = m_cs;
+        const iris::Camera_d& cam = cs.camera( getCameraId( ui->select_camera->currentIndex() ) );
 
         // camera
         ui_CameraInfo->name->setText( QString::number(cam.id) );
@@ -887,7 +1004,7 @@ void IrisCC::on_load()
 {
     try
     {
-        QStringList imagePaths = QFileDialog::getOpenFileNames(this, "Load Images", ".", "Images (*.bmp *.png *.xpm *.jpg *.tif *.tiff)");
+        QStringList imagePaths = QFileDialog::getOpenFileNames(this, "Load Images", ".", "Images (*.bmp *.png *.xpm *.jpg *.tif *.tiff);;Videos (*.avi *.mp4 *.mov *.mkv *.mpg)");
 
         // return fi nothing there
         if( imagePaths.size() == 0 )
@@ -902,6 +1019,36 @@ void IrisCC::on_load()
         // load the images
         for( int i=0; i<imagePaths.size(); i++ )
         {
+            // videos are decoded and searched for the pattern, only novel detections are added
+            QString suffix = QFileInfo( imagePaths[i] ).suffix().toLower();
+            if( suffix == "avi" || suffix == "mp4" || suffix == "mov" || suffix == "mkv" || suffix == "mpg" )
+            {
+                size_t cameraID = static_cast<size_t>( ui->cameraID->value() );
+                std::shared_ptr<iris::Finder> finder = createFinder();
+                iris::FrameSource source;
+                source.open( imagePaths[i].toStdString() );
+
+                // detect in the background and keep the window responsive
+                iris::CameraSet_d detected;
+                std::future<size_t> added = std::async( std::launch::async, [&]() { return source.process( detected, *finder, cameraID ); } );
+                while( added.wait_for( std::chrono::milliseconds( 50 ) ) != std::future_status::ready )
+                    QCoreApplication::processEvents();
+
+                // move the detected poses over with fresh ids
+                if( added.get() > 0 )
+                {
+                    std::vector<iris::Pose_d>& poses = detected.camera( cameraID ).poses;
+                    for( size_t j=0; j<poses.size(); j++ )
+                    {
+                        poses[j].id = m_cs.nextPoseId();
+                        m_cs.insert( std::move( poses[j] ), cameraID );
+                    }
+                }
+
+                progress.setValue(i);
+                continue;
+            }
+
             // load the current image to RGB888
             QImage imageQt;
             imageQt.load( imagePaths[i] );
@@ -967,6 +1114,7 @@ void IrisCC::on_erase()
             int row = ui->image_list->currentRow();
             if(  m_cs.hasPose( m_poseIndices[row] ) )
             {
+                m_imageCache.remove( static_cast<qulonglong>( m_poseIndices[row] ) );
                 m_cs.erase( m_poseIndices[row] );
                 updateImageList();
                 updateErrorPlot();
@@ -989,9 +1137,18 @@ void IrisCC::on_save()
     try
     {
         // get an output filename
-        QString filename = QFileDialog::getSaveFileName(this, "Save Calibration", "calibration.xml", "Iris Camera Calibration XML (*.xml)");
+        QString filename = QFileDialog::getSaveFileName(this, "Save Calibration", "calibration.xml", "Iris Camera Calibration XML (*.xml);;Iris Camera Calibration Binary (*.iris)");
 
         m_cs.save( filename.toStdString(), ui->save_images->isChecked() );
+
+        // the library only keeps the export timings, show them here
+        if( ui->save_images->isChecked() )
+        {
+            const iris::CameraSet_d::ExportReport& report = m_cs.exportReport();
+            std::string message = "Exported " + iris::toString( report.images ) + " undistorted images in " +
+                                  iris::toString( report.totalTime ) + "s.";
+            ui->statusBar->showMessage( QString( message.c_str() ), 5000 );
+        }
     }
     catch( std::exception &e )
     {
@@ -1063,3 +1220,80 @@ void IrisCC::on_detectedImageChanged( int idx )
     updateErrorPlot();
     //updatePosesPlotCurrent();
 }
+
+
+void IrisCC::on_poseDetected( qulonglong id, bool found )
+{
+    // the rows follow the pose indices
+    for( size_t r=0; r<m_poseIndices.size(); r++ )
+    {
+        if( m_poseIndices[r] == static_cast<size_t>( id ) )
+        {
+            ui->image_list->item( static_cast<int>( r ) )->setBackgroundColor( found ? QColor( 128, 255, 128 ) : QColor( 255, 128, 128 ) );
+            break;
+        }
+    }
+}
+
+
+void IrisCC::on_calibrationProgress( QString stage, int done, int steps )
+{
+    // signals may still be queued after the worker finished
+    if( !isCalibrating() )
+        return;
+
+    m_calibrationProgress->setLabelText( stage );
+    m_calibrationProgress->setMaximum( steps );
+    m_calibrationProgress->setValue( done );
+
+    // the error plot grows with every solved view
+    std::shared_ptr<const iris::CameraSet_d> snapshot = m_calibrationWorker->calibration().snapshot();
+    if( snapshot && snapshot != m_calibrationSnapshot )
+    {
+        m_calibrationSnapshot = snapshot;
+        updateErrorPlot();
+    }
+}
+
+
+void IrisCC::on_calibrationFinished( QString error )
+{
+    // the worker is done with its copy, take over the results
+    if( error.isEmpty() )
+        m_cs = m_calibrationWorker->cameraSet();
+
+    // report what the outlier rejection removed
+    iris::OpenCVCalibration* ocv = dynamic_cast<iris::OpenCVCalibration*>( &m_calibrationWorker->calibration() );
+    std::string report;
+    if( error.isEmpty() && ocv )
+        report = "Outlier rejection removed " + iris::toString( ocv->outlierReport().pointsRemoved ) + " points and " +
+                 iris::toString( ocv->outlierReport().posesRemoved ) + " poses.";
+
+    // the worker is deleted in its own thread
+    m_calibrationWorker->deleteLater();
+    m_calibrationWorker = 0;
+    m_calibrationSnapshot.reset();
+    m_calibrationProgress.reset();
+    setCalibrating( false );
+
+    // update the plots
+    updateImageList();
+    updateErrorPlot();
+    //updatePosesPlot();
+    updateImage( ui->image_list->currentRow() );
+
+    if( !error.isEmpty() )
+        critical( error.toStdString() );
+    else if( !report.empty() )
+        warning( report );
+}
+
+
+void IrisCC::on_cancelCalibration()
+{
+    if( isCalibrating() )
+    {
+        m_calibrationProgress->setLabelText( "Cancelling..." );
+        m_calibrationWorker->calibration().cancel();
+    }
+}
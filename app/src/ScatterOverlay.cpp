@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of IrisCC, a C++ UI for camera calibration               //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// IrisCC is free software; you can redistribute it and/or                    //
+// modify it under the terms of the GNU  General Public License               //
+// as published by the Free Software Foundation; either version 3             //
+// of the License, or (at your option) any later version.                     //
+//                                                                            //
+// IrisCC is distributed in the hope that it will be useful,                  //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of             //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU General Public License          //
+// along with IrisCC. If not, see <http://www.gnu.org/licenses/>.             //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <QPainter>
+
+#include <ScatterOverlay.hpp>
+
+
+ScatterOverlay::ScatterOverlay( QCPAxis* keyAxis, QCPAxis* valueAxis ) :
+    QCPAbstractPlottable( keyAxis, valueAxis ),
+    m_style( Plus ),
+    m_size( 6.0 ),
+    m_width( 1.0 )
+{
+}
+
+
+ScatterOverlay::~ScatterOverlay()
+{
+}
+
+
+void ScatterOverlay::setStyle( Style style )
+{
+    m_style = style;
+}
+
+
+void ScatterOverlay::setSize( double size )
+{
+    m_size = size;
+}
+
+
+void ScatterOverlay::setWidth( double width )
+{
+    m_width = width;
+}
+
+
+void ScatterOverlay::reserve( int count )
+{
+    m_keys.reserve( count );
+    m_values.reserve( count );
+    m_colors.reserve( count );
+}
+
+
+void ScatterOverlay::addData( double key, double value, const QColor& color )
+{
+    m_keys.push_back( key );
+    m_values.push_back( value );
+    m_colors.push_back( color );
+}
+
+
+int ScatterOverlay::size() const
+{
+    return m_keys.size();
+}
+
+
+void ScatterOverlay::clearData()
+{
+    m_keys.clear();
+    m_values.clear();
+    m_colors.clear();
+}
+
+
+double ScatterOverlay::selectTest( double key, double value ) const
+{
+    if( m_keys.isEmpty() || !mVisible )
+        return -1;
+
+    // pixel distance to the closest point
+    QPointF pos = coordsToPixels( key, value );
+    double minDist = std::numeric_limits<double>::max();
+    for( int i=0; i<m_keys.size(); i++ )
+    {
+        QPointF d = coordsToPixels( m_keys[i], m_values[i] ) - pos;
+        minDist = std::min( minDist, d.x()*d.x() + d.y()*d.y() );
+    }
+
+    return std::sqrt( minDist );
+}
+
+
+void ScatterOverlay::draw( QPainter* painter ) const
+{
+    if( !mVisible || m_keys.isEmpty() )
+        return;
+    if( mKeyAxis->range().size() <= 0 )
+        return;
+    painter->setClipRect( mKeyAxis->axisRect() | mValueAxis->axisRect() );
+    painter->setRenderHint( QPainter::Antialiasing, mParentPlot->antialiasedElements().testFlag( QCustomPlot::aeScatters ) );
+    painter->setBrush( Qt::NoBrush );
+
+    // the pen only changes with the color
+    QPen pen( QBrush( m_colors[0] ), m_width );
+    painter->setPen( pen );
+    for( int i=0; i<m_keys.size(); i++ )
+    {
+        if( m_colors[i] != pen.color() )
+        {
+            pen.setColor( m_colors[i] );
+            painter->setPen( pen );
+        }
+
+        double x, y;
+        coordsToPixels( m_keys[i], m_values[i], x, y );
+        drawSymbol( painter, x, y );
+    }
+}
+
+
+void ScatterOverlay::drawLegendIcon( QPainter* painter, const QRect& rect ) const
+{
+    painter->setRenderHint( QPainter::Antialiasing, mParentPlot->antialiasedElements().testFlag( QCustomPlot::aeScatters ) );
+    painter->setPen( QPen( QBrush( m_colors.isEmpty() ? QColor( Qt::black ) : m_colors[0] ), m_width ) );
+    painter->setBrush( Qt::NoBrush );
+    drawSymbol( painter, rect.center().x(), rect.center().y() );
+}
+
+
+QCPRange ScatterOverlay::getKeyRange( bool& validRange, SignDomain inSignDomain ) const
+{
+    return range( m_keys, validRange, inSignDomain );
+}
+
+
+QCPRange ScatterOverlay::getValueRange( bool& validRange, SignDomain inSignDomain ) const
+{
+    return range( m_values, validRange, inSignDomain );
+}
+
+
+void ScatterOverlay::drawSymbol( QPainter* painter, double x, double y ) const
+{
+    // same symbols and pixel correction as QCPGraph
+    double w = m_size / 2.0;
+    switch( m_style )
+    {
+        case Plus :
+            x -= 0.7;
+            y -= 0.4;
+            painter->drawLine( QLineF( x-w, y, x+w, y ) );
+            painter->drawLine( QLineF( x, y+w, x, y-w ) );
+            break;
+
+        case Circle :
+            painter->drawEllipse( QRectF( x-w, y-w, m_size, m_size ) );
+            break;
+    }
+}
+
+
+QCPRange ScatterOverlay::range( const QVector<double>& data, bool& validRange, SignDomain inSignDomain )
+{
+    QCPRange result;
+    validRange = false;
+    for( int i=0; i<data.size(); i++ )
+    {
+        double d = data[i];
+        if( ( inSignDomain == sdNegative && d >= 0 ) || ( inSignDomain == sdPositive && d <= 0 ) )
+            continue;
+
+        if( !validRange )
+        {
+            result.lower = d;
+            result.upper = d;
+            validRange = true;
+        }
+        else
+        {
+            result.lower = std::min( result.lower, d );
+            result.upper = std::max( result.upper, d );
+        }
+    }
+
+    return result;
+}
+
@@ -55,6 +55,9 @@ if( WIN32 )
 endif()
 find_package( OpenCV REQUIRED )
 
+# find the thread library
+find_package( Threads REQUIRED )
+
 # set the include dir
 set( Iris_INCLUDE_DIR "${Iris_DIR}/include")
 
@@ -90,7 +93,8 @@ set( Iris_INCLUDE_DIRS
 set( Iris_LINK_LIBRARIES
     -lm
     -lc
-    ${OpenCV_LIBS} CACHE INTERNAL "all libs iris needs" )
+    ${OpenCV_LIBS}
+    ${CMAKE_THREAD_LIBS_INIT} CACHE INTERNAL "all libs iris needs" )
 
 # set libraries
 set( Iris_LIBRARIES ${Iris_LIBRARY} ${Iris_LINK_LIBRARIES} CACHE INTERNAL "the iris lib" )
@@ -22,10 +22,17 @@
 #pragma once
 
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <iris/Finder.hpp>
 #include <iris/CameraSet.hpp>
+#include <iris/Progress.hpp>
+#include <iris/TaskPool.hpp>
 #include <iris/util.hpp>
 
 namespace iris
@@ -53,33 +60,150 @@ public:
     CameraCalibration();
     virtual ~CameraCalibration();
 
-    // run the calibration
+    // run the calibration, the set is only changed if it succeeds
     virtual void calibrate( CameraSet_d& cs ) = 0;
 
+    // solve a single precision set in double precision
+    void calibrate( CameraSet_f& cs );
+
+    // calibrate on a thread of its own, leave the set alone until the future is ready;
+    // the set is solved in place and restored if the run does not succeed
+    std::future<void> calibrateAsync( CameraSet_d& cs );
+
+    // stop the running calibration, it throws and leaves the set unchanged;
+    // checked between detected poses, before each camera is solved and between
+    // trimming rounds, a solver run that already started is not interrupted
+    void cancel();
+
+    // stop detecting and refining after this long, keeping what is solved (0 = no limit)
+    void setTimeBudget( std::chrono::milliseconds budget );
+
+    // the cameras solved so far with their results, null until the first one
+    // is solved; snapshots are only kept from the first call on
+    std::shared_ptr<const CameraSet_d> snapshot() const;
+
     void setFinder( std::shared_ptr<Finder> finder );
 
     const Finder& finder() const;
 
+    // threads of the parallel stages, the calling one included (0 = all);
+    // creates a pool of its own
+    void setThreadCount( size_t count );
+
+    // run on a pool shared with the host application or other calibrations,
+    // TaskPool::shared() by default
+    virtual void setTaskPool( std::shared_ptr<TaskPool> pool );
+
+    TaskPool& taskPool() const;
+
+    // where the progress goes, the console by default
+    void setProgressSink( std::shared_ptr<Progress::Sink> sink );
+
+    // poll the progress and metrics of a running calibration
+    const Progress& progress() const;
+
 protected:
+    // marks a running calibration, calibrate implementations start with one;
+    // it takes over the mark calibrateAsync put up, a second run throws
+    class Run
+    {
+    public:
+        Run( CameraCalibration& calibration );
+        ~Run();
+
+    protected:
+        CameraCalibration& m_calibration;
+    };
+
+    // what a run changes in the set: the detection and the results of every
+    // pose and the parameters of every camera. The correspondences and the
+    // projections are moved aside, nothing is copied on the way in or out.
+    // Restored on destruction unless released after the commit.
+    class Rollback
+    {
+    public:
+        Rollback( CameraSet_d& cs );
+        ~Rollback();
+
+        void release();
+
+    protected:
+        struct PoseState
+        {
+            Correspondences<double> correspondences;
+            std::shared_ptr<const Pattern_d> pattern;
+            size_t pointsMax;
+            Eigen::Matrix4d transformation;
+            Correspondences<double>::Points projected2D;
+            bool rejected;
+        };
+
+        struct CameraState
+        {
+            Eigen::Matrix3d intrinsic;
+            std::vector<double> distortion;
+            double error;
+            std::vector<PoseState> poses;
+        };
+
+        CameraSet_d& m_cs;
+        std::map< size_t, CameraState > m_cameras;
+        bool m_released;
+    };
+
     virtual void filter( CameraSet_d& cs ) = 0;
     virtual void commit( CameraSet_d& cs );
 
+    // copy the results of a view to its camera
+    static void commit( Camera_d& target, const CameraView_d& view );
+
     void check();
 
-    void threadID();
+    // drop the mark of calibrateAsync if the run on this thread did not take it over
+    void unreserve();
+
+    // detect on all poses, in parallel every task works on its own finder clone
+    void detect( const std::vector<Pose_d*>& poses );
+
+    // cancelled or out of time
+    bool stopping() const;
+
+    // throw if cancelled
+    void checkCancelled() const;
+
+    // update the snapshot with a solved view, only its own camera is copied
+    // and nothing at all unless snapshots were asked for
+    void publish( const CameraView_d& view );
 
 protected:
     // these two do the work
     std::shared_ptr<Finder> m_finder;
 
-    // filtered
-    std::map< size_t, iris::Camera_d > m_filteredCameras;
+    // filtered poses per camera and the results for them
+    std::map< size_t, iris::CameraView_d > m_filteredCameras;
 
     // flags
     bool m_handEye;
 
-    // threads
-    size_t m_threadCount;
+    // runs the parallel stages
+    std::shared_ptr<TaskPool> m_taskPool;
+
+    // counted by the workers
+    Progress m_progress;
+
+    // cancellation and time budget of the running calibration
+    std::mutex m_runMutex;
+    bool m_running;
+    std::thread::id m_reservedFor;
+    std::atomic<bool> m_cancelled;
+    std::chrono::milliseconds m_timeBudget;
+    std::chrono::steady_clock::time_point m_deadline;
+
+    // intermediate results, the set is assembled from the cameras on request
+    mutable std::mutex m_snapshotMutex;
+    mutable bool m_snapshotRequested;
+    std::map< size_t, std::shared_ptr<const Camera_d> > m_snapshotCameras;
+    mutable std::shared_ptr<const CameraSet_d> m_snapshot;
 };
 
 
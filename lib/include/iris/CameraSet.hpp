@@ -28,9 +28,21 @@
  *      Author: duliu
  */
 
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
 #include <tinyxml2.h>
 
 #include <iris/util.hpp>
+#include <iris/CameraSetFile.hpp>
+#include <iris/CameraSetJournal.hpp>
+#include <iris/Progress.hpp>
+#include <iris/UndistortionMap.hpp>
+#include <iris/XMLReader.hpp>
 
 namespace iris
 {
@@ -38,6 +50,29 @@ namespace iris
 template <typename T>
 class CameraSet
 {
+public:
+    // format of the undistorted images written by save()
+    enum ImageFormat
+    {
+        PNG,
+        BMP
+    };
+
+    // timings of the last image export, stages are summed over the workers
+    class ExportReport
+    {
+    public:
+        ExportReport() : images(0), workers(0), mapTime(0), convertTime(0), remapTime(0), encodeTime(0), totalTime(0) {}
+
+        size_t images;
+        size_t workers;
+        double mapTime;
+        double convertTime;
+        double remapTime;
+        double encodeTime;
+        double totalTime;
+    };
+
 public:
     // constructor
     CameraSet();
@@ -48,47 +83,135 @@ public:
     // add single image
     size_t add( std::shared_ptr<cimg_library::CImg<uint8_t> > image, const std::string& name, const size_t cameraID=0 );
 
+    // add a pose that already has its id, later ids continue after it
+    size_t insert( Pose<T>&& pose, const size_t cameraID=0 );
+
+    // id the next added pose gets
+    size_t nextPoseId() const;
+
     // remove pose
     bool erase( const size_t id );
     bool erase( const std::string& name ) ;
 
-    // get the cameras
+    // get the cameras, poses are added and removed through add, insert and erase;
+    // once the cameras were handed out for changes, poseCount() counts again
     std::map< size_t, iris::Camera<T> >& cameras();
     const std::map< size_t, iris::Camera<T> >& cameras() const;
 
     // get a particular camera
     bool hasCamera( const size_t id=0 ) const;
-    Camera_d& camera( const size_t id=0 );
-    const Camera_d& camera( const size_t id=0 ) const;
+    Camera<T>& camera( const size_t id=0 );
+    const Camera<T>& camera( const size_t id=0 ) const;
 
     // get a particular pose
     bool hasPose( const size_t id ) const;
     bool hasPose( const std::string& name ) const;
-    const Pose_d& pose( const size_t id ) const;
-    const Pose_d& pose( const std::string& name ) const;
+    Pose<T>& pose( const size_t id );
+    const Pose<T>& pose( const size_t id ) const;
+    const Pose<T>& pose( const std::string& name ) const;
 
-    // number of poses over all cameras
-    size_t poseCount();
+    // number of poses over all cameras, kept by add, insert, erase and load
+    size_t poseCount() const;
 
-    // save to disk
+    // patterns the poses refer to, each once
+    std::vector< std::shared_ptr< const Pattern<T> > > patterns() const;
+
+    // cached undistortion map of a camera, rebuilt if the camera changed
+    const UndistortionMap& undistortionMap( const size_t id=0 );
+
+    // save to disk, binary if the filename ends in ".iris", appended to a
+    // journal if it ends in ".irisj", XML otherwise
     void save( const std::string& filename, bool undistort=false );
 
-    // load from disk
+    // rewrite the journal last loaded or saved as a snapshot
+    void compact();
+    const CameraSetJournal& journal() const;
+
+    // settings of the undistorted image export
+    void setImageFormat( ImageFormat val );
+    void setPngCompression( int val );
+    void setExportMemory( size_t bytes );
+
+    // where the progress of saving goes, the console by default
+    void setProgressSink( std::shared_ptr<Progress::Sink> sink );
+
+    // timings of the last export, nothing is printed
+    const ExportReport& exportReport() const;
+
+    // load from disk, the format is detected from the file's contents;
+    // every pose is decoded, use CameraSetFile directly to read single
+    // poses of a binary file on demand
     void load( const std::string& filename );
 
     // copy operator
     void operator =( const CameraSet& cam );
 
+    // copy from a set of another scalar type
+    template <typename S>
+    void assign( const CameraSet<S>& cs );
+
 private:
-    void appendTextElement( tinyxml2::XMLDocument& doc, tinyxml2::XMLNode& node, std::string name, std::string val );
+    void saveXML( const std::string& filename );
+    void loadXML( const std::string& filename );
+    void loadBinary( const std::string& filename );
+
+    // write the undistorted images next to the file
+    void exportUndistorted( const std::string& filename );
 
-    std::string getElementValue( tinyxml2::XMLNode* node, std::string name );
+    void pushTextElement( tinyxml2::XMLPrinter& printer, const char* name, const std::string& val );
+
+    // format val into the reused buffer and write it as element
+    template <typename V>
+    void pushTextElement( tinyxml2::XMLPrinter& printer, std::string& buffer, const char* name, const V& val );
+
+    // pose lookup through the indices, null if not found
+    const Pose<T>* findPose( const size_t id ) const;
+    const Pose<T>* findPose( const std::string& name ) const;
+
+    // the caller holds the index mutex
+    const Pose<T>* indexedPose( const size_t id ) const;
+    const Pose<T>* indexedPose( const std::string& name ) const;
+    bool erasePose( const size_t id );
+    void rebuildIndex() const;
+
+    // walk all cameras
+    size_t countPoses() const;
 
 private:
+    // handle of a pose: camera id and position in its pose vector
+    typedef std::pair< size_t, size_t > PoseHandle;
+
     size_t m_poseCount;
     std::map< size_t, iris::Camera<T> > m_cameras;
+
+    // running pose count, only trusted while the cameras were not handed out
+    size_t m_poseTotal;
+    bool m_camerasShared;
+    std::map< size_t, UndistortionMap > m_undistortionMaps;
+
+    // journal of the set, not shared by copies
+    CameraSetJournal m_journal;
+
+    // image export
+    ImageFormat m_imageFormat;
+    int m_pngCompression;
+    size_t m_exportMemory;
+    ExportReport m_exportReport;
+    std::shared_ptr<Progress::Sink> m_progressSink;
+
+    // pose indices, kept up to date by add, insert and erase; a handle
+    // that does not match its pose or a miss after poses were added
+    // directly to the cameras rebuilds them
+    mutable std::unordered_map< size_t, PoseHandle > m_idIndex;
+    mutable std::unordered_multimap< std::string, size_t > m_nameIndex;
+    mutable size_t m_indexedPoses;
+    mutable std::mutex m_indexMutex;
+
+    template <typename S> friend class CameraSet;
+    template <typename S> friend class CameraSetIngest;
 };
 typedef CameraSet<double> CameraSet_d;
+typedef CameraSet<float> CameraSet_f;
 
 
 /////
@@ -97,13 +220,28 @@ typedef CameraSet<double> CameraSet_d;
 
 template <typename T>
 inline CameraSet<T>::CameraSet() :
-    m_poseCount(0)
+    m_poseCount(0),
+    m_poseTotal(0),
+    m_camerasShared(false),
+    m_imageFormat(PNG),
+    m_pngCompression(3),
+    m_exportMemory(1024*1024*1024),
+    m_progressSink( std::make_shared<Progress::ConsoleSink>() ),
+    m_indexedPoses(0)
 {
 }
 
 
 template <typename T>
-inline CameraSet<T>::CameraSet( const CameraSet& cs )
+inline CameraSet<T>::CameraSet( const CameraSet& cs ) :
+    m_poseCount(0),
+    m_poseTotal(0),
+    m_camerasShared(false),
+    m_imageFormat(PNG),
+    m_pngCompression(3),
+    m_exportMemory(1024*1024*1024),
+    m_progressSink( std::make_shared<Progress::ConsoleSink>() ),
+    m_indexedPoses(0)
 {
     *this = cs;
 }
@@ -112,80 +250,80 @@ inline CameraSet<T>::CameraSet( const CameraSet& cs )
 template <typename T>
 inline size_t CameraSet<T>::add( std::shared_ptr<cimg_library::CImg<uint8_t> > image, const std::string& name, const size_t cameraID )
 {
-    // assemble the pose
-    Pose_d pose;
+    Pose<T> pose;
     pose.id = m_poseCount;
     pose.name = name;
     pose.image = image;
 
-    // add the pose
-    m_cameras[cameraID].poses.push_back( pose );
+    return insert( std::move( pose ), cameraID );
+}
 
-    // get the image size
-    Eigen::Vector2i imageSize( image->width(), image->height() );
 
+template <typename T>
+inline size_t CameraSet<T>::insert( Pose<T>&& pose, const size_t cameraID )
+{
     // make sure the image sizes are the same
-    if( m_cameras[cameraID].poses.size() == 1 )
+    Camera<T>& camera = m_cameras[cameraID];
+    if( camera.poses.size() == 0 )
+        camera.id = cameraID;
+    if( pose.image )
     {
-        m_cameras[cameraID].id = cameraID;
-        m_cameras[cameraID].imageSize = imageSize;
+        Eigen::Vector2i imageSize( pose.image->width(), pose.image->height() );
+        if( camera.poses.size() == 0 )
+            camera.imageSize = imageSize;
+        else if( imageSize != camera.imageSize )
+            throw std::runtime_error( "CameraSet::addImage: pose has different image size than already stored poses." );
     }
-    else
+
+    // append the pose
+    size_t id = pose.id;
+    camera.poses.push_back( std::move( pose ) );
+    m_poseTotal++;
+
+    // index the new pose
     {
-        Eigen::Vector2i tmp = imageSize - m_cameras[cameraID].imageSize;
-        if( (tmp(0) != 0) || (tmp(1) != 0) )
-            throw std::runtime_error( "CameraSet::addImage: pose has different image size than already stored poses." );
+        std::lock_guard<std::mutex> lock( m_indexMutex );
+        if( m_idIndex.insert( std::make_pair( id, PoseHandle( cameraID, camera.poses.size()-1 ) ) ).second )
+            m_nameIndex.insert( std::make_pair( camera.poses.back().name, id ) );
+        m_indexedPoses++;
     }
 
-    // increment pose count and return id
-    m_poseCount++;
-    return pose.id;
+    // later ids continue after this one
+    m_poseCount = std::max( m_poseCount, id + 1 );
+    return id;
 }
 
 
 template <typename T>
-inline bool CameraSet<T>::erase( const size_t id )
+inline size_t CameraSet<T>::nextPoseId() const
 {
-    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
-    {
-        for( auto poseIt=camIt->second.poses.begin(); poseIt != camIt->second.poses.end(); poseIt++ )
-        {
-            if( poseIt->id == id )
-            {
-                camIt->second.poses.erase( poseIt );
-                return true;
-            }
-        }
-    }
+    return m_poseCount;
+}
+
 
-    // nothing found
-    return false;
+template <typename T>
+inline bool CameraSet<T>::erase( const size_t id )
+{
+    std::lock_guard<std::mutex> lock( m_indexMutex );
+    return erasePose( id );
 }
 
 
 template <typename T>
 inline bool CameraSet<T>::erase( const std::string& name )
 {
-    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
-    {
-        for( auto poseIt=camIt->second.poses.begin(); poseIt != camIt->second.poses.end(); poseIt++ )
-        {
-            if( poseIt->name.compare( name ) == 0)
-            {
-                camIt->second.poses.erase( poseIt );
-                return true;
-            }
-        }
-    }
+    std::lock_guard<std::mutex> lock( m_indexMutex );
 
-    // nothing found
-    return false;
+    // the first occurrence goes, like the lookup
+    const Pose<T>* pose = indexedPose( name );
+    return pose != 0 && erasePose( pose->id );
 }
 
 
 template <typename T>
 inline std::map< size_t, iris::Camera<T> >& CameraSet<T>::cameras()
 {
+    m_camerasShared = true;
     return m_cameras;
 }
 
@@ -201,16 +339,18 @@ template <typename T>
 inline bool CameraSet<T>::hasCamera( const size_t id ) const
 {
     // find the camera
-    std::map< size_t, Camera_d >::const_iterator camIt = m_cameras.find( id );
+    typename std::map< size_t, Camera<T> >::const_iterator camIt = m_cameras.find( id );
     return camIt != m_cameras.end();
 }
 
 
 template <typename T>
-inline Camera_d& CameraSet<T>::camera( const size_t id )
+inline Camera<T>& CameraSet<T>::camera( const size_t id )
 {
+    m_camerasShared = true;
+
     // find the camera
-    std::map< size_t, Camera_d >::iterator camIt = m_cameras.find( id );
+    typename std::map< size_t, Camera<T> >::iterator camIt = m_cameras.find( id );
 
     // search for the camera
     if( camIt != m_cameras.end() )
@@ -221,10 +361,10 @@ inline Camera_d& CameraSet<T>::camera( const size_t id )
 
 
 template <typename T>
-inline const Camera_d& CameraSet<T>::camera( const size_t id ) const
+inline const Camera<T>& CameraSet<T>::camera( const size_t id ) const
 {
     // find the camera
-    std::map< size_t, Camera_d >::const_iterator camIt = m_cameras.find( id );
+    typename std::map< size_t, Camera<T> >::const_iterator camIt = m_cameras.find( id );
 
     // search for the camera
     if( camIt != m_cameras.end() )
@@ -237,203 +377,585 @@ inline const Camera_d& CameraSet<T>::camera( const size_t id ) const
 template <typename T>
 inline bool CameraSet<T>::hasPose( const size_t id ) const
 {
-    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
-        for( size_t p=0; p<camIt->second.poses.size(); p++ )
-            if( camIt->second.poses[p].id == id )
-                return true;
-
-    // nothing found
-    return false;
+    return findPose( id ) != 0;
 }
 
 
 template <typename T>
 inline bool CameraSet<T>::hasPose( const std::string& name ) const
 {
-    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
-        for( size_t p=0; p<camIt->second.poses.size(); p++ )
-            if( camIt->second.poses[p].name.compare( name ) == 0 )
-                return true;
+    return findPose( name ) != 0;
+}
+
 
-    // nothing found
-    return false;
+template <typename T>
+inline Pose<T>& CameraSet<T>::pose( const size_t id )
+{
+    const Pose<T>* result = findPose( id );
+    if( result == 0 )
+        throw std::runtime_error("CameraSet::pose: pose not found.");
+    return const_cast< Pose<T>& >( *result );
 }
 
 
 template <typename T>
-inline const Pose_d& CameraSet<T>::pose( const size_t id ) const
+inline const Pose<T>& CameraSet<T>::pose( const size_t id ) const
 {
-    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
-        for( size_t p=0; p<camIt->second.poses.size(); p++ )
-            if( camIt->second.poses[p].id == id )
-                return camIt->second.poses[p];
+    const Pose<T>* result = findPose( id );
+    if( result == 0 )
+        throw std::runtime_error("CameraSet::pose: pose not found.");
+    return *result;
+}
+
 
-    // nothing found
-    throw std::runtime_error("CameraSet::pose: pose not found.");
+template <typename T>
+inline const Pose<T>& CameraSet<T>::pose( const std::string& name ) const
+{
+    const Pose<T>* result = findPose( name );
+    if( result == 0 )
+        throw std::runtime_error("CameraSet::pose: pose \"" + name + "\" not found.");
+    return *result;
+}
+
+
+template <typename T>
+inline size_t CameraSet<T>::poseCount() const
+{
+    // the poses may have been changed through the cameras
+    if( m_camerasShared )
+        return countPoses();
+    return m_poseTotal;
 }
 
 
 template <typename T>
-inline const Pose_d& CameraSet<T>::pose( const std::string& name ) const
+inline std::vector< std::shared_ptr< const Pattern<T> > > CameraSet<T>::patterns() const
 {
+    std::vector< std::shared_ptr< const Pattern<T> > > result;
+    std::set< const Pattern<T>* > seen;
     for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
         for( size_t p=0; p<camIt->second.poses.size(); p++ )
-            if( camIt->second.poses[p].name.compare( name ) == 0 )
-                return camIt->second.poses[p];
+            if( camIt->second.poses[p].pattern && seen.insert( camIt->second.poses[p].pattern.get() ).second )
+                result.push_back( camIt->second.poses[p].pattern );
 
-    // nothing found
-    throw std::runtime_error("CameraSet::pose: pose \"" + name + "\" not found.");
+    return result;
 }
 
 
 template <typename T>
-inline size_t CameraSet<T>::poseCount()
+inline const UndistortionMap& CameraSet<T>::undistortionMap( const size_t id )
 {
-    // count all poses over all cameras
-    size_t pc = 0;
-    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
-        pc += camIt->second.poses.size();
-    return pc;
+    auto it = m_cameras.find( id );
+    if( it == m_cameras.end() )
+        throw std::runtime_error("CameraSet::undistortionMap: camera not found.");
+
+    UndistortionMap& map = m_undistortionMaps[id];
+    map.update( it->second );
+    return map;
 }
 
 
 template <typename T>
 inline void CameraSet<T>::save( const std::string& filename, bool undistort )
 {
-    // init stuff
-    tinyxml2::XMLDocument doc;
-    progress<size_t> pb( "CameraSet::save: saving poses ", poseCount() );
-    pb.update();
+    // pick the format by extension
+    size_t dot = filename.find_last_of( '.' );
+    if( dot != std::string::npos && filename.substr( dot ) == ".iris" )
+        CameraSetFile::save( filename, m_cameras );
+    else if( dot != std::string::npos && filename.substr( dot ) == ".irisj" )
+        m_journal.append( filename, m_cameras );
+    else
+        saveXML( filename );
+
+    if( undistort )
+        exportUndistorted( filename );
+}
+
+
+template <typename T>
+inline void CameraSet<T>::compact()
+{
+    m_journal.compact( m_cameras );
+}
+
+
+template <typename T>
+inline const CameraSetJournal& CameraSet<T>::journal() const
+{
+    return m_journal;
+}
+
+
+template <typename T>
+inline void CameraSet<T>::setImageFormat( ImageFormat val )
+{
+    m_imageFormat = val;
+}
+
+
+template <typename T>
+inline void CameraSet<T>::setPngCompression( int val )
+{
+    if( val < 0 || val > 9 )
+        throw std::runtime_error( "CameraSet::setPngCompression: level has to be within 0 and 9." );
 
-    // add root
-    tinyxml2::XMLNode* root = doc.InsertEndChild( doc.NewElement( "CameraCalibration" ) );
+    m_pngCompression = val;
+}
+
+
+template <typename T>
+inline void CameraSet<T>::setExportMemory( size_t bytes )
+{
+    m_exportMemory = bytes;
+}
+
+
+template <typename T>
+inline void CameraSet<T>::setProgressSink( std::shared_ptr<Progress::Sink> sink )
+{
+    m_progressSink = sink;
+}
+
+
+template <typename T>
+inline const typename CameraSet<T>::ExportReport& CameraSet<T>::exportReport() const
+{
+    return m_exportReport;
+}
+
+
+template <typename T>
+inline void CameraSet<T>::load( const std::string& filename )
+{
+    if( CameraSetFile::isCameraSetFile( filename ) )
+        loadBinary( filename );
+    else if( CameraSetJournal::isJournal( filename ) )
+    {
+        m_journal.load( filename, m_cameras );
+        m_poseCount = std::max( m_poseCount, m_journal.nextPoseId() );
+    }
+    else
+        loadXML( filename );
+    m_poseTotal = countPoses();
+
+    std::lock_guard<std::mutex> lock( m_indexMutex );
+    rebuildIndex();
+}
+
+
+template <typename T>
+inline void CameraSet<T>::saveXML( const std::string& filename )
+{
+    // init stuff
+    FILE* file = std::fopen( filename.c_str(), "w" );
+    if( file == 0 )
+        throw std::runtime_error( "CameraSet::save: could not open \"" + filename + "\"." );
+    tinyxml2::XMLPrinter printer( file );
+    std::string text;
+    Progress progress( m_progressSink );
+    progress.begin( "CameraSet::save: saving poses ", poseCount() );
+
+    // elements are written as soon as they are complete
+    printer.OpenElement( "CameraCalibration" );
+
+    // the patterns go first, poses refer to them by index
+    std::vector< std::shared_ptr< const Pattern<T> > > patternList = patterns();
+    std::map< const Pattern<T>*, size_t > patternIds;
+    if( patternList.size() > 0 )
+    {
+        printer.OpenElement( "Patterns" );
+        for( size_t i=0; i<patternList.size(); i++ )
+        {
+            patternIds[ patternList[i].get() ] = i;
+            printer.OpenElement( "Pattern" );
+            pushTextElement( printer, text, "Id", i );
+            pushTextElement( printer, text, "Points", patternList[i]->points );
+            printer.CloseElement();
+        }
+        printer.CloseElement();
+    }
 
-    // run over the camers
-    tinyxml2::XMLNode* cameras = root->InsertEndChild( doc.NewElement( "Cameras" ) );
+    printer.OpenElement( "Cameras" );
     for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
     {
-        // init camera
-        tinyxml2::XMLNode* camera = cameras->InsertEndChild( doc.NewElement( "Camera" ) );
+        const Camera<T>& cam = camIt->second;
+        printer.OpenElement( "Camera" );
 
         // add camera properties
-        appendTextElement( doc, *camera, std::string("Id"), toString(camIt->second.id) );
-        appendTextElement( doc, *camera, std::string("ImageSize"), toString( camIt->second.imageSize ) );
-        appendTextElement( doc, *camera, std::string("Intrinsic"), toString( camIt->second.intrinsic ) );
-        appendTextElement( doc, *camera, std::string("Distortion"), toString( camIt->second.distortion ) );
-        appendTextElement( doc, *camera, std::string("Error"), toString( camIt->second.error ) );
+        pushTextElement( printer, text, "Id", cam.id );
+        pushTextElement( printer, text, "ImageSize", cam.imageSize );
+        pushTextElement( printer, text, "Intrinsic", cam.intrinsic );
+        pushTextElement( printer, text, "Distortion", cam.distortion );
+        pushTextElement( printer, text, "Error", cam.error );
 
         // run over all its poses and add them
-        tinyxml2::XMLNode* poses = camera->InsertEndChild( doc.NewElement( "Poses" ) );
-        for( size_t p=0; p<camIt->second.poses.size(); p++ )
+        printer.OpenElement( "Poses" );
+        for( size_t p=0; p<cam.poses.size(); p++ )
         {
-            // add the pose
-            tinyxml2::XMLNode* pose = poses->InsertEndChild( doc.NewElement( "Pose" ) );
+            const Pose<T>& pose = cam.poses[p];
+            printer.OpenElement( "Pose" );
 
             // pose identification
-            appendTextElement( doc, *pose, std::string("Id"), toString(camIt->second.poses[p].id) );
-            appendTextElement( doc, *pose, std::string("Name"), camIt->second.poses[p].name );
+            pushTextElement( printer, text, "Id", pose.id );
+            pushTextElement( printer, "Name", pose.name );
 
             // if not rejected, also add the rest
-            if( !camIt->second.poses[p].rejected )
+            if( !pose.rejected )
             {
-                appendTextElement( doc, *pose, std::string("Points2D"), toString( camIt->second.poses[p].points2D ) );
-                appendTextElement( doc, *pose, std::string("Points3D"), toString( camIt->second.poses[p].points3D ) );
-                appendTextElement( doc, *pose, std::string("PointIndices"), toString( camIt->second.poses[p].pointIndices ) );
-                appendTextElement( doc, *pose, std::string("Transformation"), toString( camIt->second.poses[p].transformation ) );
-                appendTextElement( doc, *pose, std::string("ProjectedPoints"), toString( camIt->second.poses[p].projected2D ) );
-
-                // check if should undistort
-                if( undistort )
+                pushTextElement( printer, text, "Points2D", pose.correspondences );
+                if( pose.pattern )
                 {
-                    // get the pose
-                    cimg_library::CImg<uint8_t> undistorted;
-                    iris::undistort( camIt->second, camIt->second.poses[p], undistorted );
-
-                    // assemble filename
-                    std::string imageFileName = filename.substr( 0, filename.find_last_of('.') ) + "-";
-                    imageFileName += camIt->second.poses[p].name.substr( 0, camIt->second.poses[p].name.find_last_of('.') ) + "-undistorted.png";
-                    undistorted.save_png( imageFileName.c_str() );
+                    // Points3D keeps the file readable for loaders without Patterns
+                    pushTextElement( printer, text, "Pattern", patternIds[ pose.pattern.get() ] );
+                    pushTextElement( printer, text, "Points3D", pose.points3D() );
                 }
+                pushTextElement( printer, text, "PointIndices", pose.correspondences.indices() );
+
+                // weights only when some differ from one, loaders default to one
+                if( ( pose.correspondences.weights().array() != T(1) ).any() )
+                {
+                    std::vector<T> weights( pose.correspondences.weights().data(), pose.correspondences.weights().data() + pose.correspondences.size() );
+                    pushTextElement( printer, text, "Weights", weights );
+                }
+                pushTextElement( printer, text, "Transformation", pose.transformation );
+                pushTextElement( printer, text, "ProjectedPoints", pose.projected2D );
             }
 
+            printer.CloseElement();
+
             // update progress bar
-            pb.next_step();
+            progress.step();
         }
+        printer.CloseElement();
+        printer.CloseElement();
     }
+    printer.CloseElement();
+    printer.CloseElement();
 
     // wrap up
-    doc.SaveFile( filename.c_str() );
-    pb.finish();
+    bool failed = std::ferror( file ) != 0;
+    failed = std::fclose( file ) != 0 || failed;
+    if( failed )
+        throw std::runtime_error( "CameraSet::save: could not write \"" + filename + "\"." );
+    progress.finish();
 }
 
 
 template <typename T>
-inline void CameraSet<T>::load( const std::string& filename )
+inline void CameraSet<T>::exportUndistorted( const std::string& filename )
+{
+    typedef std::chrono::steady_clock clock;
+    clock::time_point start = clock::now();
+    m_exportReport = ExportReport();
+
+    // collect the poses with images
+    std::vector< std::pair< size_t, const Pose<T>* > > undistortPoses;
+    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
+        for( size_t p=0; p<camIt->second.poses.size(); p++ )
+            if( !camIt->second.poses[p].rejected && camIt->second.poses[p].image )
+                undistortPoses.push_back( std::make_pair( camIt->first, &camIt->second.poses[p] ) );
+
+    if( undistortPoses.size() == 0 )
+        return;
+
+    // build the maps once per camera and check the images before going parallel
+    std::map< size_t, const UndistortionMap* > maps;
+    size_t imageBytes = 0;
+    for( size_t i=0; i<undistortPoses.size(); i++ )
+    {
+        if( maps.count( undistortPoses[i].first ) == 0 )
+            maps[ undistortPoses[i].first ] = &undistortionMap( undistortPoses[i].first );
+
+        const Camera<T>& cam = m_cameras[ undistortPoses[i].first ];
+        const cimg_library::CImg<uint8_t>& image = *undistortPoses[i].second->image;
+        if( image.width() != cam.imageSize(0) || image.height() != cam.imageSize(1) || image.spectrum() > 4 )
+            throw std::runtime_error( "CameraSet::save: image of pose \"" + undistortPoses[i].second->name + "\" does not match its camera." );
+        imageBytes = std::max( imageBytes, static_cast<size_t>( image.size() ) );
+    }
+    m_exportReport.mapTime = std::chrono::duration<double>( clock::now() - start ).count();
+
+    // every worker holds the converted, the undistorted and the encoded image
+    size_t workers = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+    workers = std::min( workers, std::max<size_t>( 1, m_exportMemory / ( 3*imageBytes ) ) );
+    workers = std::min( workers, undistortPoses.size() );
+    m_exportReport.workers = workers;
+
+    // encoder settings
+    std::string extension = ( m_imageFormat == BMP ) ? ".bmp" : ".png";
+    std::vector<int> params;
+    if( m_imageFormat == PNG )
+    {
+        params.push_back( CV_IMWRITE_PNG_COMPRESSION );
+        params.push_back( m_pngCompression );
+    }
+
+    // remap and encode concurrently
+    size_t failed = 0;
+    Progress progress( m_progressSink );
+    progress.begin( "CameraSet::save: undistorting images ", undistortPoses.size() );
+    #pragma omp parallel for schedule(dynamic) num_threads( static_cast<int>( workers ) )
+    for( int i=0; i<static_cast<int>(undistortPoses.size()); i++ )
+    {
+        const Pose<T>& pose = *undistortPoses[i].second;
+        clock::time_point t0 = clock::now();
+
+        // convert, OpenCV expects BGR
+        cv::Mat image, undistorted;
+        cimg2cv( *pose.image, image );
+        if( image.channels() == 3 )
+            cv::cvtColor( image, image, CV_RGB2BGR );
+        clock::time_point t1 = clock::now();
+
+        // undistort
+        maps.find( undistortPoses[i].first )->second->remap( image, undistorted );
+        image.release();
+        clock::time_point t2 = clock::now();
+
+        // assemble filename and save
+        std::string imageFileName = filename.substr( 0, filename.find_last_of('.') ) + "-";
+        imageFileName += pose.name.substr( 0, pose.name.find_last_of('.') ) + "-undistorted" + extension;
+        bool written = cv::imwrite( imageFileName, undistorted, params );
+        clock::time_point t3 = clock::now();
+
+        #pragma omp critical
+        {
+            m_exportReport.convertTime += std::chrono::duration<double>( t1 - t0 ).count();
+            m_exportReport.remapTime += std::chrono::duration<double>( t2 - t1 ).count();
+            m_exportReport.encodeTime += std::chrono::duration<double>( t3 - t2 ).count();
+            m_exportReport.images += written ? 1 : 0;
+            failed += written ? 0 : 1;
+        }
+        progress.step();
+    }
+    progress.finish();
+
+    if( failed > 0 )
+        throw std::runtime_error( "CameraSet::save: could not write " + toString( failed ) + " undistorted images." );
+
+    m_exportReport.totalTime = std::chrono::duration<double>( clock::now() - start ).count();
+}
+
+
+template <typename T>
+inline void CameraSet<T>::loadXML( const std::string& filename )
 {
-    // load the document
-    tinyxml2::XMLDocument doc;
-    int loadStatus = doc.LoadFile( filename.c_str() );
-    if( tinyxml2::XML_SUCCESS != loadStatus )
-        throw std::runtime_error( "CameraSet::load: " + std::string( doc.GetErrorStr1() ) );
+    // the document is pulled element by element, only one pose is held as text
+    XMLReader reader( filename );
 
     // get the root
-    tinyxml2::XMLNode* root = doc.FirstChildElement( "CameraCalibration" );
-    if( root == 0 )
+    if( reader.next() != XMLReader::StartElement || reader.name() != "CameraCalibration" )
         throw std::runtime_error( "CameraSet::load: root node not found." );
 
-    // get the cameras
-    tinyxml2::XMLNode* cameras = root->FirstChildElement( "Cameras" );
-    if( cameras == 0 )
-        throw std::runtime_error( "CameraSet::load: no cameras." );
+    // pattern references are resolved at the end, in case the patterns follow
+    std::map< size_t, std::shared_ptr< const Pattern<T> > > patterns;
+    std::vector< std::pair< Pose<T>*, size_t > > patternRefs;
+    std::vector< Pose<T>* > legacyPoses;
 
-    // run over all the cameras
+    // run over the patterns and cameras
+    bool hasCameras = false;
     m_cameras.clear();
-    for( tinyxml2::XMLNode* camPtr=cameras->FirstChildElement( "Camera" ); camPtr != 0; camPtr = camPtr->NextSiblingElement( "Camera" ) )
+    while( reader.nextChild() )
     {
-        Camera<T> camera;
+        if( reader.name() == "Patterns" )
+        {
+            while( reader.nextChild() )
+            {
+                if( reader.name() != "Pattern" )
+                {
+                    reader.skipElement();
+                    continue;
+                }
 
-        // get camera parameters
-        str2scalar( getElementValue( camPtr, "Id" ), camera.id );
-        str2eigen( getElementValue( camPtr, "ImageSize" ), camera.imageSize );
-        str2eigen( getElementValue( camPtr, "Intrinsic" ), camera.intrinsic );
-        str2vector( getElementValue( camPtr, "Distortion" ), camera.distortion );
+                size_t id = 0;
+                std::shared_ptr< Pattern<T> > pattern( new Pattern<T>() );
+                while( reader.nextChild() )
+                {
+                    if( reader.name() == "Id" )
+                        str2scalar( reader.readText(), id );
+                    else if( reader.name() == "Points" )
+                        str2eigenVector( reader.readText(), pattern->points );
+                    else
+                        reader.skipElement();
+                }
+                patterns[ id ] = pattern;
+            }
+            continue;
+        }
+        else if( reader.name() != "Cameras" )
+        {
+            reader.skipElement();
+            continue;
+        }
+        hasCameras = true;
 
-        // read the poses
-        tinyxml2::XMLNode* poses = camPtr->FirstChildElement( "Poses" );
-        if( poses != 0 )
+        while( reader.nextChild() )
         {
-            for( tinyxml2::XMLNode* posePtr=poses->FirstChildElement( "Pose" ); posePtr != 0; posePtr = posePtr->NextSiblingElement( "Pose" ) )
+            if( reader.name() != "Camera" )
+            {
+                reader.skipElement();
+                continue;
+            }
+
+            // get camera parameters, pattern references by pose index
+            Camera<T> camera;
+            std::vector< std::pair< size_t, size_t > > cameraRefs;
+            std::vector< size_t > cameraLegacy;
+            while( reader.nextChild() )
             {
-                Pose<T> pose;
-
-                // get the pose attributes
-                str2scalar( getElementValue( posePtr, "Id" ), pose.id );
-                pose.name = getElementValue( posePtr, "Name" );
-                str2eigenVector( getElementValue( posePtr, "Points2D" ), pose.points2D );
-                str2eigenVector( getElementValue( posePtr, "Points3D" ), pose.points3D );
-                str2vector( getElementValue( posePtr, "PointIndices" ), pose.pointIndices );
-                str2eigen( getElementValue( posePtr, "Transformation" ), pose.transformation );
-                str2eigenVector( getElementValue( posePtr, "ProjectedPoints" ), pose.projected2D );
-
-                pose.rejected = pose.pointIndices.size() == 0;
-
-                if( !pose.rejected &&
-                    ( pose.points2D.size() != pose.pointIndices.size() ||
-                      pose.points2D.size() != pose.points3D.size() ) )
+                if( reader.name() == "Id" )
+                    str2scalar( reader.readText(), camera.id );
+                else if( reader.name() == "ImageSize" )
+                    str2eigen( reader.readText(), camera.imageSize );
+                else if( reader.name() == "Intrinsic" )
+                    str2eigen( reader.readText(), camera.intrinsic );
+                else if( reader.name() == "Distortion" )
+                    str2vector( reader.readText(), camera.distortion );
+                else if( reader.name() == "Error" )
+                    str2scalar( reader.readText(), camera.error );
+                else if( reader.name() == "Poses" )
                 {
-                    pose.rejected = false;
-                    std::cerr << "CameraSet::load: point arrays' sizes do not match:";
-                    std::cerr << " Points3D=" << pose.points2D.size();
-                    std::cerr << ", Points3D=" << pose.points3D.size();
-                    std::cerr << ", PointIndices=" << pose.pointIndices.size() << "." << std::endl;
+                    // read the poses
+                    while( reader.nextChild() )
+                    {
+                        if( reader.name() != "Pose" )
+                        {
+                            reader.skipElement();
+                            continue;
+                        }
+
+                        // fill the pose in place
+                        camera.poses.emplace_back();
+                        Pose<T>& pose = camera.poses.back();
+                        std::vector< Eigen::Matrix<T,2,1> > points2D;
+                        std::vector< Eigen::Matrix<T,3,1> > points3D;
+                        std::vector<size_t> pointIndices;
+                        std::vector<T> weights;
+                        bool hasPattern = false;
+
+                        // get the pose attributes
+                        while( reader.nextChild() )
+                        {
+                            if( reader.name() == "Id" )
+                                str2scalar( reader.readText(), pose.id );
+                            else if( reader.name() == "Name" )
+                                pose.name = reader.readText();
+                            else if( reader.name() == "Points2D" )
+                                str2eigenVector( reader.readText(), points2D );
+                            else if( reader.name() == "Pattern" )
+                            {
+                                size_t patternId = 0;
+                                str2scalar( reader.readText(), patternId );
+                                cameraRefs.push_back( std::make_pair( camera.poses.size()-1, patternId ) );
+                                hasPattern = true;
+                            }
+                            else if( reader.name() == "Points3D" )
+                                str2eigenVector( reader.readText(), points3D );
+                            else if( reader.name() == "PointIndices" )
+                                str2vector( reader.readText(), pointIndices );
+                            else if( reader.name() == "Weights" )
+                                str2vector( reader.readText(), weights );
+                            else if( reader.name() == "Transformation" )
+                                str2eigen( reader.readText(), pose.transformation );
+                            else if( reader.name() == "ProjectedPoints" )
+                                str2points( reader.readText(), pose.projected2D );
+                            else
+                                reader.skipElement();
+                        }
+
+                        pose.correspondences.assign( points2D, pointIndices );
+                        pose.rejected = pointIndices.size() == 0;
+                        if( weights.size() == pose.correspondences.size() )
+                        {
+                            for( size_t i=0; i<weights.size(); i++ )
+                                pose.correspondences.setWeight( i, weights[i] );
+                        }
+                        else if( weights.size() > 0 )
+                            std::cerr << "CameraSet::load: " << weights.size() << " weights for " << pose.correspondences.size() << " points, ignored." << std::endl;
+
+                        // older files only store the 3D points per pose
+                        if( points3D.size() > 0 && !hasPattern )
+                        {
+                            pose.pattern = pattern_from_points( pointIndices, points3D );
+                            cameraLegacy.push_back( camera.poses.size()-1 );
+                        }
+
+                        if( !pose.rejected &&
+                            ( points2D.size() != pointIndices.size() ||
+                              ( points3D.size() > 0 && points2D.size() != points3D.size() ) ) )
+                        {
+                            pose.rejected = false;
+                            std::cerr << "CameraSet::load: point arrays' sizes do not match:";
+                            std::cerr << " Points2D=" << points2D.size();
+                            std::cerr << ", Points3D=" << points3D.size();
+                            std::cerr << ", PointIndices=" << pointIndices.size() << "." << std::endl;
+                        }
+
+                        // new poses must not reuse loaded ids
+                        m_poseCount = std::max( m_poseCount, pose.id + 1 );
+                    }
                 }
-
-                camera.poses.push_back( pose );
+                else
+                    reader.skipElement();
             }
+
+            Camera<T>& cam = m_cameras[ camera.id ];
+            cam = std::move( camera );
+            for( size_t i=0; i<cameraRefs.size(); i++ )
+                patternRefs.push_back( std::make_pair( &cam.poses[ cameraRefs[i].first ], cameraRefs[i].second ) );
+            for( size_t i=0; i<cameraLegacy.size(); i++ )
+                legacyPoses.push_back( &cam.poses[ cameraLegacy[i] ] );
         }
+    }
 
-        m_cameras[ camera.id ] = camera;
+    if( !hasCameras )
+        throw std::runtime_error( "CameraSet::load: no cameras." );
+
+    // resolve the pattern references
+    for( size_t i=0; i<patternRefs.size(); i++ )
+    {
+        auto it = patterns.find( patternRefs[i].second );
+        if( it == patterns.end() )
+            throw std::runtime_error( "CameraSet::load: pattern " + toString( patternRefs[i].second ) + " not found." );
+        patternRefs[i].first->pattern = it->second;
+    }
+
+    // poses of older files share their points where they agree
+    share_patterns( legacyPoses );
+}
+
+
+template <typename T>
+inline void CameraSet<T>::loadBinary( const std::string& filename )
+{
+    CameraSetFile file( filename );
+
+    // cameras first, their pose vectors are sized up front
+    m_cameras.clear();
+    std::vector< Pose<T>* > poses( file.poseCount(), 0 );
+    for( size_t c=0; c<file.cameraCount(); c++ )
+    {
+        Camera<T> camera;
+        file.camera( c, camera );
+        camera.poses.resize( file.cameraPoseCount( c ) );
+
+        Camera<T>& cam = m_cameras[ camera.id ];
+        cam = std::move( camera );
+        for( size_t p=0; p<cam.poses.size(); p++ )
+            poses[ file.cameraPoseBegin( c ) + p ] = &cam.poses[p];
     }
+
+    // poses in the file that belong to no camera are ignored
+    for( size_t p=0; p<poses.size(); p++ )
+        if( poses[p] != 0 )
+            m_poseCount = std::max( m_poseCount, file.poseId( p ) + 1 );
+
+    // decode the patterns once, then the poses, the file was validated when opened
+    std::vector< std::shared_ptr< const Pattern<T> > > patterns;
+    file.patterns( patterns );
+    #pragma omp parallel for schedule(dynamic, 64)
+    for( int p=0; p<static_cast<int>( poses.size() ); p++ )
+        if( poses[p] != 0 )
+            file.pose( p, *poses[p], patterns );
 }
 
 
@@ -442,33 +964,203 @@ inline void CameraSet<T>::operator =( const CameraSet& cam )
 {
     m_poseCount = cam.m_poseCount;
     m_cameras = cam.m_cameras;
+    m_poseTotal = countPoses();
+    m_imageFormat = cam.m_imageFormat;
+    m_pngCompression = cam.m_pngCompression;
+    m_exportMemory = cam.m_exportMemory;
+    m_progressSink = cam.m_progressSink;
+
+    // the handles are the same for the copied cameras
+    if( &cam == this )
+        return;
+    std::lock( m_indexMutex, cam.m_indexMutex );
+    std::lock_guard<std::mutex> lock( m_indexMutex, std::adopt_lock );
+    std::lock_guard<std::mutex> lockOther( cam.m_indexMutex, std::adopt_lock );
+    m_idIndex = cam.m_idIndex;
+    m_nameIndex = cam.m_nameIndex;
+    m_indexedPoses = cam.m_indexedPoses;
 }
 
 
 template <typename T>
-inline void CameraSet<T>::appendTextElement( tinyxml2::XMLDocument& doc,
-                                             tinyxml2::XMLNode& node,
-                                             std::string name,
-                                             std::string val )
+template <typename S>
+inline void CameraSet<T>::assign( const CameraSet<S>& cs )
 {
-    tinyxml2::XMLNode* tmp = node.InsertEndChild( doc.NewElement( name.c_str() ) );
-    tmp->InsertEndChild( doc.NewText( val.c_str() ));
+    // convert the cameras, shared patterns stay shared
+    std::map< const Pattern<S>*, std::shared_ptr< const Pattern<T> > > patterns;
+    m_cameras.clear();
+    for( auto it = cs.m_cameras.begin(); it != cs.m_cameras.end(); it++ )
+        m_cameras[ it->first ] = cast_camera<T>( it->second, patterns );
+
+    m_poseCount = cs.m_poseCount;
+    m_poseTotal = countPoses();
+    m_undistortionMaps.clear();
+    m_imageFormat = static_cast<ImageFormat>( cs.m_imageFormat );
+    m_pngCompression = cs.m_pngCompression;
+    m_exportMemory = cs.m_exportMemory;
+    m_progressSink = cs.m_progressSink;
+
+    std::lock_guard<std::mutex> lock( m_indexMutex );
+    rebuildIndex();
+}
+
+
+template <typename T>
+inline void CameraSet<T>::pushTextElement( tinyxml2::XMLPrinter& printer, const char* name, const std::string& val )
+{
+    printer.OpenElement( name );
+    printer.PushText( val.c_str() );
+    printer.CloseElement();
+}
+
+
+template <typename T>
+template <typename V>
+inline void CameraSet<T>::pushTextElement( tinyxml2::XMLPrinter& printer, std::string& buffer, const char* name, const V& val )
+{
+    buffer.clear();
+    appendString( buffer, val );
+    pushTextElement( printer, name, buffer );
+}
+
+
+template <typename T>
+inline const Pose<T>* CameraSet<T>::findPose( const size_t id ) const
+{
+    std::lock_guard<std::mutex> lock( m_indexMutex );
+    return indexedPose( id );
+}
+
+
+template <typename T>
+inline const Pose<T>* CameraSet<T>::findPose( const std::string& name ) const
+{
+    std::lock_guard<std::mutex> lock( m_indexMutex );
+    return indexedPose( name );
+}
+
+
+template <typename T>
+inline const Pose<T>* CameraSet<T>::indexedPose( const size_t id ) const
+{
+    for( size_t pass=0; pass<2; pass++ )
+    {
+        // a handle is only trusted if its pose has the id
+        auto it = m_idIndex.find( id );
+        if( it != m_idIndex.end() )
+        {
+            auto camIt = m_cameras.find( it->second.first );
+            if( camIt != m_cameras.end() && it->second.second < camIt->second.poses.size() &&
+                camIt->second.poses[ it->second.second ].id == id )
+                return &camIt->second.poses[ it->second.second ];
+        }
+        else if( m_indexedPoses == poseCount() )
+            return 0;
+
+        // the cameras were changed directly
+        rebuildIndex();
+    }
+
+    return 0;
 }
 
 
 template <typename T>
-inline std::string CameraSet<T>::getElementValue( tinyxml2::XMLNode* node, std::string name )
+inline const Pose<T>* CameraSet<T>::indexedPose( const std::string& name ) const
 {
-    tinyxml2::XMLNode* childTag = node->FirstChildElement( name.c_str() );
-    if( childTag != 0 )
+    // names resolve to their first occurrence, the lowest id
+    for( size_t pass=0; pass<2; pass++ )
     {
-        tinyxml2::XMLNode* childText = childTag->FirstChild();
-        if( childText != 0 )
-            return std::string( childText->Value() );
+        // resolving may rebuild the index, so the ids are taken out first
+        std::vector<size_t> ids;
+        auto range = m_nameIndex.equal_range( name );
+        for( auto it=range.first; it != range.second; it++ )
+            ids.push_back( it->second );
+
+        const Pose<T>* result = 0;
+        bool stale = false;
+        for( size_t i=0; i<ids.size(); i++ )
+        {
+            const Pose<T>* pose = indexedPose( ids[i] );
+            if( pose == 0 || pose->name != name )
+                stale = true;
+            else if( result == 0 || pose->id < result->id )
+                result = pose;
+        }
+
+        // stale entries, or poses added directly to the cameras
+        if( !stale && ( result != 0 || m_indexedPoses == poseCount() ) )
+            return result;
+        rebuildIndex();
+    }
+
+    return 0;
+}
+
+
+template <typename T>
+inline bool CameraSet<T>::erasePose( const size_t id )
+{
+    const Pose<T>* pose = indexedPose( id );
+    if( pose == 0 )
+        return false;
+
+    // forget the pose
+    PoseHandle handle = m_idIndex[ id ];
+    auto range = m_nameIndex.equal_range( pose->name );
+    for( auto it=range.first; it != range.second; it++ )
+    {
+        if( it->second == id )
+        {
+            m_nameIndex.erase( it );
+            break;
+        }
+    }
+    m_idIndex.erase( id );
+    m_indexedPoses--;
+    m_poseTotal--;
+
+    // remove it, only the following poses of its camera move
+    std::vector< Pose<T> >& poses = m_cameras.find( handle.first )->second.poses;
+    poses.erase( poses.begin() + handle.second );
+    for( size_t p=handle.second; p<poses.size(); p++ )
+    {
+        auto it = m_idIndex.find( poses[p].id );
+        if( it != m_idIndex.end() && it->second == PoseHandle( handle.first, p+1 ) )
+            it->second.second = p;
     }
-        return std::string();
+
+    return true;
 }
 
 
+template <typename T>
+inline size_t CameraSet<T>::countPoses() const
+{
+    size_t count = 0;
+    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
+        count += camIt->second.poses.size();
+    return count;
+}
+
+
+template <typename T>
+inline void CameraSet<T>::rebuildIndex() const
+{
+    // index all poses, duplicate ids resolve to the first
+    m_idIndex.clear();
+    m_nameIndex.clear();
+    m_indexedPoses = 0;
+    for( auto camIt=m_cameras.begin(); camIt != m_cameras.end(); camIt++ )
+    {
+        for( size_t p=0; p<camIt->second.poses.size(); p++ )
+        {
+            if( m_idIndex.insert( std::make_pair( camIt->second.poses[p].id, PoseHandle( camIt->first, p ) ) ).second )
+                m_nameIndex.insert( std::make_pair( camIt->second.poses[p].name, camIt->second.poses[p].id ) );
+            m_indexedPoses++;
+        }
+    }
+}
+
 
 } // end namespace iris
@@ -0,0 +1,757 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * CameraSetFile.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#ifdef _WIN32
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class CameraSetFile
+{
+///
+/// \file    CameraSetFile.hpp
+/// \class   CameraSetFile
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Binary, memory-mapped container for camera sets
+///
+/// \details Layout (all fields 8 bytes wide, native byte order checked on
+///          open):
+///            Header                  magic, version, counts, table offsets
+///            CameraRecord[cameras]   parameters and range in the pose table
+///            PatternRecord[patterns] block of the pattern's 3D points
+///            PoseRecord[poses]       id, transformation, pattern, block
+///                                    offsets
+///            data                    names, distortion coefficients, the
+///                                    pattern points and the points2D/
+///                                    pointIndices/weights/projected2D
+///                                    blocks of every pose
+///          Scalars are stored as float64 regardless of the set's type and
+///          indices as uint64. Opening a file maps it and validates all the
+///          tables and point indices, poses are only decoded when
+///          requested, so this class can also be used to inspect large sets
+///          without loading them. Version 1 files have no weights, their
+///          points are read with full weight.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    static const uint32_t Version = 2;
+
+    CameraSetFile();
+    CameraSetFile( const std::string& filename );
+    virtual ~CameraSetFile();
+
+    // map a file, throws if it is not a valid camera set file
+    void open( const std::string& filename );
+    void close();
+    bool isOpen() const;
+
+    // check the magic of a file without mapping it
+    static bool isCameraSetFile( const std::string& filename );
+
+    // table sizes
+    uint32_t version() const;
+    size_t cameraCount() const;
+    size_t patternCount() const;
+    size_t poseCount() const;
+
+    // camera parameters without the poses, and its range in the pose table
+    template <typename T>
+    void camera( const size_t index, Camera<T>& cam ) const;
+    size_t cameraPoseBegin( const size_t index ) const;
+    size_t cameraPoseCount( const size_t index ) const;
+
+    // pose identification without decoding the pose
+    size_t poseId( const size_t index ) const;
+    std::string poseName( const size_t index ) const;
+
+    // decode a pattern, or all of them
+    template <typename T>
+    void pattern( const size_t index, Pattern<T>& pattern ) const;
+    template <typename T>
+    void patterns( std::vector< std::shared_ptr< const Pattern<T> > >& patterns ) const;
+
+    // decode a single pose, referring to the given patterns; without, the
+    // pose's pattern is decoded for it alone
+    template <typename T>
+    void pose( const size_t index, Pose<T>& pose, const std::vector< std::shared_ptr< const Pattern<T> > >& patterns ) const;
+    template <typename T>
+    void pose( const size_t index, Pose<T>& pose ) const;
+
+    // write a set of cameras
+    template <typename T>
+    static void save( const std::string& filename, const std::map< size_t, Camera<T> >& cameras );
+
+protected:
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint64_t cameraCount;
+        uint64_t poseCount;
+        uint64_t cameraOffset;
+        uint64_t poseOffset;
+        uint64_t fileSize;
+        uint64_t patternCount;
+        uint64_t patternOffset;
+        uint64_t poseRecordSize;
+    };
+
+    struct CameraRecord
+    {
+        uint64_t id;
+        int64_t imageSize[2];
+        double sensorSize[2];
+        double intrinsic[9];
+        double error;
+        uint64_t distortionOffset;
+        uint64_t distortionCount;
+        uint64_t poseBegin;
+        uint64_t poseCount;
+    };
+
+    struct PatternRecord
+    {
+        uint64_t pointsOffset;
+        uint64_t pointsCount;
+    };
+
+    struct PoseRecord
+    {
+        uint64_t id;
+        uint64_t rejected;
+        uint64_t pointsMax;
+        double transformation[16];
+        uint64_t nameOffset;
+        uint64_t nameLength;
+        uint64_t points2DOffset;
+        uint64_t points2DCount;
+        uint64_t indicesOffset;
+        uint64_t indicesCount;
+        uint64_t projected2DOffset;
+        uint64_t projected2DCount;
+        // index in the pattern table plus one, zero for none
+        uint64_t pattern;
+        // since version 2, one per point
+        uint64_t weightsOffset;
+        uint64_t weightsCount;
+    };
+
+    // size of a pose record in version 1, before the weights
+    static const uint64_t PoseRecordSizeV1 = 12*sizeof(uint64_t) + 16*sizeof(double);
+
+    static const char* magic();
+    static uint32_t byteOrder();
+
+    // check that a block lies within the mapped file
+    void checkBlock( const uint64_t offset, const uint64_t count, const uint64_t elementSize, const char* what ) const;
+
+    const Header& header() const;
+    const CameraRecord& cameraRecord( const size_t index ) const;
+    const PatternRecord& patternRecord( const size_t index ) const;
+    const PoseRecord& poseRecord( const size_t index ) const;
+
+    template <typename T, int Rows>
+    void readBlock( const uint64_t offset, const uint64_t count, std::vector< Eigen::Matrix<T,Rows,1> >& vec ) const;
+
+    template <typename T>
+    void readBlock( const uint64_t offset, const uint64_t count, Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor>& points ) const;
+
+    template <typename T, int Rows>
+    static void appendBlock( std::vector<char>& data, const std::vector< Eigen::Matrix<T,Rows,1> >& vec, uint64_t& offset, uint64_t& count, const uint64_t base );
+
+    // points as columns, stored interleaved like the vectors
+    template <typename Derived>
+    static void appendBlock( std::vector<char>& data, const Eigen::MatrixBase<Derived>& points, uint64_t& offset, uint64_t& count, const uint64_t base );
+
+private:
+    CameraSetFile( const CameraSetFile& );
+    void operator =( const CameraSetFile& );
+
+protected:
+    const char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    std::vector<char> m_buffer;
+#endif
+};
+
+
+/////
+// Implementation
+///
+
+inline CameraSetFile::CameraSetFile() :
+    m_data(0),
+    m_size(0)
+{
+}
+
+
+inline CameraSetFile::CameraSetFile( const std::string& filename ) :
+    m_data(0),
+    m_size(0)
+{
+    open( filename );
+}
+
+
+inline CameraSetFile::~CameraSetFile()
+{
+    close();
+}
+
+
+inline void CameraSetFile::open( const std::string& filename )
+{
+    close();
+
+#ifdef _WIN32
+    // no mmap, read the whole file instead
+    std::ifstream file( filename.c_str(), std::ios::binary );
+    if( !file )
+        throw std::runtime_error( "CameraSetFile::open: could not open \"" + filename + "\"." );
+    file.seekg( 0, std::ios::end );
+    m_buffer.resize( static_cast<size_t>( file.tellg() ) );
+    file.seekg( 0, std::ios::beg );
+    file.read( m_buffer.data(), m_buffer.size() );
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    int fd = ::open( filename.c_str(), O_RDONLY );
+    if( fd < 0 )
+        throw std::runtime_error( "CameraSetFile::open: could not open \"" + filename + "\"." );
+
+    struct stat info;
+    if( fstat( fd, &info ) != 0 || info.st_size < static_cast<off_t>( sizeof(Header) ) )
+    {
+        ::close( fd );
+        throw std::runtime_error( "CameraSetFile::open: \"" + filename + "\" is too small." );
+    }
+
+    void* data = mmap( 0, static_cast<size_t>( info.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if( data == MAP_FAILED )
+        throw std::runtime_error( "CameraSetFile::open: could not map \"" + filename + "\"." );
+
+    m_data = static_cast<const char*>( data );
+    m_size = static_cast<size_t>( info.st_size );
+#endif
+
+    try
+    {
+        // check the header
+        if( m_size < sizeof(Header) || std::memcmp( header().magic, magic(), 8 ) != 0 )
+            throw std::runtime_error( "CameraSetFile::open: \"" + filename + "\" is not a camera set file." );
+        if( header().byteOrder != byteOrder() )
+            throw std::runtime_error( "CameraSetFile::open: \"" + filename + "\" was written with a different byte order." );
+        if( header().version < 1 || header().version > Version )
+            throw std::runtime_error( "CameraSetFile::open: unsupported version " + toString( header().version ) + "." );
+        if( header().poseRecordSize != ( header().version == 1 ? PoseRecordSizeV1 : sizeof(PoseRecord) ) )
+            throw std::runtime_error( "CameraSetFile::open: \"" + filename + "\" has a malformed header." );
+        if( header().fileSize != m_size )
+            throw std::runtime_error( "CameraSetFile::open: \"" + filename + "\" is truncated." );
+
+        // check the tables
+        checkBlock( header().cameraOffset, header().cameraCount, sizeof(CameraRecord), "camera table" );
+        checkBlock( header().poseOffset, header().poseCount, header().poseRecordSize, "pose table" );
+        checkBlock( header().patternOffset, header().patternCount, sizeof(PatternRecord), "pattern table" );
+        for( size_t p=0; p<patternCount(); p++ )
+            checkBlock( patternRecord( p ).pointsOffset, patternRecord( p ).pointsCount, 3*sizeof(double), "pattern" );
+        for( size_t c=0; c<cameraCount(); c++ )
+        {
+            const CameraRecord& cam = cameraRecord( c );
+            checkBlock( cam.distortionOffset, cam.distortionCount, sizeof(double), "distortion" );
+            if( cam.poseBegin > header().poseCount || cam.poseCount > header().poseCount - cam.poseBegin )
+                throw std::runtime_error( "CameraSetFile::open: pose range of camera " + toString( cam.id ) + " is out of bounds." );
+        }
+        for( size_t p=0; p<poseCount(); p++ )
+        {
+            const PoseRecord& pose = poseRecord( p );
+            checkBlock( pose.nameOffset, pose.nameLength, 1, "pose name" );
+            checkBlock( pose.points2DOffset, pose.points2DCount, 2*sizeof(double), "points2D" );
+            checkBlock( pose.indicesOffset, pose.indicesCount, sizeof(uint64_t), "point indices" );
+            checkBlock( pose.projected2DOffset, pose.projected2DCount, 2*sizeof(double), "projected2D" );
+            if( pose.indicesCount != pose.points2DCount )
+                throw std::runtime_error( "CameraSetFile::open: point indices of pose " + toString( pose.id ) + " do not match its points." );
+            if( header().version > 1 )
+            {
+                checkBlock( pose.weightsOffset, pose.weightsCount, sizeof(double), "weights" );
+                if( pose.weightsCount != pose.points2DCount )
+                    throw std::runtime_error( "CameraSetFile::open: weights of pose " + toString( pose.id ) + " do not match its points." );
+            }
+            if( pose.pattern > patternCount() )
+                throw std::runtime_error( "CameraSetFile::open: pattern of pose " + toString( pose.id ) + " is out of range." );
+
+            // correspondences have to refer to points of their pattern
+            if( pose.pattern > 0 )
+            {
+                const uint64_t points = patternRecord( static_cast<size_t>( pose.pattern ) - 1 ).pointsCount;
+                const uint64_t* indices = reinterpret_cast<const uint64_t*>( m_data + pose.indicesOffset );
+                for( uint64_t i=0; i<pose.indicesCount; i++ )
+                    if( indices[i] >= points )
+                        throw std::runtime_error( "CameraSetFile::open: point index of pose " + toString( pose.id ) + " is out of range." );
+            }
+        }
+    }
+    catch( ... )
+    {
+        close();
+        throw;
+    }
+}
+
+
+inline void CameraSetFile::close()
+{
+#ifdef _WIN32
+    m_buffer.clear();
+#else
+    if( m_data != 0 )
+        munmap( const_cast<char*>( m_data ), m_size );
+#endif
+    m_data = 0;
+    m_size = 0;
+}
+
+
+inline bool CameraSetFile::isOpen() const
+{
+    return m_data != 0;
+}
+
+
+inline bool CameraSetFile::isCameraSetFile( const std::string& filename )
+{
+    char buffer[8];
+    std::ifstream file( filename.c_str(), std::ios::binary );
+    return file.read( buffer, 8 ) && std::memcmp( buffer, magic(), 8 ) == 0;
+}
+
+
+inline uint32_t CameraSetFile::version() const
+{
+    return isOpen() ? header().version : 0;
+}
+
+
+inline size_t CameraSetFile::cameraCount() const
+{
+    return isOpen() ? static_cast<size_t>( header().cameraCount ) : 0;
+}
+
+
+inline size_t CameraSetFile::patternCount() const
+{
+    return isOpen() ? static_cast<size_t>( header().patternCount ) : 0;
+}
+
+
+inline size_t CameraSetFile::poseCount() const
+{
+    return isOpen() ? static_cast<size_t>( header().poseCount ) : 0;
+}
+
+
+template <typename T>
+inline void CameraSetFile::camera( const size_t index, Camera<T>& cam ) const
+{
+    const CameraRecord& record = cameraRecord( index );
+
+    cam.id = static_cast<size_t>( record.id );
+    cam.imageSize = Eigen::Vector2i( static_cast<int>( record.imageSize[0] ), static_cast<int>( record.imageSize[1] ) );
+    cam.sensorSize = Eigen::Matrix<T,2,1>( static_cast<T>( record.sensorSize[0] ), static_cast<T>( record.sensorSize[1] ) );
+    for( int i=0; i<9; i++ )
+        cam.intrinsic.data()[i] = static_cast<T>( record.intrinsic[i] );
+    cam.error = static_cast<T>( record.error );
+
+    const double* distortion = reinterpret_cast<const double*>( m_data + record.distortionOffset );
+    cam.distortion.assign( distortion, distortion + record.distortionCount );
+}
+
+
+inline size_t CameraSetFile::cameraPoseBegin( const size_t index ) const
+{
+    return static_cast<size_t>( cameraRecord( index ).poseBegin );
+}
+
+
+inline size_t CameraSetFile::cameraPoseCount( const size_t index ) const
+{
+    return static_cast<size_t>( cameraRecord( index ).poseCount );
+}
+
+
+inline size_t CameraSetFile::poseId( const size_t index ) const
+{
+    return static_cast<size_t>( poseRecord( index ).id );
+}
+
+
+inline std::string CameraSetFile::poseName( const size_t index ) const
+{
+    const PoseRecord& record = poseRecord( index );
+    return std::string( m_data + record.nameOffset, static_cast<size_t>( record.nameLength ) );
+}
+
+
+template <typename T>
+inline void CameraSetFile::pattern( const size_t index, Pattern<T>& pattern ) const
+{
+    const PatternRecord& record = patternRecord( index );
+    readBlock( record.pointsOffset, record.pointsCount, pattern.points );
+}
+
+
+template <typename T>
+inline void CameraSetFile::patterns( std::vector< std::shared_ptr< const Pattern<T> > >& patterns ) const
+{
+    patterns.resize( patternCount() );
+    for( size_t i=0; i<patterns.size(); i++ )
+    {
+        std::shared_ptr< Pattern<T> > tmp( new Pattern<T>() );
+        pattern( i, *tmp );
+        patterns[i] = tmp;
+    }
+}
+
+
+template <typename T>
+inline void CameraSetFile::pose( const size_t index, Pose<T>& pose, const std::vector< std::shared_ptr< const Pattern<T> > >& patterns ) const
+{
+    const PoseRecord& record = poseRecord( index );
+
+    pose.id = static_cast<size_t>( record.id );
+    pose.name.assign( m_data + record.nameOffset, static_cast<size_t>( record.nameLength ) );
+    pose.rejected = record.rejected != 0;
+    pose.pointsMax = static_cast<size_t>( record.pointsMax );
+    for( int i=0; i<16; i++ )
+        pose.transformation.data()[i] = static_cast<T>( record.transformation[i] );
+
+    readBlock( record.projected2DOffset, record.projected2DCount, pose.projected2D );
+
+    // split the interleaved points into the columns of the correspondences
+    const double* points2D = reinterpret_cast<const double*>( m_data + record.points2DOffset );
+    const uint64_t* indices = reinterpret_cast<const uint64_t*>( m_data + record.indicesOffset );
+    pose.correspondences.clear();
+    pose.correspondences.resize( static_cast<size_t>( record.points2DCount ) );
+    typename Correspondences<T>::ColumnMap x = pose.correspondences.x();
+    typename Correspondences<T>::ColumnMap y = pose.correspondences.y();
+    for( size_t i=0; i<pose.correspondences.size(); i++ )
+    {
+        x(i) = static_cast<T>( points2D[2*i] );
+        y(i) = static_cast<T>( points2D[2*i+1] );
+        pose.correspondences.setIndex( i, static_cast<size_t>( indices[i] ) );
+    }
+
+    // version 1 has no weights, resize left them at one
+    if( header().version > 1 )
+    {
+        const double* weights = reinterpret_cast<const double*>( m_data + record.weightsOffset );
+        typename Correspondences<T>::ColumnMap w = pose.correspondences.weights();
+        for( size_t i=0; i<pose.correspondences.size(); i++ )
+            w(i) = static_cast<T>( weights[i] );
+    }
+
+    // shared pattern, or one decoded for this pose alone
+    size_t patternIndex = static_cast<size_t>( record.pattern );
+    pose.pattern.reset();
+    if( patternIndex > 0 && patternIndex <= patterns.size() )
+        pose.pattern = patterns[ patternIndex-1 ];
+    else if( patternIndex > 0 )
+    {
+        std::shared_ptr< Pattern<T> > tmp( new Pattern<T>() );
+        pattern( patternIndex-1, *tmp );
+        pose.pattern = tmp;
+    }
+}
+
+
+template <typename T>
+inline void CameraSetFile::pose( const size_t index, Pose<T>& pose ) const
+{
+    this->pose( index, pose, std::vector< std::shared_ptr< const Pattern<T> > >() );
+}
+
+
+template <typename T>
+inline void CameraSetFile::save( const std::string& filename, const std::map< size_t, Camera<T> >& cameras )
+{
+    // the tables are fixed-size, the data follows them
+    Header head;
+    std::memset( &head, 0, sizeof(Header) );
+    std::memcpy( head.magic, magic(), 8 );
+    head.version = Version;
+    head.byteOrder = byteOrder();
+    head.cameraCount = cameras.size();
+    for( auto camIt=cameras.begin(); camIt != cameras.end(); camIt++ )
+        head.poseCount += camIt->second.poses.size();
+    // each pattern is stored once
+    std::map< const Pattern<T>*, uint64_t > patternIndices;
+    std::vector< const Pattern<T>* > patterns;
+    for( auto camIt=cameras.begin(); camIt != cameras.end(); camIt++ )
+    {
+        for( size_t i=0; i<camIt->second.poses.size(); i++ )
+        {
+            const Pattern<T>* pattern = camIt->second.poses[i].pattern.get();
+            if( pattern != 0 && patternIndices.count( pattern ) == 0 )
+            {
+                patternIndices[ pattern ] = patterns.size();
+                patterns.push_back( pattern );
+            }
+        }
+    }
+    head.patternCount = patterns.size();
+    head.poseRecordSize = sizeof(PoseRecord);
+
+    head.cameraOffset = sizeof(Header);
+    head.patternOffset = head.cameraOffset + head.cameraCount * sizeof(CameraRecord);
+    head.poseOffset = head.patternOffset + head.patternCount * sizeof(PatternRecord);
+    const uint64_t dataOffset = head.poseOffset + head.poseCount * sizeof(PoseRecord);
+
+    std::vector<CameraRecord> cameraTable( cameras.size() );
+    std::vector<PatternRecord> patternTable( patterns.size() );
+    std::vector<PoseRecord> poseTable( head.poseCount );
+    std::vector<char> data;
+
+    // the pattern points
+    for( size_t i=0; i<patterns.size(); i++ )
+        appendBlock( data, patterns[i]->points, patternTable[i].pointsOffset, patternTable[i].pointsCount, dataOffset );
+
+    // fill the tables
+    size_t c = 0;
+    size_t p = 0;
+    for( auto camIt=cameras.begin(); camIt != cameras.end(); camIt++, c++ )
+    {
+        const Camera<T>& cam = camIt->second;
+        CameraRecord& record = cameraTable[c];
+        std::memset( &record, 0, sizeof(CameraRecord) );
+
+        record.id = cam.id;
+        record.imageSize[0] = cam.imageSize(0);
+        record.imageSize[1] = cam.imageSize(1);
+        record.sensorSize[0] = static_cast<double>( cam.sensorSize(0) );
+        record.sensorSize[1] = static_cast<double>( cam.sensorSize(1) );
+        for( int i=0; i<9; i++ )
+            record.intrinsic[i] = static_cast<double>( cam.intrinsic.data()[i] );
+        record.error = static_cast<double>( cam.error );
+
+        std::vector< Eigen::Matrix<T,1,1> > distortion( cam.distortion.size() );
+        for( size_t i=0; i<cam.distortion.size(); i++ )
+            distortion[i](0) = cam.distortion[i];
+        appendBlock( data, distortion, record.distortionOffset, record.distortionCount, dataOffset );
+
+        record.poseBegin = p;
+        record.poseCount = cam.poses.size();
+        for( size_t i=0; i<cam.poses.size(); i++, p++ )
+        {
+            const Pose<T>& pose = cam.poses[i];
+            PoseRecord& poseRecord = poseTable[p];
+            std::memset( &poseRecord, 0, sizeof(PoseRecord) );
+
+            poseRecord.id = pose.id;
+            poseRecord.rejected = pose.rejected ? 1 : 0;
+            poseRecord.pointsMax = pose.pointsMax;
+            for( int j=0; j<16; j++ )
+                poseRecord.transformation[j] = static_cast<double>( pose.transformation.data()[j] );
+
+            // name, padded to keep the blocks aligned
+            poseRecord.nameOffset = dataOffset + data.size();
+            poseRecord.nameLength = pose.name.size();
+            data.insert( data.end(), pose.name.begin(), pose.name.end() );
+            data.resize( ( data.size() + 7 ) & ~static_cast<size_t>( 7 ), 0 );
+
+            appendBlock( data, pose.correspondences.points(), poseRecord.points2DOffset, poseRecord.points2DCount, dataOffset );
+            appendBlock( data, pose.projected2D, poseRecord.projected2DOffset, poseRecord.projected2DCount, dataOffset );
+            if( pose.pattern )
+                poseRecord.pattern = patternIndices[ pose.pattern.get() ] + 1;
+
+            poseRecord.indicesOffset = dataOffset + data.size();
+            poseRecord.indicesCount = pose.correspondences.size();
+            size_t start = data.size();
+            data.resize( start + pose.correspondences.size() * sizeof(uint64_t) );
+            uint64_t* indices = reinterpret_cast<uint64_t*>( &data[start] );
+            for( size_t j=0; j<pose.correspondences.size(); j++ )
+                indices[j] = pose.correspondences.index( j );
+
+            poseRecord.weightsOffset = dataOffset + data.size();
+            poseRecord.weightsCount = pose.correspondences.size();
+            start = data.size();
+            data.resize( start + pose.correspondences.size() * sizeof(double) );
+            double* weights = reinterpret_cast<double*>( &data[start] );
+            for( size_t j=0; j<pose.correspondences.size(); j++ )
+                weights[j] = static_cast<double>( pose.correspondences.weight( j ) );
+        }
+    }
+    head.fileSize = dataOffset + data.size();
+
+    // write everything in one go
+    std::ofstream file( filename.c_str(), std::ios::binary | std::ios::trunc );
+    if( !file )
+        throw std::runtime_error( "CameraSetFile::save: could not open \"" + filename + "\"." );
+    file.write( reinterpret_cast<const char*>( &head ), sizeof(Header) );
+    if( cameraTable.size() > 0 )
+        file.write( reinterpret_cast<const char*>( cameraTable.data() ), cameraTable.size() * sizeof(CameraRecord) );
+    if( patternTable.size() > 0 )
+        file.write( reinterpret_cast<const char*>( patternTable.data() ), patternTable.size() * sizeof(PatternRecord) );
+    if( poseTable.size() > 0 )
+        file.write( reinterpret_cast<const char*>( poseTable.data() ), poseTable.size() * sizeof(PoseRecord) );
+    if( data.size() > 0 )
+        file.write( data.data(), data.size() );
+    if( !file )
+        throw std::runtime_error( "CameraSetFile::save: could not write \"" + filename + "\"." );
+}
+
+
+inline const char* CameraSetFile::magic()
+{
+    return "IRISSET";
+}
+
+
+inline uint32_t CameraSetFile::byteOrder()
+{
+    return 0x01020304;
+}
+
+
+inline void CameraSetFile::checkBlock( const uint64_t offset, const uint64_t count, const uint64_t elementSize, const char* what ) const
+{
+    // written so that it cannot overflow
+    if( offset > m_size || count > ( m_size - offset ) / elementSize || ( elementSize > 1 && offset % 8 != 0 ) )
+        throw std::runtime_error( "CameraSetFile::open: " + std::string( what ) + " block is out of bounds." );
+}
+
+
+inline const CameraSetFile::Header& CameraSetFile::header() const
+{
+    return *reinterpret_cast<const Header*>( m_data );
+}
+
+
+inline const CameraSetFile::CameraRecord& CameraSetFile::cameraRecord( const size_t index ) const
+{
+    if( index >= cameraCount() )
+        throw std::runtime_error( "CameraSetFile::camera: index " + toString( index ) + " is out of range." );
+    return reinterpret_cast<const CameraRecord*>( m_data + header().cameraOffset )[index];
+}
+
+
+inline const CameraSetFile::PatternRecord& CameraSetFile::patternRecord( const size_t index ) const
+{
+    if( index >= patternCount() )
+        throw std::runtime_error( "CameraSetFile::pattern: index " + toString( index ) + " is out of range." );
+    return reinterpret_cast<const PatternRecord*>( m_data + header().patternOffset )[index];
+}
+
+
+inline const CameraSetFile::PoseRecord& CameraSetFile::poseRecord( const size_t index ) const
+{
+    if( index >= poseCount() )
+        throw std::runtime_error( "CameraSetFile::pose: index " + toString( index ) + " is out of range." );
+    // version 1 records are shorter
+    return *reinterpret_cast<const PoseRecord*>( m_data + header().poseOffset + index * header().poseRecordSize );
+}
+
+
+template <typename T, int Rows>
+inline void CameraSetFile::readBlock( const uint64_t offset, const uint64_t count, std::vector< Eigen::Matrix<T,Rows,1> >& vec ) const
+{
+    const double* src = reinterpret_cast<const double*>( m_data + offset );
+    vec.resize( static_cast<size_t>( count ) );
+    for( size_t i=0; i<vec.size(); i++ )
+        for( int r=0; r<Rows; r++ )
+            vec[i](r) = static_cast<T>( src[ i*Rows + r ] );
+}
+
+
+template <typename T>
+inline void CameraSetFile::readBlock( const uint64_t offset, const uint64_t count, Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor>& points ) const
+{
+    const double* src = reinterpret_cast<const double*>( m_data + offset );
+    points.resize( 2, static_cast<size_t>( count ) );
+    for( size_t i=0; i<count; i++ )
+    {
+        points(0,i) = static_cast<T>( src[ 2*i ] );
+        points(1,i) = static_cast<T>( src[ 2*i + 1 ] );
+    }
+}
+
+
+template <typename T, int Rows>
+inline void CameraSetFile::appendBlock( std::vector<char>& data, const std::vector< Eigen::Matrix<T,Rows,1> >& vec, uint64_t& offset, uint64_t& count, const uint64_t base )
+{
+    offset = base + data.size();
+    count = vec.size();
+
+    size_t start = data.size();
+    data.resize( start + vec.size() * Rows * sizeof(double) );
+    double* dst = reinterpret_cast<double*>( &data[start] );
+    for( size_t i=0; i<vec.size(); i++ )
+        for( int r=0; r<Rows; r++ )
+            dst[ i*Rows + r ] = static_cast<double>( vec[i](r) );
+}
+
+
+template <typename Derived>
+inline void CameraSetFile::appendBlock( std::vector<char>& data, const Eigen::MatrixBase<Derived>& points, uint64_t& offset, uint64_t& count, const uint64_t base )
+{
+    offset = base + data.size();
+    count = points.cols();
+
+    size_t start = data.size();
+    data.resize( start + points.size() * sizeof(double) );
+    double* dst = reinterpret_cast<double*>( &data[start] );
+    for( typename Derived::Index i=0; i<points.cols(); i++ )
+        for( typename Derived::Index r=0; r<points.rows(); r++ )
+            dst[ i*points.rows() + r ] = static_cast<double>( points(r,i) );
+}
+
+
+} // end namespace iris
@@ -0,0 +1,450 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * CameraSetIngest.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <iris/CameraSet.hpp>
+
+namespace iris
+{
+
+template <typename T>
+class CameraSetIngest
+{
+///
+/// \file    CameraSetIngest.hpp
+/// \class   CameraSetIngest
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Concurrent front end for filling a camera set
+///
+/// \details Capture threads push frames, detection workers take them and
+///          commit them once processed, and publish() moves the committed
+///          poses into a new snapshot. Pose ids are handed out
+///          by an atomic counter. The queues are sharded by camera, each
+///          shard with a lock of its own, so producers of different
+///          cameras do not wait on each other and none of them waits on
+///          a publication. Snapshots are never changed once published,
+///          readers such as the calibration or the UI can hold on to one
+///          while ingestion goes on. Snapshots share their poses: a
+///          publication adds one chunk of poses to each camera it changed
+///          and copies no pose of an earlier one, apart from merging
+///          chunks of similar size, which keeps the chunks per camera
+///          logarithmic in the number of poses. A full CameraSet is only
+///          assembled when a reader asks for one.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    // a pose on its way into the set
+    class Frame
+    {
+    public:
+        Frame() : camera(0) {}
+
+        size_t camera;
+        Pose<T> pose;
+    };
+
+    // published poses of one camera, never changed once published
+    class CameraPoses
+    {
+    public:
+        typedef std::vector< Pose<T> > Chunk;
+
+        CameraPoses() : poseCount(0) {}
+
+        // the pose at position i over all chunks
+        const Pose<T>& pose( size_t i ) const;
+
+        // the camera's parameters, its poses are in the chunks
+        Camera<T> camera;
+        std::vector< std::shared_ptr<const Chunk> > chunks;
+        size_t poseCount;
+    };
+
+    // a published state, cameras that did not change are shared with the previous one
+    class Snapshot
+    {
+    public:
+        Snapshot() : m_poseCount(0), m_nextPoseId(0) {}
+
+        size_t poseCount() const;
+        size_t nextPoseId() const;
+        const std::map< size_t, std::shared_ptr<const CameraPoses> >& cameras() const;
+
+        // the poses as a set of their own, every pose is copied
+        CameraSet<T> cameraSet() const;
+
+    protected:
+        size_t m_poseCount;
+        size_t m_nextPoseId;
+        std::map< size_t, std::shared_ptr<const CameraPoses> > m_cameras;
+
+        friend class CameraSetIngest;
+    };
+
+public:
+    // ingestion continues the ids of the set
+    CameraSetIngest( const CameraSet<T>& cs=CameraSet<T>(), const size_t shardCount=16 );
+
+    // any thread: queue a frame, returns the id of its pose; the image has to be set
+    size_t push( std::shared_ptr< cimg_library::CImg<uint8_t> > image, const std::string& name, const size_t cameraID=0 );
+
+    // detection workers: take up to maxFrames queued frames, returns how many
+    size_t take( std::vector<Frame>& frames, const size_t maxFrames );
+
+    // detection workers: hand back processed frames
+    void commit( Frame&& frame );
+    void commit( std::vector<Frame>& frames );
+
+    // move the committed poses into a new snapshot, returns how many
+    size_t publish();
+
+    // the last published state
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    // frames queued and not taken, and taken but not committed
+    size_t queued() const;
+    size_t processing() const;
+
+protected:
+    class Shard
+    {
+    public:
+        std::mutex mutex;
+        std::deque<Frame> queued;
+        std::vector<Frame> committed;
+        // image size of each camera, checked on push
+        std::map< size_t, Eigen::Vector2i > imageSizes;
+    };
+
+    Shard& shard( const size_t cameraID );
+
+private:
+    CameraSetIngest( const CameraSetIngest& );
+    void operator =( const CameraSetIngest& );
+
+protected:
+    std::vector< std::unique_ptr<Shard> > m_shards;
+    std::atomic<size_t> m_nextId;
+    std::atomic<size_t> m_nextShard;
+    std::atomic<size_t> m_queued;
+    std::atomic<size_t> m_processing;
+
+    // publications are serialized, readers load the pointer atomically
+    std::mutex m_publishMutex;
+    std::shared_ptr<const Snapshot> m_snapshot;
+};
+
+
+/////
+// Implementation
+///
+
+template <typename T>
+inline const Pose<T>& CameraSetIngest<T>::CameraPoses::pose( size_t i ) const
+{
+    for( size_t c=0; c<chunks.size(); c++ )
+    {
+        if( i < chunks[c]->size() )
+            return (*chunks[c])[i];
+        i -= chunks[c]->size();
+    }
+    throw std::runtime_error( "CameraSetIngest::CameraPoses::pose: pose not found." );
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::Snapshot::poseCount() const
+{
+    return m_poseCount;
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::Snapshot::nextPoseId() const
+{
+    return m_nextPoseId;
+}
+
+
+template <typename T>
+inline const std::map< size_t, std::shared_ptr<const typename CameraSetIngest<T>::CameraPoses> >& CameraSetIngest<T>::Snapshot::cameras() const
+{
+    return m_cameras;
+}
+
+
+template <typename T>
+inline CameraSet<T> CameraSetIngest<T>::Snapshot::cameraSet() const
+{
+    CameraSet<T> cs;
+    for( auto it=m_cameras.begin(); it != m_cameras.end(); it++ )
+    {
+        cs.m_cameras[ it->first ] = it->second->camera;
+        for( size_t c=0; c<it->second->chunks.size(); c++ )
+            for( size_t p=0; p<it->second->chunks[c]->size(); p++ )
+                cs.insert( Pose<T>( (*it->second->chunks[c])[p] ), it->first );
+    }
+    cs.m_poseCount = std::max( cs.m_poseCount, m_nextPoseId );
+
+    return cs;
+}
+
+
+template <typename T>
+inline CameraSetIngest<T>::CameraSetIngest( const CameraSet<T>& cs, const size_t shardCount ) :
+    m_nextId( cs.nextPoseId() ),
+    m_nextShard( 0 ),
+    m_queued( 0 ),
+    m_processing( 0 )
+{
+    if( shardCount == 0 )
+        throw std::runtime_error( "CameraSetIngest::CameraSetIngest: at least one shard is needed." );
+
+    // the poses of the set are the first chunk of their camera
+    std::shared_ptr<Snapshot> initial( new Snapshot() );
+    for( auto it=cs.cameras().begin(); it != cs.cameras().end(); it++ )
+    {
+        std::shared_ptr<CameraPoses> camera( new CameraPoses() );
+        camera->camera = it->second;
+        camera->camera.poses.clear();
+        if( it->second.poses.size() > 0 )
+            camera->chunks.push_back( std::make_shared<const typename CameraPoses::Chunk>( it->second.poses ) );
+        camera->poseCount = it->second.poses.size();
+        initial->m_cameras[ it->first ] = camera;
+    }
+    initial->m_poseCount = cs.poseCount();
+    initial->m_nextPoseId = cs.nextPoseId();
+    m_snapshot = initial;
+
+    m_shards.resize( shardCount );
+    for( size_t s=0; s<shardCount; s++ )
+        m_shards[s].reset( new Shard() );
+
+    // new frames have to match the poses already in the set
+    for( auto it=cs.cameras().begin(); it != cs.cameras().end(); it++ )
+        if( it->second.poses.size() > 0 )
+            shard( it->first ).imageSizes[ it->first ] = it->second.imageSize;
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::push( std::shared_ptr< cimg_library::CImg<uint8_t> > image, const std::string& name, const size_t cameraID )
+{
+    if( !image )
+        throw std::runtime_error( "CameraSetIngest::push: image not set." );
+
+    Frame frame;
+    frame.camera = cameraID;
+    frame.pose.name = name;
+    frame.pose.image = image;
+
+    size_t id;
+    Shard& s = shard( cameraID );
+    {
+        std::lock_guard<std::mutex> lock( s.mutex );
+
+        // the first frame of a camera sets its image size
+        Eigen::Vector2i imageSize( image->width(), image->height() );
+        auto it = s.imageSizes.find( cameraID );
+        if( it == s.imageSizes.end() )
+            s.imageSizes[ cameraID ] = imageSize;
+        else if( it->second != imageSize )
+            throw std::runtime_error( "CameraSetIngest::push: frame has different image size than the camera's poses." );
+
+        // ids are taken under the lock, so each camera's queue is in id order
+        frame.pose.id = m_nextId++;
+        id = frame.pose.id;
+        s.queued.push_back( std::move( frame ) );
+    }
+    m_queued++;
+
+    return id;
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::take( std::vector<Frame>& frames, const size_t maxFrames )
+{
+    // visit the shards round robin, starting where the last call stopped
+    size_t taken = 0;
+    size_t start = m_nextShard++;
+    for( size_t i=0; i<m_shards.size() && taken < maxFrames; i++ )
+    {
+        Shard& s = *m_shards[ ( start + i ) % m_shards.size() ];
+        std::lock_guard<std::mutex> lock( s.mutex );
+        while( !s.queued.empty() && taken < maxFrames )
+        {
+            frames.push_back( std::move( s.queued.front() ) );
+            s.queued.pop_front();
+            taken++;
+        }
+    }
+    m_queued -= taken;
+    m_processing += taken;
+
+    return taken;
+}
+
+
+template <typename T>
+inline void CameraSetIngest<T>::commit( Frame&& frame )
+{
+    Shard& s = shard( frame.camera );
+    {
+        std::lock_guard<std::mutex> lock( s.mutex );
+        s.committed.push_back( std::move( frame ) );
+    }
+    m_processing--;
+}
+
+
+template <typename T>
+inline void CameraSetIngest<T>::commit( std::vector<Frame>& frames )
+{
+    for( size_t i=0; i<frames.size(); i++ )
+        commit( std::move( frames[i] ) );
+    frames.clear();
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::publish()
+{
+    std::lock_guard<std::mutex> publishLock( m_publishMutex );
+
+    // collect what was committed, each shard is locked only for the swap
+    std::vector<Frame> frames;
+    for( size_t i=0; i<m_shards.size(); i++ )
+    {
+        std::vector<Frame> committed;
+        {
+            std::lock_guard<std::mutex> lock( m_shards[i]->mutex );
+            committed.swap( m_shards[i]->committed );
+        }
+        std::move( committed.begin(), committed.end(), std::back_inserter( frames ) );
+    }
+    if( frames.empty() )
+        return 0;
+
+    // within a publication the poses of a camera are in capture order
+    std::sort( frames.begin(), frames.end(), []( const Frame& a, const Frame& b ) { return a.pose.id < b.pose.id; } );
+
+    // group the poses by camera, each group becomes one chunk
+    size_t nextPoseId = frames.back().pose.id + 1;
+    std::map< size_t, std::shared_ptr< typename CameraPoses::Chunk > > chunks;
+    for( size_t i=0; i<frames.size(); i++ )
+    {
+        std::shared_ptr< typename CameraPoses::Chunk >& chunk = chunks[ frames[i].camera ];
+        if( !chunk )
+            chunk.reset( new typename CameraPoses::Chunk() );
+        chunk->push_back( std::move( frames[i].pose ) );
+    }
+
+    // only the changed cameras are new, the old snapshot stays valid for its readers
+    std::shared_ptr<const Snapshot> current = std::atomic_load( &m_snapshot );
+    std::shared_ptr<Snapshot> next( new Snapshot( *current ) );
+    for( auto it=chunks.begin(); it != chunks.end(); it++ )
+    {
+        std::shared_ptr<CameraPoses> camera( new CameraPoses() );
+        auto camIt = current->m_cameras.find( it->first );
+        if( camIt != current->m_cameras.end() )
+            *camera = *camIt->second;
+        else
+        {
+            camera->camera.id = it->first;
+            const Pose<T>& first = it->second->front();
+            if( first.image )
+                camera->camera.imageSize = Eigen::Vector2i( first.image->width(), first.image->height() );
+        }
+
+        // merge with the previous chunks while they are not larger
+        std::shared_ptr<const typename CameraPoses::Chunk> chunk( it->second );
+        while( camera->chunks.size() > 0 && camera->chunks.back()->size() <= chunk->size() )
+        {
+            std::shared_ptr< typename CameraPoses::Chunk > merged( new typename CameraPoses::Chunk( *camera->chunks.back() ) );
+            merged->insert( merged->end(), chunk->begin(), chunk->end() );
+            camera->chunks.pop_back();
+            chunk = merged;
+        }
+        camera->chunks.push_back( chunk );
+        camera->poseCount += it->second->size();
+        next->m_cameras[ it->first ] = camera;
+    }
+    next->m_poseCount += frames.size();
+    next->m_nextPoseId = std::max( next->m_nextPoseId, nextPoseId );
+    std::atomic_store( &m_snapshot, std::shared_ptr<const Snapshot>( next ) );
+
+    return frames.size();
+}
+
+
+template <typename T>
+inline std::shared_ptr<const typename CameraSetIngest<T>::Snapshot> CameraSetIngest<T>::snapshot() const
+{
+    return std::atomic_load( &m_snapshot );
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::queued() const
+{
+    return m_queued;
+}
+
+
+template <typename T>
+inline size_t CameraSetIngest<T>::processing() const
+{
+    return m_processing;
+}
+
+
+template <typename T>
+inline typename CameraSetIngest<T>::Shard& CameraSetIngest<T>::shard( const size_t cameraID )
+{
+    return *m_shards[ cameraID % m_shards.size() ];
+}
+
+
+} // end namespace iris
@@ -0,0 +1,903 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * CameraSetJournal.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class CameraSetJournal
+{
+///
+/// \file    CameraSetJournal.hpp
+/// \class   CameraSetJournal
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Append-only log of the changes to a camera set
+///
+/// \details Layout: a header with magic, version and byte order, followed
+///          by records, each a type, a checksum and the size of its
+///          payload. Records add patterns and poses, erase poses and
+///          cameras, and set the detections and results of poses and the
+///          parameters of cameras. Scalars are stored as float64 and
+///          integers as uint64, like in CameraSetFile.
+///          The journal remembers a fingerprint of what it wrote for every
+///          pose and camera, an append only writes the records of what
+///          changed since, in one write at the end of the file. Loading
+///          replays the records in order and never writes, a record torn
+///          by a crash at the end of the file is ignored and left in place,
+///          a damaged record before the end fails the load. Compaction
+///          writes the whole set anew and replaces the file once complete,
+///          it also removes a torn tail. A file the journal does not track
+///          yet starts with such a snapshot. Detections carry the point
+///          weights since version 2, older files are read with full
+///          weights and compacted on their next append.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    static const uint32_t Version = 2;
+
+    CameraSetJournal();
+    virtual ~CameraSetJournal();
+
+    // check the magic of a file
+    static bool isJournal( const std::string& filename );
+
+    // the file appended to, empty before the first load or append
+    const std::string& filename() const;
+
+    // bytes written by the last append or compaction
+    uint64_t appendedBytes() const;
+
+    // pose ids handed out so far, including those of erased poses
+    size_t nextPoseId() const;
+
+    // bytes of a torn record at the end of the file that the last load
+    // ignored, the next append compacts the file instead of adding to it
+    uint64_t tornBytes() const;
+
+    // replay a journal, later appends go to the same file, throws if a
+    // record before the end of the file is damaged
+    template <typename T>
+    void load( const std::string& filename, std::map< size_t, Camera<T> >& cameras );
+
+    // write the changes since the last load or append
+    template <typename T>
+    void append( const std::string& filename, const std::map< size_t, Camera<T> >& cameras );
+
+    // rewrite the file as a snapshot of the cameras
+    template <typename T>
+    void compact( const std::map< size_t, Camera<T> >& cameras );
+
+    // forget the file, the next append starts with a snapshot
+    void close();
+
+protected:
+    enum RecordType
+    {
+        AddPattern = 1,
+        AddPose,
+        ErasePose,
+        Detection,
+        PoseResult,
+        CameraResult,
+        EraseCamera
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrder;
+    };
+
+    struct RecordHeader
+    {
+        uint32_t type;
+        uint32_t checksum;
+        uint64_t size;
+    };
+
+    // fingerprints of what was last written for a pose
+    struct PoseState
+    {
+        size_t camera;
+        uint64_t detection;
+        uint64_t result;
+    };
+
+    // a written pattern, kept alive so that its address stays unique
+    struct PatternState
+    {
+        uint64_t id;
+        std::shared_ptr<const void> pattern;
+    };
+
+    // sequential reader of a record's payload
+    class Reader
+    {
+    public:
+        Reader( const char* data, const uint64_t size ) : m_pos( data ), m_end( data + size ) {}
+
+        uint64_t integer();
+        double real();
+        std::string name( const uint64_t length );
+
+    protected:
+        void check( const uint64_t size ) const;
+
+    protected:
+        const char* m_pos;
+        const char* m_end;
+    };
+
+    static const char* magic();
+    static uint32_t byteOrder();
+
+    // FNV-1a over 8 byte words, used for the checksums and the fingerprints
+    static uint64_t hash( const void* data, const size_t size, uint64_t h=14695981039346656037ULL );
+
+    template <typename T>
+    static uint64_t detectionHash( const Pose<T>& pose );
+    template <typename T>
+    static uint64_t resultHash( const Pose<T>& pose );
+    template <typename T>
+    static uint64_t cameraHash( const Camera<T>& cam );
+
+    // records are assembled in place, the header is filled in at the end
+    static size_t beginRecord( std::vector<char>& data, const RecordType type );
+    static void endRecord( std::vector<char>& data, const size_t start );
+    static void appendInteger( std::vector<char>& data, const uint64_t val );
+    static void appendReal( std::vector<char>& data, const double val );
+    static void appendName( std::vector<char>& data, const std::string& name );
+
+    template <typename T>
+    void appendChanges( std::vector<char>& data, const std::map< size_t, Camera<T> >& cameras );
+
+    // write a complete file and put it in place of filename
+    static void replaceFile( const std::string& filename, const std::vector<char>& data );
+
+    // forget what was written
+    void reset();
+
+private:
+    CameraSetJournal( const CameraSetJournal& );
+    void operator =( const CameraSetJournal& );
+
+protected:
+    std::string m_filename;
+    uint64_t m_appendedBytes;
+    size_t m_nextPoseId;
+    uint64_t m_tornBytes;
+    uint32_t m_version;
+
+    std::unordered_map< size_t, PoseState > m_poses;
+    std::map< size_t, uint64_t > m_cameras;
+    std::map< const void*, PatternState > m_patterns;
+    uint64_t m_nextPattern;
+};
+
+
+/////
+// Implementation
+///
+
+inline CameraSetJournal::CameraSetJournal() :
+    m_appendedBytes(0),
+    m_nextPoseId(0),
+    m_tornBytes(0),
+    m_version(Version),
+    m_nextPattern(0)
+{
+}
+
+
+inline CameraSetJournal::~CameraSetJournal()
+{
+}
+
+
+inline bool CameraSetJournal::isJournal( const std::string& filename )
+{
+    char buffer[8];
+    std::ifstream file( filename.c_str(), std::ios::binary );
+    return file.read( buffer, 8 ) && std::memcmp( buffer, magic(), 8 ) == 0;
+}
+
+
+inline const std::string& CameraSetJournal::filename() const
+{
+    return m_filename;
+}
+
+
+inline uint64_t CameraSetJournal::appendedBytes() const
+{
+    return m_appendedBytes;
+}
+
+
+inline size_t CameraSetJournal::nextPoseId() const
+{
+    return m_nextPoseId;
+}
+
+
+inline uint64_t CameraSetJournal::tornBytes() const
+{
+    return m_tornBytes;
+}
+
+
+template <typename T>
+inline void CameraSetJournal::load( const std::string& filename, std::map< size_t, Camera<T> >& cameras )
+{
+    // journals are replayed front to back, read it at once
+    std::ifstream file( filename.c_str(), std::ios::binary | std::ios::ate );
+    if( !file )
+        throw std::runtime_error( "CameraSetJournal::load: could not open \"" + filename + "\"." );
+    std::vector<char> data( static_cast<size_t>( file.tellg() ) );
+    file.seekg( 0, std::ios::beg );
+    if( data.size() > 0 )
+        file.read( data.data(), data.size() );
+    if( !file )
+        throw std::runtime_error( "CameraSetJournal::load: could not read \"" + filename + "\"." );
+    file.close();
+
+    // check the header
+    Header head;
+    if( data.size() < sizeof(Header) || std::memcmp( data.data(), magic(), 8 ) != 0 )
+        throw std::runtime_error( "CameraSetJournal::load: \"" + filename + "\" is not a camera set journal." );
+    std::memcpy( &head, data.data(), sizeof(Header) );
+    if( head.byteOrder != byteOrder() )
+        throw std::runtime_error( "CameraSetJournal::load: \"" + filename + "\" was written with a different byte order." );
+    if( head.version < 1 || head.version > Version )
+        throw std::runtime_error( "CameraSetJournal::load: unsupported version " + toString( head.version ) + "." );
+
+    // poses by the order they were added in, cameras and patterns by id
+    std::map< uint64_t, std::pair< size_t, Pose<T> > > poses;
+    std::unordered_map< size_t, uint64_t > sequence;
+    std::map< size_t, Camera<T> > result;
+    std::map< uint64_t, std::shared_ptr< const Pattern<T> > > patterns;
+    uint64_t added = 0;
+    size_t nextPoseId = 0;
+
+    // replay up to the end or a record torn by a crash, which can only be
+    // the last one since appends only ever write at the end
+    size_t pos = sizeof(Header);
+    while( data.size() - pos >= sizeof(RecordHeader) )
+    {
+        RecordHeader record;
+        std::memcpy( &record, &data[pos], sizeof(RecordHeader) );
+        const char* payload = &data[pos] + sizeof(RecordHeader);
+        if( record.size > data.size() - pos - sizeof(RecordHeader) )
+            break;
+        if( record.checksum != static_cast<uint32_t>( hash( payload, static_cast<size_t>( record.size ) ) ) )
+        {
+            if( pos + sizeof(RecordHeader) + record.size == data.size() )
+                break;
+            throw std::runtime_error( "CameraSetJournal::load: damaged record at offset " + toString( pos ) + " of \"" + filename + "\"." );
+        }
+
+        Reader in( payload, record.size );
+        switch( record.type )
+        {
+            case AddPattern:
+            {
+                uint64_t id = in.integer();
+                std::shared_ptr< Pattern<T> > pattern( new Pattern<T>() );
+                pattern->points.resize( static_cast<size_t>( in.integer() ) );
+                for( size_t i=0; i<pattern->points.size(); i++ )
+                    for( int r=0; r<3; r++ )
+                        pattern->points[i](r) = static_cast<T>( in.real() );
+                patterns[id] = pattern;
+                break;
+            }
+            case AddPose:
+            {
+                Pose<T> pose;
+                pose.id = static_cast<size_t>( in.integer() );
+                size_t camera = static_cast<size_t>( in.integer() );
+                Eigen::Vector2i imageSize;
+                imageSize(0) = static_cast<int>( in.integer() );
+                imageSize(1) = static_cast<int>( in.integer() );
+                pose.name = in.name( in.integer() );
+
+                // the first pose of a camera brings its image size
+                if( result.count( camera ) == 0 )
+                {
+                    result[camera].id = camera;
+                    result[camera].imageSize = imageSize;
+                }
+                nextPoseId = std::max( nextPoseId, pose.id + 1 );
+                sequence[ pose.id ] = added;
+                poses[ added++ ] = std::make_pair( camera, std::move( pose ) );
+                break;
+            }
+            case ErasePose:
+            {
+                auto it = sequence.find( static_cast<size_t>( in.integer() ) );
+                if( it != sequence.end() )
+                {
+                    poses.erase( it->second );
+                    sequence.erase( it );
+                }
+                break;
+            }
+            case Detection:
+            {
+                auto it = sequence.find( static_cast<size_t>( in.integer() ) );
+                if( it == sequence.end() )
+                    break;
+                Pose<T>& pose = poses[ it->second ].second;
+
+                uint64_t pattern = in.integer();
+                auto patternIt = patterns.find( pattern-1 );
+                pose.pattern.reset();
+                if( pattern > 0 && patternIt != patterns.end() )
+                    pose.pattern = patternIt->second;
+                pose.pointsMax = static_cast<size_t>( in.integer() );
+
+                pose.correspondences.clear();
+                pose.correspondences.resize( static_cast<size_t>( in.integer() ) );
+                typename Correspondences<T>::ColumnMap x = pose.correspondences.x();
+                typename Correspondences<T>::ColumnMap y = pose.correspondences.y();
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                    x(i) = static_cast<T>( in.real() );
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                    y(i) = static_cast<T>( in.real() );
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                {
+                    size_t index = static_cast<size_t>( in.integer() );
+                    if( pose.pattern && index >= pose.pattern->points.size() )
+                        throw std::runtime_error( "CameraSetJournal::load: correspondence index out of range in \"" + filename + "\"." );
+                    pose.correspondences.setIndex( i, index );
+                }
+                // version 1 has no weights, resize left them at one
+                if( head.version > 1 )
+                {
+                    typename Correspondences<T>::ColumnMap w = pose.correspondences.weights();
+                    for( size_t i=0; i<pose.correspondences.size(); i++ )
+                        w(i) = static_cast<T>( in.real() );
+                }
+                break;
+            }
+            case PoseResult:
+            {
+                auto it = sequence.find( static_cast<size_t>( in.integer() ) );
+                if( it == sequence.end() )
+                    break;
+                Pose<T>& pose = poses[ it->second ].second;
+
+                pose.rejected = in.integer() != 0;
+                for( int i=0; i<16; i++ )
+                    pose.transformation.data()[i] = static_cast<T>( in.real() );
+                pose.projected2D.resize( 2, static_cast<size_t>( in.integer() ) );
+                for( typename Correspondences<T>::Points::Index i=0; i<pose.projected2D.cols(); i++ )
+                {
+                    pose.projected2D(0,i) = static_cast<T>( in.real() );
+                    pose.projected2D(1,i) = static_cast<T>( in.real() );
+                }
+                break;
+            }
+            case CameraResult:
+            {
+                size_t id = static_cast<size_t>( in.integer() );
+                Camera<T>& cam = result[id];
+                cam.id = id;
+                cam.imageSize(0) = static_cast<int>( in.integer() );
+                cam.imageSize(1) = static_cast<int>( in.integer() );
+                cam.sensorSize(0) = static_cast<T>( in.real() );
+                cam.sensorSize(1) = static_cast<T>( in.real() );
+                for( int i=0; i<9; i++ )
+                    cam.intrinsic.data()[i] = static_cast<T>( in.real() );
+                cam.error = static_cast<T>( in.real() );
+                cam.distortion.resize( static_cast<size_t>( in.integer() ) );
+                for( size_t i=0; i<cam.distortion.size(); i++ )
+                    cam.distortion[i] = static_cast<T>( in.real() );
+                break;
+            }
+            case EraseCamera:
+                result.erase( static_cast<size_t>( in.integer() ) );
+                break;
+            default:
+                throw std::runtime_error( "CameraSetJournal::load: unknown record type " + toString( record.type ) + "." );
+        }
+
+        pos += sizeof(RecordHeader) + static_cast<size_t>( record.size );
+    }
+
+    // put the poses into their cameras in the order they were added
+    for( auto it=poses.begin(); it != poses.end(); it++ )
+        result[ it->second.first ].poses.push_back( std::move( it->second.second ) );
+
+    // remember what the file holds, later appends only add to it
+    reset();
+    m_filename = filename;
+    m_nextPoseId = nextPoseId;
+    m_tornBytes = data.size() - pos;
+    m_version = head.version;
+    for( auto it=patterns.begin(); it != patterns.end(); it++ )
+    {
+        PatternState& state = m_patterns[ it->second.get() ];
+        state.id = it->first;
+        state.pattern = it->second;
+        m_nextPattern = std::max( m_nextPattern, it->first + 1 );
+    }
+    for( auto camIt=result.begin(); camIt != result.end(); camIt++ )
+    {
+        m_cameras[ camIt->first ] = cameraHash( camIt->second );
+        for( size_t p=0; p<camIt->second.poses.size(); p++ )
+        {
+            const Pose<T>& pose = camIt->second.poses[p];
+            PoseState& state = m_poses[ pose.id ];
+            state.camera = camIt->first;
+            state.detection = detectionHash( pose );
+            state.result = resultHash( pose );
+        }
+    }
+
+    cameras.swap( result );
+}
+
+
+template <typename T>
+inline void CameraSetJournal::append( const std::string& filename, const std::map< size_t, Camera<T> >& cameras )
+{
+    // a file of its own starts with a snapshot, one with a torn record at
+    // the end is rewritten since appending would bury the torn record, and
+    // an older version since its records are read differently
+    if( filename != m_filename || m_tornBytes > 0 || m_version != Version )
+    {
+        reset();
+        m_filename = filename;
+        compact( cameras );
+        return;
+    }
+
+    std::vector<char> data;
+    appendChanges( data, cameras );
+    m_appendedBytes = data.size();
+    if( data.size() == 0 )
+        return;
+
+    // one write at the end, what was there before stays untouched
+    std::ofstream file( m_filename.c_str(), std::ios::binary | std::ios::app );
+    if( file )
+        file.write( data.data(), data.size() );
+    file.flush();
+    if( !file )
+    {
+        // the fingerprints are ahead of the file, start over next time
+        std::string name = m_filename;
+        close();
+        throw std::runtime_error( "CameraSetJournal::append: could not write \"" + name + "\"." );
+    }
+}
+
+
+template <typename T>
+inline void CameraSetJournal::compact( const std::map< size_t, Camera<T> >& cameras )
+{
+    if( m_filename.empty() )
+        throw std::runtime_error( "CameraSetJournal::compact: no file to compact." );
+
+    // everything is written again
+    std::string filename = m_filename;
+    reset();
+    m_filename = filename;
+
+    Header head;
+    std::memset( &head, 0, sizeof(Header) );
+    std::memcpy( head.magic, magic(), 8 );
+    head.version = Version;
+    head.byteOrder = byteOrder();
+    std::vector<char> data( reinterpret_cast<const char*>( &head ), reinterpret_cast<const char*>( &head ) + sizeof(Header) );
+    appendChanges( data, cameras );
+
+    try
+    {
+        replaceFile( m_filename, data );
+    }
+    catch( ... )
+    {
+        close();
+        throw;
+    }
+    m_appendedBytes = data.size();
+    m_version = Version;
+}
+
+
+inline void CameraSetJournal::close()
+{
+    reset();
+    m_filename.clear();
+}
+
+
+inline uint64_t CameraSetJournal::Reader::integer()
+{
+    uint64_t val;
+    check( sizeof(uint64_t) );
+    std::memcpy( &val, m_pos, sizeof(uint64_t) );
+    m_pos += sizeof(uint64_t);
+    return val;
+}
+
+
+inline double CameraSetJournal::Reader::real()
+{
+    double val;
+    check( sizeof(double) );
+    std::memcpy( &val, m_pos, sizeof(double) );
+    m_pos += sizeof(double);
+    return val;
+}
+
+
+inline std::string CameraSetJournal::Reader::name( const uint64_t length )
+{
+    // padded to whole fields
+    uint64_t padded = ( length + 7 ) & ~static_cast<uint64_t>( 7 );
+    check( padded );
+    std::string result( m_pos, static_cast<size_t>( length ) );
+    m_pos += padded;
+    return result;
+}
+
+
+inline void CameraSetJournal::Reader::check( const uint64_t size ) const
+{
+    if( size > static_cast<uint64_t>( m_end - m_pos ) )
+        throw std::runtime_error( "CameraSetJournal::load: record is shorter than its contents." );
+}
+
+
+inline const char* CameraSetJournal::magic()
+{
+    return "IRISLOG";
+}
+
+
+inline uint32_t CameraSetJournal::byteOrder()
+{
+    return 0x01020304;
+}
+
+
+inline uint64_t CameraSetJournal::hash( const void* data, const size_t size, uint64_t h )
+{
+    const char* bytes = static_cast<const char*>( data );
+    size_t i = 0;
+    for( ; i+8<=size; i+=8 )
+    {
+        uint64_t word;
+        std::memcpy( &word, bytes + i, 8 );
+        h ^= word;
+        h *= 1099511628211ULL;
+    }
+    for( ; i<size; i++ )
+    {
+        h ^= static_cast<unsigned char>( bytes[i] );
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+
+template <typename T>
+inline uint64_t CameraSetJournal::detectionHash( const Pose<T>& pose )
+{
+    const Pattern<T>* pattern = pose.pattern.get();
+    size_t size = pose.correspondences.size();
+    uint64_t h = hash( &pattern, sizeof(pattern) );
+    h = hash( &pose.pointsMax, sizeof(size_t), h );
+    h = hash( &size, sizeof(size_t), h );
+    h = hash( pose.correspondences.x().data(), size*sizeof(T), h );
+    h = hash( pose.correspondences.y().data(), size*sizeof(T), h );
+    h = hash( pose.correspondences.weights().data(), size*sizeof(T), h );
+    return hash( pose.correspondences.indices().data(), size*sizeof(size_t), h );
+}
+
+
+template <typename T>
+inline uint64_t CameraSetJournal::resultHash( const Pose<T>& pose )
+{
+    size_t size = pose.projected2D.cols();
+    uint64_t h = hash( &pose.rejected, sizeof(bool) );
+    h = hash( pose.transformation.data(), 16*sizeof(T), h );
+    h = hash( &size, sizeof(size_t), h );
+    return hash( pose.projected2D.data(), 2*size*sizeof(T), h );
+}
+
+
+template <typename T>
+inline uint64_t CameraSetJournal::cameraHash( const Camera<T>& cam )
+{
+    uint64_t h = hash( cam.imageSize.data(), 2*sizeof(int) );
+    h = hash( cam.sensorSize.data(), 2*sizeof(T), h );
+    h = hash( cam.intrinsic.data(), 9*sizeof(T), h );
+    h = hash( &cam.error, sizeof(T), h );
+    return hash( cam.distortion.data(), cam.distortion.size()*sizeof(T), h );
+}
+
+
+inline size_t CameraSetJournal::beginRecord( std::vector<char>& data, const RecordType type )
+{
+    size_t start = data.size();
+    RecordHeader head;
+    head.type = type;
+    head.checksum = 0;
+    head.size = 0;
+    data.insert( data.end(), reinterpret_cast<const char*>( &head ), reinterpret_cast<const char*>( &head ) + sizeof(RecordHeader) );
+    return start;
+}
+
+
+inline void CameraSetJournal::endRecord( std::vector<char>& data, const size_t start )
+{
+    RecordHeader head;
+    std::memcpy( &head, &data[start], sizeof(RecordHeader) );
+    head.size = data.size() - start - sizeof(RecordHeader);
+    head.checksum = static_cast<uint32_t>( hash( data.data() + start + sizeof(RecordHeader), static_cast<size_t>( head.size ) ) );
+    std::memcpy( &data[start], &head, sizeof(RecordHeader) );
+}
+
+
+inline void CameraSetJournal::appendInteger( std::vector<char>& data, const uint64_t val )
+{
+    data.insert( data.end(), reinterpret_cast<const char*>( &val ), reinterpret_cast<const char*>( &val ) + sizeof(uint64_t) );
+}
+
+
+inline void CameraSetJournal::appendReal( std::vector<char>& data, const double val )
+{
+    data.insert( data.end(), reinterpret_cast<const char*>( &val ), reinterpret_cast<const char*>( &val ) + sizeof(double) );
+}
+
+
+inline void CameraSetJournal::appendName( std::vector<char>& data, const std::string& name )
+{
+    // padded to whole fields
+    appendInteger( data, name.size() );
+    data.insert( data.end(), name.begin(), name.end() );
+    data.resize( ( data.size() + 7 ) & ~static_cast<size_t>( 7 ), 0 );
+}
+
+
+template <typename T>
+inline void CameraSetJournal::appendChanges( std::vector<char>& data, const std::map< size_t, Camera<T> >& cameras )
+{
+    // fingerprints of a pose that was just added
+    const Pose<T> empty;
+    const uint64_t emptyDetection = detectionHash( empty );
+    const uint64_t emptyResult = resultHash( empty );
+
+    // new patterns first, poses refer to them
+    for( auto camIt=cameras.begin(); camIt != cameras.end(); camIt++ )
+    {
+        for( size_t p=0; p<camIt->second.poses.size(); p++ )
+        {
+            const std::shared_ptr< const Pattern<T> >& pattern = camIt->second.poses[p].pattern;
+            if( !pattern || m_patterns.count( pattern.get() ) > 0 )
+                continue;
+
+            PatternState& state = m_patterns[ pattern.get() ];
+            state.id = m_nextPattern++;
+            state.pattern = pattern;
+
+            size_t start = beginRecord( data, AddPattern );
+            appendInteger( data, state.id );
+            appendInteger( data, pattern->points.size() );
+            for( size_t i=0; i<pattern->points.size(); i++ )
+                for( int r=0; r<3; r++ )
+                    appendReal( data, static_cast<double>( pattern->points[i](r) ) );
+            endRecord( data, start );
+        }
+    }
+
+    // poses that are new or changed
+    std::unordered_map< size_t, PoseState > poses;
+    poses.reserve( m_poses.size() );
+    for( auto camIt=cameras.begin(); camIt != cameras.end(); camIt++ )
+    {
+        for( size_t p=0; p<camIt->second.poses.size(); p++ )
+        {
+            const Pose<T>& pose = camIt->second.poses[p];
+            auto it = m_poses.find( pose.id );
+            PoseState state;
+            if( it != m_poses.end() && it->second.camera == camIt->first )
+                state = it->second;
+            else
+            {
+                // moved to another camera, erase it there first
+                if( it != m_poses.end() )
+                {
+                    size_t start = beginRecord( data, ErasePose );
+                    appendInteger( data, pose.id );
+                    endRecord( data, start );
+                }
+
+                size_t start = beginRecord( data, AddPose );
+                appendInteger( data, pose.id );
+                appendInteger( data, camIt->first );
+                appendInteger( data, static_cast<uint64_t>( camIt->second.imageSize(0) ) );
+                appendInteger( data, static_cast<uint64_t>( camIt->second.imageSize(1) ) );
+                appendName( data, pose.name );
+                endRecord( data, start );
+
+                state.camera = camIt->first;
+                state.detection = emptyDetection;
+                state.result = emptyResult;
+                m_nextPoseId = std::max( m_nextPoseId, pose.id + 1 );
+            }
+
+            uint64_t detection = detectionHash( pose );
+            if( detection != state.detection )
+            {
+                size_t start = beginRecord( data, Detection );
+                appendInteger( data, pose.id );
+                appendInteger( data, pose.pattern ? m_patterns[ pose.pattern.get() ].id + 1 : 0 );
+                appendInteger( data, pose.pointsMax );
+                appendInteger( data, pose.correspondences.size() );
+                typename Correspondences<T>::ConstColumnMap x = pose.correspondences.x();
+                typename Correspondences<T>::ConstColumnMap y = pose.correspondences.y();
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                    appendReal( data, static_cast<double>( x(i) ) );
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                    appendReal( data, static_cast<double>( y(i) ) );
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                    appendInteger( data, pose.correspondences.index( i ) );
+                typename Correspondences<T>::ConstColumnMap w = pose.correspondences.weights();
+                for( size_t i=0; i<pose.correspondences.size(); i++ )
+                    appendReal( data, static_cast<double>( w(i) ) );
+                endRecord( data, start );
+                state.detection = detection;
+            }
+
+            uint64_t result = resultHash( pose );
+            if( result != state.result )
+            {
+                size_t start = beginRecord( data, PoseResult );
+                appendInteger( data, pose.id );
+                appendInteger( data, pose.rejected ? 1 : 0 );
+                for( int i=0; i<16; i++ )
+                    appendReal( data, static_cast<double>( pose.transformation.data()[i] ) );
+                appendInteger( data, pose.projected2D.cols() );
+                for( typename Correspondences<T>::Points::Index i=0; i<pose.projected2D.cols(); i++ )
+                {
+                    appendReal( data, static_cast<double>( pose.projected2D(0,i) ) );
+                    appendReal( data, static_cast<double>( pose.projected2D(1,i) ) );
+                }
+                endRecord( data, start );
+                state.result = result;
+            }
+
+            poses[ pose.id ] = state;
+        }
+    }
+
+    // poses that are gone
+    for( auto it=m_poses.begin(); it != m_poses.end(); it++ )
+    {
+        if( poses.count( it->first ) > 0 )
+            continue;
+        size_t start = beginRecord( data, ErasePose );
+        appendInteger( data, it->first );
+        endRecord( data, start );
+    }
+    m_poses.swap( poses );
+
+    // cameras last, their parameters win over the image size of a new pose
+    std::map< size_t, uint64_t > cameraStates;
+    for( auto camIt=cameras.begin(); camIt != cameras.end(); camIt++ )
+    {
+        const Camera<T>& cam = camIt->second;
+        uint64_t h = cameraHash( cam );
+        auto it = m_cameras.find( camIt->first );
+        if( it == m_cameras.end() || it->second != h )
+        {
+            size_t start = beginRecord( data, CameraResult );
+            appendInteger( data, camIt->first );
+            appendInteger( data, static_cast<uint64_t>( cam.imageSize(0) ) );
+            appendInteger( data, static_cast<uint64_t>( cam.imageSize(1) ) );
+            appendReal( data, static_cast<double>( cam.sensorSize(0) ) );
+            appendReal( data, static_cast<double>( cam.sensorSize(1) ) );
+            for( int i=0; i<9; i++ )
+                appendReal( data, static_cast<double>( cam.intrinsic.data()[i] ) );
+            appendReal( data, static_cast<double>( cam.error ) );
+            appendInteger( data, cam.distortion.size() );
+            for( size_t i=0; i<cam.distortion.size(); i++ )
+                appendReal( data, static_cast<double>( cam.distortion[i] ) );
+            endRecord( data, start );
+        }
+        cameraStates[ camIt->first ] = h;
+    }
+    for( auto it=m_cameras.begin(); it != m_cameras.end(); it++ )
+    {
+        if( cameraStates.count( it->first ) > 0 )
+            continue;
+        size_t start = beginRecord( data, EraseCamera );
+        appendInteger( data, it->first );
+        endRecord( data, start );
+    }
+    m_cameras.swap( cameraStates );
+}
+
+
+inline void CameraSetJournal::replaceFile( const std::string& filename, const std::vector<char>& data )
+{
+    // the old file stays valid until the new one is complete
+    std::string tmp = filename + ".tmp";
+    {
+        std::ofstream file( tmp.c_str(), std::ios::binary | std::ios::trunc );
+        if( file && data.size() > 0 )
+            file.write( data.data(), data.size() );
+        file.flush();
+        if( !file )
+        {
+            std::remove( tmp.c_str() );
+            throw std::runtime_error( "CameraSetJournal: could not write \"" + tmp + "\"." );
+        }
+    }
+
+#ifdef _WIN32
+    std::remove( filename.c_str() );
+#endif
+    if( std::rename( tmp.c_str(), filename.c_str() ) != 0 )
+        throw std::runtime_error( "CameraSetJournal: could not replace \"" + filename + "\"." );
+}
+
+
+inline void CameraSetJournal::reset()
+{
+    m_appendedBytes = 0;
+    m_nextPoseId = 0;
+    m_tornBytes = 0;
+    m_poses.clear();
+    m_cameras.clear();
+    m_patterns.clear();
+    m_nextPattern = 0;
+}
+
+
+} // end namespace iris
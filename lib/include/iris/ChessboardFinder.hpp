@@ -49,8 +49,15 @@ public:
     void setSubpixelCorner( bool val );
 
     virtual bool find( Pose_d& pose );
+    virtual bool find( Pose_f& pose );
+
+    virtual std::shared_ptr<Finder> clone() const;
 
 protected:
+    // detection in the precision of the pose
+    template <typename T>
+    bool findPose( Pose<T>& pose );
+
     int flags();
 
     int devideFactor( const cimg_library::CImg<uint8_t>& image );
@@ -66,6 +73,21 @@ protected:
     bool m_limitToLargeQuads;
     bool m_subpixelCorner;
 
+    // buffers reused from frame to frame, every instance has its own
+    struct Scratch
+    {
+        Scratch() {}
+        Scratch( const Scratch& ) {}
+        Scratch& operator =( const Scratch& ) { return *this; }
+
+        cv::Mat image;
+        cv::Mat scaled;
+        cv::Mat gray;
+        cimg_library::CImg<uint8_t> resized;
+        std::vector< cv::Point2f > corners;
+    };
+    Scratch m_scratch;
+
 };
 
 } // end namespace iris
@@ -0,0 +1,532 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * Correspondences.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <Eigen/Core>
+
+using std::ptrdiff_t;
+#include <opencv2/opencv.hpp>
+
+namespace iris
+{
+
+template <typename T>
+class Correspondences
+{
+///
+/// \file    Correspondences.hpp
+/// \class   Correspondences
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   2D points of a pose with their pattern indices and weights
+///
+/// \details Stored as structure of arrays: the x, y and weight columns lie
+///          in one buffer, each starting on an aligned boundary, the
+///          indices in a column of their own. x and y form the rows of a
+///          2xN row-major matrix, so a pose can be handed to Eigen or
+///          OpenCV as a whole without repacking (points(), mat()) and
+///          residuals against projections of the same layout are plain
+///          vectorizable expressions. Views are invalidated when the
+///          storage grows.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    // the buffer is only aligned if Eigen aligns its allocations
+#if defined(EIGEN_DONT_ALIGN) || ( defined(EIGEN_MAX_ALIGN_BYTES) && EIGEN_MAX_ALIGN_BYTES == 0 )
+    static const int MapAlignment = Eigen::Unaligned;
+#else
+    static const int MapAlignment = Eigen::Aligned;
+#endif
+
+    typedef Eigen::Matrix<T,2,1> Point;
+    typedef Eigen::Matrix<T,Eigen::Dynamic,1> Column;
+    typedef Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor> Points;
+    typedef Eigen::Map< Column, MapAlignment > ColumnMap;
+    typedef Eigen::Map< const Column, MapAlignment > ConstColumnMap;
+    typedef Eigen::Map< Points, MapAlignment, Eigen::OuterStride<> > PointsMap;
+    typedef Eigen::Map< const Points, MapAlignment, Eigen::OuterStride<> > ConstPointsMap;
+
+    // columns start on multiples of this many elements
+    static const size_t Alignment = 16;
+
+    Correspondences();
+    Correspondences( const Correspondences& c );
+
+    // the source is left empty
+    Correspondences( Correspondences&& c );
+
+    Correspondences& operator =( const Correspondences& c );
+    Correspondences& operator =( Correspondences&& c );
+
+    // size
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+    void clear();
+    void reserve( const size_t n );
+    void resize( const size_t n );
+
+    // add entries
+    void push_back( const Point& point, const size_t index, const T weight=T(1) );
+    template <typename S>
+    void assign( const std::vector< Eigen::Matrix<S,2,1> >& points, const std::vector<size_t>& indices );
+
+    // single entries
+    Point point( const size_t i ) const;
+    void setPoint( const size_t i, const Point& point );
+    size_t index( const size_t i ) const;
+    void setIndex( const size_t i, const size_t index );
+    T weight( const size_t i ) const;
+    void setWeight( const size_t i, const T weight );
+
+    // entries with a positive weight, rejected ones are kept with weight zero
+    size_t weightedCount() const;
+
+    // whole columns
+    ColumnMap x();
+    ConstColumnMap x() const;
+    ColumnMap y();
+    ConstColumnMap y() const;
+    ColumnMap weights();
+    ConstColumnMap weights() const;
+    const std::vector<size_t>& indices() const;
+
+    // x and y as rows of a 2xN matrix
+    PointsMap points();
+    ConstPointsMap points() const;
+
+    // the same as OpenCV matrix, sharing the memory
+    cv::Mat mat();
+
+    // copy of the points, for interfaces that expect them interleaved
+    std::vector<Point> toVector() const;
+
+    // copy in another scalar type
+    template <typename S>
+    Correspondences<S> cast() const;
+
+    // keep the entries whose mask is set, in order, returns the new size
+    size_t compact( const std::vector<bool>& mask );
+
+    bool operator ==( const Correspondences& c ) const;
+    bool operator !=( const Correspondences& c ) const;
+
+protected:
+    void reallocate( const size_t capacity );
+
+    T* column( const size_t c );
+    const T* column( const size_t c ) const;
+
+protected:
+    size_t m_size;
+    size_t m_capacity;
+    // x, y and weight columns of m_capacity elements each
+    Column m_data;
+    std::vector<size_t> m_indices;
+
+    template <typename S> friend class Correspondences;
+};
+
+
+template <typename T>
+const size_t Correspondences<T>::Alignment;
+
+
+template <typename T>
+inline Correspondences<T>::Correspondences() :
+    m_size( 0 ),
+    m_capacity( 0 )
+{
+}
+
+
+template <typename T>
+inline Correspondences<T>::Correspondences( const Correspondences& c ) :
+    m_size( c.m_size ),
+    m_capacity( c.m_capacity ),
+    m_data( c.m_data ),
+    m_indices( c.m_indices )
+{
+}
+
+
+template <typename T>
+inline Correspondences<T>::Correspondences( Correspondences&& c ) :
+    m_size( c.m_size ),
+    m_capacity( c.m_capacity )
+{
+    // swapping only exchanges the buffers
+    m_data.swap( c.m_data );
+    m_indices.swap( c.m_indices );
+    c.m_size = 0;
+    c.m_capacity = 0;
+}
+
+
+template <typename T>
+inline Correspondences<T>& Correspondences<T>::operator =( const Correspondences& c )
+{
+    m_size = c.m_size;
+    m_capacity = c.m_capacity;
+    m_data = c.m_data;
+    m_indices = c.m_indices;
+    return *this;
+}
+
+
+template <typename T>
+inline Correspondences<T>& Correspondences<T>::operator =( Correspondences&& c )
+{
+    if( this == &c )
+        return *this;
+
+    m_size = c.m_size;
+    m_capacity = c.m_capacity;
+    m_data.swap( c.m_data );
+    m_indices.swap( c.m_indices );
+
+    // the previous buffers are released
+    c.m_data.resize( 0 );
+    c.m_indices.clear();
+    c.m_size = 0;
+    c.m_capacity = 0;
+    return *this;
+}
+
+
+template <typename T>
+inline size_t Correspondences<T>::size() const
+{
+    return m_size;
+}
+
+
+template <typename T>
+inline bool Correspondences<T>::empty() const
+{
+    return m_size == 0;
+}
+
+
+template <typename T>
+inline size_t Correspondences<T>::capacity() const
+{
+    return m_capacity;
+}
+
+
+template <typename T>
+inline void Correspondences<T>::clear()
+{
+    m_size = 0;
+    m_indices.clear();
+}
+
+
+template <typename T>
+inline void Correspondences<T>::reserve( const size_t n )
+{
+    if( n > m_capacity )
+        reallocate( n );
+    m_indices.reserve( n );
+}
+
+
+template <typename T>
+inline void Correspondences<T>::resize( const size_t n )
+{
+    if( n > m_capacity )
+        reallocate( std::max( n, 2*m_capacity ) );
+
+    // new entries are at the origin with full weight
+    for( size_t i=m_size; i<n; i++ )
+    {
+        column( 0 )[i] = T(0);
+        column( 1 )[i] = T(0);
+        column( 2 )[i] = T(1);
+    }
+    m_indices.resize( n, 0 );
+    m_size = n;
+}
+
+
+template <typename T>
+inline void Correspondences<T>::push_back( const Point& point, const size_t index, const T weight )
+{
+    if( m_size == m_capacity )
+        reallocate( std::max( Alignment, 2*m_capacity ) );
+
+    column( 0 )[m_size] = point(0);
+    column( 1 )[m_size] = point(1);
+    column( 2 )[m_size] = weight;
+    m_indices.push_back( index );
+    m_size++;
+}
+
+
+template <typename T>
+template <typename S>
+inline void Correspondences<T>::assign( const std::vector< Eigen::Matrix<S,2,1> >& points, const std::vector<size_t>& indices )
+{
+    // indices missing at the end are taken as the position
+    clear();
+    reserve( points.size() );
+    for( size_t i=0; i<points.size(); i++ )
+        push_back( points[i].template cast<T>(), i < indices.size() ? indices[i] : i );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::Point Correspondences<T>::point( const size_t i ) const
+{
+    return Point( column( 0 )[i], column( 1 )[i] );
+}
+
+
+template <typename T>
+inline void Correspondences<T>::setPoint( const size_t i, const Point& point )
+{
+    column( 0 )[i] = point(0);
+    column( 1 )[i] = point(1);
+}
+
+
+template <typename T>
+inline size_t Correspondences<T>::index( const size_t i ) const
+{
+    return m_indices[i];
+}
+
+
+template <typename T>
+inline void Correspondences<T>::setIndex( const size_t i, const size_t index )
+{
+    m_indices[i] = index;
+}
+
+
+template <typename T>
+inline T Correspondences<T>::weight( const size_t i ) const
+{
+    return column( 2 )[i];
+}
+
+
+template <typename T>
+inline void Correspondences<T>::setWeight( const size_t i, const T weight )
+{
+    column( 2 )[i] = weight;
+}
+
+
+template <typename T>
+inline size_t Correspondences<T>::weightedCount() const
+{
+    return static_cast<size_t>( ( weights().array() > T(0) ).count() );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ColumnMap Correspondences<T>::x()
+{
+    return ColumnMap( column( 0 ), m_size );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ConstColumnMap Correspondences<T>::x() const
+{
+    return ConstColumnMap( column( 0 ), m_size );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ColumnMap Correspondences<T>::y()
+{
+    return ColumnMap( column( 1 ), m_size );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ConstColumnMap Correspondences<T>::y() const
+{
+    return ConstColumnMap( column( 1 ), m_size );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ColumnMap Correspondences<T>::weights()
+{
+    return ColumnMap( column( 2 ), m_size );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ConstColumnMap Correspondences<T>::weights() const
+{
+    return ConstColumnMap( column( 2 ), m_size );
+}
+
+
+template <typename T>
+inline const std::vector<size_t>& Correspondences<T>::indices() const
+{
+    return m_indices;
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::PointsMap Correspondences<T>::points()
+{
+    return PointsMap( column( 0 ), 2, m_size, Eigen::OuterStride<>( std::max<size_t>( m_capacity, 1 ) ) );
+}
+
+
+template <typename T>
+inline typename Correspondences<T>::ConstPointsMap Correspondences<T>::points() const
+{
+    return ConstPointsMap( column( 0 ), 2, m_size, Eigen::OuterStride<>( std::max<size_t>( m_capacity, 1 ) ) );
+}
+
+
+template <typename T>
+inline cv::Mat Correspondences<T>::mat()
+{
+    if( m_size == 0 )
+        return cv::Mat();
+    return cv::Mat( 2, static_cast<int>( m_size ), cv::DataType<T>::type, column( 0 ), m_capacity*sizeof(T) );
+}
+
+
+template <typename T>
+inline std::vector<typename Correspondences<T>::Point> Correspondences<T>::toVector() const
+{
+    std::vector<Point> result( m_size );
+    for( size_t i=0; i<m_size; i++ )
+        result[i] = point( i );
+    return result;
+}
+
+
+template <typename T>
+template <typename S>
+inline Correspondences<S> Correspondences<T>::cast() const
+{
+    // same layout, converted column by column
+    Correspondences<S> result;
+    result.reserve( m_size );
+    for( size_t c=0; c<3; c++ )
+        for( size_t i=0; i<m_size; i++ )
+            result.column( c )[i] = static_cast<S>( column( c )[i] );
+    result.m_indices = m_indices;
+    result.m_size = m_size;
+
+    return result;
+}
+
+
+template <typename T>
+inline size_t Correspondences<T>::compact( const std::vector<bool>& mask )
+{
+    size_t j = 0;
+    for( size_t i=0; i<m_size && i<mask.size(); i++ )
+    {
+        if( !mask[i] )
+            continue;
+
+        if( i != j )
+        {
+            for( size_t c=0; c<3; c++ )
+                column( c )[j] = column( c )[i];
+            m_indices[j] = m_indices[i];
+        }
+        j++;
+    }
+    m_size = j;
+    m_indices.resize( j );
+
+    return j;
+}
+
+
+template <typename T>
+inline bool Correspondences<T>::operator ==( const Correspondences& c ) const
+{
+    return m_size == c.m_size &&
+           m_indices == c.m_indices &&
+           std::equal( column( 0 ), column( 0 ) + m_size, c.column( 0 ) ) &&
+           std::equal( column( 1 ), column( 1 ) + m_size, c.column( 1 ) ) &&
+           std::equal( column( 2 ), column( 2 ) + m_size, c.column( 2 ) );
+}
+
+
+template <typename T>
+inline bool Correspondences<T>::operator !=( const Correspondences& c ) const
+{
+    return !( *this == c );
+}
+
+
+template <typename T>
+inline void Correspondences<T>::reallocate( const size_t capacity )
+{
+    // round up, so that every column starts aligned
+    size_t aligned = ( ( capacity + Alignment - 1 ) / Alignment ) * Alignment;
+    Column data( 3*aligned );
+    for( size_t c=0; c<3; c++ )
+        std::copy( column( c ), column( c ) + m_size, data.data() + c*aligned );
+
+    m_data.swap( data );
+    m_capacity = aligned;
+}
+
+
+template <typename T>
+inline T* Correspondences<T>::column( const size_t c )
+{
+    return m_data.data() + c*m_capacity;
+}
+
+
+template <typename T>
+inline const T* Correspondences<T>::column( const size_t c ) const
+{
+    return m_data.data() + c*m_capacity;
+}
+
+
+} // end namespace iris
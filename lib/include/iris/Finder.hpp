@@ -49,13 +49,34 @@ public:
 
     void setScale( double scale );
 
+    // geometry of the configured pattern, shared by all poses found with it
+    std::shared_ptr<const Pattern_d> pattern() const;
+
+    // subclasses overriding only one of the overloads pull in the other
+    // with "using Finder::find;", otherwise it is hidden
     virtual bool find( Pose_d& pose ) = 0;
 
+    // by default detects in double precision and converts the result
+    virtual bool find( Pose_f& pose );
+
+    // instance for another thread, the configuration is shared, buffers are not;
+    // null by default, the finder is then only used from one thread at a time
+    virtual std::shared_ptr<Finder> clone() const;
+
+protected:
+    // set the pattern, the single precision copy is derived from it
+    void setPattern( const std::shared_ptr<const Pattern_d>& pattern );
+
+    // the pattern in the precision of the pose
+    const std::shared_ptr<const Pattern_d>& sharedPattern( const Pose_d& pose ) const;
+    const std::shared_ptr<const Pattern_f>& sharedPattern( const Pose_f& pose ) const;
+
 protected:
     bool m_configured;
     bool m_useOpenMP;
     double m_scale;
-    std::vector<Eigen::Vector3d> m_points3D;
+    std::shared_ptr<const Pattern_d> m_pattern;
+    std::shared_ptr<const Pattern_f> m_patternFloat;
     std::vector<size_t> m_indices;
 };
 
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * FrameSource.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <iris/CameraSet.hpp>
+#include <iris/Finder.hpp>
+
+namespace iris
+{
+
+class FrameSource
+{
+///
+/// \file    FrameSource.hpp
+/// \class   FrameSource
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Candidate frames from a video file or an image directory
+///
+/// \details Frames are decoded on a background thread into a bounded queue.
+///          A frame only becomes a candidate if it is still (little motion
+///          with respect to the previous frame, so it is not blurred) and
+///          novel (enough change with respect to the last candidate). Both
+///          are measured as mean absolute difference of small grayscale
+///          thumbnails. process() runs the finder on the candidates and only
+///          adds poses whose detected points moved far enough.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    FrameSource();
+    virtual ~FrameSource();
+
+    void setQueueSize( size_t val );
+    void setStride( size_t val );
+    void setThumbnailWidth( int val );
+    void setMaxMotion( double val );
+    void setMinNovelty( double val );
+    void setMinPoseNovelty( double val );
+
+    // open a video file or a directory of images and start decoding
+    void open( const std::string& path );
+    void close();
+    bool isOpen() const;
+
+    // next candidate frame, blocks until there is one, false at the end;
+    // rethrows what stopped the decoder
+    bool next( std::shared_ptr< cimg_library::CImg<uint8_t> >& image, std::string& name );
+
+    // detect the pattern in all candidates and add the novel poses to the set,
+    // with their detections
+    size_t process( CameraSet_d& cs, Finder& finder, const size_t cameraID=0 );
+
+    // statistics
+    size_t decodedFrames() const;
+    size_t candidateFrames() const;
+
+protected:
+    void decode();
+    void decodeFrames();
+    bool read( cv::Mat& frame );
+    bool isCandidate( const cv::Mat& frame );
+    bool isNovel( const Pose_d& pose );
+
+protected:
+    // settings
+    size_t m_queueSize;
+    size_t m_stride;
+    int m_thumbnailWidth;
+    double m_maxMotion;
+    double m_minNovelty;
+    double m_minPoseNovelty;
+
+    // input, only touched by the decoding thread once opened
+    std::string m_stem;
+    cv::VideoCapture m_capture;
+    std::vector<std::string> m_files;
+    size_t m_frameIndex;
+    cv::Mat m_previous;
+    cv::Mat m_lastCandidate;
+
+    // points of the last added pose, by point index
+    std::map< size_t, Eigen::Vector2d > m_lastPoints;
+
+    // queue of candidates
+    struct Frame
+    {
+        std::shared_ptr< cimg_library::CImg<uint8_t> > image;
+        std::string name;
+    };
+    std::deque<Frame> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::thread m_thread;
+    bool m_open;
+    std::atomic<bool> m_stop;
+    bool m_finished;
+    std::exception_ptr m_error;
+
+    // statistics
+    std::atomic<size_t> m_decodedFrames;
+    std::atomic<size_t> m_candidateFrames;
+};
+
+} // end namespace iris
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * Initialization.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iris/TaskPool.hpp>
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class Initialization
+{
+///
+/// \file    Initialization.hpp
+/// \class   Initialization
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Closed-form initialization of intrinsics and poses
+///
+/// \details Computes a homography from the planar pattern to the image for
+///          every pose (in parallel), solves Zhang's closed-form system for
+///          the intrinsics (zero skew) and decomposes each homography into
+///          a pose, which is then refined with a few Gauss-Newton steps on
+///          the reprojection error. The result is a starting point for the
+///          nonlinear refinement, distortion is assumed to be zero.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    Initialization();
+    virtual ~Initialization();
+
+    void setFixAspectRatio( bool val );
+    void setFixPrincipalPoint( bool val );
+    void setPoseRefinement( size_t iterations );
+
+    // runs the per pose loops, TaskPool::shared() by default
+    void setTaskPool( std::shared_ptr<TaskPool> pool );
+
+    // homography per pose, zero if the pose has too few or non-planar points
+    std::vector<Eigen::Matrix3d> homographies( const CameraView_d& view ) const;
+
+    // Zhang's closed-form intrinsics, false if the views are degenerate
+    bool intrinsics( const std::vector<Eigen::Matrix3d>& homographies, const Eigen::Vector2i& imageSize, Eigen::Matrix3d& K ) const;
+
+    // pose of a planar pattern from its homography
+    Eigen::Matrix4d pose( const Eigen::Matrix3d& K, const Eigen::Matrix3d& H, const Pose_d& pose ) const;
+
+    // initialize the intrinsics and pose transformations of the viewed poses
+    bool initialize( CameraView_d& view ) const;
+
+    // initialize the intrinsics and all pose transformations of a camera
+    bool initialize( Camera_d& cam ) const;
+
+protected:
+    bool m_fixAspectRatio;
+    bool m_fixPrincipalPoint;
+    size_t m_poseRefinement;
+    std::shared_ptr<TaskPool> m_taskPool;
+};
+
+} // end namespace iris
@@ -29,6 +29,8 @@
  */
 
 #include <iris/CameraCalibration.hpp>
+#include <iris/Initialization.hpp>
+#include <iris/OutlierRejection.hpp>
 
 namespace iris {
 
@@ -43,16 +45,34 @@ public:
     void setTangentialDistortion( bool val );
     void setMinCorrespondences( size_t val );
     void setIntrinsicGuess( bool val );
+    void setRejectOutliers( bool val );
+    // start the solver from a closed-form guess, off by default
+    void setClosedFormInitialization( bool val );
+
+    virtual void setTaskPool( std::shared_ptr<TaskPool> pool );
+
+    // outlier rejection settings and the result of the last run
+    OutlierRejection& outlierRejection();
+    const OutlierRejection::Report& outlierReport() const;
+
+    // closed-form initialization settings
+    Initialization& initialization();
 
  protected:
-    std::vector< Eigen::Vector2d > projectPoints( const std::vector<cv::Point3f> points3D,
-                                                  const cv::Mat& rot,
-                                                  const cv::Mat& transl,
-                                                  const cv::Mat& cameraMatrix,
-                                                  const cv::Mat& distCoeff );
+    Correspondences<double>::Points projectPoints( const std::vector<cv::Point3f> points3D,
+                                                   const cv::Mat& rot,
+                                                   const cv::Mat& transl,
+                                                   const cv::Mat& cameraMatrix,
+                                                   const cv::Mat& distCoeff );
 
     virtual int flags() = 0;
 
+    // closed-form intrinsic guess, false if there is none
+    bool initialize( CameraView_d& view ) const;
+
+    // only the intrinsics of the guess, the view is left as it is
+    bool initialize( const CameraView_d& view, Eigen::Matrix3d& K ) const;
+
 protected:
     bool m_fixPrincipalPoint;
     bool m_fixAspectRatio;
@@ -60,6 +80,15 @@ protected:
     bool m_intrinsicGuess;
     size_t m_minPoseCorrespondences;
 
+    // outlier rejection
+    bool m_rejectOutliers;
+    OutlierRejection m_outlierRejection;
+    OutlierRejection::Report m_outlierReport;
+
+    // closed-form initialization
+    bool m_closedFormInitialization;
+    Initialization m_initialization;
+
 };
 
 } // end namespace iris
@@ -29,6 +29,7 @@
  */
 
 #include <iris/OpenCVCalibration.hpp>
+#include <iris/PoseSelection.hpp>
 
 namespace iris {
 
@@ -42,15 +43,24 @@ public:
                     bool fixAspectRatio,
                     bool tangentialDistortion );
 
+    // limit the number of poses used for solving (0 means all)
+    void setMaxPoses( size_t val );
+
+    virtual void setTaskPool( std::shared_ptr<TaskPool> pool );
+
+    using OpenCVCalibration::calibrate;
     virtual void calibrate( CameraSet_d& cs );
 
  protected:
-    void calibrateCamera( Camera_d &cam, int flags );
+    void calibrateCamera( CameraView_d& view, int flags );
 
     virtual void filter( CameraSet_d& cs );
 
     virtual int flags();
 
+protected:
+    PoseSelection m_poseSelection;
+
 };
 
 } // end namespace iris
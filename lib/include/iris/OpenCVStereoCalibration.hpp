@@ -42,15 +42,19 @@ public:
     void setSameFocalLength( bool val );
     void setFixIntrinsic( bool val );
 
+    using OpenCVCalibration::calibrate;
     virtual void calibrate( CameraSet_d& cs );
 
 protected:
-    void stereoCalibrate( iris::Camera_d& cam1, iris::Camera_d& cam2 );
+    void stereoCalibrate( iris::CameraView_d& cam1, iris::CameraView_d& cam2, int flags );
 
     virtual void filter( CameraSet_d& cs );
 
     bool checkFrame( const iris::Pose_d& cam1, const iris::Pose_d& cam2 );
 
+    // remove points that are outliers in either view, by RANSAC or by residuals
+    OutlierRejection::Report rejectOutliers( iris::CameraView_d& cam1, iris::CameraView_d& cam2, bool residuals );
+
     virtual int flags();
 
 protected:
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * OutlierRejection.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iris/TaskPool.hpp>
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class OutlierRejection
+{
+///
+/// \file    OutlierRejection.hpp
+/// \class   OutlierRejection
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Rejects bad correspondences between detection and solving
+///
+/// \details Optionally, each pose is first verified on its own: a RANSAC
+///          homography between the (planar) pattern and the image, with
+///          adaptive early termination, marks the points that do not fit.
+///          A homography ignores the lens distortion, so its threshold is
+///          relative to the image diagonal and the check is off by
+///          default. After a first solve, points whose reprojection
+///          residual is far above the camera's median residual are trimmed
+///          as well. Rejected points keep their detection but get a weight
+///          of zero, the solvers only use points with a positive weight.
+///          Poses left with too few of those are dropped from the view.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    class Report
+    {
+    public:
+        Report() : pointsRemoved(0), posesRemoved(0) {}
+
+        void operator +=( const Report& r )
+        {
+            pointsRemoved += r.pointsRemoved;
+            posesRemoved += r.posesRemoved;
+        }
+
+        size_t pointsRemoved;
+        size_t posesRemoved;
+    };
+
+public:
+    OutlierRejection();
+    virtual ~OutlierRejection();
+
+    // homography check before the first solve, off by default
+    void setHomographyCheck( bool val );
+
+    // RANSAC inlier threshold as a fraction of the image diagonal
+    void setRansacThreshold( double val );
+    void setConfidence( double val );
+    void setMaxIterations( size_t val );
+    void setResidualFactor( double val );
+    void setMinResidual( double val );
+    void setMaxTrimIterations( size_t val );
+    void setMinPoints( size_t val );
+
+    // runs the per pose loops, TaskPool::shared() by default
+    void setTaskPool( std::shared_ptr<TaskPool> pool );
+
+    bool homographyCheck() const;
+    size_t maxTrimIterations() const;
+    size_t minPoints() const;
+
+    // RANSAC inlier threshold in pixels for images of the given size
+    double ransacThreshold( const Eigen::Vector2i& imageSize ) const;
+
+    // RANSAC homography inlier mask of a pose (all true if it can't be verified)
+    std::vector<bool> inliers( const Pose_d& pose, const Eigen::Vector2i& imageSize ) const;
+
+    // residual inlier mask of a solved pose
+    std::vector<bool> inliers( const Pose_d& pose, double threshold ) const;
+
+    // residual threshold for the solved poses of a camera
+    double threshold( const CameraView_d& view ) const;
+
+    // verify all poses of a camera in parallel, nothing happens unless the
+    // homography check is on
+    Report verify( CameraView_d& view ) const;
+
+    // trim the solved poses of a camera by their residuals
+    Report trim( CameraView_d& view ) const;
+
+    // zero the weights of the points that are not kept, returns the number
+    // of points newly rejected
+    static size_t rejectPoints( Pose_d& pose, const std::vector<bool>& keep );
+
+protected:
+    // drop poses with too few weighted points left from the view
+    size_t removePoses( CameraView_d& view ) const;
+
+protected:
+    bool m_homographyCheck;
+    double m_ransacThreshold;
+    double m_confidence;
+    size_t m_maxIterations;
+    double m_residualFactor;
+    double m_minResidual;
+    size_t m_maxTrimIterations;
+    size_t m_minPoints;
+    std::shared_ptr<TaskPool> m_taskPool;
+};
+
+} // end namespace iris
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * PoseSelection.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iris/TaskPool.hpp>
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class PoseSelection
+{
+///
+/// \file    PoseSelection.hpp
+/// \class   PoseSelection
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Greedy selection of an information-rich subset of poses
+///
+/// \details Scores the poses of a camera by how much new image area they
+///          cover (spatial binning), how much they add to the spread of the
+///          pattern plane normals (log-determinant of the accumulated normal
+///          information matrix) and how many points they carry. Points
+///          rejected with a weight of zero are left out of all three. The
+///          best poses are picked greedily until the configured maximum is
+///          reached.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    PoseSelection();
+    virtual ~PoseSelection();
+
+    void setMaxPoses( size_t val );
+    void setGridSize( size_t val );
+    void setCoverageWeight( double val );
+    void setTiltWeight( double val );
+    void setCountWeight( double val );
+
+    // runs the per pose loops, TaskPool::shared() by default
+    void setTaskPool( std::shared_ptr<TaskPool> pool );
+
+    size_t maxPoses() const;
+
+    // returns the indices (into the view) of the selected poses, sorted
+    std::vector<size_t> select( const CameraView_d& view ) const;
+
+protected:
+    // bins of the image grid hit by the pose's points
+    std::vector<size_t> bins( const Eigen::Vector2i& imageSize, const Pose_d& pose ) const;
+
+    // normal of the pattern plane in camera coordinates
+    Eigen::Vector3d planeNormal( const Eigen::Matrix3d& K, const Pose_d& pose ) const;
+
+protected:
+    size_t m_maxPoses;
+    size_t m_gridSize;
+    double m_coverageWeight;
+    double m_tiltWeight;
+    double m_countWeight;
+    std::shared_ptr<TaskPool> m_taskPool;
+};
+
+} // end namespace iris
@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * Progress.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class Progress
+{
+///
+/// \file    Progress.hpp
+/// \class   Progress
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Progress and metrics of a long running operation
+///
+/// \details An operation runs in stages with a known number of steps.
+///          Workers count steps and metrics with relaxed atomic increments,
+///          no lock is taken. A sink receives a report at most once per
+///          interval, from whichever worker notices the interval is over
+///          first, and never from two threads at once. The clock is only
+///          looked at every 1/128th of a stage. Without a sink the
+///          counters can be polled from any thread.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    enum Metric
+    {
+        PosesDetected = 0,
+        PosesFound,
+        PointsRemoved,
+        PosesRemoved,
+        MetricCount
+    };
+
+    // receives the reports, one at a time
+    class Sink
+    {
+    public:
+        virtual ~Sink() {}
+
+        virtual void report( const Progress& progress ) = 0;
+
+        // the stage is complete, reports it by default
+        virtual void finish( const Progress& progress ) { report( progress ); }
+    };
+
+    // progress bar on the console
+    class ConsoleSink : public Sink
+    {
+    public:
+        virtual void report( const Progress& progress );
+        virtual void finish( const Progress& progress );
+    };
+
+    // swallows everything
+    class NullSink : public Sink
+    {
+    public:
+        virtual void report( const Progress& ) {}
+    };
+
+public:
+    Progress( std::shared_ptr<Sink> sink=std::shared_ptr<Sink>(), std::chrono::milliseconds interval=std::chrono::milliseconds( 100 ) );
+    virtual ~Progress();
+
+    // set before a stage begins
+    void setSink( std::shared_ptr<Sink> sink );
+    void setInterval( std::chrono::milliseconds interval );
+
+    // start a stage, the metrics keep counting
+    void begin( const std::string& stage, size_t steps );
+
+    // a relaxed increment, rarely followed by a report
+    void step( size_t count=1 );
+
+    // report the stage unthrottled
+    void finish();
+
+    void add( Metric metric, size_t count );
+
+    // zero the metrics, before an operation starts
+    void reset();
+
+    // polling, from any thread
+    std::string stage() const;
+    size_t steps() const;
+    size_t done() const;
+    size_t metric( Metric metric ) const;
+
+protected:
+    // report if the interval is over and nobody else is reporting
+    void check();
+
+private:
+    // not copyable
+    Progress( const Progress& );
+    Progress& operator =( const Progress& );
+
+protected:
+    std::shared_ptr<Sink> m_sink;
+    std::chrono::milliseconds m_interval;
+
+    // the stage name is only written between stages
+    mutable std::mutex m_stageMutex;
+    std::string m_stage;
+
+    std::atomic<size_t> m_steps;
+    std::atomic<size_t> m_done;
+    std::atomic<size_t> m_metrics[MetricCount];
+
+    // step count at which to look at the clock next
+    std::atomic<size_t> m_nextCheck;
+    size_t m_checkStride;
+    std::chrono::steady_clock::time_point m_nextReport;
+    std::atomic_flag m_reporting;
+};
+
+
+/////
+// Implementation
+///
+
+inline void Progress::ConsoleSink::report( const Progress& progress )
+{
+    // assemble the progressbar
+    size_t steps = std::max<size_t>( progress.steps(), 1 );
+    size_t done = std::min( progress.done(), progress.steps() );
+    size_t pc = ( 100 * done ) / steps;
+    std::string pb = " [";
+    for( size_t i=0; i<20; i++ )
+        pb += ( (i*100)/20 <= pc ) ? "#" : " ";
+    pb += "] " + toString( pc ) + " (" + toString( done ) + "/" + toString( progress.steps() ) + ")";
+
+    std::cout << '\r' << progress.stage() << pb;
+    std::cout.flush();
+}
+
+
+inline void Progress::ConsoleSink::finish( const Progress& progress )
+{
+    report( progress );
+    std::cout << std::endl;
+}
+
+
+inline Progress::Progress( std::shared_ptr<Sink> sink, std::chrono::milliseconds interval ) :
+    m_sink( sink ),
+    m_interval( interval ),
+    m_steps( 0 ),
+    m_done( 0 ),
+    m_nextCheck( std::numeric_limits<size_t>::max() ),
+    m_checkStride( 1 )
+{
+    reset();
+    m_reporting.clear();
+}
+
+
+inline Progress::~Progress()
+{
+}
+
+
+inline void Progress::setSink( std::shared_ptr<Sink> sink )
+{
+    m_sink = sink;
+}
+
+
+inline void Progress::setInterval( std::chrono::milliseconds interval )
+{
+    m_interval = interval;
+}
+
+
+inline void Progress::begin( const std::string& stage, size_t steps )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_stageMutex );
+        m_stage = stage;
+    }
+    m_steps = steps;
+    m_done = 0;
+
+    // without a sink there is nothing to check
+    m_checkStride = std::max<size_t>( steps / 128, 1 );
+    m_nextCheck = m_sink ? 0 : std::numeric_limits<size_t>::max();
+    m_nextReport = std::chrono::steady_clock::now();
+    check();
+}
+
+
+inline void Progress::step( size_t count )
+{
+    size_t done = m_done.fetch_add( count, std::memory_order_relaxed ) + count;
+    if( done >= m_nextCheck.load( std::memory_order_relaxed ) )
+        check();
+}
+
+
+inline void Progress::finish()
+{
+    m_nextCheck = std::numeric_limits<size_t>::max();
+    if( !m_sink )
+        return;
+
+    // wait for a report in flight
+    while( m_reporting.test_and_set( std::memory_order_acquire ) )
+        std::this_thread::yield();
+    m_sink->finish( *this );
+    m_reporting.clear( std::memory_order_release );
+}
+
+
+inline void Progress::add( Metric metric, size_t count )
+{
+    m_metrics[metric].fetch_add( count, std::memory_order_relaxed );
+}
+
+
+inline void Progress::reset()
+{
+    for( size_t m=0; m<MetricCount; m++ )
+        m_metrics[m] = 0;
+}
+
+
+inline std::string Progress::stage() const
+{
+    std::lock_guard<std::mutex> lock( m_stageMutex );
+    return m_stage;
+}
+
+
+inline size_t Progress::steps() const
+{
+    return m_steps.load( std::memory_order_relaxed );
+}
+
+
+inline size_t Progress::done() const
+{
+    return m_done.load( std::memory_order_relaxed );
+}
+
+
+inline size_t Progress::metric( Metric metric ) const
+{
+    return m_metrics[metric].load( std::memory_order_relaxed );
+}
+
+
+inline void Progress::check()
+{
+    // somebody else is at it
+    if( !m_sink || m_reporting.test_and_set( std::memory_order_acquire ) )
+        return;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if( now >= m_nextReport )
+    {
+        m_sink->report( *this );
+        m_nextReport = now + m_interval;
+    }
+    m_nextCheck.store( done() + m_checkStride, std::memory_order_relaxed );
+
+    m_reporting.clear( std::memory_order_release );
+}
+
+
+} // end namespace iris
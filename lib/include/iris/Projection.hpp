@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * Projection.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+/////
+// Camera models
+//
+// A model maps normalized image coordinates (x/z, y/z) to pixels and provides
+// the derivatives of that mapping with respect to its parameters and to the
+// normalized coordinates. The rigid transformation and the perspective
+// division are shared by all models and live in the batch functions below.
+///
+
+/////
+// Pinhole, no distortion (fx, fy, cx, cy)
+///
+template <typename T>
+class PinholeModel
+{
+public:
+    typedef T Scalar;
+    enum { ParamCount = 4 };
+
+    static inline void params( const Camera<T>& cam, T* p )
+    {
+        p[0] = cam.intrinsic(0,0);
+        p[1] = cam.intrinsic(1,1);
+        p[2] = cam.intrinsic(0,2);
+        p[3] = cam.intrinsic(1,2);
+    }
+
+    static inline void project( const T* p, const T x, const T y, T& u, T& v )
+    {
+        u = p[0]*x + p[2];
+        v = p[1]*y + p[3];
+    }
+
+    // whole columns at once, u and v are written
+    template <typename X, typename Y, typename U, typename V>
+    static inline void project( const T* p,
+                                const Eigen::ArrayBase<X>& x, const Eigen::ArrayBase<Y>& y,
+                                const Eigen::ArrayBase<U>& u, const Eigen::ArrayBase<V>& v )
+    {
+        u.const_cast_derived() = p[0]*x + p[2];
+        v.const_cast_derived() = p[1]*y + p[3];
+    }
+
+    static inline void project( const T* p, const T x, const T y, T& u, T& v,
+                                Eigen::Matrix<T,2,ParamCount>& dParams,
+                                Eigen::Matrix<T,2,2>& dNormalized )
+    {
+        project( p, x, y, u, v );
+        dParams << x, 0, 1, 0,
+                   0, y, 0, 1;
+        dNormalized << p[0], 0,
+                       0, p[1];
+    }
+};
+
+
+/////
+// Pinhole with radial (k1, k2, k3) and tangential (p1, p2) distortion,
+// parameters ordered as fx, fy, cx, cy followed by Camera::distortion
+// (k1, k2, p1, p2, k3), the same convention OpenCV uses.
+///
+template <typename T>
+class RadialTangentialModel
+{
+public:
+    typedef T Scalar;
+    enum { ParamCount = 9 };
+
+    static inline void params( const Camera<T>& cam, T* p )
+    {
+        PinholeModel<T>::params( cam, p );
+        for( size_t i=0; i<5; i++ )
+            p[4+i] = ( i < cam.distortion.size() ) ? cam.distortion[i] : static_cast<T>(0);
+    }
+
+    static inline void project( const T* p, const T x, const T y, T& u, T& v )
+    {
+        const T r2 = x*x + y*y;
+        const T radial = 1 + r2*( p[4] + r2*( p[5] + r2*p[8] ) );
+        const T xy = x*y;
+        const T xd = x*radial + 2*p[6]*xy + p[7]*( r2 + 2*x*x );
+        const T yd = y*radial + p[6]*( r2 + 2*y*y ) + 2*p[7]*xy;
+        u = p[0]*xd + p[2];
+        v = p[1]*yd + p[3];
+    }
+
+    // whole columns at once, u and v are written
+    template <typename X, typename Y, typename U, typename V>
+    static inline void project( const T* p,
+                                const Eigen::ArrayBase<X>& x, const Eigen::ArrayBase<Y>& y,
+                                const Eigen::ArrayBase<U>& u, const Eigen::ArrayBase<V>& v )
+    {
+        typedef Eigen::Array<T,Eigen::Dynamic,1> Column;
+        const T two = static_cast<T>(2);
+        const Column r2 = x.square() + y.square();
+        const Column radial = static_cast<T>(1) + r2*( p[4] + r2*( p[5] + r2*p[8] ) );
+        const Column xy = x*y;
+        u.const_cast_derived() = p[0]*( x*radial + two*p[6]*xy + p[7]*( r2 + two*x.square() ) ) + p[2];
+        v.const_cast_derived() = p[1]*( y*radial + p[6]*( r2 + two*y.square() ) + two*p[7]*xy ) + p[3];
+    }
+
+    static inline void project( const T* p, const T x, const T y, T& u, T& v,
+                                Eigen::Matrix<T,2,ParamCount>& dParams,
+                                Eigen::Matrix<T,2,2>& dNormalized )
+    {
+        // distort
+        const T r2 = x*x + y*y;
+        const T r4 = r2*r2;
+        const T r6 = r4*r2;
+        const T radial = 1 + p[4]*r2 + p[5]*r4 + p[8]*r6;
+        const T dRadial = p[4] + 2*p[5]*r2 + 3*p[8]*r4; // d radial / d r2
+        const T xy = x*y;
+        const T xd = x*radial + 2*p[6]*xy + p[7]*( r2 + 2*x*x );
+        const T yd = y*radial + p[6]*( r2 + 2*y*y ) + 2*p[7]*xy;
+        u = p[0]*xd + p[2];
+        v = p[1]*yd + p[3];
+
+        // derivatives w.r.t. fx fy cx cy k1 k2 p1 p2 k3
+        dParams << xd, 0, 1, 0, p[0]*x*r2, p[0]*x*r4, p[0]*2*xy,            p[0]*(r2 + 2*x*x), p[0]*x*r6,
+                   0, yd, 0, 1, p[1]*y*r2, p[1]*y*r4, p[1]*(r2 + 2*y*y),    p[1]*2*xy,         p[1]*y*r6;
+
+        // derivatives w.r.t. the normalized coordinates
+        const T cross = 2*xy*dRadial + 2*p[6]*x + 2*p[7]*y;
+        dNormalized << p[0]*( radial + 2*x*x*dRadial + 2*p[6]*y + 6*p[7]*x ), p[0]*cross,
+                       p[1]*cross, p[1]*( radial + 2*y*y*dRadial + 6*p[6]*y + 2*p[7]*x );
+    }
+};
+
+
+/////
+// Batch projection
+//
+// points3D is a 3xN matrix (or a map of one), x and y are the pixel columns
+// of the result and have to hold N entries already, e.g. the x() and y()
+// maps of Correspondences or the transposed rows of Correspondences::Points.
+///
+template <typename Model, typename Points3D, typename X, typename Y>
+inline void project( const typename Model::Scalar* params,
+                     const Eigen::Matrix<typename Model::Scalar,4,4>& transformation,
+                     const Eigen::MatrixBase<Points3D>& points3D,
+                     const Eigen::MatrixBase<X>& x,
+                     const Eigen::MatrixBase<Y>& y )
+{
+    typedef typename Model::Scalar T;
+    typedef Eigen::Array<T,Eigen::Dynamic,1> Column;
+
+    // camera coordinates as Nx3, every axis is a contiguous column
+    const Eigen::Matrix<T,Eigen::Dynamic,3> Xc = ( points3D.transpose() * transformation.template topLeftCorner<3,3>().transpose() ).rowwise()
+                                                 + transformation.template topRightCorner<3,1>().transpose();
+
+    // perspective division and the model, column by column
+    const Column iz = Xc.col(2).array().inverse();
+    const Column xn = Xc.col(0).array() * iz;
+    const Column yn = Xc.col(1).array() * iz;
+    Model::project( params, xn, yn, x.const_cast_derived().array(), y.const_cast_derived().array() );
+}
+
+
+/////
+// Batch projection with analytic Jacobians
+//
+// dParams: 2xParamCount per point, w.r.t. the model parameters
+// dPose:   2x6 per point, w.r.t. a rotation increment w (first three) and a
+//          translation increment dt: R' = exp([w]x) R, t' = t + dt
+// dPoints: 2x3 per point, w.r.t. the 3D point
+// any of the Jacobian arrays may be null.
+///
+template <typename Model, typename Points3D, typename X, typename Y>
+inline void project( const typename Model::Scalar* params,
+                     const Eigen::Matrix<typename Model::Scalar,4,4>& transformation,
+                     const Eigen::MatrixBase<Points3D>& points3D,
+                     const Eigen::MatrixBase<X>& x,
+                     const Eigen::MatrixBase<Y>& y,
+                     Eigen::Matrix<typename Model::Scalar,2,Model::ParamCount>* dParams,
+                     Eigen::Matrix<typename Model::Scalar,2,6>* dPose,
+                     Eigen::Matrix<typename Model::Scalar,2,3>* dPoints )
+{
+    typedef typename Model::Scalar T;
+    const Eigen::Matrix<T,3,3> R = transformation.template topLeftCorner<3,3>();
+    const Eigen::Matrix<T,3,1> t = transformation.template topRightCorner<3,1>();
+    Eigen::Matrix<T,2,Model::ParamCount> dP;
+    Eigen::Matrix<T,2,2> dN;
+
+    for( size_t i=0; i<static_cast<size_t>( points3D.cols() ); i++ )
+    {
+        // transform and project
+        const Eigen::Matrix<T,3,1> RX = R*points3D.col(i);
+        const Eigen::Matrix<T,3,1> Xc = RX + t;
+        const T iz = static_cast<T>(1) / Xc(2);
+        const T xn = Xc(0)*iz;
+        const T yn = Xc(1)*iz;
+        Model::project( params, xn, yn, x.const_cast_derived()(i), y.const_cast_derived()(i), dP, dN );
+
+        if( dParams != 0 )
+            dParams[i] = dP;
+
+        if( dPose == 0 && dPoints == 0 )
+            continue;
+
+        // chain through the perspective division
+        Eigen::Matrix<T,2,3> dDivision;
+        dDivision << iz, 0, -xn*iz,
+                     0, iz, -yn*iz;
+        const Eigen::Matrix<T,2,3> dXc = dN * dDivision;
+
+        if( dPose != 0 )
+        {
+            dPose[i].template leftCols<3>() = -dXc * crossMatrix<T>( RX );
+            dPose[i].template rightCols<3>() = dXc;
+        }
+
+        if( dPoints != 0 )
+            dPoints[i] = dXc * R;
+    }
+}
+
+
+/////
+// Convenience wrappers on iris types
+///
+
+// contiguous points as the 3xN matrix the batch functions take, no copy
+template <typename T>
+inline Eigen::Map< const Eigen::Matrix<T,3,Eigen::Dynamic> > pointsMap( const std::vector< Eigen::Matrix<T,3,1> >& points3D )
+{
+    return Eigen::Map< const Eigen::Matrix<T,3,Eigen::Dynamic> >( points3D.empty() ? 0 : points3D[0].data(), 3, points3D.size() );
+}
+
+
+template <typename Model>
+inline typename Correspondences<typename Model::Scalar>::Points project( const Camera<typename Model::Scalar>& cam,
+                                                                         const Eigen::Matrix<typename Model::Scalar,4,4>& transformation,
+                                                                         const std::vector< Eigen::Matrix<typename Model::Scalar,3,1> >& points3D )
+{
+    typedef typename Model::Scalar T;
+    T params[Model::ParamCount];
+    Model::params( cam, params );
+
+    typename Correspondences<T>::Points projected( 2, points3D.size() );
+    if( points3D.size() > 0 )
+        project<Model>( params, transformation, pointsMap( points3D ), projected.row(0).transpose(), projected.row(1).transpose() );
+    return projected;
+}
+
+
+template <typename Model>
+inline typename Correspondences<typename Model::Scalar>::Points project( const Camera<typename Model::Scalar>& cam,
+                                                                         const Pose<typename Model::Scalar>& pose )
+{
+    return project<Model>( cam, pose.transformation, pose.points3D() );
+}
+
+
+} // end namespace iris
@@ -75,7 +75,8 @@ public:
 
     void operator() ( const std::vector<Eigen::Vector2d>& points );
 
-    void match( const RandomFeatureDescriptor& rfd, Pose_d& pose ) const;
+    template <typename T>
+    void match( const RandomFeatureDescriptor& rfd, Pose<T>& pose ) const;
 
     void operator =( const RandomFeatureDescriptor& pose );
 
@@ -184,7 +185,8 @@ inline void RandomFeatureDescriptor<M,N,K>::operator() ( const std::vector<Eigen
 
 
 template <size_t M, size_t N, size_t K>
-inline void RandomFeatureDescriptor<M,N,K>::match( const RandomFeatureDescriptor<M,N,K>& rfd, Pose_d& pose ) const
+template <typename T>
+inline void RandomFeatureDescriptor<M,N,K>::match( const RandomFeatureDescriptor<M,N,K>& rfd, Pose<T>& pose ) const
 {
     // match the feature vectors
     cv::FlannBasedMatcher matcher;
@@ -249,9 +251,8 @@ inline void RandomFeatureDescriptor<M,N,K>::match( const RandomFeatureDescriptor
     // project these points with the homography
     std::vector<Eigen::Vector2d> projected2D = iris::project_points<double,2>( H, queryPoints );
 
-    pose.points2D = trainPoints;
-    pose.pointIndices = queryIndices;
-    pose.projected2D = projected2D;
+    pose.correspondences.assign( trainPoints, queryIndices );
+    pose.projected2D = iris::eigen2points( projected2D ).template cast<T>();
 
 
 
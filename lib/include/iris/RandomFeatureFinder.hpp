@@ -53,8 +53,15 @@ public:
     void setMeanAreaFac( double val );
 
     virtual bool find( Pose_d& pose );
+    virtual bool find( Pose_f& pose );
+
+    virtual std::shared_ptr<Finder> clone() const;
 
 protected:
+    // detection in the precision of the pose
+    template <typename T>
+    bool findPose( Pose<T>& pose );
+
     std::vector< Eigen::Vector2d > findCircles( const cimg_library::CImg<uint8_t>& image );
 
     std::vector<cv::RotatedRect> filterEllipses( const std::vector<cv::RotatedRect>& ellipses );
@@ -62,14 +69,28 @@ protected:
     std::vector<cv::RotatedRect> removeIntersectingEllipses( const std::vector<cv::RotatedRect>& ellipses );
 
 protected:
-    // config
-    RFD m_patternRFD;
+    // config, shared with the clones
+    std::shared_ptr<const RFD> m_patternRFD;
     size_t m_minPoints;
 
     // MSER elipse detector
     double m_mserMaxRadiusRatio;
     double m_mserMinRadius;
     double m_mserMearAreaFac;
+
+    // buffers reused from frame to frame, every instance has its own
+    struct Scratch
+    {
+        Scratch() : poseRFD( true ) {}
+        Scratch( const Scratch& ) : poseRFD( true ) {}
+        Scratch& operator =( const Scratch& ) { return *this; }
+
+        RFD poseRFD;
+        cv::Mat image;
+        std::vector< std::vector<cv::Point> > contours;
+        std::vector< cv::RotatedRect > ellipses;
+    };
+    Scratch m_scratch;
 };
 
 } // end namespace iris
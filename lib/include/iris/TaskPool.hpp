@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * TaskPool.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace iris {
+
+class TaskPool
+{
+///
+/// \file    TaskPool.hpp
+/// \class   TaskPool
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Work-stealing thread pool for the parallel calibration stages
+///
+/// \details Every worker owns a task deque, it works on the newest task of
+///          its own deque and steals the oldest one of another deque when it
+///          runs dry. Threads which are not part of the pool share one extra
+///          deque, so a pool can be driven from any thread of a host
+///          application. parallel_for splits its range in halves on demand,
+///          the calling thread works on the lower half while the upper half
+///          is left for thieves, which keeps the chunks large when the pool
+///          is busy and small when it is idle. The calling thread helps out
+///          until its loop is done, which makes nested loops safe. The thread
+///          count includes the calling thread, a pool of one runs everything
+///          in place. The first exception thrown by a loop body is rethrown
+///          by parallel_for once the loop is done.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    typedef std::function<void()> Task;
+
+    // 0 uses all hardware threads
+    TaskPool( size_t threadCount=0 );
+    virtual ~TaskPool();
+
+    // process-wide pool with all hardware threads, created on first use;
+    // the default of every class that takes a pool
+    static std::shared_ptr<TaskPool> shared();
+
+    // threads working on a loop, the calling one included
+    size_t threadCount() const;
+
+    // calls body(i) for all i in [begin,end), at least grain indices in a row
+    template <typename F>
+    void parallel_for( size_t begin, size_t end, const F& body, size_t grain=1 );
+
+protected:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct Group
+    {
+        Group() : pending(0), failed(false) {}
+
+        void fail( std::exception_ptr e );
+
+        std::atomic<size_t> pending;
+        std::atomic<bool> failed;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    template <typename F>
+    void split( Group& group, size_t begin, size_t end, const F& body, size_t grain );
+
+    // queue of the calling thread
+    size_t queueIndex() const;
+
+    void push( Task&& task );
+
+    // run one task of the own queue or steal one, false if there was none
+    bool runOne( size_t index );
+
+    // help out until all tasks of the group are done
+    void wait( Group& group );
+
+    void work( size_t index );
+
+private:
+    // not copyable
+    TaskPool( const TaskPool& );
+    TaskPool& operator =( const TaskPool& );
+
+protected:
+    // queue 0 is shared by all threads outside the pool
+    std::vector< std::unique_ptr<Queue> > m_queues;
+    std::vector<std::thread> m_threads;
+
+    // idle workers sleep until something is queued
+    std::atomic<size_t> m_queued;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    bool m_stop;
+};
+
+
+/////
+// Implementation
+///
+
+template <typename F>
+inline void TaskPool::parallel_for( size_t begin, size_t end, const F& body, size_t grain )
+{
+    if( begin >= end )
+        return;
+
+    Group group;
+    split( group, begin, end, body, std::max<size_t>( grain, 1 ) );
+    wait( group );
+
+    if( group.error )
+        std::rethrow_exception( group.error );
+}
+
+
+template <typename F>
+inline void TaskPool::split( Group& group, size_t begin, size_t end, const F& body, size_t grain )
+{
+    // leave the upper halves for other threads
+    while( m_threads.size() > 0 && end - begin > grain && !group.failed )
+    {
+        size_t middle = begin + (end - begin) / 2;
+        group.pending++;
+        push( [this, &group, middle, end, &body, grain]()
+        {
+            split( group, middle, end, body, grain );
+
+            // the waiting thread may be asleep
+            std::lock_guard<std::mutex> lock( group.mutex );
+            if( --group.pending == 0 )
+                group.done.notify_all();
+        } );
+        end = middle;
+    }
+
+    // work on the rest, unless the loop is lost anyway
+    try
+    {
+        for( size_t i=begin; i<end && !group.failed; i++ )
+            body( i );
+    }
+    catch( ... )
+    {
+        group.fail( std::current_exception() );
+    }
+}
+
+
+} // end namespace iris
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * UndistortionMap.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iris/util.hpp>
+
+namespace iris
+{
+
+class UndistortionMap
+{
+///
+/// \file    UndistortionMap.hpp
+/// \class   UndistortionMap
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Cached undistortion map of a camera
+///
+/// \details The map is computed once from the intrinsics and distortion of
+///          a camera and stored in OpenCV's fixed-point format (CV_16SC2
+///          plus interpolation table), which is both compact and the fastest
+///          input for cv::remap. update() only rebuilds it when the camera
+///          parameters differ from the cached ones, remap() is const and can
+///          be called concurrently.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    UndistortionMap();
+    virtual ~UndistortionMap();
+
+    // rebuild the map if the camera changed, true if it was rebuilt
+    template <typename T>
+    bool update( const Camera<T>& cam );
+
+    // drop the cached map
+    void clear();
+    bool empty() const;
+
+    // undistort a single image
+    void remap( const cv::Mat& src, cv::Mat& dst ) const;
+
+    template <typename T>
+    void remap( const cimg_library::CImg<T>& src, cimg_library::CImg<T>& dst ) const;
+
+    // undistort a batch of images concurrently
+    void remap( const std::vector<cv::Mat>& src, std::vector<cv::Mat>& dst ) const;
+
+protected:
+    // parameters the map was built from
+    Eigen::Vector2i m_imageSize;
+    Eigen::Matrix3d m_intrinsic;
+    std::vector<double> m_distortion;
+
+    // fixed-point map
+    cv::Mat m_map1;
+    cv::Mat m_map2;
+};
+
+
+/////
+// Implementation
+///
+
+inline UndistortionMap::UndistortionMap() :
+    m_imageSize( 0, 0 ),
+    m_intrinsic( Eigen::Matrix3d::Zero() )
+{
+}
+
+
+inline UndistortionMap::~UndistortionMap()
+{
+}
+
+
+template <typename T>
+inline bool UndistortionMap::update( const Camera<T>& cam )
+{
+    // check if anything changed
+    Eigen::Matrix3d intrinsic = cam.intrinsic.template cast<double>();
+    std::vector<double> distortion( cam.distortion.begin(), cam.distortion.end() );
+    if( !empty() && m_imageSize == cam.imageSize && m_intrinsic == intrinsic && m_distortion == distortion )
+        return false;
+
+    // the camera has to be usable
+    if( cam.imageSize(0) <= 0 || cam.imageSize(1) <= 0 )
+        throw std::runtime_error( "UndistortionMap::update: invalid image size." );
+
+    // compute the map, same as cv::undistort does internally
+    cv::Mat K, D;
+    cv::eigen2cv( intrinsic, K );
+    if( distortion.size() > 0 )
+        D = cv::Mat( distortion, true );
+    cv::initUndistortRectifyMap( K, D, cv::Mat(), K,
+                                 cv::Size( cam.imageSize(0), cam.imageSize(1) ),
+                                 CV_16SC2, m_map1, m_map2 );
+
+    // remember what it was built from
+    m_imageSize = cam.imageSize;
+    m_intrinsic = intrinsic;
+    m_distortion = distortion;
+    return true;
+}
+
+
+inline void UndistortionMap::clear()
+{
+    m_map1.release();
+    m_map2.release();
+}
+
+
+inline bool UndistortionMap::empty() const
+{
+    return m_map1.empty();
+}
+
+
+inline void UndistortionMap::remap( const cv::Mat& src, cv::Mat& dst ) const
+{
+    if( empty() )
+        throw std::runtime_error( "UndistortionMap::remap: map not initialized." );
+    if( src.cols != m_imageSize(0) || src.rows != m_imageSize(1) )
+        throw std::runtime_error( "UndistortionMap::remap: image size does not match the map." );
+
+    cv::remap( src, dst, m_map1, m_map2, CV_INTER_LINEAR );
+}
+
+
+template <typename T>
+inline void UndistortionMap::remap( const cimg_library::CImg<T>& src, cimg_library::CImg<T>& dst ) const
+{
+    cv::Mat srcCV, dstCV;
+    cimg2cv( src, srcCV );
+    remap( srcCV, dstCV );
+    cv2cimg( dstCV, dst );
+}
+
+
+inline void UndistortionMap::remap( const std::vector<cv::Mat>& src, std::vector<cv::Mat>& dst ) const
+{
+    // check everything up front, exceptions must not leave the parallel loop
+    if( empty() )
+        throw std::runtime_error( "UndistortionMap::remap: map not initialized." );
+    for( size_t i=0; i<src.size(); i++ )
+        if( src[i].cols != m_imageSize(0) || src[i].rows != m_imageSize(1) )
+            throw std::runtime_error( "UndistortionMap::remap: image size does not match the map." );
+
+    // remap
+    dst.resize( src.size() );
+    #pragma omp parallel for schedule(dynamic)
+    for( int i=0; i<static_cast<int>(src.size()); i++ )
+        cv::remap( src[i], dst[i], m_map1, m_map2, CV_INTER_LINEAR );
+}
+
+
+} // end namespace iris
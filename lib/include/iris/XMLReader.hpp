@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * XMLReader.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace iris
+{
+
+class XMLReader
+{
+///
+/// \file    XMLReader.hpp
+/// \class   XMLReader
+///
+/// \package iris
+/// \version 0.1.0
+///
+/// \brief   Pull parser for XML files
+///
+/// \details Reads the file through a fixed-size buffer and reports one
+///          event at a time, so memory does not grow with the document.
+///          Supports elements, text with the predefined and numeric
+///          entities, CDATA, comments and declarations. Attributes are
+///          skipped. Whitespace-only text is not reported. Malformed input
+///          throws.
+///
+/// \author  agent
+/// \date    Oct 19, 2026
+///
+
+public:
+    enum Event
+    {
+        StartElement,
+        EndElement,
+        Text,
+        EndDocument
+    };
+
+    XMLReader();
+    XMLReader( const std::string& filename );
+    virtual ~XMLReader();
+
+    void open( const std::string& filename );
+    void close();
+    bool isOpen() const;
+
+    // advance to the next event
+    Event next();
+
+    // name of the element of the last start or end event
+    const std::string& name() const;
+
+    // text of the last text event
+    const std::string& text() const;
+
+    // number of open elements
+    size_t depth() const;
+
+    // advance to the next child of the current element, false at its end
+    bool nextChild();
+
+    // text content of the element just started, consumes its end
+    const std::string& readText();
+
+    // skip the rest of the element just started, including its end
+    void skipElement();
+
+protected:
+    int peek();
+    int get();
+    void expect( const char* str );
+    void skipUntil( const char* str );
+    void readName( std::string& name );
+    void readEntity( std::string& text );
+    void error( const std::string& msg ) const;
+
+protected:
+    FILE* m_file;
+    std::string m_filename;
+    std::vector<char> m_buffer;
+    size_t m_position;
+    size_t m_size;
+    size_t m_line;
+
+    std::vector<std::string> m_elements;
+    std::string m_name;
+    std::string m_text;
+    std::string m_value;
+    bool m_pendingEnd;
+
+private:
+    XMLReader( const XMLReader& );
+    void operator =( const XMLReader& );
+};
+
+} // end namespace iris
@@ -21,14 +21,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <clocale>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <sstream>
+#include <type_traits>
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <Eigen/Eigenvalues>
 
 // opencv
 using std::ptrdiff_t;
@@ -40,9 +49,25 @@ using std::ptrdiff_t;
 #define cimg_display 0
 #include <CImg.h>
 
+#include <iris/Correspondences.hpp>
+
 namespace iris
 {
 
+/////
+// Pattern
+///
+template <typename T>
+class Pattern
+{
+public:
+    // 3D points, addressed by the point indices of the poses
+    std::vector< Eigen::Matrix<T,3,1> > points;
+};
+typedef Pattern<double> Pattern_d;
+typedef Pattern<float> Pattern_f;
+
+
 /////
 // Pose
 ///
@@ -53,30 +78,56 @@ public:
     Pose()
     {
         id = -1;
+        pointsMax = 0;
         transformation = Eigen::Matrix<T,4,4>::Identity();
         rejected = true;
     }
 
+    // copy and move are generated member-wise
 
-    Pose( const Pose& pose )
+    // true if every correspondence has a point in the pattern
+    bool hasPoints3D() const
     {
-        *this = pose;
+        if( !pattern )
+            return false;
+        for( size_t i=0; i<correspondences.size(); i++ )
+            if( correspondences.index( i ) >= pattern->points.size() )
+                return false;
+        return true;
     }
 
+    // 3D point of correspondence i
+    const Eigen::Matrix<T,3,1>& point3D( const size_t i ) const
+    {
+        return pattern->points[ correspondences.index( i ) ];
+    }
 
-    void operator =( const Pose& pose )
+    // gather the 3D points of all correspondences
+    std::vector< Eigen::Matrix<T,3,1> > points3D() const
     {
-        id = pose.id;
-        name = pose.name;
-        image = pose.image;
-        points2D = pose.points2D;
-        points3D = pose.points3D;
-        pointIndices = pose.pointIndices;
-        transformation = pose.transformation;
-        projected2D = pose.projected2D;
-        rejected = pose.rejected;
+        std::vector< Eigen::Matrix<T,3,1> > result;
+        if( hasPoints3D() )
+        {
+            result.reserve( correspondences.size() );
+            for( size_t i=0; i<correspondences.size(); i++ )
+                result.push_back( point3D( i ) );
+        }
+        return result;
     }
 
+    // true if there is a projection for every correspondence
+    bool hasProjections() const
+    {
+        return static_cast<size_t>( projected2D.cols() ) == correspondences.size();
+    }
+
+    // distance of every correspondence to its projection
+    Eigen::Matrix<T,Eigen::Dynamic,1> residuals() const
+    {
+        if( !hasProjections() )
+            return Eigen::Matrix<T,Eigen::Dynamic,1>();
+        return ( projected2D - correspondences.points() ).colwise().norm().transpose();
+    }
 
 public:
     // id
@@ -84,17 +135,17 @@ public:
     std::string name;
     // image
     std::shared_ptr< cimg_library::CImg<uint8_t> > image;
-    // correspondences
-    std::vector< Eigen::Matrix<T,2,1> > points2D;
-    std::vector< Eigen::Matrix<T,3,1> > points3D;
-    std::vector<size_t> pointIndices;
+    // correspondences, the 3D points are shared through the pattern
+    Correspondences<T> correspondences;
+    std::shared_ptr< const Pattern<T> > pattern;
     size_t pointsMax;
-    // calibration results
+    // calibration results, projections in the layout of the correspondences
     Eigen::Matrix<T,4,4> transformation;
-    std::vector< Eigen::Matrix<T,2,1> > projected2D;
+    typename Correspondences<T>::Points projected2D;
     bool rejected;
 };
 typedef Pose<double> Pose_d;
+typedef Pose<float> Pose_f;
 
 
 /////
@@ -110,35 +161,214 @@ public:
         error = 0;
     }
 
+    // copy and move are generated member-wise
+
+public:
+    size_t id;
+    std::vector< Pose<T> > poses;
+    Eigen::Vector2i imageSize;
+    Eigen::Matrix<T,2,1> sensorSize;
+    Eigen::Matrix<T,3,3> intrinsic;
+    std::vector<T> distortion;
+    T error;
+};
+typedef Camera<double> Camera_d;
+typedef Camera<float> Camera_f;
+
+
+/////
+// Patterns from 3D points given per correspondence, as in older files.
+// Points no correspondence refers to are NaN.
+///
+template <typename T>
+inline std::shared_ptr< Pattern<T> > pattern_from_points( const std::vector<size_t>& indices, const std::vector< Eigen::Matrix<T,3,1> >& points3D )
+{
+    std::shared_ptr< Pattern<T> > pattern( new Pattern<T>() );
+    for( size_t i=0; i<indices.size() && i<points3D.size(); i++ )
+    {
+        if( indices[i] >= pattern->points.size() )
+            pattern->points.resize( indices[i]+1, Eigen::Matrix<T,3,1>::Constant( std::numeric_limits<T>::quiet_NaN() ) );
+        pattern->points[ indices[i] ] = points3D[i];
+    }
+
+    return pattern;
+}
+
+
+// merge b into a if they agree wherever both have a point
+template <typename T>
+inline bool merge_patterns( Pattern<T>& a, const Pattern<T>& b )
+{
+    size_t common = std::min( a.points.size(), b.points.size() );
+    for( size_t i=0; i<common; i++ )
+        if( a.points[i] != b.points[i] && !a.points[i].hasNaN() && !b.points[i].hasNaN() )
+            return false;
+
+    if( b.points.size() > a.points.size() )
+        a.points.resize( b.points.size(), Eigen::Matrix<T,3,1>::Constant( std::numeric_limits<T>::quiet_NaN() ) );
+    for( size_t i=0; i<b.points.size(); i++ )
+        if( a.points[i].hasNaN() )
+            a.points[i] = b.points[i];
+
+    return true;
+}
+
+
+// let poses with agreeing patterns share one
+template <typename T>
+inline void share_patterns( const std::vector< Pose<T>* >& poses )
+{
+    std::vector< std::shared_ptr< Pattern<T> > > shared;
+    for( size_t p=0; p<poses.size(); p++ )
+    {
+        if( !poses[p]->pattern )
+            continue;
+
+        // most poses agree with the most recent pattern
+        bool merged = false;
+        for( size_t s=shared.size(); s>0 && !merged; s-- )
+        {
+            if( merge_patterns( *shared[s-1], *poses[p]->pattern ) )
+            {
+                poses[p]->pattern = shared[s-1];
+                merged = true;
+            }
+        }
+
+        if( !merged )
+        {
+            shared.push_back( std::shared_ptr< Pattern<T> >( new Pattern<T>( *poses[p]->pattern ) ) );
+            poses[p]->pattern = shared.back();
+        }
+    }
+}
+
+
+/////
+// Conversion to another scalar type. Poses that shared a pattern share its
+// converted copy, the map holds the copies made so far.
+///
+template <typename To, typename From>
+inline std::shared_ptr< const Pattern<To> > cast_pattern( const std::shared_ptr< const Pattern<From> >& pattern,
+                                                         std::map< const Pattern<From>*, std::shared_ptr< const Pattern<To> > >& patterns )
+{
+    if( !pattern )
+        return std::shared_ptr< const Pattern<To> >();
+
+    std::shared_ptr< const Pattern<To> >& result = patterns[ pattern.get() ];
+    if( !result )
+    {
+        std::shared_ptr< Pattern<To> > converted( new Pattern<To>() );
+        converted->points.reserve( pattern->points.size() );
+        for( size_t i=0; i<pattern->points.size(); i++ )
+            converted->points.push_back( pattern->points[i].template cast<To>() );
+        result = converted;
+    }
+
+    return result;
+}
+
+
+template <typename To, typename From>
+inline Pose<To> cast_pose( const Pose<From>& pose,
+                           std::map< const Pattern<From>*, std::shared_ptr< const Pattern<To> > >& patterns )
+{
+    Pose<To> result;
+    result.id = pose.id;
+    result.name = pose.name;
+    result.image = pose.image;
+    result.correspondences = pose.correspondences.template cast<To>();
+    result.pattern = cast_pattern( pose.pattern, patterns );
+    result.pointsMax = pose.pointsMax;
+    result.transformation = pose.transformation.template cast<To>();
+    result.projected2D = pose.projected2D.template cast<To>();
+    result.rejected = pose.rejected;
+
+    return result;
+}
+
+
+template <typename To, typename From>
+inline Camera<To> cast_camera( const Camera<From>& camera,
+                               std::map< const Pattern<From>*, std::shared_ptr< const Pattern<To> > >& patterns )
+{
+    Camera<To> result;
+    result.id = camera.id;
+    result.poses.reserve( camera.poses.size() );
+    for( size_t p=0; p<camera.poses.size(); p++ )
+        result.poses.push_back( cast_pose( camera.poses[p], patterns ) );
+    result.imageSize = camera.imageSize;
+    result.sensorSize = camera.sensorSize.template cast<To>();
+    result.intrinsic = camera.intrinsic.template cast<To>();
+    result.distortion.assign( camera.distortion.begin(), camera.distortion.end() );
+    result.error = static_cast<To>( camera.error );
+
+    return result;
+}
+
+
+/////
+// Camera View, the accepted poses of a camera and the results solved for it
+///
+template <typename T>
+class CameraView
+{
+public:
+    CameraView() :
+        camera(0),
+        error(0)
+    {
+    }
+
+
+    CameraView( Camera<T>& cam ) :
+        camera(&cam),
+        intrinsic(cam.intrinsic),
+        distortion(cam.distortion),
+        error(cam.error)
+    {
+    }
+
+
+    // view all poses of the camera
+    void addAll()
+    {
+        poses.clear();
+        for( size_t p=0; p<camera->poses.size(); p++ )
+            poses.push_back( p );
+    }
+
 
-    Camera( const Camera& cam )
+    size_t size() const
     {
-        *this = cam;
+        return poses.size();
     }
 
 
-    void operator =( const Camera& cam )
+    Pose<T>& pose( size_t i )
     {
-        id = cam.id;
-        poses = cam.poses;
-        imageSize = cam.imageSize;
-        sensorSize = cam.sensorSize;
-        intrinsic = cam.intrinsic;
-        distortion = cam.distortion;
-        error = cam.error;
+        return camera->poses[ poses[i] ];
+    }
+
+
+    const Pose<T>& pose( size_t i ) const
+    {
+        return camera->poses[ poses[i] ];
     }
 
 
 public:
-    size_t id;
-    std::vector< Pose<T> > poses;
-    Eigen::Vector2i imageSize;
-    Eigen::Matrix<T,2,1> sensorSize;
+    // the viewed camera and the positions of the accepted poses in it
+    Camera<T>* camera;
+    std::vector<size_t> poses;
+
+    // results, written back to the camera on commit
     Eigen::Matrix<T,3,3> intrinsic;
     std::vector<T> distortion;
     T error;
 };
-typedef Camera<double> Camera_d;
+typedef CameraView<double> CameraView_d;
+typedef CameraView<float> CameraView_f;
 
 
 /////
@@ -160,6 +390,23 @@ inline std::vector<cv::Point_<To> > eigen2cv( const std::vector<Eigen::Matrix<Te
 }
 
 
+template <typename To, typename Te>
+inline std::vector<cv::Point_<To> > eigen2cv( const Correspondences<Te>& correspondences, bool weightedOnly=false )
+{
+    // interleave the columns, rejected points are skipped if asked to
+    std::vector<cv::Point_<To> > cvPoints2D;
+    cvPoints2D.reserve( correspondences.size() );
+    typename Correspondences<Te>::ConstColumnMap x = correspondences.x();
+    typename Correspondences<Te>::ConstColumnMap y = correspondences.y();
+    typename Correspondences<Te>::ConstColumnMap w = correspondences.weights();
+    for( size_t j=0; j<correspondences.size(); j++ )
+        if( !weightedOnly || w(j) > Te(0) )
+            cvPoints2D.push_back( cv::Point_<To>( static_cast<To>( x(j) ), static_cast<To>( y(j) ) ) );
+
+    return cvPoints2D;
+}
+
+
 template <typename To, typename Te>
 inline std::vector<cv::Point3_<To> > eigen2cv( const std::vector<Eigen::Matrix<Te,3,1> >& points3D )
 {
@@ -177,6 +424,44 @@ inline std::vector<cv::Point3_<To> > eigen2cv( const std::vector<Eigen::Matrix<T
 }
 
 
+template <typename To, typename Te>
+inline std::vector<cv::Point3_<To> > pattern2cv( const Pose<Te>& pose, bool weightedOnly=false )
+{
+    // gather the points of the correspondences from the pattern
+    std::vector<cv::Point3_<To> > cvPoints3D;
+    if( !pose.hasPoints3D() )
+        return cvPoints3D;
+
+    cvPoints3D.reserve( pose.correspondences.size() );
+    for( size_t j=0; j<pose.correspondences.size(); j++ )
+    {
+        if( weightedOnly && !( pose.correspondences.weight( j ) > Te(0) ) )
+            continue;
+
+        const Eigen::Matrix<Te,3,1>& point = pose.point3D( j );
+        cvPoints3D.push_back( cv::Point3_<To>( static_cast<To>( point(0) ),
+                                               static_cast<To>( point(1) ),
+                                               static_cast<To>( point(2) ) ) );
+    }
+
+    return cvPoints3D;
+}
+
+
+/////
+// Points as columns, in the layout of the correspondences
+///
+template <typename T>
+inline Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor> eigen2points( const std::vector<Eigen::Matrix<T,2,1> >& points )
+{
+    Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor> result( 2, points.size() );
+    for( size_t i=0; i<points.size(); i++ )
+        result.col( i ) = points[i];
+
+    return result;
+}
+
+
 /////
 // OpenCV Matrices
 ///
@@ -253,48 +538,199 @@ inline void eigen2cv( const Eigen::Matrix<T, Rows, Cols>& trans, cv::Mat& rot, c
 
 
 /////
-// from Eigen to String (with love)
+// Numbers to text and back without streams or allocations, independent of
+// the C locale. Floating point values round-trip exactly.
 ///
+inline char decimalPoint()
+{
+    const char* point = std::localeconv()->decimal_point;
+    return ( point != 0 && *point != 0 ) ? *point : '.';
+}
+
+
+template <typename T>
+inline void appendNumber( std::string& str, const T val, std::true_type )
+{
+    char buffer[32];
+    int length = std::snprintf( buffer, sizeof(buffer), "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>( val ) );
+
+    // undo the locale's decimal point
+    char point = decimalPoint();
+    if( point != '.' )
+        std::replace( buffer, buffer + length, point, '.' );
+
+    str.append( buffer, length );
+}
+
+
+template <typename T>
+inline void appendNumber( std::string& str, const T val, std::false_type )
+{
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* pos = end;
+
+    bool negative = val < static_cast<T>(0);
+    unsigned long long u = negative ? 0ULL - static_cast<unsigned long long>( val ) : static_cast<unsigned long long>( val );
+    do
+    {
+        *--pos = static_cast<char>( '0' + u % 10 );
+        u /= 10;
+    }
+    while( u != 0 );
+    if( negative )
+        *--pos = '-';
+
+    str.append( pos, end );
+}
+
+
 template <typename T>
-inline std::string toString( const T val )
+inline void appendNumber( std::string& str, const T val )
 {
-    std::stringstream ss;
-    ss << val;
+    appendNumber( str, val, typename std::is_floating_point<T>::type() );
+}
+
+
+template <typename T>
+inline bool parseNumber( const char*& pos, T& val, std::true_type )
+{
+    const char* start = pos;
+    while( *start == ' ' || *start == '\t' || *start == '\r' || *start == '\n' )
+        start++;
+
+    // copy the candidate characters, with the locale's decimal point and
+    // letters for nan and inf
+    char buffer[64];
+    char point = decimalPoint();
+    size_t length = 0;
+    for( const char* c=start; length < sizeof(buffer)-1 && ( ( *c >= '0' && *c <= '9' ) || ( *c >= 'a' && *c <= 'z' ) || ( *c >= 'A' && *c <= 'Z' ) || std::strchr( "+-.", *c ) != 0 ) && *c != 0; c++ )
+        buffer[length++] = ( *c == '.' ) ? point : *c;
+    buffer[length] = 0;
+
+    char* end = buffer;
+    double result = std::strtod( buffer, &end );
+    if( end == buffer )
+        return false;
+
+    val = static_cast<T>( result );
+    pos = start + ( end - buffer );
+    return true;
+}
+
+
+template <typename T>
+inline bool parseNumber( const char*& pos, T& val, std::false_type )
+{
+    const char* c = pos;
+    while( *c == ' ' || *c == '\t' || *c == '\r' || *c == '\n' )
+        c++;
+
+    bool negative = *c == '-';
+    if( *c == '-' || *c == '+' )
+        c++;
+    if( *c < '0' || *c > '9' )
+        return false;
+
+    unsigned long long u = 0;
+    for( ; *c >= '0' && *c <= '9'; c++ )
+        u = 10*u + static_cast<unsigned long long>( *c - '0' );
+
+    val = static_cast<T>( negative ? 0ULL - u : u );
+    pos = c;
+    return true;
+}
+
 
-    return ss.str();
+// parse the number at pos, skipping whitespace, and advance pos past it;
+// false if there is none, pos has to point into a null-terminated string
+template <typename T>
+inline bool parseNumber( const char*& pos, T& val )
+{
+    return parseNumber( pos, val, typename std::is_floating_point<T>::type() );
+}
+
+
+/////
+// from Eigen to String (with love), appending to an existing string
+///
+template <typename T>
+inline void appendString( std::string& str, const T val )
+{
+    appendNumber( str, val );
 }
 
 
 template <typename T, int Rows, int Cols>
-inline std::string toString( const Eigen::Matrix<T,Rows,Cols>& mat )
+inline void appendString( std::string& str, const Eigen::Matrix<T,Rows,Cols>& mat )
 {
-    std::stringstream ss;
     for( int i=0; i<Rows*Cols; i++ )
-        ss << mat.data()[i] << " ";
-
-    return ss.str();
+    {
+        appendNumber( str, mat.data()[i] );
+        str.push_back( ' ' );
+    }
 }
 
 
 template <typename T>
-inline std::string toString( const std::vector<T>& vec )
+inline void appendString( std::string& str, const std::vector<T>& vec )
 {
-    std::stringstream ss;
     for( size_t i=0; i<vec.size(); i++ )
-        ss << vec[i] << " ";
-
-    return ss.str();
+    {
+        appendNumber( str, vec[i] );
+        str.push_back( ' ' );
+    }
 }
 
 
 template <typename T, int Rows, int Cols>
-inline std::string toString( const std::vector< Eigen::Matrix<T,Rows,Cols> >& vec )
+inline void appendString( std::string& str, const std::vector< Eigen::Matrix<T,Rows,Cols> >& vec )
 {
-    std::stringstream ss;
     for( size_t i=0; i<vec.size(); i++ )
-        ss << toString( vec[i] ) << "; ";
+    {
+        appendString( str, vec[i] );
+        str.append( "; " );
+    }
+}
 
-    return ss.str();
+
+// 2D points stored as columns, written like a vector of points
+template <typename Derived>
+inline void appendColumns( std::string& str, const Eigen::MatrixBase<Derived>& points )
+{
+    for( typename Derived::Index i=0; i<points.cols(); i++ )
+    {
+        for( typename Derived::Index r=0; r<points.rows(); r++ )
+        {
+            appendNumber( str, points(r,i) );
+            str.push_back( ' ' );
+        }
+        str.append( "; " );
+    }
+}
+
+
+template <typename T>
+inline void appendString( std::string& str, const Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor>& points )
+{
+    appendColumns( str, points );
+}
+
+
+template <typename T>
+inline void appendString( std::string& str, const Correspondences<T>& correspondences )
+{
+    appendColumns( str, correspondences.points() );
+}
+
+
+template <typename T>
+inline std::string toString( const T& val )
+{
+    std::string str;
+    appendString( str, val );
+
+    return str;
 }
 
 
@@ -302,62 +738,57 @@ inline std::string toString( const std::vector< Eigen::Matrix<T,Rows,Cols> >& ve
 // from String to Eigen (also with love)
 ///
 template <typename T>
-inline void str2scalar( std::string str, T& result )
+inline void str2scalar( const std::string& str, T& result )
 {
-    std::stringstream ss;
-    ss << str;
-    ss.seekg( 0, std::ios::beg );
-    ss >> result;
+    const char* pos = str.c_str();
+    parseNumber( pos, result );
 }
 
 
 template <typename T>
 inline void str2vector( const std::string& str, std::vector<T>& result )
 {
-    std::stringstream ss;
-    ss << str;
-    ss.seekg( 0, std::ios::beg );
-    while( !ss.eof() )
-    {
-        T tmp;
-        ss >> tmp;
+    const char* pos = str.c_str();
+    T tmp;
+    while( parseNumber( pos, tmp ) )
         result.push_back( tmp );
-    }
-    result.pop_back();
 }
 
 
 template <typename T, int Rows, int Cols>
-inline void str2eigen( std::string str, Eigen::Matrix<T,Rows,Cols>& result )
+inline void str2eigen( const std::string& str, Eigen::Matrix<T,Rows,Cols>& result )
 {
-    std::stringstream ss;
-    ss << str;
-    ss.seekg( 0, std::ios::beg );
-    for( int i=0; i<Rows*Cols && str.size() > Rows*Cols; i++ )
-        ss >> result.data()[i];
+    const char* pos = str.c_str();
+    for( int i=0; i<Rows*Cols && parseNumber( pos, result.data()[i] ); i++ );
 }
 
 
 template <typename T, int Rows, int Cols>
-inline void str2eigenVector( std::string str, std::vector< Eigen::Matrix<T,Rows,Cols> >& result )
+inline void str2eigenVector( const std::string& str, std::vector< Eigen::Matrix<T,Rows,Cols> >& result )
 {
-    size_t start=0;
-    size_t finish = str.find_first_of( ';' );
-    while( finish != std::string::npos )
+    // one matrix per ';'
+    result.reserve( result.size() + std::count( str.begin(), str.end(), ';' ) );
+    const char* pos = str.c_str();
+    for( const char* finish=std::strchr( pos, ';' ); finish != 0; finish=std::strchr( pos, ';' ) )
     {
-        // get the matrix
         Eigen::Matrix<T,Rows,Cols> mat;
-        str2eigen( str.substr( start, finish - start ), mat );
+        for( int i=0; i<Rows*Cols && parseNumber( pos, mat.data()[i] ); i++ );
         result.push_back( mat );
-
-        // advance indices
-        start=finish + 1;
-        finish = str.find_first_of( ';', start );
+        pos = finish + 1;
     }
 }
 
 
 
+template <typename T>
+inline void str2points( const std::string& str, Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor>& result )
+{
+    std::vector< Eigen::Matrix<T,2,1> > points;
+    str2eigenVector( str, points );
+    result = eigen2points( points );
+}
+
+
 /////
 // OpenCV Image to CImg
 ///
@@ -368,18 +799,14 @@ inline void cimg2cv( const cimg_library::CImg<T>& src, cv::Mat& dst )
     if( Ch != src.spectrum() )
         throw std::runtime_error( "iris::cimg2cv: channel count of source image does not match template parameter." );
 
-    // init result
-    typedef cv::Vec<T,Ch> Pix;
-    cv::Mat_<Pix> result( src.height(), src.width() ); // don't forget cv::Mat works on rows and columns and not width and height ;)
+    // CImg stores the channels as planes, wrap each of them without copying
+    // (don't forget cv::Mat works on rows and columns and not width and height ;)
+    std::vector<cv::Mat> planes( Ch );
+    for( int c=0; c<Ch; c++ )
+        planes[c] = cv::Mat( src.height(), src.width(), cv::DataType<T>::type, const_cast<T*>( src.data( 0, 0, 0, c ) ) );
 
-    // convert
-    for( int y=0; y<src.height(); y++ )
-        for( int x=0; x<src.width(); x++ )
-            for( int c=0; c<Ch; c++ )
-                result(y,x)[c] = src( x, y, 0, c );
-
-    // pass the result
-    dst = result;
+    // interleave them into the result
+    cv::merge( planes, dst );
 }
 
 
@@ -401,18 +828,17 @@ inline void cimg2cv( const cimg_library::CImg<T>& src, cv::Mat& dst )
 template <typename T, int Ch>
 inline void cv2cimg( const cv::Mat& src, cimg_library::CImg<T>& dst )
 {
-    // init result
-    typedef cv::Vec<T,Ch> Pix;
-    cimg_library::CImg<uint8_t> result( src.cols, src.rows, 1, Ch );
-
-    // convert
-    for( int y=0; y<src.rows; y++ )
-        for( int x=0; x<src.cols; x++ )
-            for( int c=0; c<Ch; c++ )
-                result( x, y, 0, c ) = src.at<Pix>(y,x)[c];
-
-    // pass the result
-    dst = result;
+    // make sure the depth matches
+    cv::Mat source = src;
+    if( src.depth() != cv::DataType<T>::depth )
+        src.convertTo( source, CV_MAKETYPE( cv::DataType<T>::depth, Ch ) );
+
+    // wrap the planes of the result and split directly into them
+    dst.assign( src.cols, src.rows, 1, Ch );
+    std::vector<cv::Mat> planes( Ch );
+    for( int c=0; c<Ch; c++ )
+        planes[c] = cv::Mat( src.rows, src.cols, cv::DataType<T>::type, dst.data( 0, 0, 0, c ) );
+    cv::split( source, planes );
 }
 
 
@@ -487,72 +913,6 @@ inline void undistort( const Camera<Tmat>& camera, const Pose<Tmat> &pose, cimg_
 }
 
 
-/////
-// Commandline Progress bar
-///
-template <typename T>
-class progress
-{
-public:
-    progress( const std::string& message, T steps ) :
-        m_message(message),
-        m_step(0),
-        m_steps(steps)
-    {}
-
-
-    ~progress(){ reset(); }
-
-
-    void step( T step )
-    {
-        m_step = (step) < m_steps ? step : m_steps;
-        update();
-    }
-
-
-    void next_step()
-    {
-        step( m_step + static_cast<T>(1) );
-    }
-
-
-    void reset()
-    {
-        m_step = 0;
-    }
-
-
-    void finish()
-    {
-        m_step = m_steps;
-        update();
-        std::cout << std::endl;
-    }
-
-
-    void update()
-    {
-        // assemble the progressbar
-        size_t pc = (100.0*static_cast<size_t>(m_step)) / static_cast<size_t>(m_steps);
-        std::string pb = " [";
-        for( size_t i=0; i<20; i++ )
-            pb += ( (i*100)/20 <= pc ) ? "#" : " ";
-        pb += "] " + toString( pc ) + " (" + toString(m_step) + "/" + toString(m_steps) +")";
-
-
-        std::cout << '\r' << m_message << pb;
-        std::cout.flush();
-    }
-
-protected:
-    std::string m_message;
-    T m_step;
-    T m_steps;
-};
-
-
-
 /////
 // limit an image to a certain pixel count
 ///
@@ -922,6 +1282,88 @@ inline std::vector<Eigen::Matrix<T,Dim,1> > project_points( const Eigen::Matrix<
 }
 
 
+// project points given as columns
+template <typename T, typename Derived>
+inline Eigen::Matrix<T,2,Eigen::Dynamic,Eigen::RowMajor> project_columns( const Eigen::Matrix<T,3,3>& P,
+                                                                         const Eigen::MatrixBase<Derived>& points )
+{
+    return ( P * points.colwise().homogeneous() ).colwise().hnormalized();
+}
+
+
+/////
+// Homography between two point sets (normalized DLT), points as columns
+///
+template <typename Derived>
+inline Eigen::Matrix<typename Derived::Scalar,3,3> normalize_points( const Eigen::MatrixBase<Derived>& points )
+{
+    typedef typename Derived::Scalar T;
+
+    // compute centroid and mean distance to it
+    Eigen::Matrix<T,2,1> centroid = points.rowwise().sum() / static_cast<T>( points.cols() );
+    T meanDist = ( points.colwise() - centroid ).colwise().norm().sum() / static_cast<T>( points.cols() );
+
+    // scale so that the mean distance becomes sqrt(2)
+    T s = ( meanDist > std::numeric_limits<T>::epsilon() ) ? std::sqrt( static_cast<T>(2) ) / meanDist : static_cast<T>(1);
+    Eigen::Matrix<T,3,3> N;
+    N << s, 0, -s*centroid(0),
+         0, s, -s*centroid(1),
+         0, 0, 1;
+    return N;
+}
+
+
+template <typename DerivedS, typename DerivedD>
+inline Eigen::Matrix<typename DerivedS::Scalar,3,3> compute_homography( const Eigen::MatrixBase<DerivedS>& src,
+                                                                        const Eigen::MatrixBase<DerivedD>& dst )
+{
+    typedef typename DerivedS::Scalar T;
+
+    // check
+    if( src.cols() != dst.cols() || src.cols() < 4 )
+        throw std::runtime_error( "iris::compute_homography: at least 4 point pairs of equal count required." );
+
+    // normalize both point sets
+    Eigen::Matrix<T,3,3> Ns = normalize_points( src );
+    Eigen::Matrix<T,3,3> Nd = normalize_points( dst );
+
+    // accumulate A^T A of the DLT system
+    Eigen::Matrix<T,9,9> AtA = Eigen::Matrix<T,9,9>::Zero();
+    for( typename DerivedS::Index i=0; i<src.cols(); i++ )
+    {
+        Eigen::Matrix<T,3,1> s = Ns * Eigen::Matrix<T,2,1>( src.col(i) ).homogeneous();
+        Eigen::Matrix<T,3,1> d = Nd * Eigen::Matrix<T,2,1>( dst.col(i) ).homogeneous();
+
+        Eigen::Matrix<T,9,1> a, b;
+        a << 0, 0, 0, -s(0), -s(1), -1, d(1)*s(0), d(1)*s(1), d(1);
+        b << s(0), s(1), 1, 0, 0, 0, -d(0)*s(0), -d(0)*s(1), -d(0);
+        AtA += a * a.transpose() + b * b.transpose();
+    }
+
+    // the solution is the eigenvector of the smallest eigenvalue
+    Eigen::SelfAdjointEigenSolver< Eigen::Matrix<T,9,9> > es( AtA );
+    Eigen::Matrix<T,9,1> h = es.eigenvectors().col(0);
+    Eigen::Matrix<T,3,3> Hn;
+    Hn << h(0), h(1), h(2),
+          h(3), h(4), h(5),
+          h(6), h(7), h(8);
+
+    // denormalize
+    Eigen::Matrix<T,3,3> H = Nd.inverse() * Hn * Ns;
+    if( std::fabs( H(2,2) ) > std::numeric_limits<T>::epsilon() )
+        H /= H(2,2);
+    return H;
+}
+
+
+template <typename T>
+inline Eigen::Matrix<T,3,3> compute_homography( const std::vector<Eigen::Matrix<T,2,1> >& src,
+                                                const std::vector<Eigen::Matrix<T,2,1> >& dst )
+{
+    return compute_homography( eigen2points( src ), eigen2points( dst ) );
+}
+
+
 
 
 } // end namespace iris
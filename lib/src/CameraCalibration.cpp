@@ -27,10 +27,8 @@
  */
 
 #include <iostream>
-
-#ifdef IRIS_OPENMP
-#include <omp.h>
-#endif
+#include <mutex>
+#include <thread>
 
 #include <Eigen/Geometry>
 
@@ -41,13 +39,13 @@ namespace iris {
 CameraCalibration::CameraCalibration() :
     m_finder(0),
     m_handEye(false),
-    m_threadCount(1)
+    m_taskPool( TaskPool::shared() ),
+    m_progress( std::make_shared<Progress::ConsoleSink>() ),
+    m_running( false ),
+    m_cancelled( false ),
+    m_timeBudget( 0 ),
+    m_snapshotRequested( false )
 {
-    // use all available threads
-#ifdef IRIS_OPENMP
-    omp_set_num_threads( omp_get_max_threads() );
-    m_threadCount = omp_get_max_threads();
-#endif
 }
 
 
@@ -62,36 +60,260 @@ void CameraCalibration::setFinder( std::shared_ptr<Finder> finder )
 }
 
 
-void CameraCalibration::commit( CameraSet_d &cs )
+void CameraCalibration::setThreadCount( size_t count )
+{
+    setTaskPool( std::make_shared<TaskPool>( count ) );
+}
+
+
+void CameraCalibration::setTaskPool( std::shared_ptr<TaskPool> pool )
+{
+    if( !pool )
+        throw std::runtime_error("CameraCalibration::setTaskPool: pool not set.");
+
+    m_taskPool = pool;
+}
+
+
+TaskPool& CameraCalibration::taskPool() const
+{
+    return *m_taskPool;
+}
+
+
+void CameraCalibration::setProgressSink( std::shared_ptr<Progress::Sink> sink )
+{
+    m_progress.setSink( sink );
+}
+
+
+const Progress& CameraCalibration::progress() const
+{
+    return m_progress;
+}
+
+
+void CameraCalibration::calibrate( CameraSet_f &cs )
+{
+    // solve on a converted copy and convert the results back
+    CameraSet_d tmp;
+    tmp.assign( cs );
+    calibrate( tmp );
+    cs.assign( tmp );
+
+    // the views refer to the copy
+    m_filteredCameras.clear();
+}
+
+
+std::future<void> CameraCalibration::calibrateAsync( CameraSet_d& cs )
 {
-    for( auto camIt=m_filteredCameras.begin(); camIt != m_filteredCameras.end(); camIt++ )
     {
-        // get the poses for the target
-        std::vector<Pose_d>& srcPoses = camIt->second.poses;
-        std::vector<Pose_d>& targetPoses = cs.cameras()[ camIt->second.id ].poses;
+        std::lock_guard<std::mutex> lock( m_runMutex );
+        if( m_running )
+            throw std::runtime_error("CameraCalibration::calibrateAsync: a calibration is running already.");
 
-        // run over all found poses and commit
-        for( size_t p=0; p<srcPoses.size(); p++ )
+        // cancelling works from now on, the run of calibrate takes the mark over
+        m_running = true;
+        m_reservedFor = std::thread::id();
+        m_cancelled = false;
+    }
+
+    try
+    {
+        return std::async( std::launch::async, [this, &cs]()
         {
-            // find the corresponding target pose
-            for( size_t tp=0; tp<targetPoses.size(); tp++ )
             {
-                if( targetPoses[tp].id == srcPoses[p].id )
-                {
-                    targetPoses[tp] = srcPoses[p];
-                    targetPoses[tp].rejected = false;
-                }
+                std::lock_guard<std::mutex> lock( m_runMutex );
+                m_reservedFor = std::this_thread::get_id();
             }
+
+            try
+            {
+                calibrate( cs );
+            }
+            catch( ... )
+            {
+                unreserve();
+                throw;
+            }
+            unreserve();
+        } );
+    }
+    catch( ... )
+    {
+        std::lock_guard<std::mutex> lock( m_runMutex );
+        m_running = false;
+        throw;
+    }
+}
+
+
+void CameraCalibration::unreserve()
+{
+    // only if calibrate never started its run
+    std::lock_guard<std::mutex> lock( m_runMutex );
+    if( m_reservedFor == std::this_thread::get_id() )
+    {
+        m_reservedFor = std::thread::id();
+        m_running = false;
+    }
+}
+
+
+void CameraCalibration::cancel()
+{
+    std::lock_guard<std::mutex> lock( m_runMutex );
+    if( m_running )
+        m_cancelled = true;
+}
+
+
+void CameraCalibration::setTimeBudget( std::chrono::milliseconds budget )
+{
+    m_timeBudget = budget;
+}
+
+
+std::shared_ptr<const CameraSet_d> CameraCalibration::snapshot() const
+{
+    std::lock_guard<std::mutex> lock( m_snapshotMutex );
+    m_snapshotRequested = true;
+
+    // assemble the set once per change
+    if( !m_snapshot && m_snapshotCameras.size() > 0 )
+    {
+        std::shared_ptr<CameraSet_d> snapshot( new CameraSet_d() );
+        for( auto it=m_snapshotCameras.begin(); it != m_snapshotCameras.end(); it++ )
+            snapshot->cameras()[ it->first ] = *it->second;
+        m_snapshot = snapshot;
+    }
+
+    return m_snapshot;
+}
+
+
+CameraCalibration::Run::Run( CameraCalibration& calibration ) :
+    m_calibration( calibration )
+{
+    // an asynchronous calibration is marked before it starts, it may have
+    // been cancelled already
+    {
+        std::lock_guard<std::mutex> lock( m_calibration.m_runMutex );
+        if( m_calibration.m_running && m_calibration.m_reservedFor != std::this_thread::get_id() )
+            throw std::runtime_error("CameraCalibration::calibrate: a calibration is running already.");
+        if( !m_calibration.m_running )
+            m_calibration.m_cancelled = false;
+        m_calibration.m_reservedFor = std::thread::id();
+        m_calibration.m_running = true;
+    }
+
+    // the budget starts now
+    if( m_calibration.m_timeBudget.count() > 0 )
+        m_calibration.m_deadline = std::chrono::steady_clock::now() + m_calibration.m_timeBudget;
+    else
+        m_calibration.m_deadline = std::chrono::steady_clock::time_point::max();
+
+    std::lock_guard<std::mutex> lock( m_calibration.m_snapshotMutex );
+    m_calibration.m_snapshotCameras.clear();
+    m_calibration.m_snapshot.reset();
+}
+
+
+CameraCalibration::Run::~Run()
+{
+    std::lock_guard<std::mutex> lock( m_calibration.m_runMutex );
+    m_calibration.m_running = false;
+    m_calibration.m_cancelled = false;
+}
+
+
+void CameraCalibration::commit( CameraSet_d &cs )
+{
+    for( auto camIt=m_filteredCameras.begin(); camIt != m_filteredCameras.end(); camIt++ )
+        commit( cs.camera( camIt->first ), camIt->second );
+}
+
+
+CameraCalibration::Rollback::Rollback( CameraSet_d& cs ) :
+    m_cs( cs ),
+    m_released( false )
+{
+    // the detection starts from scratch, the previous one is only kept aside
+    for( auto camIt=cs.cameras().begin(); camIt != cs.cameras().end(); camIt++ )
+    {
+        Camera_d& cam = camIt->second;
+        CameraState& state = m_cameras[ camIt->first ];
+        state.intrinsic = cam.intrinsic;
+        state.distortion = cam.distortion;
+        state.error = cam.error;
+        state.poses.resize( cam.poses.size() );
+        for( size_t p=0; p<cam.poses.size(); p++ )
+        {
+            Pose_d& pose = cam.poses[p];
+            PoseState& poseState = state.poses[p];
+            poseState.correspondences = std::move( pose.correspondences );
+            poseState.pattern = pose.pattern;
+            poseState.pointsMax = pose.pointsMax;
+            poseState.transformation = pose.transformation;
+            poseState.projected2D.swap( pose.projected2D );
+            poseState.rejected = pose.rejected;
         }
+    }
+}
+
+
+CameraCalibration::Rollback::~Rollback()
+{
+    if( m_released )
+        return;
 
-        // get camera params
-        cs.cameras()[ camIt->second.id ].intrinsic = camIt->second.intrinsic;
-        cs.cameras()[ camIt->second.id ].distortion = camIt->second.distortion;
-        cs.cameras()[ camIt->second.id ].error = camIt->second.error;
+    // the poses of the set are not added or removed while calibrating
+    for( auto it=m_cameras.begin(); it != m_cameras.end(); it++ )
+    {
+        auto camIt = m_cs.cameras().find( it->first );
+        if( camIt == m_cs.cameras().end() )
+            continue;
+        Camera_d& cam = camIt->second;
+        CameraState& state = it->second;
+        cam.intrinsic = state.intrinsic;
+        cam.distortion.swap( state.distortion );
+        cam.error = state.error;
+        for( size_t p=0; p<state.poses.size() && p<cam.poses.size(); p++ )
+        {
+            Pose_d& pose = cam.poses[p];
+            PoseState& poseState = state.poses[p];
+            pose.correspondences = std::move( poseState.correspondences );
+            pose.pattern = poseState.pattern;
+            pose.pointsMax = poseState.pointsMax;
+            pose.transformation = poseState.transformation;
+            pose.projected2D.swap( poseState.projected2D );
+            pose.rejected = poseState.rejected;
+        }
     }
 }
 
 
+void CameraCalibration::Rollback::release()
+{
+    m_released = true;
+    m_cameras.clear();
+}
+
+
+void CameraCalibration::commit( Camera_d& target, const CameraView_d& view )
+{
+    // the poses were solved in place, only accept them
+    for( size_t p=0; p<view.size(); p++ )
+        target.poses[ view.poses[p] ].rejected = false;
+
+    // get camera params
+    target.intrinsic = view.intrinsic;
+    target.distortion = view.distortion;
+    target.error = view.error;
+}
+
+
 void CameraCalibration::check()
 {
     if( !m_finder )
@@ -99,16 +321,83 @@ void CameraCalibration::check()
 }
 
 
-void CameraCalibration::threadID()
+void CameraCalibration::detect( const std::vector<Pose_d*>& poses )
+{
+    // serial finders and finders without clones stay on the configured instance
+    std::shared_ptr<Finder> clone;
+    if( m_finder->useOpenMP() && m_taskPool->threadCount() > 1 )
+        clone = m_finder->clone();
+    if( !clone )
+    {
+        for( size_t p=0; p<poses.size() && !stopping(); p++ )
+        {
+            if( m_finder->find( *poses[p] ) )
+                m_progress.add( Progress::PosesFound, 1 );
+            m_progress.add( Progress::PosesDetected, 1 );
+            m_progress.step();
+        }
+        return;
+    }
+
+    // clones are only created as tasks run concurrently and reused afterwards
+    std::mutex mutex;
+    std::vector< std::shared_ptr<Finder> > idle( 1, clone );
+    m_taskPool->parallel_for( 0, poses.size(), [&]( size_t p )
+    {
+        if( stopping() )
+            return;
+
+        std::shared_ptr<Finder> finder;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( !idle.empty() )
+            {
+                finder = idle.back();
+                idle.pop_back();
+            }
+        }
+        if( !finder )
+            finder = m_finder->clone();
+
+        if( finder->find( *poses[p] ) )
+            m_progress.add( Progress::PosesFound, 1 );
+        m_progress.add( Progress::PosesDetected, 1 );
+        m_progress.step();
+
+        std::lock_guard<std::mutex> lock( mutex );
+        idle.push_back( finder );
+    } );
+}
+
+
+bool CameraCalibration::stopping() const
+{
+    return m_cancelled || std::chrono::steady_clock::now() > m_deadline;
+}
+
+
+void CameraCalibration::checkCancelled() const
+{
+    if( m_cancelled )
+        throw std::runtime_error("CameraCalibration::calibrate: cancelled.");
+}
+
+
+void CameraCalibration::publish( const CameraView_d& view )
 {
-#ifdef IRIS_OPENMP
-     int tid=omp_get_thread_num();
-    int nThreads=omp_get_num_threads();
-    #pragma omp critical
     {
-        std::cout<<"Thread ID: "<< tid << " / " << nThreads <<std::endl;
+        std::lock_guard<std::mutex> lock( m_snapshotMutex );
+        if( !m_snapshotRequested )
+            return;
     }
-#endif
+
+    // the view's camera is only touched by the thread solving it
+    std::shared_ptr<Camera_d> camera( new Camera_d( *view.camera ) );
+    commit( *camera, view );
+
+    std::lock_guard<std::mutex> lock( m_snapshotMutex );
+    m_snapshotCameras[ camera->id ] = camera;
+    m_snapshot.reset();
 }
 
 
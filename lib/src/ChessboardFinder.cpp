@@ -50,8 +50,8 @@ ChessboardFinder::~ChessboardFinder() {
 
 void ChessboardFinder::configure( const size_t columns, const size_t rows, const double squareSize )
 {
-    // init stuff
-    m_points3D.clear();
+    // init stuff, poses found so far keep the previous pattern
+    std::shared_ptr<Pattern_d> pattern( new Pattern_d() );
     m_indices.clear();
 
     // set stuff
@@ -66,11 +66,12 @@ void ChessboardFinder::configure( const size_t columns, const size_t rows, const
     // compute the positions of the points
     for( size_t i=0; i<m_columns*m_rows; i++ )
     {
-        m_points3D.push_back( Eigen::Vector3d( static_cast<double>( i % m_columns ) *ss,
-                                               static_cast<double>( i / m_columns ) *ss,
-                                               0.0f ) );
+        pattern->points.push_back( Eigen::Vector3d( static_cast<double>( i % m_columns ) *ss,
+                                                    static_cast<double>( i / m_columns ) *ss,
+                                                    0.0f ) );
         m_indices.push_back(i);
     }
+    setPattern( pattern );
 
     // all is well in the jungle
     m_configured = true;
@@ -102,6 +103,25 @@ void ChessboardFinder::setSubpixelCorner( bool val )
 
 
 bool ChessboardFinder::find( Pose_d& pose )
+{
+    return findPose( pose );
+}
+
+
+bool ChessboardFinder::find( Pose_f& pose )
+{
+    return findPose( pose );
+}
+
+
+std::shared_ptr<Finder> ChessboardFinder::clone() const
+{
+    return std::make_shared<ChessboardFinder>( *this );
+}
+
+
+template <typename T>
+bool ChessboardFinder::findPose( Pose<T>& pose )
 {
     // check if configured
     if( !m_configured )
@@ -109,13 +129,12 @@ bool ChessboardFinder::find( Pose_d& pose )
 
     // init stuff
     cimg_library::CImg<uint8_t>& image = *(pose.image);
-    cv::Mat imageCV;
-    std::vector< cv::Point2f > corners;
+    cv::Mat& imageCV = m_scratch.image;
+    std::vector< cv::Point2f >& corners = m_scratch.corners;
     cv::Size patternSize( m_columns, m_rows );
     bool found = false;
-    pose.points2D.clear();
-    pose.points3D.clear();
-    pose.pointIndices.clear();
+    pose.correspondences.clear();
+    pose.pattern.reset();
 
     // convert it to the openCV internal format
     iris::cimg2cv( image, imageCV );
@@ -129,12 +148,13 @@ bool ChessboardFinder::find( Pose_d& pose )
     else
     {
         // scale down untill targets are met
-        cimg_library::CImg<uint8_t> imageNew = image.get_resize_halfXY();
+        cimg_library::CImg<uint8_t>& imageNew = m_scratch.resized;
+        imageNew = image.get_resize_halfXY();
         for( size_t f=divFac/2; f>1; f=f/2 )
             imageNew.resize_halfXY();
 
         // convert to openCV
-        cv::Mat imageNewCV;
+        cv::Mat& imageNewCV = m_scratch.scaled;
         iris::cimg2cv( imageNew, imageNewCV );
 
         // now detect the corners
@@ -154,27 +174,26 @@ bool ChessboardFinder::find( Pose_d& pose )
     if( found )
     {
         // check if all corners were found (not sure this is necessary)
-        if( corners.size() != m_points3D.size() )
+        if( corners.size() != m_pattern->points.size() )
             throw std::runtime_error("ChessboardFinder::find: found less corners then the grid should have.");
 
         // try to refine the corners (example from the opencv doc)
         if( m_subpixelCorner )
         {
-            cv::Mat grayImage;
-            if( pose.image->spectrum() == 1 )
-                grayImage = imageCV;
-            else
-                cv::cvtColor(imageCV, grayImage, CV_RGB2GRAY);
+            cv::Mat grayImage = imageCV;
+            if( pose.image->spectrum() != 1 )
+            {
+                cv::cvtColor(imageCV, m_scratch.gray, CV_RGB2GRAY);
+                grayImage = m_scratch.gray;
+            }
             cv::cornerSubPix(grayImage, corners, cv::Size(11, 11), cv::Size(-1, -1), cv::TermCriteria(CV_TERMCRIT_EPS + CV_TERMCRIT_ITER, 10, 0.1 ));
         }
 
-        // convert to eigen
+        // convert to eigen, referring to the pattern's points
+        pose.correspondences.reserve( corners.size() );
         for( size_t i=0; i<corners.size(); i++ )
-            pose.points2D.push_back( Eigen::Vector2d( corners[i].x, corners[i].y ) );
-
-        // set the 3d Points
-        pose.points3D = m_points3D;
-        pose.pointIndices = m_indices;
+            pose.correspondences.push_back( Eigen::Matrix<T,2,1>( corners[i].x, corners[i].y ), m_indices[i] );
+        pose.pattern = sharedPattern( pose );
         pose.pointsMax = m_indices.size();
     }
 
@@ -57,5 +57,61 @@ void Finder::setScale( double scale )
 }
 
 
+std::shared_ptr<const Pattern_d> Finder::pattern() const
+{
+    return m_pattern;
+}
+
+
+bool Finder::find( Pose_f& pose )
+{
+    // detect on the same image
+    Pose_d result;
+    result.image = pose.image;
+    bool found = find( result );
+
+    // convert, the pattern is the shared single precision copy
+    pose.correspondences = result.correspondences.cast<float>();
+    pose.projected2D = result.projected2D.cast<float>();
+    pose.pointsMax = result.pointsMax;
+    if( result.pattern == m_pattern )
+        pose.pattern = m_patternFloat;
+    else
+    {
+        std::map< const Pattern_d*, std::shared_ptr<const Pattern_f> > patterns;
+        pose.pattern = cast_pattern<float>( result.pattern, patterns );
+    }
+
+    return found;
+}
+
+
+std::shared_ptr<Finder> Finder::clone() const
+{
+    return std::shared_ptr<Finder>();
+}
+
+
+void Finder::setPattern( const std::shared_ptr<const Pattern_d>& pattern )
+{
+    // poses found so far keep the previous patterns
+    std::map< const Pattern_d*, std::shared_ptr<const Pattern_f> > patterns;
+    m_patternFloat = cast_pattern<float>( pattern, patterns );
+    m_pattern = pattern;
+}
+
+
+const std::shared_ptr<const Pattern_d>& Finder::sharedPattern( const Pose_d& ) const
+{
+    return m_pattern;
+}
+
+
+const std::shared_ptr<const Pattern_f>& Finder::sharedPattern( const Pose_f& ) const
+{
+    return m_patternFloat;
+}
+
+
 } // end namespace iris
 
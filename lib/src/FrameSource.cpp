@@ -0,0 +1,398 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * FrameSource.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <cstdio>
+
+#include <sys/stat.h>
+
+#include <iris/FrameSource.hpp>
+
+namespace iris {
+
+FrameSource::FrameSource() :
+    m_queueSize( 8 ),
+    m_stride( 1 ),
+    m_thumbnailWidth( 64 ),
+    m_maxMotion( 4.0 ),
+    m_minNovelty( 6.0 ),
+    m_minPoseNovelty( 20.0 ),
+    m_frameIndex( 0 ),
+    m_open( false ),
+    m_stop( false ),
+    m_finished( true ),
+    m_decodedFrames( 0 ),
+    m_candidateFrames( 0 )
+{
+}
+
+
+FrameSource::~FrameSource()
+{
+    close();
+}
+
+
+void FrameSource::setQueueSize( size_t val )
+{
+    m_queueSize = std::max<size_t>( val, 1 );
+}
+
+
+void FrameSource::setStride( size_t val )
+{
+    m_stride = std::max<size_t>( val, 1 );
+}
+
+
+void FrameSource::setThumbnailWidth( int val )
+{
+    m_thumbnailWidth = std::max( val, 8 );
+}
+
+
+void FrameSource::setMaxMotion( double val )
+{
+    m_maxMotion = val;
+}
+
+
+void FrameSource::setMinNovelty( double val )
+{
+    m_minNovelty = val;
+}
+
+
+void FrameSource::setMinPoseNovelty( double val )
+{
+    m_minPoseNovelty = val;
+}
+
+
+void FrameSource::open( const std::string& path )
+{
+    // init stuff
+    close();
+    m_files.clear();
+    m_frameIndex = 0;
+    m_previous.release();
+    m_lastCandidate.release();
+    m_lastPoints.clear();
+    m_decodedFrames = 0;
+    m_candidateFrames = 0;
+    m_error = std::exception_ptr();
+
+    // name of the source without path and extension
+    size_t slash = path.find_last_of( "/\\" );
+    m_stem = ( slash == std::string::npos ) ? path : path.substr( slash + 1 );
+    m_stem = m_stem.substr( 0, m_stem.find_last_of( '.' ) );
+
+    // directory of images or video file
+    struct stat info;
+    if( stat( path.c_str(), &info ) == 0 && S_ISDIR( info.st_mode ) )
+    {
+        // collect the images in lexicographic order
+        std::vector<std::string> files;
+        cv::glob( path, files, false );
+        const char* extensions[] = { ".png", ".jpg", ".jpeg", ".bmp", ".tif", ".tiff", ".ppm", ".pgm" };
+        for( size_t i=0; i<files.size(); i++ )
+        {
+            std::string extension = files[i].substr( std::min( files[i].find_last_of( '.' ), files[i].size() ) );
+            std::transform( extension.begin(), extension.end(), extension.begin(), ::tolower );
+            if( std::find( extensions, extensions + 8, extension ) != extensions + 8 )
+                m_files.push_back( files[i] );
+        }
+        std::sort( m_files.begin(), m_files.end() );
+
+        if( m_files.size() == 0 )
+            throw std::runtime_error( "FrameSource::open: no images in \"" + path + "\"." );
+    }
+    else if( !m_capture.open( path ) )
+        throw std::runtime_error( "FrameSource::open: could not open \"" + path + "\"." );
+
+    // start decoding
+    m_stop = false;
+    m_finished = false;
+    m_open = true;
+    m_thread = std::thread( &FrameSource::decode, this );
+}
+
+
+void FrameSource::close()
+{
+    // stop the decoder
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_stop = true;
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+    if( m_thread.joinable() )
+        m_thread.join();
+
+    // clean up
+    m_capture.release();
+    m_queue.clear();
+    m_finished = true;
+    m_open = false;
+}
+
+
+bool FrameSource::isOpen() const
+{
+    return m_open;
+}
+
+
+bool FrameSource::next( std::shared_ptr< cimg_library::CImg<uint8_t> >& image, std::string& name )
+{
+    // wait for a frame or the end of the input
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while( m_queue.empty() && !m_finished )
+        m_notEmpty.wait( lock );
+
+    // a failed decoder ends the input with its error
+    if( m_queue.empty() && m_error )
+    {
+        std::exception_ptr error = m_error;
+        m_error = std::exception_ptr();
+        std::rethrow_exception( error );
+    }
+    if( m_queue.empty() )
+        return false;
+
+    // pass it on
+    image = m_queue.front().image;
+    name = m_queue.front().name;
+    m_queue.pop_front();
+    m_notFull.notify_one();
+    return true;
+}
+
+
+size_t FrameSource::process( CameraSet_d& cs, Finder& finder, const size_t cameraID )
+{
+    // init stuff
+    size_t added = 0;
+    std::shared_ptr< cimg_library::CImg<uint8_t> > image;
+    std::string name;
+
+    // decoding continues in the background while we detect
+    while( next( image, name ) )
+    {
+        Pose_d pose;
+        pose.name = name;
+        pose.image = image;
+        if( !finder.find( pose ) || !isNovel( pose ) )
+            continue;
+
+        // keep the detection, the calibration does not have to repeat it
+        pose.id = cs.nextPoseId();
+        cs.insert( std::move( pose ), cameraID );
+        added++;
+    }
+
+    return added;
+}
+
+
+size_t FrameSource::decodedFrames() const
+{
+    return m_decodedFrames;
+}
+
+
+size_t FrameSource::candidateFrames() const
+{
+    return m_candidateFrames;
+}
+
+
+void FrameSource::decode()
+{
+    // errors must not leave the thread, next() rethrows them
+    try
+    {
+        decodeFrames();
+    }
+    catch( ... )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_error = std::current_exception();
+    }
+
+    // signal the end of the input
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_finished = true;
+    m_notEmpty.notify_all();
+}
+
+
+void FrameSource::decodeFrames()
+{
+    cv::Mat frame;
+    while( !m_stop && read( frame ) )
+    {
+        m_decodedFrames++;
+        if( !isCandidate( frame ) )
+            continue;
+        m_candidateFrames++;
+
+        // convert to RGB
+        Frame candidate;
+        cv::Mat rgb;
+        if( frame.channels() == 3 )
+            cv::cvtColor( frame, rgb, CV_BGR2RGB );
+        else
+            rgb = frame;
+        candidate.image = std::shared_ptr< cimg_library::CImg<uint8_t> >( new cimg_library::CImg<uint8_t>() );
+        cv2cimg( rgb, *candidate.image );
+
+        // name it after the frame or the file
+        if( m_files.size() > 0 )
+        {
+            size_t slash = m_files[m_frameIndex].find_last_of( "/\\" );
+            candidate.name = ( slash == std::string::npos ) ? m_files[m_frameIndex] : m_files[m_frameIndex].substr( slash + 1 );
+        }
+        else
+        {
+            char index[32];
+            std::sprintf( index, "%06lu", static_cast<unsigned long>( m_frameIndex ) );
+            candidate.name = m_stem + "-" + index + ".png";
+        }
+
+        // wait for space in the queue
+        std::unique_lock<std::mutex> lock( m_mutex );
+        while( m_queue.size() >= m_queueSize && !m_stop )
+            m_notFull.wait( lock );
+        if( m_stop )
+            break;
+        m_queue.push_back( candidate );
+        m_notEmpty.notify_one();
+    }
+}
+
+
+bool FrameSource::read( cv::Mat& frame )
+{
+    // image sequence, skipped files are never loaded
+    if( m_files.size() > 0 )
+    {
+        size_t index = ( m_decodedFrames == 0 ) ? 0 : m_frameIndex + m_stride;
+        for( ; index < m_files.size(); index++ )
+        {
+            frame = cv::imread( m_files[index] );
+            if( !frame.empty() )
+            {
+                m_frameIndex = index;
+                return true;
+            }
+        }
+        m_frameIndex = m_files.size();
+        return false;
+    }
+
+    // video, skipped frames are grabbed but not decoded
+    size_t skip = ( m_decodedFrames == 0 ) ? 0 : m_stride - 1;
+    for( size_t i=0; i<skip; i++ )
+        if( !m_capture.grab() )
+            return false;
+    if( !m_capture.read( frame ) || frame.empty() )
+        return false;
+    m_frameIndex = ( m_decodedFrames == 0 ) ? 0 : m_frameIndex + m_stride;
+    return true;
+}
+
+
+bool FrameSource::isCandidate( const cv::Mat& frame )
+{
+    // small grayscale thumbnail
+    cv::Mat gray, thumbnail;
+    if( frame.channels() == 3 )
+        cv::cvtColor( frame, gray, CV_BGR2GRAY );
+    else if( frame.channels() == 4 )
+        cv::cvtColor( frame, gray, CV_BGRA2GRAY );
+    else
+        gray = frame;
+    int height = std::max( 1, ( m_thumbnailWidth * frame.rows ) / std::max( frame.cols, 1 ) );
+    cv::resize( gray, thumbnail, cv::Size( m_thumbnailWidth, height ), 0, 0, cv::INTER_AREA );
+
+    // a moving camera gives blurry frames, frames of another size can not be
+    // compared and count as still
+    cv::Mat diff;
+    bool still = true;
+    if( !m_previous.empty() && m_previous.size() == thumbnail.size() && m_previous.type() == thumbnail.type() )
+    {
+        cv::absdiff( thumbnail, m_previous, diff );
+        still = cv::mean( diff )[0] <= m_maxMotion;
+    }
+    m_previous = thumbnail;
+    if( !still )
+        return false;
+
+    // the frame has to differ from the last candidate, one of another size does
+    if( !m_lastCandidate.empty() && m_lastCandidate.size() == thumbnail.size() && m_lastCandidate.type() == thumbnail.type() )
+    {
+        cv::absdiff( thumbnail, m_lastCandidate, diff );
+        if( cv::mean( diff )[0] < m_minNovelty )
+            return false;
+    }
+    m_lastCandidate = thumbnail;
+    return true;
+}
+
+
+bool FrameSource::isNovel( const Pose_d& pose )
+{
+    // mean displacement of the points seen in both poses
+    double displacement = 0;
+    size_t common = 0;
+    std::map< size_t, Eigen::Vector2d > points;
+    for( size_t i=0; i<pose.correspondences.size(); i++ )
+    {
+        size_t index = pose.correspondences.index( i );
+        points[index] = pose.correspondences.point( i );
+
+        std::map< size_t, Eigen::Vector2d >::const_iterator last = m_lastPoints.find( index );
+        if( last != m_lastPoints.end() )
+        {
+            displacement += ( points[index] - last->second ).norm();
+            common++;
+        }
+    }
+
+    // little displacement means the same view again
+    if( common > 0 && displacement / static_cast<double>( common ) < m_minPoseNovelty )
+        return false;
+
+    m_lastPoints.swap( points );
+    return true;
+}
+
+
+} // end namespace iris
@@ -0,0 +1,310 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Initialization.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <cmath>
+
+#include <Eigen/Cholesky>
+#include <Eigen/SVD>
+
+#include <iris/Initialization.hpp>
+#include <iris/Projection.hpp>
+
+namespace iris {
+
+Initialization::Initialization() :
+    m_fixAspectRatio( false ),
+    m_fixPrincipalPoint( false ),
+    m_poseRefinement( 5 ),
+    m_taskPool( TaskPool::shared() )
+{
+}
+
+
+Initialization::~Initialization()
+{
+}
+
+
+void Initialization::setFixAspectRatio( bool val )
+{
+    m_fixAspectRatio = val;
+}
+
+
+void Initialization::setFixPrincipalPoint( bool val )
+{
+    m_fixPrincipalPoint = val;
+}
+
+
+void Initialization::setPoseRefinement( size_t iterations )
+{
+    m_poseRefinement = iterations;
+}
+
+
+void Initialization::setTaskPool( std::shared_ptr<TaskPool> pool )
+{
+    if( !pool )
+        throw std::runtime_error( "Initialization::setTaskPool: pool not set." );
+
+    m_taskPool = pool;
+}
+
+
+std::vector<Eigen::Matrix3d> Initialization::homographies( const CameraView_d& view ) const
+{
+    std::vector<Eigen::Matrix3d> result( view.size(), Eigen::Matrix3d::Zero() );
+
+    m_taskPool->parallel_for( 0, view.size(), [&]( size_t p )
+    {
+        // check the pose, rejected points do not count
+        const Pose_d& pose = view.pose(p);
+        size_t n = pose.correspondences.weightedCount();
+        if( n < 4 || !pose.hasPoints3D() )
+            return;
+
+        // the pattern has to be planar
+        bool planar = true;
+        Correspondences<double>::Points plane( 2, n ), image( 2, n );
+        for( size_t i=0, k=0; i<pose.correspondences.size() && planar; i++ )
+        {
+            if( !( pose.correspondences.weight( i ) > 0.0 ) )
+                continue;
+            planar = std::fabs( pose.point3D(i)(2) ) < std::numeric_limits<float>::epsilon();
+            plane.col(k) = pose.point3D(i).head<2>();
+            image.col(k) = pose.correspondences.point( i );
+            k++;
+        }
+
+        if( planar )
+            result[p] = compute_homography( plane, image );
+    } );
+
+    return result;
+}
+
+
+bool Initialization::intrinsics( const std::vector<Eigen::Matrix3d>& homographies, const Eigen::Vector2i& imageSize, Eigen::Matrix3d& K ) const
+{
+    // condition the image coordinates
+    double s = 2.0 / static_cast<double>( imageSize(0) + imageSize(1) );
+    Eigen::Matrix3d N;
+    N << s, 0, -0.5*s*imageSize(0),
+         0, s, -0.5*s*imageSize(1),
+         0, 0, 1;
+
+    // accumulate Zhang's constraints on b = [B11 B12 B22 B13 B23 B33]
+    Eigen::Matrix<double,6,6> VtV = Eigen::Matrix<double,6,6>::Zero();
+    size_t views = 0;
+    for( size_t i=0; i<homographies.size(); i++ )
+    {
+        if( homographies[i].isZero() )
+            continue;
+
+        Eigen::Matrix3d H = N * homographies[i];
+        H /= H.norm();
+
+        // v_ij from the columns i and j of H
+        Eigen::Matrix<double,6,1> v[2][2];
+        for( int a=0; a<2; a++ )
+            for( int b=0; b<2; b++ )
+                v[a][b] << H(0,a)*H(0,b),
+                           H(0,a)*H(1,b) + H(1,a)*H(0,b),
+                           H(1,a)*H(1,b),
+                           H(2,a)*H(0,b) + H(0,a)*H(2,b),
+                           H(2,a)*H(1,b) + H(1,a)*H(2,b),
+                           H(2,a)*H(2,b);
+
+        Eigen::Matrix<double,6,1> c1 = v[0][1];
+        Eigen::Matrix<double,6,1> c2 = v[0][0] - v[1][1];
+        VtV += c1*c1.transpose() + c2*c2.transpose();
+        views++;
+    }
+
+    // zero skew, and optionally a centered principal point and square pixels
+    double w = static_cast<double>( views );
+    Eigen::Matrix<double,6,1> c;
+    c << 0, 1, 0, 0, 0, 0;
+    VtV += w * c*c.transpose();
+    if( m_fixPrincipalPoint )
+    {
+        c << 0, 0, 0, 1, 0, 0; VtV += w * c*c.transpose();
+        c << 0, 0, 0, 0, 1, 0; VtV += w * c*c.transpose();
+    }
+    if( m_fixAspectRatio )
+    {
+        c << 1, 0, -1, 0, 0, 0;
+        VtV += w * c*c.transpose();
+    }
+
+    // we need at least two views, or one with the extra constraints
+    if( views < 2 && !( views == 1 && m_fixPrincipalPoint ) )
+        return false;
+
+    // b is the eigenvector of the smallest eigenvalue
+    Eigen::SelfAdjointEigenSolver< Eigen::Matrix<double,6,6> > es( VtV );
+    Eigen::Matrix<double,6,1> b = es.eigenvectors().col(0);
+    if( b(0) < 0 )
+        b = -b;
+
+    // extract the intrinsics (Zhang 2000, appendix B) with zero skew
+    double d = b(0)*b(2) - b(1)*b(1);
+    if( std::fabs( d ) < std::numeric_limits<double>::epsilon() || b(0) <= 0 )
+        return false;
+    double v0 = ( b(1)*b(3) - b(0)*b(4) ) / d;
+    double lambda = b(5) - ( b(3)*b(3) + v0*( b(1)*b(3) - b(0)*b(4) ) ) / b(0);
+    double alpha2 = lambda / b(0);
+    double beta2 = lambda * b(0) / d;
+    if( alpha2 <= 0 || beta2 <= 0 )
+        return false;
+    double alpha = std::sqrt( alpha2 );
+    double beta = std::sqrt( beta2 );
+    double u0 = -b(3) * alpha2 / lambda;
+
+    // the constraints are only weighted in the system, enforce them
+    if( m_fixAspectRatio )
+        alpha = beta = 0.5 * ( alpha + beta );
+    if( m_fixPrincipalPoint )
+        u0 = v0 = 0;
+
+    // undo the conditioning
+    Eigen::Matrix3d Kn;
+    Kn << alpha, 0, u0,
+          0, beta, v0,
+          0, 0, 1;
+    K = N.inverse() * Kn;
+    K /= K(2,2);
+    K(0,1) = 0;
+    return true;
+}
+
+
+Eigen::Matrix4d Initialization::pose( const Eigen::Matrix3d& K, const Eigen::Matrix3d& H, const Pose_d& pose ) const
+{
+    // decompose K^-1 H = lambda [r1 r2 t]
+    Eigen::Matrix3d M = K.inverse() * H;
+    double lambda = 1.0 / M.col(0).norm();
+    if( M(2,2) < 0 )
+        lambda = -lambda;
+    Eigen::Vector3d r1 = lambda * M.col(0);
+    Eigen::Vector3d r2 = lambda * M.col(1);
+    Eigen::Vector3d t = lambda * M.col(2);
+
+    // closest rotation
+    Eigen::Matrix3d R;
+    R << r1, r2, r1.cross( r2 );
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd( R, Eigen::ComputeFullU | Eigen::ComputeFullV );
+    R = svd.matrixU() * svd.matrixV().transpose();
+    if( R.determinant() < 0 )
+        R = -R;
+
+    Eigen::Matrix4d T = Eigen::Matrix4d::Identity();
+    T.topLeftCorner<3,3>() = R;
+    T.topRightCorner<3,1>() = t;
+
+    // refine with a few Gauss-Newton steps on the reprojection error
+    typedef PinholeModel<double> Model;
+    double params[Model::ParamCount] = { K(0,0), K(1,1), K(0,2), K(1,2) };
+    std::vector<Eigen::Vector3d> points3D = pose.points3D();
+    size_t n = points3D.size();
+    Eigen::VectorXd u( n );
+    Eigen::VectorXd v( n );
+    std::vector< Eigen::Matrix<double,2,6>, Eigen::aligned_allocator< Eigen::Matrix<double,2,6> > > dPose( n );
+    for( size_t it=0; it<m_poseRefinement && n > 0; it++ )
+    {
+        project<Model>( params, T, pointsMap( points3D ), u, v, 0, &dPose[0], 0 );
+
+        // residuals straight from the columns of the correspondences,
+        // weighted so that rejected points drop out
+        const Eigen::VectorXd ru = pose.correspondences.x() - u;
+        const Eigen::VectorXd rv = pose.correspondences.y() - v;
+        Eigen::Matrix<double,6,6> JtJ = Eigen::Matrix<double,6,6>::Zero();
+        Eigen::Matrix<double,6,1> Jtr = Eigen::Matrix<double,6,1>::Zero();
+        for( size_t i=0; i<n; i++ )
+        {
+            const double weight = pose.correspondences.weight( i );
+            JtJ += weight * dPose[i].transpose() * dPose[i];
+            Jtr += weight * dPose[i].transpose() * Eigen::Vector2d( ru(i), rv(i) );
+        }
+        Eigen::Matrix<double,6,1> delta = JtJ.ldlt().solve( Jtr );
+        if( !delta.allFinite() )
+            break;
+
+        // apply the update
+        Eigen::Vector3d w = delta.head<3>();
+        if( w.norm() > 0 )
+            T.topLeftCorner<3,3>() = Eigen::AngleAxisd( w.norm(), w.normalized() ).toRotationMatrix() * T.topLeftCorner<3,3>();
+        T.topRightCorner<3,1>() += delta.tail<3>();
+
+        if( delta.norm() < 1e-12 )
+            break;
+    }
+
+    return T;
+}
+
+
+bool Initialization::initialize( CameraView_d& view ) const
+{
+    // homographies and intrinsics
+    std::vector<Eigen::Matrix3d> H = homographies( view );
+    Eigen::Matrix3d K;
+    if( !intrinsics( H, view.camera->imageSize, K ) )
+        return false;
+
+    // store the intrinsics, the distortion starts at zero
+    view.intrinsic = K;
+    view.distortion.assign( 5, 0.0 );
+
+    // estimate the poses
+    m_taskPool->parallel_for( 0, view.size(), [&]( size_t p )
+    {
+        if( !H[p].isZero() )
+            view.pose(p).transformation = pose( K, H[p], view.pose(p) );
+    } );
+
+    return true;
+}
+
+
+bool Initialization::initialize( Camera_d& cam ) const
+{
+    // view all poses and keep the result
+    CameraView_d view( cam );
+    view.addAll();
+    if( !initialize( view ) )
+        return false;
+
+    cam.intrinsic = view.intrinsic;
+    cam.distortion = view.distortion;
+    return true;
+}
+
+
+} // end namespace iris
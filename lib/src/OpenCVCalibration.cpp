@@ -28,6 +28,7 @@
 
 
 #include <iris/OpenCVCalibration.hpp>
+#include <iris/Projection.hpp>
 
 
 namespace iris {
@@ -38,8 +39,12 @@ OpenCVCalibration::OpenCVCalibration() :
     m_fixAspectRatio( true ),
     m_tangentialDistortion( true ),
     m_intrinsicGuess(false),
-    m_minPoseCorrespondences( 8 )
+    m_minPoseCorrespondences( 8 ),
+    m_rejectOutliers( false ),
+    m_closedFormInitialization( false )
 {
+    m_outlierRejection.setTaskPool( m_taskPool );
+    m_initialization.setTaskPool( m_taskPool );
 }
 
 
@@ -78,22 +83,99 @@ void OpenCVCalibration::setIntrinsicGuess( bool val )
 }
 
 
-std::vector< Eigen::Vector2d > OpenCVCalibration::projectPoints( const std::vector<cv::Point3f> points3D,
-                                                                 const cv::Mat& rot,
-                                                                 const cv::Mat& transl,
-                                                                 const cv::Mat& cameraMatrix,
-                                                                 const cv::Mat& distCoeff )
+void OpenCVCalibration::setRejectOutliers( bool val )
 {
-    // init stuff
-    std::vector< cv::Point2f > projected;
-    std::vector< Eigen::Vector2d > result;
+    m_rejectOutliers = val;
+}
+
+
+void OpenCVCalibration::setClosedFormInitialization( bool val )
+{
+    m_closedFormInitialization = val;
+}
+
+
+void OpenCVCalibration::setTaskPool( std::shared_ptr<TaskPool> pool )
+{
+    CameraCalibration::setTaskPool( pool );
+    m_outlierRejection.setTaskPool( pool );
+    m_initialization.setTaskPool( pool );
+}
+
+
+OutlierRejection& OpenCVCalibration::outlierRejection()
+{
+    return m_outlierRejection;
+}
+
+
+const OutlierRejection::Report& OpenCVCalibration::outlierReport() const
+{
+    return m_outlierReport;
+}
+
+
+Initialization& OpenCVCalibration::initialization()
+{
+    return m_initialization;
+}
+
+
+bool OpenCVCalibration::initialize( CameraView_d& view ) const
+{
+    // a user supplied guess takes precedence
+    if( !m_closedFormInitialization || m_intrinsicGuess )
+        return false;
+
+    // the guess has to respect the constraints of the solver
+    Initialization init = m_initialization;
+    init.setFixAspectRatio( m_fixAspectRatio );
+    init.setFixPrincipalPoint( m_fixPrincipalPoint );
+    return init.initialize( view );
+}
 
-    // project points and store
-    cv::projectPoints( cv::Mat(points3D), rot, transl, cameraMatrix, distCoeff, projected );
-    for( size_t p=0; p<projected.size(); p++ )
-        result.push_back( Eigen::Vector2d( projected[p].x, projected[p].y ) );
 
-    // return
+bool OpenCVCalibration::initialize( const CameraView_d& view, Eigen::Matrix3d& K ) const
+{
+    if( !m_closedFormInitialization || m_intrinsicGuess )
+        return false;
+
+    Initialization init = m_initialization;
+    init.setFixAspectRatio( m_fixAspectRatio );
+    init.setFixPrincipalPoint( m_fixPrincipalPoint );
+    return init.intrinsics( init.homographies( view ), view.camera->imageSize, K );
+}
+
+
+Correspondences<double>::Points OpenCVCalibration::projectPoints( const std::vector<cv::Point3f> points3D,
+                                                                  const cv::Mat& rot,
+                                                                  const cv::Mat& transl,
+                                                                  const cv::Mat& cameraMatrix,
+                                                                  const cv::Mat& distCoeff )
+{
+    // init stuff
+    typedef RadialTangentialModel<double> Model;
+    Eigen::Matrix4d transformation;
+    double params[Model::ParamCount] = { 0 };
+    Correspondences<double>::Points result( 2, points3D.size() );
+
+    // convert pose and camera
+    iris::cv2eigen( rot, transl, transformation );
+    params[0] = cameraMatrix.at<double>(0,0);
+    params[1] = cameraMatrix.at<double>(1,1);
+    params[2] = cameraMatrix.at<double>(0,2);
+    params[3] = cameraMatrix.at<double>(1,2);
+    for( int i=0; i<5 && i<static_cast<int>( distCoeff.total() ); i++ )
+        params[4+i] = distCoeff.at<double>(i);
+
+    // project the points where they are, straight into the layout of the correspondences
+    static_assert( sizeof( cv::Point3f ) == 3*sizeof( float ), "cv::Point3f is expected to be three packed floats" );
+    if( points3D.size() > 0 )
+    {
+        Eigen::Map< const Eigen::Matrix<float,3,Eigen::Dynamic> > points( &points3D[0].x, 3, points3D.size() );
+        project<Model>( params, transformation, points.cast<double>(), result.row(0).transpose(), result.row(1).transpose() );
+    }
+
     return result;
 }
 
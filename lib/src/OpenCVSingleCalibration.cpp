@@ -26,9 +26,7 @@
  *      Author: duliu
  */
 
-#ifdef IRIS_OPENMP
-#include <omp.h>
-#endif
+#include <mutex>
 
 
 #include <iris/OpenCVSingleCalibration.hpp>
@@ -38,6 +36,7 @@ namespace iris {
 
 OpenCVSingleCalibration::OpenCVSingleCalibration() : OpenCVCalibration()
 {
+    m_poseSelection.setTaskPool( m_taskPool );
 }
 
 
@@ -46,81 +45,145 @@ OpenCVSingleCalibration::~OpenCVSingleCalibration() {
 }
 
 
+void OpenCVSingleCalibration::setMaxPoses( size_t val )
+{
+    m_poseSelection.setMaxPoses( val );
+}
+
+
+void OpenCVSingleCalibration::setTaskPool( std::shared_ptr<TaskPool> pool )
+{
+    OpenCVCalibration::setTaskPool( pool );
+    m_poseSelection.setTaskPool( pool );
+}
+
+
 void OpenCVSingleCalibration::calibrate( CameraSet_d &cs )
 {
     // check that all is OK
+    Run run( *this );
     check();
 
-    // init progress bar
-    iris::progress<size_t> pb( "OpenCVSingleCalibration::calibrate: ", cs.poseCount() );
+    // solve in place, the set is restored unless the calibration succeeds
+    Rollback rollback( cs );
 
-    // run over all cameras and calibrate them
+    // flatten all poses of all cameras into one task list
+    std::vector< Pose_d* > poses;
     for( auto it = cs.cameras().begin(); it != cs.cameras().end(); it++ )
-    {
-        // update stuff
-        std::vector< Pose_d >& poses = it->second.poses;
-        size_t poseCount = poses.size();
+        for( size_t p=0; p<it->second.poses.size(); p++ )
+            poses.push_back( &it->second.poses[p] );
 
+    // run feature detection
+    m_progress.reset();
+    m_progress.begin( "OpenCVSingleCalibration::calibrate: detecting ", poses.size() );
+    detect( poses );
+    m_progress.finish();
+    checkCancelled();
 
-        // run feature detection
-        if( m_finder->useOpenMP() )
-        {
-            #pragma omp parallel for
-            for( int p=0; p<poseCount; p++ )
-            {
-                m_finder->find( poses[p] );
+    // filter the poses
+    filter( cs );
 
-                #pragma omp critical
-                {
-                    pb.next_step();
-                }
-            }
+    // verify the correspondences of each pose before solving
+    m_outlierReport = OutlierRejection::Report();
+    if( m_rejectOutliers )
+    {
+        m_outlierRejection.setMinPoints( m_minPoseCorrespondences + 1 );
+        for( auto it = m_filteredCameras.begin(); it != m_filteredCameras.end(); )
+        {
+            m_outlierReport += m_outlierRejection.verify( it->second );
+            if( it->second.poses.size() == 0 )
+                m_filteredCameras.erase( it++ );
+            else
+                it++;
         }
-        else
+    }
+
+    // calibrate all cameras, they are independent of each other
+    std::vector< CameraView_d* > cameras;
+    for( auto it = m_filteredCameras.begin(); it != m_filteredCameras.end(); it++ )
+        cameras.push_back( &it->second );
+    int calibrationFlags = flags();
+
+    std::mutex reportMutex;
+    m_progress.begin( "OpenCVSingleCalibration::calibrate: solving ", cameras.size() );
+    m_taskPool->parallel_for( 0, cameras.size(), [&]( size_t c )
+    {
+        // start from the closed-form solution if there is one
+        checkCancelled();
+        int cameraFlags = calibrationFlags;
+        if( initialize( *cameras[c] ) )
+            cameraFlags = cameraFlags | CV_CALIB_USE_INTRINSIC_GUESS;
+        calibrateCamera( *cameras[c], cameraFlags );
+        publish( *cameras[c] );
+
+        // trim by residuals and solve again until nothing changes or time is up
+        for( size_t i=0; m_rejectOutliers && i<m_outlierRejection.maxTrimIterations() && !stopping(); i++ )
         {
-            for( int p=0; p<poseCount; p++ )
+            OutlierRejection::Report report = m_outlierRejection.trim( *cameras[c] );
             {
-                m_finder->find( poses[p] );
-                pb.next_step();
+                std::lock_guard<std::mutex> lock( reportMutex );
+                m_outlierReport += report;
             }
-        }
-    }
 
-    // filter the poses
-    filter( cs );
+            if( report.pointsRemoved == 0 || cameras[c]->poses.size() == 0 )
+                break;
+            calibrateCamera( *cameras[c], cameraFlags );
+            publish( *cameras[c] );
+        }
+        m_progress.step();
+    } );
+    m_progress.finish();
+    checkCancelled();
 
-    // calibrate all cameras
-    for( auto it = m_filteredCameras.begin(); it != m_filteredCameras.end(); it++ )
-        calibrateCamera( it->second, flags() );
+    // a camera might have lost all its poses
+    for( auto it = m_filteredCameras.begin(); it != m_filteredCameras.end(); )
+    {
+        if( it->second.poses.size() == 0 )
+            m_filteredCameras.erase( it++ );
+        else
+            it++;
+    }
 
     // wrap up
-    pb.finish();
+    m_progress.add( Progress::PointsRemoved, m_outlierReport.pointsRemoved );
+    m_progress.add( Progress::PosesRemoved, m_outlierReport.posesRemoved );
     commit( cs );
+    rollback.release();
 }
 
 
-void OpenCVSingleCalibration::calibrateCamera( Camera_d &cam, int flags )
+void OpenCVSingleCalibration::calibrateCamera( CameraView_d& view, int flags )
 {
     // init stuff
     std::vector< std::vector<cv::Point2f> > cvVectorPoints2D;
     std::vector< std::vector<cv::Point3f> > cvVectorPoints3D;
     cv::Mat cameraMatrix = cv::Mat::eye(3,3,CV_64F);
-    cv::Mat distCoeff(5,1,CV_64F);
+    cv::Mat distCoeff = cv::Mat::zeros(5,1,CV_64F);
     std::vector<cv::Mat> rotationVectors;
     std::vector<cv::Mat> translationVectors;
+    const Eigen::Vector2i& imageSize = view.camera->imageSize;
 
-    // run over all the poses of this camera and assemble the correspondences
-    for( size_t i=0; i<cam.poses.size(); i++ )
+    // pick the poses to solve with, the rest is only evaluated
+    std::vector<size_t> selected = m_poseSelection.select( view );
+    std::vector<bool> isSelected( view.size(), false );
+    for( size_t i=0; i<selected.size(); i++ )
+        isSelected[ selected[i] ] = true;
+
+    // run over all the poses of this camera and assemble the correspondences,
+    // rejected points are left out
+    for( size_t i=0; i<selected.size(); i++ )
     {
-        cvVectorPoints2D.push_back( iris::eigen2cv<float>( cam.poses[i].points2D ) );
-        cvVectorPoints3D.push_back( iris::eigen2cv<float>( cam.poses[i].points3D ) );
+        cvVectorPoints2D.push_back( iris::eigen2cv<float>( view.pose( selected[i] ).correspondences, true ) );
+        cvVectorPoints3D.push_back( iris::pattern2cv<float>( view.pose( selected[i] ), true ) );
     }
 
     // try to compute the intrinsic and extrinsic parameters
-    eigen2cv( cam.intrinsic, cameraMatrix );
+    eigen2cv( view.intrinsic, cameraMatrix );
+    for( size_t i=0; i<view.distortion.size() && i<5; i++ )
+        distCoeff.at<double>( static_cast<int>(i), 0 ) = view.distortion[i];
     double error = cv::calibrateCamera( cvVectorPoints3D,
                                         cvVectorPoints2D,
-                                        cv::Size( cam.imageSize(0), cam.imageSize(1) ),
+                                        cv::Size( imageSize(0), imageSize(1) ),
                                         cameraMatrix,
                                         distCoeff,
                                         rotationVectors,
@@ -128,29 +191,65 @@ void OpenCVSingleCalibration::calibrateCamera( Camera_d &cam, int flags )
                                         flags );
 
     // instrinsic matrix
-    cv::cv2eigen( cameraMatrix, cam.intrinsic );
+    cv::cv2eigen( cameraMatrix, view.intrinsic );
 
     // distortion coefficeints
-    cam.distortion.clear();
+    view.distortion.clear();
     for( int i=0; i<distCoeff.rows; i++ )
-        cam.distortion.push_back( distCoeff.at<double>( i, 0 ) );
+        view.distortion.push_back( distCoeff.at<double>( i, 0 ) );
 
     // error
-    cam.error = error;
+    view.error = error;
 
-    // compute and save the poses
+    // compute and save the poses, directly in the camera set
     for( size_t i=0; i<rotationVectors.size(); i++ )
     {
         // store the transformation
-        iris::cv2eigen( rotationVectors[i], translationVectors[i], cam.poses[i].transformation );
-
-        // reproject points from the opencv poses
-        cam.poses[i].projected2D = projectPoints( cvVectorPoints3D[i],
-                                                  rotationVectors[i],
-                                                  translationVectors[i],
-                                                  cameraMatrix,
-                                                  distCoeff );
+        iris::cv2eigen( rotationVectors[i], translationVectors[i], view.pose( selected[i] ).transformation );
+
+        // reproject all points from the opencv poses, the rejected ones too
+        view.pose( selected[i] ).projected2D = projectPoints( iris::pattern2cv<float>( view.pose( selected[i] ) ),
+                                                              rotationVectors[i],
+                                                              translationVectors[i],
+                                                              cameraMatrix,
+                                                              distCoeff );
+    }
+
+    // nothing left out, we are done
+    if( selected.size() == view.size() )
+        return;
+
+    // evaluate the remaining poses against the solved intrinsics
+    m_taskPool->parallel_for( 0, view.size(), [&]( size_t p )
+    {
+        if( isSelected[p] )
+            return;
+
+        // estimate the pose
+        Pose_d& pose = view.pose(p);
+        std::vector<cv::Point2f> points2D = iris::eigen2cv<float>( pose.correspondences, true );
+        std::vector<cv::Point3f> points3D = iris::pattern2cv<float>( pose, true );
+        cv::Mat rVec, tVec;
+        cv::solvePnP( points3D, points2D, cameraMatrix, distCoeff, rVec, tVec, false );
+
+        // store and reproject
+        iris::cv2eigen( rVec, tVec, pose.transformation );
+        pose.projected2D = projectPoints( iris::pattern2cv<float>( pose ), rVec, tVec, cameraMatrix, distCoeff );
+    } );
+
+    // the error is reported over all poses, not only the solved ones, but
+    // without the rejected points
+    double sqErr = 0.0;
+    size_t pointCount = 0;
+    for( size_t p=0; p<view.size(); p++ )
+    {
+        const Pose_d& pose = view.pose(p);
+        if( pose.hasProjections() )
+            sqErr += ( ( pose.projected2D - pose.correspondences.points() ).colwise().squaredNorm().transpose().array() *
+                       ( pose.correspondences.weights().array() > 0.0 ).cast<double>() ).sum();
+        pointCount += pose.correspondences.weightedCount();
     }
+    view.error = ( pointCount > 0 ) ? std::sqrt( sqErr / static_cast<double>(pointCount) ) : 0.0;
 }
 
 
@@ -159,11 +258,10 @@ void OpenCVSingleCalibration::filter( CameraSet_d& cs )
     // init stuff
     m_filteredCameras.clear();
 
-    // run over all the poses and only
+    // run over all the poses and only keep the indices of the good ones
     for( auto it = cs.cameras().begin(); it != cs.cameras().end(); it++ )
     {
-        // update stuff
-        size_t posesAdded = 0;
+        CameraView_d view( it->second );
 
         for( size_t p=0; p<it->second.poses.size(); p++ )
         {
@@ -171,20 +269,13 @@ void OpenCVSingleCalibration::filter( CameraSet_d& cs )
             it->second.poses[p].rejected = true;
 
             // check that all is well
-            if( it->second.poses[p].pointIndices.size() > m_minPoseCorrespondences )
-            {
-                m_filteredCameras[it->second.id].poses.push_back( it->second.poses[p] );
-                posesAdded++;
-            }
+            if( it->second.poses[p].correspondences.size() > m_minPoseCorrespondences )
+                view.poses.push_back( p );
         }
 
-        // set image size
-        if( posesAdded > 0 )
-        {
-            m_filteredCameras[it->second.id].id = it->second.id;
-            m_filteredCameras[it->second.id].imageSize = it->second.imageSize;
-            m_filteredCameras[it->second.id].intrinsic = it->second.intrinsic;
-        }
+        // keep the camera if it has any poses
+        if( view.size() > 0 )
+            m_filteredCameras[it->first] = std::move( view );
     }
 }
 
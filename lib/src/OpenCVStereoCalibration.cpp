@@ -25,7 +25,7 @@
  *  Created on: Jun 12, 2012
  *      Author: duliu
  */
-
+#include <atomic>
 
 #include <iris/util.hpp>
 #include <iris/OpenCVStereoCalibration.hpp>
@@ -66,82 +66,135 @@ void OpenCVStereoCalibration::setFixIntrinsic( bool val )
 
 void OpenCVStereoCalibration::calibrate( CameraSet_d& cs )
 {
+    Run run( *this );
+
     // assuming there are only two cameras
     if( cs.cameras().size() != 2 )
         throw std::runtime_error("OpenCVStereoCalibration::calibrate: exactly 2 cameras are required.");
 
+    // solve in place, the set is restored unless the calibration succeeds
+    Rollback rollback( cs );
+
     // get refs of camera
     iris::Camera_d& cam1 = cs.cameras().begin()->second;
     iris::Camera_d& cam2 = (++(cs.cameras().begin()))->second;
 
     // detect correspondences over all poses
-    if( m_finder->useOpenMP() )
+    std::vector< Pose_d* > poses;
+    for( size_t p=0; p<cam1.poses.size(); p++ )
     {
-        #pragma omp parallel for
-        for( int p=0; p<cam1.poses.size(); p++ )
-        {
-            m_finder->find( cam1.poses[p] );
-            m_finder->find( cam2.poses[p] );
-        }
+        poses.push_back( &cam1.poses[p] );
+        poses.push_back( &cam2.poses[p] );
     }
-    else
-        for( int p=0; p<cam1.poses.size(); p++ )
-        {
-            m_finder->find( cam1.poses[p] );
-            m_finder->find( cam2.poses[p] );
-        }
+    m_progress.reset();
+    m_progress.begin( "OpenCVStereoCalibration::calibrate: detecting ", poses.size() );
+    detect( poses );
+    m_progress.finish();
+    checkCancelled();
 
     // filter the poses
     filter( cs );
+    if( m_filteredCameras.size() != 2 )
+        throw std::runtime_error("OpenCVStereoCalibration::calibrate: no valid frames.");
+    iris::CameraView_d& filtered1 = m_filteredCameras.begin()->second;
+    iris::CameraView_d& filtered2 = (++(m_filteredCameras.begin()))->second;
+
+    // verify the correspondences of each frame before solving
+    m_outlierReport = OutlierRejection::Report();
+    if( m_rejectOutliers )
+    {
+        m_outlierRejection.setMinPoints( m_minPoseCorrespondences + 1 );
+        m_outlierReport += rejectOutliers( filtered1, filtered2, false );
+    }
 
     // calibrate the cameras
-    stereoCalibrate( m_filteredCameras.begin()->second,
-                 (++(m_filteredCameras.begin()))->second );
+    if( filtered1.poses.size() == 0 )
+        throw std::runtime_error("OpenCVStereoCalibration::calibrate: no valid frames left.");
+
+    // start from the closed-form solution if there is one for both cameras,
+    // neither view changes unless both have one
+    int calibrationFlags = flags();
+    Eigen::Matrix3d K1, K2;
+    if( !m_fixIntrinsic && initialize( filtered1, K1 ) && initialize( filtered2, K2 ) )
+    {
+        filtered1.intrinsic = K1;
+        filtered1.distortion.assign( 5, 0.0 );
+        filtered2.intrinsic = K2;
+        filtered2.distortion.assign( 5, 0.0 );
+        calibrationFlags = calibrationFlags | CV_CALIB_USE_INTRINSIC_GUESS;
+    }
+    stereoCalibrate( filtered1, filtered2, calibrationFlags );
+    publish( filtered1 );
+    publish( filtered2 );
+
+    // trim by residuals and solve again until nothing changes or time is up
+    for( size_t i=0; m_rejectOutliers && i<m_outlierRejection.maxTrimIterations() && !stopping(); i++ )
+    {
+        OutlierRejection::Report report = rejectOutliers( filtered1, filtered2, true );
+        m_outlierReport += report;
+
+        if( report.pointsRemoved == 0 )
+            break;
+        if( filtered1.poses.size() == 0 )
+            throw std::runtime_error("OpenCVStereoCalibration::calibrate: no valid frames left.");
+        stereoCalibrate( filtered1, filtered2, calibrationFlags );
+        publish( filtered1 );
+        publish( filtered2 );
+    }
+    checkCancelled();
+    m_progress.add( Progress::PointsRemoved, m_outlierReport.pointsRemoved );
+    m_progress.add( Progress::PosesRemoved, m_outlierReport.posesRemoved );
 
     // commit the results
     commit( cs );
+    rollback.release();
 }
 
 
-void OpenCVStereoCalibration::stereoCalibrate( iris::Camera_d& cam1, iris::Camera_d& cam2 )
+void OpenCVStereoCalibration::stereoCalibrate( iris::CameraView_d& cam1, iris::CameraView_d& cam2, int flags )
 {
     // init stuff
     std::vector< std::vector<cv::Point2f> > cvVectorPoints2D_1;
     std::vector< std::vector<cv::Point2f> > cvVectorPoints2D_2;
     std::vector< std::vector<cv::Point3f> > cvVectorPoints3D;
-    size_t frameCount = cam1.poses.size();
+    size_t frameCount = cam1.size();
 
     // init camera params
     cv::Mat A_1 = cv::Mat::eye(3,3,CV_64F); // intrinsic matrix 1
     cv::Mat A_2 = cv::Mat::eye(3,3,CV_64F); // intrinsic matrix 2
     cv::Mat E = cv::Mat::eye(3,3,CV_64F); // essential matrix
     cv::Mat F = cv::Mat::eye(3,3,CV_64F); // fundamental matrix
-    cv::Mat dc_1(5,1,CV_64F); // distortion coefficients
-    cv::Mat dc_2(5,1,CV_64F); // distortion coefficients
+    cv::Mat dc_1 = cv::Mat::zeros(5,1,CV_64F); // distortion coefficients
+    cv::Mat dc_2 = cv::Mat::zeros(5,1,CV_64F); // distortion coefficients
     cv::Mat R; // rotation
     cv::Mat T; // translation
 
-    // run over all the poses of this camera and assemble the correspondences
+    // run over all the poses of this camera and assemble the correspondences,
+    // points are rejected in both views at once so the lists stay aligned
     for( size_t f=0; f<frameCount; f++ )
     {
         // add them to the opencv vectors
-        cvVectorPoints2D_1.push_back( iris::eigen2cv<float>( cam1.poses[f].points2D ) );
-        cvVectorPoints2D_2.push_back( iris::eigen2cv<float>( cam2.poses[f].points2D ) );
-        cvVectorPoints3D.push_back( iris::eigen2cv<float>( cam1.poses[f].points3D ) );
+        cvVectorPoints2D_1.push_back( iris::eigen2cv<float>( cam1.pose(f).correspondences, true ) );
+        cvVectorPoints2D_2.push_back( iris::eigen2cv<float>( cam2.pose(f).correspondences, true ) );
+        cvVectorPoints3D.push_back( iris::pattern2cv<float>( cam1.pose(f), true ) );
     }
 
     // try to compute the intrinsic and extrinsic parameters
     eigen2cv( cam1.intrinsic, A_1 );
     eigen2cv( cam2.intrinsic, A_2 );
+    for( size_t i=0; i<cam1.distortion.size() && i<5; i++ )
+        dc_1.at<double>( static_cast<int>(i), 0 ) = cam1.distortion[i];
+    for( size_t i=0; i<cam2.distortion.size() && i<5; i++ )
+        dc_2.at<double>( static_cast<int>(i), 0 ) = cam2.distortion[i];
     double error = cv::stereoCalibrate( cvVectorPoints3D,
                                         cvVectorPoints2D_1,
                                         cvVectorPoints2D_2,
                                         A_1, dc_1,
                                         A_2, dc_2,
-                                        cv::Size( cam1.imageSize(0), cam1.imageSize(1) ),
+                                        cv::Size( cam1.camera->imageSize(0), cam1.camera->imageSize(1) ),
                                         R, T, E, F,
                                         cv::TermCriteria( cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 30, 1e-6),
-                                        flags() );
+                                        flags );
 
     // instrinsic matrix
     cv::cv2eigen( A_1, cam1.intrinsic );
@@ -163,8 +216,7 @@ void OpenCVStereoCalibration::stereoCalibrate( iris::Camera_d& cam1, iris::Camer
     // convert and save the poses
     Eigen::Matrix4d RT;
     iris::cv2eigen( R, T, RT );
-    #pragma omp parallel for
-    for( int i=0; i<frameCount; i++ )
+    m_taskPool->parallel_for( 0, frameCount, [&]( size_t i )
     {
         // compute the pose
         cv::Mat rVec_cam1, tVec_cam1, rVec_cam2, tVec_cam2;
@@ -175,25 +227,26 @@ void OpenCVStereoCalibration::stereoCalibrate( iris::Camera_d& cam1, iris::Camer
         Eigen::Matrix4d trans_cam1, trans_cam2;
         iris::cv2eigen( rVec_cam1, tVec_cam1, trans_cam1 );
         iris::cv2eigen( rVec_cam2, tVec_cam2, trans_cam2 );
-        cam1.poses[i].transformation = trans_cam1;
-        cam2.poses[i].transformation = trans_cam2;
+        cam1.pose(i).transformation = trans_cam1;
+        cam2.pose(i).transformation = trans_cam2;
 
         // now the ugly part, convert back to openCV for back projection
         cv::Mat rv1, rv2, tv1, tv2;
-        iris::eigen2cv( cam1.poses[i].transformation, rv1, tv1 );
-        iris::eigen2cv( cam2.poses[i].transformation, rv2, tv2 );
+        iris::eigen2cv( cam1.pose(i).transformation, rv1, tv1 );
+        iris::eigen2cv( cam2.pose(i).transformation, rv2, tv2 );
 
-        // reproject points from the opencv poses
-        cam1.poses[i].projected2D = projectPoints( cvVectorPoints3D[i], rv1, tv1, A_1, dc_1 );
-        cam2.poses[i].projected2D = projectPoints( cvVectorPoints3D[i], rv2, tv2, A_2, dc_2 );
-    }
+        // reproject all points from the opencv poses, the rejected ones too
+        std::vector<cv::Point3f> points3D = iris::pattern2cv<float>( cam1.pose(i) );
+        cam1.pose(i).projected2D = projectPoints( points3D, rv1, tv1, A_1, dc_1 );
+        cam2.pose(i).projected2D = projectPoints( points3D, rv2, tv2, A_2, dc_2 );
+    } );
 
     // if only the relative pose is desired, just blank it all
     for( size_t i=0; !m_relativeToPattern && i<frameCount; i++ )
     {
         // get the extrinsics
-        cam1.poses[i].transformation = Eigen::Matrix4d::Identity();
-        cam2.poses[i].transformation = RT;
+        cam1.pose(i).transformation = Eigen::Matrix4d::Identity();
+        cam2.pose(i).transformation = RT;
     }
 }
 
@@ -202,7 +255,6 @@ void OpenCVStereoCalibration::filter( CameraSet_d& cs )
 {
     // init stuff
     m_filteredCameras.clear();
-    size_t framesAdded = 0;
 
     // get refs of camera
     iris::Camera_d& cam1 = cs.cameras().begin()->second;
@@ -212,7 +264,9 @@ void OpenCVStereoCalibration::filter( CameraSet_d& cs )
     if( !(m_intrinsicGuess || m_fixIntrinsic) && ( (cam1.imageSize(0) != cam2.imageSize(0)) || (cam1.imageSize(1) != cam2.imageSize(1)) ) )
         throw std::runtime_error("OpenCVStereoCalibration::filter: cameras do not have the same images size.");
 
-    // do the actual filtering
+    // do the actual filtering, both views keep the same frames in the same order
+    CameraView_d view1( cam1 );
+    CameraView_d view2( cam2 );
     for( size_t p=0; p<cam1.poses.size(); p++ )
     {
         // guilty untill proven innocent
@@ -222,42 +276,69 @@ void OpenCVStereoCalibration::filter( CameraSet_d& cs )
         // check if this frame is valid
         if( checkFrame( cam1.poses[p], cam2.poses[p] ) )
         {
-            m_filteredCameras[cam1.id].poses.push_back( cam1.poses[p] );
-            m_filteredCameras[cam2.id].poses.push_back( cam2.poses[p] );
-            framesAdded++;
+            view1.poses.push_back( p );
+            view2.poses.push_back( p );
         }
         else
             std::cout << "OpenCVStereoCalibration::filter: frame rejected." << std::endl;
     }
 
-    // set image size
-    if( framesAdded > 0 )
+    // keep the views if there is anything in them
+    if( view1.size() > 0 )
+    {
+        m_filteredCameras[cam1.id] = std::move( view1 );
+        m_filteredCameras[cam2.id] = std::move( view2 );
+    }
+}
+
+
+OutlierRejection::Report OpenCVStereoCalibration::rejectOutliers( iris::CameraView_d& cam1, iris::CameraView_d& cam2, bool residuals )
+{
+    // init stuff
+    OutlierRejection::Report report;
+    std::atomic<size_t> pointsRemoved( 0 );
+    if( !residuals && !m_outlierRejection.homographyCheck() )
+        return report;
+    double t1 = residuals ? m_outlierRejection.threshold( cam1 ) : 0.0;
+    double t2 = residuals ? m_outlierRejection.threshold( cam2 ) : 0.0;
+
+    // a point has to be an inlier in both views, the frames share their point order
+    m_taskPool->parallel_for( 0, cam1.size(), [&]( size_t f )
     {
-        m_filteredCameras[cam1.id].imageSize = cam1.imageSize;
-        m_filteredCameras[cam2.id].imageSize = cam2.imageSize;
-        m_filteredCameras[cam1.id].id = cam1.id;
-        m_filteredCameras[cam2.id].id = cam2.id;
-        m_filteredCameras[cam1.id].intrinsic = cam1.intrinsic;
-        m_filteredCameras[cam2.id].intrinsic = cam2.intrinsic;
+        std::vector<bool> keep1 = residuals ? m_outlierRejection.inliers( cam1.pose(f), t1 ) : m_outlierRejection.inliers( cam1.pose(f), cam1.camera->imageSize );
+        std::vector<bool> keep2 = residuals ? m_outlierRejection.inliers( cam2.pose(f), t2 ) : m_outlierRejection.inliers( cam2.pose(f), cam2.camera->imageSize );
+        for( size_t i=0; i<keep1.size() && i<keep2.size(); i++ )
+            keep1[i] = keep1[i] && keep2[i];
+
+        pointsRemoved += OutlierRejection::rejectPoints( cam1.pose(f), keep1 );
+        OutlierRejection::rejectPoints( cam2.pose(f), keep1 );
+    } );
+    report.pointsRemoved = pointsRemoved;
+
+    // drop frames with too few points left from both views
+    for( size_t f=cam1.size(); f>0; f-- )
+    {
+        if( cam1.pose(f-1).correspondences.weightedCount() < m_outlierRejection.minPoints() )
+        {
+            cam1.poses.erase( cam1.poses.begin() + (f-1) );
+            cam2.poses.erase( cam2.poses.begin() + (f-1) );
+            report.posesRemoved++;
+        }
     }
+
+    return report;
 }
 
 
 bool OpenCVStereoCalibration::checkFrame( const iris::Pose_d& pose1, const iris::Pose_d& pose2 )
 {
     // check if the arrays have the same length
-    if( pose1.points2D.size() == 0 ||
-        pose1.pointIndices.size() == 0 ||
-        (pose1.points2D.size() != pose2.points2D.size() ) ||
-        (pose1.pointIndices.size() != pose2.pointIndices.size() ) )
+    if( pose1.correspondences.size() == 0 ||
+        pose1.correspondences.size() != pose2.correspondences.size() )
         return false;
 
     // check that all the indices match
-    for( size_t i=0; i<pose1.pointIndices.size(); i++ )
-        if( pose1.pointIndices[i] != pose2.pointIndices[i] )
-            return false;
-
-    return true;
+    return pose1.correspondences.indices() == pose2.correspondences.indices();
 }
 
 
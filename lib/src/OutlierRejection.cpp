@@ -0,0 +1,349 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * OutlierRejection.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+
+#include <iris/OutlierRejection.hpp>
+
+namespace iris {
+
+OutlierRejection::OutlierRejection() :
+    m_homographyCheck( false ),
+    m_ransacThreshold( 0.005 ),
+    m_confidence( 0.999 ),
+    m_maxIterations( 1000 ),
+    m_residualFactor( 3.0 ),
+    m_minResidual( 0.5 ),
+    m_maxTrimIterations( 3 ),
+    m_minPoints( 9 ),
+    m_taskPool( TaskPool::shared() )
+{
+}
+
+
+OutlierRejection::~OutlierRejection()
+{
+}
+
+
+void OutlierRejection::setHomographyCheck( bool val )
+{
+    m_homographyCheck = val;
+}
+
+
+void OutlierRejection::setRansacThreshold( double val )
+{
+    m_ransacThreshold = val;
+}
+
+
+void OutlierRejection::setConfidence( double val )
+{
+    m_confidence = val;
+}
+
+
+void OutlierRejection::setMaxIterations( size_t val )
+{
+    m_maxIterations = val;
+}
+
+
+void OutlierRejection::setResidualFactor( double val )
+{
+    m_residualFactor = val;
+}
+
+
+void OutlierRejection::setMinResidual( double val )
+{
+    m_minResidual = val;
+}
+
+
+void OutlierRejection::setMaxTrimIterations( size_t val )
+{
+    m_maxTrimIterations = val;
+}
+
+
+void OutlierRejection::setMinPoints( size_t val )
+{
+    m_minPoints = val;
+}
+
+
+void OutlierRejection::setTaskPool( std::shared_ptr<TaskPool> pool )
+{
+    if( !pool )
+        throw std::runtime_error( "OutlierRejection::setTaskPool: pool not set." );
+
+    m_taskPool = pool;
+}
+
+
+bool OutlierRejection::homographyCheck() const
+{
+    return m_homographyCheck;
+}
+
+
+size_t OutlierRejection::maxTrimIterations() const
+{
+    return m_maxTrimIterations;
+}
+
+
+size_t OutlierRejection::minPoints() const
+{
+    return m_minPoints;
+}
+
+
+double OutlierRejection::ransacThreshold( const Eigen::Vector2i& imageSize ) const
+{
+    return m_ransacThreshold * imageSize.cast<double>().norm();
+}
+
+
+std::vector<bool> OutlierRejection::inliers( const Pose_d& pose, const Eigen::Vector2i& imageSize ) const
+{
+    // init stuff, points rejected before stay rejected
+    size_t total = pose.correspondences.size();
+    std::vector<bool> result( total, true );
+    std::vector<size_t> active;
+    for( size_t i=0; i<total; i++ )
+    {
+        result[i] = pose.correspondences.weight( i ) > 0.0;
+        if( result[i] )
+            active.push_back( i );
+    }
+
+    // only planar patterns with enough points can be verified
+    size_t n = active.size();
+    if( n < 5 || !pose.hasPoints3D() )
+        return result;
+    Correspondences<double>::Points plane( 2, n ), points( 2, n );
+    for( size_t i=0; i<n; i++ )
+    {
+        if( std::fabs( pose.point3D( active[i] )(2) ) > std::numeric_limits<float>::epsilon() )
+            return result;
+        plane.col(i) = pose.point3D( active[i] ).head<2>();
+        points.col(i) = pose.correspondences.point( active[i] );
+    }
+
+    // deterministic per pose
+    std::mt19937 rng( static_cast<unsigned int>( pose.id ) );
+    std::uniform_int_distribution<size_t> pick( 0, n-1 );
+
+    // RANSAC with adaptive number of iterations
+    size_t bestCount = 0;
+    std::vector<bool> best( n, true );
+    double threshold = ransacThreshold( imageSize );
+    double thresholdSq = threshold * threshold;
+    double iterations = static_cast<double>( m_maxIterations );
+    Eigen::Matrix<double,2,4> src, dst;
+    std::vector<bool> mask( n );
+    for( size_t it=0; static_cast<double>(it) < iterations; it++ )
+    {
+        // draw a minimal sample of distinct points
+        size_t idx[4];
+        for( size_t k=0; k<4; k++ )
+        {
+            bool unique;
+            do
+            {
+                idx[k] = pick( rng );
+                unique = true;
+                for( size_t j=0; j<k; j++ )
+                    unique = unique && ( idx[j] != idx[k] );
+            }
+            while( !unique );
+
+            src.col(k) = plane.col( idx[k] );
+            dst.col(k) = points.col( idx[k] );
+        }
+
+        // fit and count the inliers, all points at once
+        Eigen::Matrix3d H = compute_homography( src, dst );
+        Eigen::RowVectorXd errors = ( project_columns( H, plane ) - points ).colwise().squaredNorm();
+        size_t count = 0;
+        for( size_t i=0; i<n; i++ )
+        {
+            mask[i] = errors(i) < thresholdSq;
+            count += mask[i] ? 1 : 0;
+        }
+
+        // keep the best model and tighten the number of iterations
+        if( count > bestCount )
+        {
+            bestCount = count;
+            best = mask;
+
+            double w = static_cast<double>( count ) / static_cast<double>( n );
+            double denom = std::log( 1.0 - std::pow( w, 4 ) );
+            if( denom < 0.0 )
+                iterations = std::min( iterations, std::log( 1.0 - m_confidence ) / denom );
+            else
+                break;
+        }
+    }
+
+    // refit on all inliers and reclassify
+    if( bestCount >= 4 )
+    {
+        Correspondences<double>::Points in2D( 2, bestCount ), in3D( 2, bestCount );
+        for( size_t i=0, k=0; i<n; i++ )
+            if( best[i] )
+            {
+                in3D.col(k) = plane.col(i);
+                in2D.col(k) = points.col(i);
+                k++;
+            }
+
+        Eigen::Matrix3d H = compute_homography( in3D, in2D );
+        Eigen::RowVectorXd errors = ( project_columns( H, plane ) - points ).colwise().squaredNorm();
+        for( size_t i=0; i<n; i++ )
+            best[i] = errors(i) < thresholdSq;
+    }
+
+    // back to the positions in the pose
+    for( size_t i=0; i<n; i++ )
+        result[ active[i] ] = best[i];
+    return result;
+}
+
+
+std::vector<bool> OutlierRejection::inliers( const Pose_d& pose, double threshold ) const
+{
+    std::vector<bool> mask( pose.correspondences.size(), true );
+    for( size_t i=0; i<mask.size(); i++ )
+        mask[i] = pose.correspondences.weight( i ) > 0.0;
+    if( !pose.hasProjections() )
+        return mask;
+
+    Eigen::VectorXd residuals = pose.residuals();
+    for( size_t i=0; i<mask.size(); i++ )
+        mask[i] = mask[i] && residuals(i) <= threshold;
+    return mask;
+}
+
+
+double OutlierRejection::threshold( const CameraView_d& view ) const
+{
+    // collect the residuals of the points still in use
+    std::vector<double> residuals;
+    for( size_t p=0; p<view.size(); p++ )
+    {
+        const Pose_d& pose = view.pose(p);
+        Eigen::VectorXd poseResiduals = pose.residuals();
+        for( Eigen::VectorXd::Index i=0; i<poseResiduals.size(); i++ )
+            if( pose.correspondences.weight( static_cast<size_t>(i) ) > 0.0 )
+                residuals.push_back( poseResiduals(i) );
+    }
+
+    if( residuals.size() == 0 )
+        return std::numeric_limits<double>::max();
+
+    // scale the median
+    std::nth_element( residuals.begin(), residuals.begin() + residuals.size()/2, residuals.end() );
+    double median = residuals[ residuals.size()/2 ];
+    return std::max( m_minResidual, m_residualFactor * median );
+}
+
+
+OutlierRejection::Report OutlierRejection::verify( CameraView_d& view ) const
+{
+    // init stuff
+    Report report;
+    std::atomic<size_t> pointsRemoved( 0 );
+    if( !m_homographyCheck )
+        return report;
+
+    // verify all poses
+    m_taskPool->parallel_for( 0, view.size(), [&]( size_t p )
+    {
+        pointsRemoved += rejectPoints( view.pose(p), inliers( view.pose(p), view.camera->imageSize ) );
+    } );
+
+    // wrap up
+    report.pointsRemoved = pointsRemoved;
+    report.posesRemoved = removePoses( view );
+    return report;
+}
+
+
+OutlierRejection::Report OutlierRejection::trim( CameraView_d& view ) const
+{
+    // init stuff
+    Report report;
+    double t = threshold( view );
+
+    // trim all poses
+    for( size_t p=0; p<view.size(); p++ )
+        report.pointsRemoved += rejectPoints( view.pose(p), inliers( view.pose(p), t ) );
+
+    // wrap up
+    report.posesRemoved = removePoses( view );
+    return report;
+}
+
+
+size_t OutlierRejection::rejectPoints( Pose_d& pose, const std::vector<bool>& keep )
+{
+    // the detections and their projections stay, only the weights change
+    size_t rejected = 0;
+    for( size_t i=0; i<keep.size() && i<pose.correspondences.size(); i++ )
+    {
+        if( keep[i] || !( pose.correspondences.weight( i ) > 0.0 ) )
+            continue;
+        pose.correspondences.setWeight( i, 0.0 );
+        rejected++;
+    }
+    return rejected;
+}
+
+
+size_t OutlierRejection::removePoses( CameraView_d& view ) const
+{
+    // only the view forgets them, the camera keeps all its poses
+    size_t before = view.size();
+    size_t j = 0;
+    for( size_t p=0; p<view.size(); p++ )
+        if( view.pose(p).correspondences.weightedCount() >= m_minPoints )
+            view.poses[j++] = view.poses[p];
+    view.poses.resize( j );
+    return before - j;
+}
+
+
+} // end namespace iris
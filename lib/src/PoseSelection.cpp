@@ -0,0 +1,249 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * PoseSelection.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <iris/PoseSelection.hpp>
+
+namespace iris {
+
+PoseSelection::PoseSelection() :
+    m_maxPoses( 0 ),
+    m_gridSize( 8 ),
+    m_coverageWeight( 1.0 ),
+    m_tiltWeight( 1.0 ),
+    m_countWeight( 0.25 ),
+    m_taskPool( TaskPool::shared() )
+{
+}
+
+
+PoseSelection::~PoseSelection()
+{
+}
+
+
+void PoseSelection::setMaxPoses( size_t val )
+{
+    m_maxPoses = val;
+}
+
+
+void PoseSelection::setGridSize( size_t val )
+{
+    m_gridSize = std::max<size_t>( val, 1 );
+}
+
+
+void PoseSelection::setCoverageWeight( double val )
+{
+    m_coverageWeight = val;
+}
+
+
+void PoseSelection::setTiltWeight( double val )
+{
+    m_tiltWeight = val;
+}
+
+
+void PoseSelection::setCountWeight( double val )
+{
+    m_countWeight = val;
+}
+
+
+void PoseSelection::setTaskPool( std::shared_ptr<TaskPool> pool )
+{
+    if( !pool )
+        throw std::runtime_error( "PoseSelection::setTaskPool: pool not set." );
+
+    m_taskPool = pool;
+}
+
+
+size_t PoseSelection::maxPoses() const
+{
+    return m_maxPoses;
+}
+
+
+std::vector<size_t> PoseSelection::select( const CameraView_d& view ) const
+{
+    // init stuff
+    size_t poseCount = view.size();
+    const Eigen::Vector2i& imageSize = view.camera->imageSize;
+    std::vector<size_t> result;
+
+    // nothing to choose from, take everything
+    if( m_maxPoses == 0 || poseCount <= m_maxPoses )
+    {
+        for( size_t p=0; p<poseCount; p++ )
+            result.push_back( p );
+        return result;
+    }
+
+    // rough intrinsics for the normal estimation, unless the camera has some
+    Eigen::Matrix3d K = view.intrinsic;
+    if( K.isIdentity() )
+    {
+        double f = std::max( imageSize(0), imageSize(1) );
+        K << f, 0, 0.5*imageSize(0),
+             0, f, 0.5*imageSize(1),
+             0, 0, 1;
+    }
+
+    // precompute the per pose properties
+    std::vector< std::vector<size_t> > poseBins( poseCount );
+    std::vector< Eigen::Vector3d > normals( poseCount );
+    std::vector< double > counts( poseCount );
+    double maxCount = 1.0;
+    m_taskPool->parallel_for( 0, poseCount, [&]( size_t p )
+    {
+        poseBins[p] = bins( imageSize, view.pose(p) );
+        normals[p] = planeNormal( K, view.pose(p) );
+        counts[p] = static_cast<double>( view.pose(p).correspondences.weightedCount() );
+    } );
+    for( size_t p=0; p<poseCount; p++ )
+        maxCount = std::max( maxCount, counts[p] );
+
+    // greedy selection
+    std::vector<size_t> binHits( m_gridSize*m_gridSize, 0 );
+    std::vector<bool> selected( poseCount, false );
+    Eigen::Matrix3d information = 0.1 * Eigen::Matrix3d::Identity();
+    while( result.size() < m_maxPoses )
+    {
+        // the information matrix only changes once per round
+        Eigen::Matrix3d informationInv = information.inverse();
+
+        // find the pose with the best marginal gain
+        double bestGain = -std::numeric_limits<double>::max();
+        size_t best = poseCount;
+        for( size_t p=0; p<poseCount; p++ )
+        {
+            if( selected[p] )
+                continue;
+
+            // coverage: sparsely hit bins are worth more
+            double coverage = 0.0;
+            for( size_t b=0; b<poseBins[p].size(); b++ )
+                coverage += 1.0 / static_cast<double>( 1 + binHits[ poseBins[p][b] ] );
+            coverage /= static_cast<double>( binHits.size() );
+
+            // tilt diversity: log det increase of the normal information matrix
+            double tilt = std::log( 1.0 + normals[p].dot( informationInv * normals[p] ) );
+
+            // point count
+            double count = counts[p] / maxCount;
+
+            // combine
+            double gain = m_coverageWeight*coverage + m_tiltWeight*tilt + m_countWeight*count;
+            if( gain > bestGain )
+            {
+                bestGain = gain;
+                best = p;
+            }
+        }
+
+        // add the best pose
+        selected[best] = true;
+        result.push_back( best );
+        for( size_t b=0; b<poseBins[best].size(); b++ )
+            binHits[ poseBins[best][b] ]++;
+        information += normals[best] * normals[best].transpose();
+    }
+
+    // keep the original order
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+
+std::vector<size_t> PoseSelection::bins( const Eigen::Vector2i& imageSize, const Pose_d& pose ) const
+{
+    // mark the bins hit by the points, rejected ones cover nothing
+    std::vector<bool> hit( m_gridSize*m_gridSize, false );
+    double sx = static_cast<double>( m_gridSize ) / static_cast<double>( std::max( imageSize(0), 1 ) );
+    double sy = static_cast<double>( m_gridSize ) / static_cast<double>( std::max( imageSize(1), 1 ) );
+    Correspondences<double>::ConstColumnMap px = pose.correspondences.x();
+    Correspondences<double>::ConstColumnMap py = pose.correspondences.y();
+    for( size_t i=0; i<pose.correspondences.size(); i++ )
+    {
+        if( !( pose.correspondences.weight( i ) > 0.0 ) )
+            continue;
+        int x = static_cast<int>( px(i) * sx );
+        int y = static_cast<int>( py(i) * sy );
+        x = std::min( std::max( x, 0 ), static_cast<int>(m_gridSize) - 1 );
+        y = std::min( std::max( y, 0 ), static_cast<int>(m_gridSize) - 1 );
+        hit[ y*m_gridSize + x ] = true;
+    }
+
+    // collect them
+    std::vector<size_t> result;
+    for( size_t b=0; b<hit.size(); b++ )
+        if( hit[b] )
+            result.push_back( b );
+    return result;
+}
+
+
+Eigen::Vector3d PoseSelection::planeNormal( const Eigen::Matrix3d& K, const Pose_d& pose ) const
+{
+    // a homography needs at least four points that were not rejected
+    size_t count = pose.correspondences.weightedCount();
+    if( count < 4 || !pose.hasPoints3D() )
+        return Eigen::Vector3d::UnitZ();
+
+    // homography from the pattern plane to the image
+    Correspondences<double>::Points planePoints( 2, count ), imagePoints( 2, count );
+    for( size_t i=0, k=0; i<pose.correspondences.size(); i++ )
+    {
+        if( !( pose.correspondences.weight( i ) > 0.0 ) )
+            continue;
+        planePoints.col(k) = pose.point3D(i).head<2>();
+        imagePoints.col(k) = pose.correspondences.point(i);
+        k++;
+    }
+    Eigen::Matrix3d H = compute_homography( planePoints, imagePoints );
+
+    // the first two columns of K^-1 H are the scaled rotation axes of the plane
+    Eigen::Matrix3d M = K.inverse() * H;
+    Eigen::Vector3d r1 = M.col(0).normalized();
+    Eigen::Vector3d r2 = M.col(1).normalized();
+    Eigen::Vector3d n = r1.cross( r2 );
+    if( n.norm() < std::numeric_limits<double>::epsilon() )
+        return Eigen::Vector3d::UnitZ();
+
+    // facing the camera
+    n.normalize();
+    return ( n(2) < 0 ) ? -n : n;
+}
+
+
+} // end namespace iris
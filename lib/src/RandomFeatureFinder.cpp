@@ -36,7 +36,7 @@ namespace iris {
 
 RandomFeatureFinder::RandomFeatureFinder() :
     Finder(),
-    m_patternRFD(false),
+    m_patternRFD( new RFD( false ) ),
     m_minPoints(11),
     m_mserMaxRadiusRatio( 3.0),
     m_mserMinRadius( 5.0),
@@ -55,13 +55,16 @@ void RandomFeatureFinder::configure( const std::vector< Eigen::Vector2d >& point
     // compute the descriptor for the points
     if( points.size() > m_minPoints )
     {
-        // generate feature vectors
-        m_patternRFD( points );
+        // generate feature vectors, clones made so far keep the previous ones
+        std::shared_ptr<RFD> patternRFD( new RFD( false ) );
+        (*patternRFD)( points );
+        m_patternRFD = patternRFD;
 
-        // set the 3d points
-        m_points3D.clear();
+        // set the 3d points, poses found so far keep the previous pattern
+        std::shared_ptr<Pattern_d> pattern( new Pattern_d() );
         for( size_t i=0; i<points.size(); i++ )
-            m_points3D.push_back( Eigen::Vector3d( points[i](0), points[i](1), 0 ) );
+            pattern->points.push_back( Eigen::Vector3d( points[i](0), points[i](1), 0 ) );
+        setPattern( pattern );
 
         // we are happy
         m_configured = true;
@@ -74,23 +77,13 @@ void RandomFeatureFinder::configure( const std::vector< Eigen::Vector2d >& point
 void RandomFeatureFinder::configure( const std::string& points )
 {
     // init stuff
-    std::stringstream ss;
+    const char* pos = points.c_str();
     double x, y;
     std::vector< Eigen::Vector2d > points2D;
 
-    // convert to stringstram
-    ss << points;
-    ss.seekg( 0, std::ios::beg );
-
     // parse the points
-    while( !ss.eof() )
-    {
-        ss >> x;
-        ss >> y;
-
+    while( parseNumber( pos, x ) && parseNumber( pos, y ) )
         points2D.push_back( Eigen::Vector2d( m_scale*x, m_scale*y) );
-    }
-    points2D.pop_back();
 
     // configure
     configure( points2D );
@@ -122,6 +115,25 @@ void RandomFeatureFinder::setMeanAreaFac( double val )
 
 
 bool RandomFeatureFinder::find( Pose_d& pose )
+{
+    return findPose( pose );
+}
+
+
+bool RandomFeatureFinder::find( Pose_f& pose )
+{
+    return findPose( pose );
+}
+
+
+std::shared_ptr<Finder> RandomFeatureFinder::clone() const
+{
+    return std::make_shared<RandomFeatureFinder>( *this );
+}
+
+
+template <typename T>
+bool RandomFeatureFinder::findPose( Pose<T>& pose )
 {
     if( !m_configured )
         throw std::runtime_error("RandomFeatureFinder::find: not configured.");
@@ -132,22 +144,20 @@ bool RandomFeatureFinder::find( Pose_d& pose )
         return false;
 
     // generate descriptors for detected points
-    RFD poseRFD(true);
+    RFD& poseRFD = m_scratch.poseRFD;
     poseRFD( posePoints );
 
     // compare the resulting descriptors with the configured
-    m_patternRFD.match( poseRFD, pose );
+    m_patternRFD->match( poseRFD, pose );
 
     // assemble the result
-    if( pose.pointIndices.size() >= m_minPoints )
+    if( pose.correspondences.size() >= m_minPoints )
     {
         // set max number of points
-        pose.pointsMax = m_points3D.size();
+        pose.pointsMax = m_pattern->points.size();
 
-        // run over the indices and set the 3D points
-        pose.points3D.clear();
-        for( size_t i=0; i<pose.pointIndices.size(); i++ )
-            pose.points3D.push_back( m_points3D[pose.pointIndices[i] ] );
+        // the indices refer to the pattern's points
+        pose.pattern = sharedPattern( pose );
 
         // we are happy
         return true;
@@ -160,10 +170,10 @@ bool RandomFeatureFinder::find( Pose_d& pose )
 std::vector<Eigen::Vector2d> RandomFeatureFinder::findCircles( const cimg_library::CImg<uint8_t>& image )
 {
     // init stuff
-    cv::Mat img;
-    std::vector<std::vector<cv::Point> > contours;
+    cv::Mat& img = m_scratch.image;
+    std::vector<std::vector<cv::Point> >& contours = m_scratch.contours;
     std::vector<Eigen::Vector2d> centers;
-    std::vector<cv::RotatedRect> ellipses;
+    std::vector<cv::RotatedRect>& ellipses = m_scratch.ellipses;
 
     // convert to ocv gray and filter
     cimg2cv( image, img );
@@ -173,9 +183,11 @@ std::vector<Eigen::Vector2d> RandomFeatureFinder::findCircles( const cimg_librar
 
     // detect blobs
     cv::MSER mser;
+    contours.clear();
     mser( img, contours, mask );
 
     // fit ellipses
+    ellipses.clear();
     for( size_t i=0; i<contours.size(); i++ )
         ellipses.push_back( cv::fitEllipse( contours[i] ) );
 
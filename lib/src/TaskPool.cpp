@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * TaskPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <chrono>
+
+#include <iris/TaskPool.hpp>
+
+namespace iris {
+
+// pool and queue the current thread works for
+static thread_local const TaskPool* t_pool = 0;
+static thread_local size_t t_queue = 0;
+
+
+TaskPool::TaskPool( size_t threadCount ) :
+    m_queued( 0 ),
+    m_stop( false )
+{
+    if( threadCount == 0 )
+        threadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    // one queue per worker and one for the outside
+    for( size_t i=0; i<threadCount; i++ )
+        m_queues.push_back( std::unique_ptr<Queue>( new Queue() ) );
+
+    // the calling thread is the first one
+    for( size_t i=1; i<threadCount; i++ )
+        m_threads.push_back( std::thread( &TaskPool::work, this, i ) );
+}
+
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for( size_t i=0; i<m_threads.size(); i++ )
+        m_threads[i].join();
+}
+
+
+std::shared_ptr<TaskPool> TaskPool::shared()
+{
+    // initialized once, even with several threads asking at the same time
+    static std::shared_ptr<TaskPool> pool = std::make_shared<TaskPool>();
+    return pool;
+}
+
+
+size_t TaskPool::threadCount() const
+{
+    return m_threads.size() + 1;
+}
+
+
+void TaskPool::Group::fail( std::exception_ptr e )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    if( !error )
+        error = e;
+    failed = true;
+}
+
+
+size_t TaskPool::queueIndex() const
+{
+    return t_pool == this ? t_queue : 0;
+}
+
+
+void TaskPool::push( Task&& task )
+{
+    // count first, so a worker never sees more tasks than were counted
+    {
+        std::lock_guard<std::mutex> lock( m_sleepMutex );
+        m_queued++;
+    }
+
+    Queue& queue = *m_queues[ queueIndex() ];
+    {
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        queue.tasks.push_back( std::move( task ) );
+    }
+    m_wake.notify_one();
+}
+
+
+bool TaskPool::runOne( size_t index )
+{
+    Task task;
+
+    // newest task of the own queue, oldest one of the others
+    for( size_t i=0; i<m_queues.size() && !task; i++ )
+    {
+        Queue& queue = *m_queues[ (index + i) % m_queues.size() ];
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        if( queue.tasks.empty() )
+            continue;
+
+        if( i == 0 )
+        {
+            task = std::move( queue.tasks.back() );
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move( queue.tasks.front() );
+            queue.tasks.pop_front();
+        }
+    }
+
+    if( !task )
+        return false;
+
+    m_queued--;
+    task();
+    return true;
+}
+
+
+void TaskPool::wait( Group& group )
+{
+    size_t index = queueIndex();
+    while( true )
+    {
+        // help out while there is work
+        if( group.pending > 0 && runOne( index ) )
+            continue;
+
+        // the rest is running on other threads, check back now and then
+        std::unique_lock<std::mutex> lock( group.mutex );
+        if( group.pending == 0 )
+            return;
+        group.done.wait_for( lock, std::chrono::milliseconds( 1 ) );
+        if( group.pending == 0 )
+            return;
+    }
+}
+
+
+void TaskPool::work( size_t index )
+{
+    t_pool = this;
+    t_queue = index;
+
+    while( true )
+    {
+        if( runOne( index ) )
+            continue;
+
+        std::unique_lock<std::mutex> lock( m_sleepMutex );
+        m_wake.wait( lock, [this]() { return m_stop || m_queued > 0; } );
+        if( m_stop && m_queued == 0 )
+            return;
+    }
+}
+
+
+} // end namespace iris
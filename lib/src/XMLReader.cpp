@@ -0,0 +1,421 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * XMLReader.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <iris/XMLReader.hpp>
+#include <iris/util.hpp>
+
+namespace iris {
+
+XMLReader::XMLReader() :
+    m_file( 0 ),
+    m_buffer( 64*1024 ),
+    m_position( 0 ),
+    m_size( 0 ),
+    m_line( 1 ),
+    m_pendingEnd( false )
+{
+}
+
+
+XMLReader::XMLReader( const std::string& filename ) :
+    m_file( 0 ),
+    m_buffer( 64*1024 ),
+    m_position( 0 ),
+    m_size( 0 ),
+    m_line( 1 ),
+    m_pendingEnd( false )
+{
+    open( filename );
+}
+
+
+XMLReader::~XMLReader()
+{
+    close();
+}
+
+
+void XMLReader::open( const std::string& filename )
+{
+    close();
+
+    m_file = std::fopen( filename.c_str(), "rb" );
+    if( m_file == 0 )
+        throw std::runtime_error( "XMLReader::open: could not open \"" + filename + "\"." );
+    m_filename = filename;
+}
+
+
+void XMLReader::close()
+{
+    if( m_file != 0 )
+        std::fclose( m_file );
+
+    m_file = 0;
+    m_position = 0;
+    m_size = 0;
+    m_line = 1;
+    m_elements.clear();
+    m_pendingEnd = false;
+}
+
+
+bool XMLReader::isOpen() const
+{
+    return m_file != 0;
+}
+
+
+XMLReader::Event XMLReader::next()
+{
+    if( m_file == 0 )
+        throw std::runtime_error( "XMLReader::next: no file open." );
+
+    // end of a self-closing element
+    if( m_pendingEnd )
+    {
+        m_pendingEnd = false;
+        m_name = m_elements.back();
+        m_elements.pop_back();
+        return EndElement;
+    }
+
+    while( true )
+    {
+        int c = peek();
+
+        // end of file
+        if( c == EOF )
+        {
+            if( m_elements.size() > 0 )
+                error( "unexpected end of file inside <" + m_elements.back() + ">" );
+            return EndDocument;
+        }
+
+        // text
+        if( c != '<' )
+        {
+            bool whitespace = true;
+            m_text.clear();
+            while( ( c = peek() ) != EOF && c != '<' )
+            {
+                if( c == '&' )
+                {
+                    readEntity( m_text );
+                    whitespace = false;
+                }
+                else
+                {
+                    get();
+                    m_text.push_back( static_cast<char>( c ) );
+                    whitespace = whitespace && std::strchr( " \t\r\n", c ) != 0;
+                }
+            }
+
+            if( whitespace )
+                continue;
+            if( m_elements.size() == 0 )
+                error( "text outside of the root element" );
+            return Text;
+        }
+        get();
+
+        // declarations, comments and CDATA
+        c = peek();
+        if( c == '?' )
+        {
+            skipUntil( "?>" );
+            continue;
+        }
+        if( c == '!' )
+        {
+            get();
+            if( peek() == '-' )
+            {
+                expect( "--" );
+                skipUntil( "-->" );
+                continue;
+            }
+            if( peek() == '[' )
+            {
+                expect( "[CDATA[" );
+                m_text.clear();
+                while( m_text.size() < 3 || m_text.compare( m_text.size()-3, 3, "]]>" ) != 0 )
+                {
+                    if( ( c = get() ) == EOF )
+                        error( "unterminated CDATA section" );
+                    m_text.push_back( static_cast<char>( c ) );
+                }
+                m_text.resize( m_text.size()-3 );
+                return Text;
+            }
+            skipUntil( ">" );
+            continue;
+        }
+
+        // end tag
+        if( c == '/' )
+        {
+            get();
+            readName( m_name );
+            while( std::strchr( " \t\r\n", peek() ) != 0 && peek() != EOF )
+                get();
+            expect( ">" );
+            if( m_elements.size() == 0 || m_elements.back() != m_name )
+                error( "unexpected </" + m_name + ">" );
+            m_elements.pop_back();
+            return EndElement;
+        }
+
+        // start tag, attributes are skipped
+        readName( m_name );
+        while( ( c = get() ) != '>' )
+        {
+            if( c == EOF )
+                error( "unterminated <" + m_name + ">" );
+            if( c == '"' || c == '\'' )
+            {
+                int quote = c;
+                while( ( c = get() ) != quote )
+                    if( c == EOF )
+                        error( "unterminated attribute in <" + m_name + ">" );
+            }
+            else if( c == '/' && peek() == '>' )
+            {
+                get();
+                m_pendingEnd = true;
+                break;
+            }
+        }
+        m_elements.push_back( m_name );
+        return StartElement;
+    }
+}
+
+
+const std::string& XMLReader::name() const
+{
+    return m_name;
+}
+
+
+const std::string& XMLReader::text() const
+{
+    return m_text;
+}
+
+
+size_t XMLReader::depth() const
+{
+    return m_elements.size();
+}
+
+
+bool XMLReader::nextChild()
+{
+    while( true )
+    {
+        switch( next() )
+        {
+        case StartElement:
+            return true;
+        case EndElement:
+        case EndDocument:
+            return false;
+        default:
+            break;
+        }
+    }
+}
+
+
+const std::string& XMLReader::readText()
+{
+    m_value.clear();
+    while( true )
+    {
+        switch( next() )
+        {
+        case Text:
+            m_value += m_text;
+            break;
+        case StartElement:
+            skipElement();
+            break;
+        default:
+            return m_value;
+        }
+    }
+}
+
+
+void XMLReader::skipElement()
+{
+    size_t depth = m_elements.size();
+    while( m_elements.size() >= depth )
+        if( next() == EndDocument )
+            return;
+}
+
+
+int XMLReader::peek()
+{
+    if( m_position == m_size )
+    {
+        m_size = std::fread( m_buffer.data(), 1, m_buffer.size(), m_file );
+        m_position = 0;
+        if( m_size == 0 )
+            return EOF;
+    }
+
+    return static_cast<unsigned char>( m_buffer[ m_position ] );
+}
+
+
+int XMLReader::get()
+{
+    int c = peek();
+    if( c != EOF )
+    {
+        m_position++;
+        if( c == '\n' )
+            m_line++;
+    }
+
+    return c;
+}
+
+
+void XMLReader::expect( const char* str )
+{
+    for( const char* s=str; *s != 0; s++ )
+        if( get() != *s )
+            error( "expected \"" + std::string( str ) + "\"" );
+}
+
+
+void XMLReader::skipUntil( const char* str )
+{
+    // enough for the terminators used here, "-->" is the only one starting with a repeat
+    size_t length = std::strlen( str );
+    size_t matched = 0;
+    while( matched < length )
+    {
+        int c = get();
+        if( c == EOF )
+            error( "expected \"" + std::string( str ) + "\"" );
+        if( c == str[matched] )
+            matched++;
+        else if( c != str[0] )
+            matched = 0;
+        else if( !( matched == 2 && str[1] == str[0] ) )
+            matched = 1;
+    }
+}
+
+
+void XMLReader::readName( std::string& name )
+{
+    name.clear();
+    int c;
+    while( ( c = peek() ) != EOF && std::strchr( " \t\r\n/>=", c ) == 0 )
+        name.push_back( static_cast<char>( get() ) );
+
+    if( name.empty() )
+        error( "expected an element name" );
+}
+
+
+void XMLReader::readEntity( std::string& text )
+{
+    // read up to the semicolon
+    std::string entity;
+    get();
+    int c;
+    while( ( c = get() ) != ';' )
+    {
+        if( c == EOF || entity.size() > 8 )
+            error( "malformed entity" );
+        entity.push_back( static_cast<char>( c ) );
+    }
+
+    if( entity == "lt" )
+        text.push_back( '<' );
+    else if( entity == "gt" )
+        text.push_back( '>' );
+    else if( entity == "amp" )
+        text.push_back( '&' );
+    else if( entity == "quot" )
+        text.push_back( '"' );
+    else if( entity == "apos" )
+        text.push_back( '\'' );
+    else if( entity.size() > 1 && entity[0] == '#' )
+    {
+        // numeric character reference, encoded as UTF-8
+        char* end = 0;
+        unsigned long code = ( entity[1] == 'x' ) ? std::strtoul( entity.c_str()+2, &end, 16 ) : std::strtoul( entity.c_str()+1, &end, 10 );
+        if( *end != 0 || code > 0x10FFFF )
+            error( "malformed entity &" + entity + ";" );
+
+        if( code < 0x80 )
+            text.push_back( static_cast<char>( code ) );
+        else if( code < 0x800 )
+        {
+            text.push_back( static_cast<char>( 0xC0 | ( code >> 6 ) ) );
+            text.push_back( static_cast<char>( 0x80 | ( code & 0x3F ) ) );
+        }
+        else if( code < 0x10000 )
+        {
+            text.push_back( static_cast<char>( 0xE0 | ( code >> 12 ) ) );
+            text.push_back( static_cast<char>( 0x80 | ( ( code >> 6 ) & 0x3F ) ) );
+            text.push_back( static_cast<char>( 0x80 | ( code & 0x3F ) ) );
+        }
+        else
+        {
+            text.push_back( static_cast<char>( 0xF0 | ( code >> 18 ) ) );
+            text.push_back( static_cast<char>( 0x80 | ( ( code >> 12 ) & 0x3F ) ) );
+            text.push_back( static_cast<char>( 0x80 | ( ( code >> 6 ) & 0x3F ) ) );
+            text.push_back( static_cast<char>( 0x80 | ( code & 0x3F ) ) );
+        }
+    }
+    else
+        error( "unknown entity &" + entity + ";" );
+}
+
+
+void XMLReader::error( const std::string& msg ) const
+{
+    throw std::runtime_error( "XMLReader: " + m_filename + ":" + toString( m_line ) + ": " + msg + "." );
+}
+
+
+} // end namespace iris
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+#include <iris/CameraSet.hpp>
+#include <iris/OpenCVSingleCalibration.hpp>
+#include <iris/Projection.hpp>
+
+#include "SyntheticCamera.hpp"
+
+
+/////
+// Allocation counting
+///
+static std::atomic<size_t> g_allocations( 0 );
+static std::atomic<size_t> g_bytes( 0 );
+
+void* operator new( size_t size )
+{
+    g_allocations++;
+    g_bytes += size;
+    void* ptr = std::malloc( size > 0 ? size : 1 );
+    if( ptr == 0 )
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+
+/////
+// Finder that hands out precomputed detections
+///
+class SyntheticFinder : public iris::Finder
+{
+public:
+    SyntheticFinder( const iris::Camera_d& cam, size_t poseCount )
+    {
+        // a 9x6 checkerboard
+        std::shared_ptr<iris::Pattern_d> pattern = synthetic_checkerboard( 9, 6, 0.03 );
+        for( size_t i=0; i<pattern->points.size(); i++ )
+            m_indices.push_back( i );
+        setPattern( pattern );
+
+        // views from various directions
+        for( size_t p=0; p<poseCount; p++ )
+        {
+            double a = 6.283185307179586 * static_cast<double>( p % 97 ) / 97.0;
+            Eigen::Matrix4d view = synthetic_view( a, 0.4, 0.6 + 0.1*static_cast<double>( p % 13 ) / 13.0, 0.03, 3*a );
+            m_detections.push_back( iris::project< iris::PinholeModel<double> >( cam, view, m_pattern->points ) );
+        }
+        m_configured = true;
+    }
+
+    using iris::Finder::find;
+
+    virtual bool find( iris::Pose_d& pose )
+    {
+        const iris::Correspondences<double>::Points& detection = m_detections[ pose.id % m_detections.size() ];
+        pose.correspondences.clear();
+        pose.correspondences.resize( detection.cols() );
+        pose.correspondences.points() = detection;
+        for( size_t i=0; i<m_indices.size(); i++ )
+            pose.correspondences.setIndex( i, m_indices[i] );
+        pose.pattern = m_pattern;
+        return true;
+    }
+
+    virtual std::shared_ptr<iris::Finder> clone() const
+    {
+        return std::make_shared<SyntheticFinder>( *this );
+    }
+
+protected:
+    std::vector< iris::Correspondences<double>::Points > m_detections;
+};
+
+
+/////
+// Measure a stage
+///
+class Stage
+{
+public:
+    Stage( const std::string& name ) :
+        m_name( name ),
+        m_allocations( g_allocations ),
+        m_bytes( g_bytes ),
+        m_start( std::chrono::high_resolution_clock::now() )
+    {
+    }
+
+    ~Stage()
+    {
+        double ms = std::chrono::duration<double,std::milli>( std::chrono::high_resolution_clock::now() - m_start ).count();
+        std::cout << m_name << ": " << ( g_allocations - m_allocations ) << " allocations, "
+                  << ( g_bytes - m_bytes ) / 1024 << " KiB, " << ms << " ms" << std::endl;
+    }
+
+protected:
+    std::string m_name;
+    size_t m_allocations;
+    size_t m_bytes;
+    std::chrono::high_resolution_clock::time_point m_start;
+};
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        size_t poseCount = 5000;
+        std::string filename = "bench_allocations.xml";
+
+        // one shared image for all poses
+        iris::Camera_d reference;
+        reference.imageSize = Eigen::Vector2i( 640, 480 );
+        reference.intrinsic << 820, 0, 330,
+                               0, 810, 235,
+                               0, 0, 1;
+        std::shared_ptr< cimg_library::CImg<uint8_t> > image( new cimg_library::CImg<uint8_t>( 640, 480, 1, 1, 0 ) );
+        std::shared_ptr<SyntheticFinder> finder( new SyntheticFinder( reference, poseCount ) );
+
+        iris::CameraSet_d cs;
+        {
+            Stage stage( "add" );
+            for( size_t p=0; p<poseCount; p++ )
+                cs.add( image, "pose_" + iris::toString( p ) + ".png" );
+        }
+
+        {
+            Stage stage( "calibrate" );
+            iris::OpenCVSingleCalibration calibration;
+            calibration.setFinder( finder );
+            calibration.setMaxPoses( 50 );
+            calibration.calibrate( cs );
+        }
+
+        {
+            Stage stage( "save" );
+            cs.save( filename );
+        }
+
+        {
+            Stage stage( "load" );
+            iris::CameraSet_d loaded;
+            loaded.load( filename );
+        }
+
+        std::remove( filename.c_str() );
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/CameraSet.hpp>
+
+
+inline double elapsed( const std::chrono::high_resolution_clock::time_point& start )
+{
+    return std::chrono::duration<double,std::milli>( std::chrono::high_resolution_clock::now() - start ).count();
+}
+
+
+inline size_t file_size( const std::string& filename )
+{
+    std::ifstream file( filename.c_str(), std::ios::binary | std::ios::ate );
+    return static_cast<size_t>( file.tellg() );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        size_t poseCount = argc > 1 ? std::atoi( argv[1] ) : 10000;
+        size_t pointCount = 300;
+        std::string xmlFile = "bench_camera_set.xml";
+        std::string binaryFile = "bench_camera_set.iris";
+        std::string journalFile = "bench_camera_set.irisj";
+
+        // a calibrated set with a dense pattern
+        iris::CameraSet_d cs;
+        iris::Camera_d& cam = cs.cameras()[0];
+        cam.id = 0;
+        cam.imageSize = Eigen::Vector2i( 1920, 1080 );
+        cam.intrinsic << 1400, 0, 960, 0, 1400, 540, 0, 0, 1;
+        cam.distortion = { -0.2, 0.05, 0.001, -0.001, 0.0 };
+        cam.poses.resize( poseCount );
+        std::shared_ptr<iris::Pattern_d> pattern( new iris::Pattern_d() );
+        for( size_t i=0; i<pointCount; i++ )
+            pattern->points.push_back( Eigen::Vector3d::Random() );
+        for( size_t p=0; p<poseCount; p++ )
+        {
+            iris::Pose_d& pose = cam.poses[p];
+            pose.id = p;
+            pose.name = "pose_" + iris::toString( p ) + ".png";
+            pose.rejected = false;
+            pose.transformation = Eigen::Matrix4d::Random();
+            pose.pattern = pattern;
+            for( size_t i=0; i<pointCount; i++ )
+                pose.correspondences.push_back( Eigen::Vector2d::Random() * 1000, i );
+            pose.projected2D = iris::Correspondences<double>::Points::Random( 2, pointCount ) * 1000;
+        }
+
+        std::chrono::high_resolution_clock::time_point start;
+        std::cout << poseCount << " poses with " << pointCount << " points each" << std::endl;
+
+        // XML
+        start = std::chrono::high_resolution_clock::now();
+        cs.save( xmlFile );
+        double xmlSave = elapsed( start );
+        start = std::chrono::high_resolution_clock::now();
+        {
+            iris::CameraSet_d loaded;
+            loaded.load( xmlFile );
+        }
+        double xmlLoad = elapsed( start );
+
+        // binary
+        start = std::chrono::high_resolution_clock::now();
+        cs.save( binaryFile );
+        double binarySave = elapsed( start );
+        start = std::chrono::high_resolution_clock::now();
+        {
+            iris::CameraSet_d loaded;
+            loaded.load( binaryFile );
+        }
+        double binaryLoad = elapsed( start );
+
+        // lazy access to a single pose
+        start = std::chrono::high_resolution_clock::now();
+        {
+            iris::CameraSetFile file( binaryFile );
+            iris::Pose_d pose;
+            file.pose( poseCount/2, pose );
+        }
+        double binarySingle = elapsed( start );
+
+        // journal, a snapshot and then a batch of new poses
+        std::remove( journalFile.c_str() );
+        start = std::chrono::high_resolution_clock::now();
+        cs.save( journalFile );
+        double journalSave = elapsed( start );
+        size_t batch = 10;
+        for( size_t p=0; p<batch; p++ )
+        {
+            iris::Pose_d pose = cs.cameras()[0].poses[p];
+            pose.id = poseCount + p;
+            pose.name = "pose_" + iris::toString( pose.id ) + ".png";
+            cs.cameras()[0].poses.push_back( pose );
+        }
+        start = std::chrono::high_resolution_clock::now();
+        cs.save( journalFile );
+        double journalAppend = elapsed( start );
+        size_t journalSize = file_size( journalFile );
+        uint64_t appended = cs.journal().appendedBytes();
+        start = std::chrono::high_resolution_clock::now();
+        {
+            iris::CameraSet_d loaded;
+            loaded.load( journalFile );
+        }
+        double journalLoad = elapsed( start );
+
+        std::cout << "xml:    " << file_size( xmlFile ) / (1024*1024) << " MiB, save " << xmlSave << " ms, load " << xmlLoad << " ms" << std::endl;
+        std::cout << "binary: " << file_size( binaryFile ) / (1024*1024) << " MiB, save " << binarySave << " ms, load " << binaryLoad << " ms, single pose " << binarySingle << " ms" << std::endl;
+        std::cout << "journal: " << journalSize / (1024*1024) << " MiB, snapshot " << journalSave << " ms, load " << journalLoad << " ms, append of " << batch << " poses "
+                  << journalAppend << " ms (" << appended / 1024 << " KiB)" << std::endl;
+
+        std::remove( xmlFile.c_str() );
+        std::remove( binaryFile.c_str() );
+        std::remove( journalFile.c_str() );
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/Initialization.hpp>
+#include <iris/Projection.hpp>
+
+#include "SyntheticCamera.hpp"
+
+
+inline iris::Camera_d synthetic_camera( size_t poseCount )
+{
+    iris::Camera_d cam;
+    cam.imageSize = Eigen::Vector2i( 1280, 960 );
+    cam.intrinsic << 1640, 0, 655,
+                     0, 1640, 470,
+                     0, 0, 1;
+
+    // a 12x9 checkerboard
+    std::shared_ptr<iris::Pattern_d> pattern = synthetic_checkerboard( 12, 9, 0.025 );
+    for( size_t p=0; p<poseCount; p++ )
+    {
+        double a = 6.283185307179586 * p / poseCount;
+        cam.poses.push_back( synthetic_pose( cam, pattern, synthetic_view( a, 0.5, 0.7 + 0.2*p/poseCount, 0.03, 3*a ), 0.3 ) );
+        cam.poses.back().id = p;
+    }
+
+    return cam;
+}
+
+
+inline double calibrate( const iris::Camera_d& cam, const Eigen::Matrix3d& K, int flags, double& error )
+{
+    std::vector< std::vector<cv::Point2f> > points2D;
+    std::vector< std::vector<cv::Point3f> > points3D;
+    for( size_t p=0; p<cam.poses.size(); p++ )
+    {
+        points2D.push_back( iris::eigen2cv<float>( cam.poses[p].correspondences ) );
+        points3D.push_back( iris::pattern2cv<float>( cam.poses[p] ) );
+    }
+
+    cv::Mat cameraMatrix;
+    cv::Mat distCoeff = cv::Mat::zeros(5,1,CV_64F);
+    std::vector<cv::Mat> rotationVectors, translationVectors;
+    cv::eigen2cv( K, cameraMatrix );
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    error = cv::calibrateCamera( points3D, points2D, cv::Size( cam.imageSize(0), cam.imageSize(1) ),
+                                 cameraMatrix, distCoeff, rotationVectors, translationVectors, flags );
+    return std::chrono::duration<double,std::milli>( std::chrono::high_resolution_clock::now() - start ).count();
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        size_t poseCounts[] = { 10, 50, 200 };
+        for( size_t i=0; i<3; i++ )
+        {
+            iris::Camera_d cam = synthetic_camera( poseCounts[i] );
+            Eigen::Matrix3d truth = cam.intrinsic;
+
+            // closed form
+            iris::Initialization init;
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            if( !init.initialize( cam ) )
+                throw std::runtime_error("BenchInitialization: initialization failed.");
+            double initTime = std::chrono::duration<double,std::milli>( std::chrono::high_resolution_clock::now() - start ).count();
+
+            // refinement from identity and from the closed form
+            double errorPlain, errorGuess;
+            double plainTime = calibrate( cam, Eigen::Matrix3d::Identity(), 0, errorPlain );
+            double guessTime = calibrate( cam, cam.intrinsic, CV_CALIB_USE_INTRINSIC_GUESS, errorGuess );
+
+            std::cout << poseCounts[i] << " poses:"
+                      << " init " << initTime << " ms (focal error " << std::fabs( cam.intrinsic(0,0) - truth(0,0) ) << " px),"
+                      << " refine from identity " << plainTime << " ms (" << errorPlain << "),"
+                      << " refine from closed form " << guessTime << " ms (" << errorGuess << ")" << std::endl;
+        }
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
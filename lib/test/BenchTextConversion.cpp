@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/util.hpp>
+
+
+/////
+// The stream based helpers as they were
+///
+template <typename T, int Rows, int Cols>
+inline std::string legacy_toString( const std::vector< Eigen::Matrix<T,Rows,Cols> >& vec )
+{
+    std::stringstream ss;
+    for( size_t i=0; i<vec.size(); i++ )
+    {
+        std::stringstream element;
+        element.precision( std::numeric_limits<T>::max_digits10 );
+        for( int j=0; j<Rows*Cols; j++ )
+            element << vec[i].data()[j] << " ";
+        ss << element.str() << "; ";
+    }
+
+    return ss.str();
+}
+
+
+template <typename T, int Rows, int Cols>
+inline void legacy_str2eigenVector( std::string str, std::vector< Eigen::Matrix<T,Rows,Cols> >& result )
+{
+    size_t start=0;
+    size_t finish = str.find_first_of( ';' );
+    while( finish != std::string::npos )
+    {
+        std::string sub = str.substr( start, finish - start );
+        std::stringstream ss;
+        ss << sub;
+        ss.seekg( 0, std::ios::beg );
+        Eigen::Matrix<T,Rows,Cols> mat;
+        for( int i=0; i<Rows*Cols && sub.size() > Rows*Cols; i++ )
+            ss >> mat.data()[i];
+        result.push_back( mat );
+
+        start=finish + 1;
+        finish = str.find_first_of( ';', start );
+    }
+}
+
+
+inline double elapsed( const std::chrono::high_resolution_clock::time_point& start )
+{
+    return std::chrono::duration<double,std::milli>( std::chrono::high_resolution_clock::now() - start ).count();
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        // the points of a few hundred poses
+        size_t pointCount = 1000000;
+        std::vector< Eigen::Vector2d > points( pointCount );
+        for( size_t i=0; i<pointCount; i++ )
+            points[i] = Eigen::Vector2d::Random() * 1000;
+        std::chrono::high_resolution_clock::time_point start;
+
+        // formatting
+        start = std::chrono::high_resolution_clock::now();
+        std::string legacyText = legacy_toString( points );
+        double legacyFormat = elapsed( start );
+
+        start = std::chrono::high_resolution_clock::now();
+        std::string text;
+        text.reserve( legacyText.size() );
+        iris::appendString( text, points );
+        double format = elapsed( start );
+
+        if( text != legacyText )
+            throw std::runtime_error( "BenchTextConversion: formatted text differs." );
+
+        // parsing
+        std::vector< Eigen::Vector2d > legacyParsed, parsed;
+        start = std::chrono::high_resolution_clock::now();
+        legacy_str2eigenVector( text, legacyParsed );
+        double legacyParse = elapsed( start );
+
+        start = std::chrono::high_resolution_clock::now();
+        iris::str2eigenVector( text, parsed );
+        double parse = elapsed( start );
+
+        if( parsed != points || legacyParsed != points )
+            throw std::runtime_error( "BenchTextConversion: parsed points differ." );
+
+        std::cout << pointCount << " points, " << text.size() / (1024*1024) << " MiB of text" << std::endl;
+        std::cout << "format: streams " << legacyFormat << " ms, iris " << format << " ms" << std::endl;
+        std::cout << "parse:  streams " << legacyParse << " ms, iris " << parse << " ms" << std::endl;
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/*
+ * SyntheticCamera.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <cmath>
+#include <memory>
+
+#include <iris/Projection.hpp>
+
+
+/////
+// Synthetic calibration data shared by the tests and benchmarks
+///
+
+// a planar checkerboard of columns x rows corners, centered on the origin
+inline std::shared_ptr<iris::Pattern_d> synthetic_checkerboard( int columns, int rows, double square )
+{
+    std::shared_ptr<iris::Pattern_d> pattern( new iris::Pattern_d() );
+    for( int y=0; y<rows; y++ )
+        for( int x=0; x<columns; x++ )
+            pattern->points.push_back( Eigen::Vector3d( square * ( x - 0.5*(columns-1) ), square * ( y - 0.5*(rows-1) ), 0 ) );
+    return pattern;
+}
+
+
+// the pattern at distance, shifted off the axis towards shiftAngle and
+// tilted by tilt around the axis in direction a
+inline Eigen::Matrix4d synthetic_view( double a, double tilt, double distance, double shift, double shiftAngle )
+{
+    Eigen::Affine3d trans;
+    trans.setIdentity();
+    trans.translate( Eigen::Vector3d( shift*std::cos( shiftAngle ), shift*std::sin( shiftAngle ), distance ) );
+    trans.rotate( Eigen::AngleAxisd( tilt, Eigen::Vector3d( std::cos( a ), std::sin( a ), 0 ) ) );
+    return trans.matrix();
+}
+
+
+// a pose seeing the whole pattern from the given view, with uniform noise
+// of up to noise pixels on the detections
+inline iris::Pose_d synthetic_pose( const iris::Camera_d& cam, const std::shared_ptr<iris::Pattern_d>& pattern, const Eigen::Matrix4d& view, double noise )
+{
+    iris::Pose_d pose;
+    pose.pattern = pattern;
+    pose.transformation = view;
+    iris::Correspondences<double>::Points points2D = iris::project< iris::PinholeModel<double> >( cam, view, pattern->points );
+    for( size_t i=0; i<static_cast<size_t>( points2D.cols() ); i++ )
+        pose.correspondences.push_back( points2D.col(i) + noise * Eigen::Vector2d::Random(), i );
+    return pose;
+}
+
+
+// a VGA camera seeing a 9x6 checkerboard from poseCount directions around
+// the optical axis
+inline iris::Camera_d synthetic_camera( size_t poseCount, double noise )
+{
+    iris::Camera_d cam;
+    cam.imageSize = Eigen::Vector2i( 640, 480 );
+    cam.intrinsic << 820, 0, 330,
+                     0, 810, 235,
+                     0, 0, 1;
+
+    std::shared_ptr<iris::Pattern_d> pattern = synthetic_checkerboard( 9, 6, 0.03 );
+    for( size_t p=0; p<poseCount; p++ )
+    {
+        double a = 6.283185307179586 * p / poseCount;
+        cam.poses.push_back( synthetic_pose( cam, pattern, synthetic_view( a, 0.4, 0.6 + 0.05*p/poseCount, 0.02, a ), noise ) );
+        cam.poses.back().id = p;
+    }
+
+    return cam;
+}
@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <iris/CameraCalibration.hpp>
+#include <iris/TaskPool.hpp>
+
+
+/////
+// Finder which takes its time
+///
+class SlowFinder : public iris::Finder
+{
+public:
+    SlowFinder()
+    {
+        std::shared_ptr<iris::Pattern_d> pattern( new iris::Pattern_d() );
+        pattern->points.push_back( Eigen::Vector3d( 0, 0, 0 ) );
+        setPattern( pattern );
+        m_configured = true;
+    }
+
+    using iris::Finder::find;
+
+    virtual bool find( iris::Pose_d& pose )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+        pose.correspondences.clear();
+        pose.correspondences.push_back( Eigen::Vector2d( 1, 2 ), 0 );
+        pose.pattern = m_pattern;
+        return true;
+    }
+
+    virtual std::shared_ptr<iris::Finder> clone() const
+    {
+        return std::make_shared<SlowFinder>( *this );
+    }
+};
+
+
+/////
+// Finder without clones, counts the calls running at the same time
+///
+class SerialFinder : public SlowFinder
+{
+public:
+    SerialFinder() : running(0), maxRunning(0) {}
+
+    using iris::Finder::find;
+
+    virtual bool find( iris::Pose_d& pose )
+    {
+        size_t now = ++running;
+        maxRunning = std::max<size_t>( maxRunning, now );
+        bool found = SlowFinder::find( pose );
+        running--;
+        return found;
+    }
+
+    virtual std::shared_ptr<iris::Finder> clone() const
+    {
+        return iris::Finder::clone();
+    }
+
+    std::atomic<size_t> running;
+    size_t maxRunning;
+};
+
+
+/////
+// Calibration which refines for a while
+///
+class SlowCalibration : public iris::CameraCalibration
+{
+public:
+    SlowCalibration() : iterations(0)
+    {
+        setProgressSink( std::make_shared<iris::Progress::NullSink>() );
+        setFinder( std::make_shared<SlowFinder>() );
+    }
+
+    using iris::CameraCalibration::calibrate;
+    virtual void calibrate( iris::CameraSet_d& cs )
+    {
+        Run run( *this );
+        check();
+        iterations = 0;
+        Rollback rollback( cs );
+
+        // detect
+        std::vector< iris::Pose_d* > poses;
+        for( auto it = cs.cameras().begin(); it != cs.cameras().end(); it++ )
+            for( size_t p=0; p<it->second.poses.size(); p++ )
+                poses.push_back( &it->second.poses[p] );
+        detect( poses );
+        checkCancelled();
+
+        // refine until done or out of time
+        filter( cs );
+        iris::CameraView_d& view = m_filteredCameras.begin()->second;
+        for( size_t i=0; i<100 && !stopping(); i++ )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+            view.error = static_cast<double>( i );
+            publish( view );
+            iterations++;
+        }
+        checkCancelled();
+        commit( cs );
+        rollback.release();
+    }
+
+    size_t iterations;
+
+protected:
+    virtual void filter( iris::CameraSet_d& cs )
+    {
+        m_filteredCameras.clear();
+        for( auto it = cs.cameras().begin(); it != cs.cameras().end(); it++ )
+        {
+            iris::CameraView_d view( it->second );
+            view.addAll();
+            m_filteredCameras[ it->first ] = view;
+        }
+    }
+};
+
+
+inline iris::CameraSet_d make_set()
+{
+    std::shared_ptr< cimg_library::CImg<uint8_t> > image( new cimg_library::CImg<uint8_t>( 8, 6, 1, 1, 0 ) );
+    iris::CameraSet_d cs;
+    for( size_t i=0; i<20; i++ )
+        cs.add( image, "pose_" + iris::toString( i ) + ".png" );
+    return cs;
+}
+
+
+inline void test_async()
+{
+    // runs to the end, the snapshot follows the refinement
+    SlowCalibration calibration;
+    iris::CameraSet_d cs = make_set();
+    assert( !calibration.snapshot() );
+    std::future<void> result = calibration.calibrateAsync( cs );
+
+    // only one at a time
+    bool thrown = false;
+    try
+    {
+        iris::CameraSet_d other = make_set();
+        calibration.calibrateAsync( other );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown );
+
+    // nor next to a run of the same calibration on another thread
+    thrown = false;
+    try
+    {
+        iris::CameraSet_d other = make_set();
+        calibration.calibrate( other );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown );
+
+    result.get();
+    assert( calibration.iterations == 100 );
+    assert( cs.camera().error == 99.0 && cs.camera().poses[19].correspondences.size() == 1 );
+    assert( calibration.snapshot() && calibration.snapshot()->camera().error == 99.0 );
+
+    // the run is over once the future is ready
+    calibration.calibrateAsync( cs ).get();
+    assert( calibration.iterations == 100 );
+}
+
+
+inline void test_cancel()
+{
+    SlowCalibration calibration;
+    iris::CameraSet_d cs = make_set();
+    calibration.snapshot();
+
+    // a first run leaves results behind, the cancelled one has to restore them
+    calibration.calibrate( cs );
+    cs.camera().poses[3].correspondences.setWeight( 0, 0.0 );
+    cs.camera().poses[3].transformation(0,3) = 7.0;
+    cs.camera().poses[5].rejected = true;
+    std::future<void> result = calibration.calibrateAsync( cs );
+
+    // cancel as soon as the refinement shows up
+    while( !calibration.snapshot() || calibration.snapshot()->camera().error < 3.0 )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    calibration.cancel();
+
+    bool thrown = false;
+    try
+    {
+        result.get();
+    }
+    catch( std::runtime_error& e )
+    {
+        thrown = true;
+    }
+    assert( thrown && calibration.iterations < 100 );
+
+    // the set is as it was before the run
+    assert( cs.camera().error == 99.0 );
+    for( size_t p=0; p<cs.camera().poses.size(); p++ )
+        assert( cs.camera().poses[p].correspondences.size() == 1 && cs.camera().poses[p].rejected == ( p == 5 ) );
+    assert( cs.camera().poses[3].correspondences.weight( 0 ) == 0.0 );
+    assert( cs.camera().poses[3].transformation(0,3) == 7.0 );
+
+    // the next run is not affected
+    calibration.calibrate( cs );
+    assert( calibration.iterations == 100 );
+}
+
+
+inline void test_budget()
+{
+    // out of time the best so far is committed
+    SlowCalibration calibration;
+    calibration.setTimeBudget( std::chrono::milliseconds( 100 ) );
+    iris::CameraSet_d cs = make_set();
+    calibration.calibrate( cs );
+    assert( calibration.iterations < 100 );
+    assert( calibration.iterations == 0 || cs.camera().error == static_cast<double>( calibration.iterations ) - 1.0 );
+}
+
+
+inline void test_serial_finder()
+{
+    // without clones the detection stays on the configured instance
+    SlowCalibration calibration;
+    std::shared_ptr<SerialFinder> finder = std::make_shared<SerialFinder>();
+    calibration.setFinder( finder );
+    calibration.setTaskPool( std::make_shared<iris::TaskPool>( 4 ) );
+    iris::CameraSet_d cs = make_set();
+    calibration.calibrate( cs );
+    assert( finder->maxRunning == 1 );
+    assert( cs.camera().poses[19].correspondences.size() == 1 );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_async();
+        test_cancel();
+        test_budget();
+        test_serial_finder();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,554 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include <iris/CameraSet.hpp>
+
+
+inline std::string pose_name( size_t i )
+{
+    return "pose_" + iris::toString( i ) + ".png";
+}
+
+
+inline void test_lookup()
+{
+    // two cameras, the second one reuses the names of the first
+    iris::CameraSet_d cs;
+    std::shared_ptr< cimg_library::CImg<uint8_t> > image( new cimg_library::CImg<uint8_t>( 8, 6, 1, 1, 0 ) );
+    size_t poseCount = 2000;
+    for( size_t i=0; i<poseCount; i++ )
+        assert( cs.add( image, pose_name( i % (poseCount/2) ), i < poseCount/2 ? 0 : 1 ) == i );
+
+    // ids and names
+    for( size_t i=0; i<poseCount; i++ )
+    {
+        assert( cs.hasPose( i ) );
+        assert( cs.pose( i ).id == i );
+    }
+    assert( !cs.hasPose( poseCount ) );
+    assert( !cs.hasPose( std::string("missing.png") ) );
+
+    // names resolve to the first occurrence
+    assert( cs.pose( pose_name( 3 ) ).id == 3 );
+
+    // erasing moves the following poses, lookups have to follow
+    assert( cs.erase( 10 ) );
+    assert( !cs.erase( 10 ) );
+    assert( !cs.hasPose( 10 ) );
+    assert( cs.pose( 11 ).id == 11 );
+    assert( cs.pose( pose_name( 10 ) ).id == 10 + poseCount/2 );
+    assert( cs.erase( pose_name( 10 ) ) );
+    assert( !cs.hasPose( pose_name( 10 ) ) );
+    assert( cs.pose( poseCount-1 ).id == poseCount-1 );
+    assert( cs.poseCount() == poseCount - 2 );
+
+    // erasing from the middle keeps every other pose reachable
+    for( size_t i=100; i<200; i+=3 )
+        assert( cs.erase( i ) );
+    for( size_t i=0; i<poseCount; i++ )
+        assert( cs.hasPose( i ) == !( i == 10 || i == 10 + poseCount/2 || ( i >= 100 && i < 200 && ( i - 100 ) % 3 == 0 ) ) );
+
+    // results written through the cameras or the pose keep the handles
+    for( auto it=cs.cameras().begin(); it != cs.cameras().end(); it++ )
+        for( size_t p=0; p<it->second.poses.size(); p++ )
+            it->second.poses[p].rejected = true;
+    cs.pose( 101 ).rejected = false;
+    assert( !cs.pose( 101 ).rejected && cs.pose( 102 ).rejected );
+    assert( cs.pose( pose_name( 101 ) ).id == 101 );
+
+    // direct changes through the cameras are picked up
+    size_t count = cs.poseCount();
+    cs.cameras()[0].poses.erase( cs.cameras()[0].poses.begin() );
+    assert( cs.poseCount() == count - 1 );
+    assert( !cs.hasPose( 0 ) );
+    assert( cs.pose( 1 ).id == 1 );
+
+    // new poses after changes and copies
+    size_t id = cs.add( image, "new.png", 0 );
+    assert( cs.pose( "new.png" ).id == id );
+    iris::CameraSet_d copy( cs );
+    assert( copy.pose( id ).name == "new.png" );
+    assert( copy.pose( pose_name( 5 ) ).id == 5 );
+}
+
+
+inline iris::CameraSet_d random_set()
+{
+    // two cameras with calibration results and one rejected pose
+    iris::CameraSet_d cs;
+    std::map< size_t, iris::Camera_d >& cameras = cs.cameras();
+    for( size_t c=0; c<2; c++ )
+    {
+        iris::Camera_d& cam = cameras[c];
+        cam.id = c;
+        cam.imageSize = Eigen::Vector2i( 640, 480 );
+        cam.sensorSize = Eigen::Vector2d::Random();
+        cam.intrinsic = Eigen::Matrix3d::Random();
+        cam.distortion = { 0.1/3.0, -0.2/7.0, 1e-17, 0.0, 3.0e5/11.0 };
+        cam.error = 0.3/7.0;
+
+        // the poses of a camera share its pattern
+        std::shared_ptr<iris::Pattern_d> pattern( new iris::Pattern_d() );
+        for( size_t i=0; i<3*17+5; i++ )
+            pattern->points.push_back( Eigen::Vector3d::Random() );
+
+        for( size_t p=0; p<5; p++ )
+        {
+            cam.poses.emplace_back();
+            iris::Pose_d& pose = cam.poses.back();
+            pose.id = c*5 + p;
+            pose.name = pose_name( pose.id );
+            pose.rejected = false;
+            pose.transformation = Eigen::Matrix4d::Random();
+            pose.pattern = pattern;
+            // some points are down-weighted or rejected, the formats have to keep that
+            for( size_t i=0; i<17; i++ )
+                pose.correspondences.push_back( Eigen::Vector2d::Random() * 1000, 3*i + p, ( i % 5 == 0 ) ? 0.0 : 1.0 / static_cast<double>( i % 3 + 1 ) );
+            pose.projected2D = iris::Correspondences<double>::Points::Random( 2, 17 ) * 1000;
+        }
+    }
+    cameras[1].poses[2].rejected = true;
+    cameras[1].poses[2].correspondences.clear();
+    cameras[1].poses[2].pattern.reset();
+    cameras[1].poses[2].projected2D.resize( 2, 0 );
+    cameras[1].poses[2].transformation.setIdentity();
+
+    return cs;
+}
+
+
+template <typename T>
+inline void assert_equal( const iris::CameraSet<T>& a, const iris::CameraSet<T>& b )
+{
+    assert( a.cameras().size() == b.cameras().size() );
+    for( auto aIt=a.cameras().begin(), bIt=b.cameras().begin(); aIt != a.cameras().end(); aIt++, bIt++ )
+    {
+        const iris::Camera<T>& ca = aIt->second;
+        const iris::Camera<T>& cb = bIt->second;
+        assert( ca.id == cb.id );
+        assert( ca.imageSize == cb.imageSize );
+        assert( ca.intrinsic == cb.intrinsic );
+        assert( ca.distortion == cb.distortion );
+        assert( ca.error == cb.error );
+        assert( ca.poses.size() == cb.poses.size() );
+        for( size_t p=0; p<ca.poses.size(); p++ )
+        {
+            const iris::Pose<T>& pa = ca.poses[p];
+            const iris::Pose<T>& pb = cb.poses[p];
+            assert( pa.id == pb.id );
+            assert( pa.name == pb.name );
+            assert( pa.rejected == pb.rejected );
+            assert( pa.transformation == pb.transformation );
+            assert( pa.correspondences == pb.correspondences );
+            assert( pa.points3D() == pb.points3D() );
+            assert( pa.projected2D == pb.projected2D );
+        }
+    }
+}
+
+
+inline void test_binary_file()
+{
+    iris::CameraSet_d cs = random_set();
+    std::string filename = "test_camera_set.iris";
+
+    // round trip through the binary format is exact
+    cs.save( filename );
+    assert( iris::CameraSetFile::isCameraSetFile( filename ) );
+    iris::CameraSet_d loaded;
+    loaded.load( filename );
+    assert_equal( cs, loaded );
+    assert( loaded.pose( 7 ).name == pose_name( 7 ) );
+    assert( loaded.add( std::shared_ptr< cimg_library::CImg<uint8_t> >( new cimg_library::CImg<uint8_t>( 640, 480, 1, 1, 0 ) ), "new.png" ) == 10 );
+
+    // poses can be read one at a time
+    iris::CameraSetFile file( filename );
+    assert( file.cameraCount() == 2 );
+    assert( file.poseCount() == 10 );
+    assert( file.cameraPoseBegin( 1 ) == 5 );
+    assert( file.poseName( 6 ) == pose_name( 6 ) );
+    iris::Pose_d pose;
+    file.pose( 3, pose );
+    assert( pose.points3D() == cs.camera( 0 ).poses[3].points3D() );
+    assert( pose.correspondences.weight( 5 ) == 0.0 && pose.correspondences.weight( 4 ) == 0.5 );
+    assert( pose.correspondences.weightedCount() == 13 );
+    file.close();
+
+    // truncated files are refused
+    {
+        std::ifstream in( filename.c_str(), std::ios::binary );
+        std::string contents( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+        std::ofstream out( filename.c_str(), std::ios::binary | std::ios::trunc );
+        out.write( contents.data(), contents.size() - 8 );
+    }
+    bool thrown = false;
+    try
+    {
+        file.open( filename );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown && !file.isOpen() );
+
+    // so are correspondences pointing past their pattern
+    iris::CameraSet_d invalid( cs );
+    iris::Pose_d& first = invalid.cameras()[0].poses[0];
+    first.correspondences.setIndex( 0, first.pattern->points.size() );
+    invalid.save( filename );
+    thrown = false;
+    try
+    {
+        file.open( filename );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown && !file.isOpen() );
+
+    std::remove( filename.c_str() );
+}
+
+
+inline void test_xml_conversion()
+{
+    iris::CameraSet_d cs = random_set();
+    std::string xmlFile = "test_camera_set.xml";
+    std::string binaryFile = "test_camera_set.iris";
+
+    // binary -> xml -> binary keeps every bit
+    cs.save( binaryFile );
+    iris::CameraSet_d fromBinary;
+    fromBinary.load( binaryFile );
+    fromBinary.save( xmlFile );
+    iris::CameraSet_d fromXML;
+    fromXML.load( xmlFile );
+    assert_equal( cs, fromXML );
+    fromXML.save( binaryFile );
+    iris::CameraSet_d back;
+    back.load( binaryFile );
+    assert_equal( cs, back );
+
+    std::remove( xmlFile.c_str() );
+    std::remove( binaryFile.c_str() );
+}
+
+
+inline void test_shared_patterns()
+{
+    iris::CameraSet_d cs = random_set();
+    std::string filename = "test_camera_set.xml";
+
+    // one pattern per camera, in both formats
+    assert( cs.patterns().size() == 2 );
+    for( int binary=0; binary<2; binary++ )
+    {
+        cs.save( binary ? "test_camera_set.iris" : filename );
+        iris::CameraSet_d loaded;
+        loaded.load( binary ? "test_camera_set.iris" : filename );
+        assert( loaded.patterns().size() == 2 );
+        assert( loaded.camera( 0 ).poses[0].pattern == loaded.camera( 0 ).poses[4].pattern );
+        assert( loaded.camera( 0 ).poses[0].pattern != loaded.camera( 1 ).poses[0].pattern );
+    }
+    std::remove( "test_camera_set.iris" );
+
+    // the points are still written per pose, for readers without patterns
+    {
+        std::ifstream in( filename.c_str() );
+        std::string content( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+        assert( content.find( "<Patterns>" ) != std::string::npos );
+        assert( content.find( "<Points3D>" ) != std::string::npos );
+    }
+
+    // older files store the points per pose, poses that agree share them
+    {
+        std::ofstream out( filename.c_str() );
+        out << "<CameraCalibration><Cameras><Camera><Id>0</Id><Poses>\n";
+        out << "<Pose><Id>0</Id><Points2D>1 1 ; 2 2 ;</Points2D><Points3D>0 0 0 ; 1 0 0 ;</Points3D><PointIndices>0 1</PointIndices></Pose>\n";
+        out << "<Pose><Id>1</Id><Points2D>1 1 ; 2 2 ;</Points2D><Points3D>1 0 0 ; 1 1 0 ;</Points3D><PointIndices>1 3</PointIndices></Pose>\n";
+        out << "<Pose><Id>2</Id><Points2D>1 1 ;</Points2D><Points3D>5 5 5 ;</Points3D><PointIndices>0</PointIndices></Pose>\n";
+        out << "</Poses></Camera></Cameras></CameraCalibration>\n";
+    }
+    iris::CameraSet_d legacy;
+    legacy.load( filename );
+    const std::vector<iris::Pose_d>& poses = legacy.camera( 0 ).poses;
+    assert( poses[0].pattern == poses[1].pattern && poses[0].pattern != poses[2].pattern );
+    assert( poses[1].points3D()[1] == Eigen::Vector3d( 1, 1, 0 ) );
+    assert( poses[2].points3D()[0] == Eigen::Vector3d( 5, 5, 5 ) );
+
+    // the gap at index 2 survives a round trip
+    legacy.save( filename );
+    iris::CameraSet_d reloaded;
+    reloaded.load( filename );
+    assert( reloaded.patterns().size() == 2 );
+    assert( reloaded.camera( 0 ).poses[0].pattern->points.size() == 4 );
+    assert( reloaded.camera( 0 ).poses[0].pattern->points[2].hasNaN() );
+    assert( reloaded.camera( 0 ).poses[1].points3D() == poses[1].points3D() );
+
+    std::remove( filename.c_str() );
+}
+
+
+inline void test_single_precision()
+{
+    iris::CameraSet_d cs = random_set();
+
+    // conversion keeps the structure and the shared patterns
+    iris::CameraSet_f single;
+    single.assign( cs );
+    assert( single.patterns().size() == 2 );
+    assert( single.camera( 0 ).poses[0].pattern == single.camera( 0 ).poses[4].pattern );
+    assert( single.pose( 7 ).name == pose_name( 7 ) );
+    assert( single.pose( 6 ).correspondences.indices() == cs.pose( 6 ).correspondences.indices() );
+    assert( single.pose( 6 ).correspondences.point( 3 ) == cs.pose( 6 ).correspondences.point( 3 ).cast<float>() );
+    assert( single.pose( 6 ).points3D()[5] == cs.pose( 6 ).points3D()[5].cast<float>() );
+    assert( single.camera( 1 ).intrinsic == cs.camera( 1 ).intrinsic.cast<float>() );
+    assert( !single.pose( 7 ).pattern && single.pose( 7 ).correspondences.empty() );
+
+    // both formats round trip single precision sets exactly
+    for( int binary=0; binary<2; binary++ )
+    {
+        std::string filename = binary ? "test_camera_set.iris" : "test_camera_set.xml";
+        single.save( filename );
+        iris::CameraSet_f loaded;
+        loaded.load( filename );
+        assert_equal( single, loaded );
+        assert( loaded.patterns().size() == 2 );
+        std::remove( filename.c_str() );
+    }
+
+    // and back to double precision, for solving
+    iris::CameraSet_d back;
+    back.assign( single );
+    assert( back.patterns().size() == 2 );
+    assert( back.pose( 3 ).correspondences.point( 2 ) == single.pose( 3 ).correspondences.point( 2 ).cast<double>() );
+    assert( ( back.pose( 3 ).projected2D - cs.pose( 3 ).projected2D ).cwiseAbs().maxCoeff() < 1e-3 );
+    assert( back.pose( pose_name( 9 ) ).id == 9 );
+}
+
+
+inline void test_journal()
+{
+    iris::CameraSet_d cs = random_set();
+    std::string filename = "test_camera_set.irisj";
+    std::remove( filename.c_str() );
+
+    // the first save of a set is a snapshot
+    cs.save( filename );
+    assert( iris::CameraSetJournal::isJournal( filename ) );
+    iris::CameraSet_d work;
+    work.load( filename );
+    assert_equal( cs, work );
+    assert( work.patterns().size() == 2 );
+    size_t snapshotSize = static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() );
+
+    // saving again without changes writes nothing, a change only itself
+    work.save( filename );
+    assert( static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() ) == snapshotSize );
+    work.cameras()[0].poses[1].transformation(0,3) = 42;
+    work.save( filename );
+    size_t poseResultSize = static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() ) - snapshotSize;
+    assert( poseResultSize > 0 && poseResultSize < snapshotSize / 10 );
+
+    // adds, erases, detections and camera parameters
+    std::shared_ptr< cimg_library::CImg<uint8_t> > image( new cimg_library::CImg<uint8_t>( 640, 480, 1, 1, 0 ) );
+    size_t id = work.add( image, "new.png", 1 );
+    assert( id == 10 );
+    assert( work.erase( 3 ) );
+    work.cameras()[1].poses.back().correspondences.push_back( Eigen::Vector2d( 1, 2 ), 7 );
+    work.cameras()[1].poses.back().pattern = work.cameras()[1].poses[0].pattern;
+    work.cameras()[0].poses[2].correspondences.setWeight( 1, 0.0 );
+    work.cameras()[0].intrinsic(0,0) = 1000;
+    work.save( filename );
+
+    iris::CameraSet_d replayed;
+    replayed.load( filename );
+    assert_equal( work, replayed );
+    assert( replayed.patterns().size() == 2 );
+    assert( replayed.pose( "new.png" ).pattern == replayed.camera( 1 ).poses[0].pattern );
+    assert( replayed.add( image, "next.png" ) == 11 );
+
+    // a record torn by a crash is ignored and left in place, the rest stays readable
+    iris::CameraSet_d before( work );
+    work.cameras()[0].poses[0].rejected = true;
+    work.save( filename );
+    size_t fullSize = static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() );
+    {
+        std::ifstream in( filename.c_str(), std::ios::binary );
+        std::string contents( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+        std::ofstream out( filename.c_str(), std::ios::binary | std::ios::trunc );
+        out.write( contents.data(), contents.size() - 8 );
+    }
+    iris::CameraSet_d recovered;
+    recovered.load( filename );
+    assert_equal( before, recovered );
+    assert( recovered.journal().tornBytes() > 0 );
+    assert( static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() ) == fullSize - 8 );
+
+    // the next save of the recovered set compacts the file
+    recovered.cameras()[0].poses[0].rejected = true;
+    recovered.save( filename );
+    iris::CameraSet_d again;
+    again.load( filename );
+    assert_equal( work, again );
+    assert( again.journal().tornBytes() == 0 );
+
+    // correspondences pointing past their pattern are rejected
+    {
+        std::string invalidName = "test_camera_set_invalid.irisj";
+        std::remove( invalidName.c_str() );
+        iris::CameraSet_d invalid( work );
+        iris::Pose_d& pose = invalid.cameras()[0].poses[0];
+        pose.correspondences.setIndex( 0, pose.pattern->points.size() );
+        invalid.save( invalidName );
+
+        bool failed = false;
+        try
+        {
+            iris::CameraSet_d loaded;
+            loaded.load( invalidName );
+        }
+        catch( std::exception& )
+        {
+            failed = true;
+        }
+        assert( failed );
+        std::remove( invalidName.c_str() );
+    }
+
+    // damage before the end fails the load and leaves the file alone
+    {
+        std::ifstream in( filename.c_str(), std::ios::binary );
+        std::string contents( ( std::istreambuf_iterator<char>( in ) ), std::istreambuf_iterator<char>() );
+        std::string damaged = contents;
+        // in the payload of the first record, a damaged size would look like a torn tail
+        damaged[ 40 ] ^= 0x5a;
+        {
+            std::ofstream out( filename.c_str(), std::ios::binary | std::ios::trunc );
+            out.write( damaged.data(), damaged.size() );
+        }
+
+        bool failed = false;
+        try
+        {
+            iris::CameraSet_d broken;
+            broken.load( filename );
+        }
+        catch( std::exception& )
+        {
+            failed = true;
+        }
+        assert( failed );
+        std::ifstream check( filename.c_str(), std::ios::binary );
+        assert( std::string( ( std::istreambuf_iterator<char>( check ) ), std::istreambuf_iterator<char>() ) == damaged );
+
+        std::ofstream out( filename.c_str(), std::ios::binary | std::ios::trunc );
+        out.write( contents.data(), contents.size() );
+    }
+
+    // compaction leaves only the current state
+    again.load( filename );
+    again.cameras()[0].poses[0].rejected = false;
+    again.save( filename );
+    again.cameras()[0].poses[0].rejected = true;
+    again.save( filename );
+    size_t journalSize = static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() );
+    again.compact();
+    assert( static_cast<size_t>( std::ifstream( filename.c_str(), std::ios::binary | std::ios::ate ).tellg() ) < journalSize );
+    iris::CameraSet_d compacted;
+    compacted.load( filename );
+    assert_equal( work, compacted );
+
+    std::remove( filename.c_str() );
+}
+
+
+inline void test_xml_reader()
+{
+    std::string filename = "test_xml_reader.xml";
+    {
+        std::ofstream out( filename.c_str() );
+        out << "<?xml version=\"1.0\"?>\n<!-- a comment -- with dashes --->\n";
+        out << "<Root attr=\"a > b\">\n  <Empty/>\n  <Text>a &lt;&amp;&gt; &#65;&#x42;<![CDATA[<raw>]]></Text>\n";
+        out << "  <Nested><Inner>x</Inner></Nested>\n</Root>\n";
+    }
+
+    iris::XMLReader reader( filename );
+    assert( reader.next() == iris::XMLReader::StartElement && reader.name() == "Root" );
+    assert( reader.nextChild() && reader.name() == "Empty" );
+    assert( reader.readText().empty() );
+    assert( reader.nextChild() && reader.name() == "Text" );
+    assert( reader.readText() == "a <&> AB<raw>" );
+    assert( reader.nextChild() && reader.name() == "Nested" );
+    reader.skipElement();
+    assert( !reader.nextChild() && reader.name() == "Root" );
+    assert( reader.next() == iris::XMLReader::EndDocument );
+
+    // mismatched tags throw
+    {
+        std::ofstream out( filename.c_str() );
+        out << "<Root><A></B></Root>";
+    }
+    reader.open( filename );
+    bool thrown = false;
+    try
+    {
+        while( reader.next() != iris::XMLReader::EndDocument );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown );
+
+    std::remove( filename.c_str() );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_lookup();
+        test_binary_file();
+        test_xml_conversion();
+        test_shared_patterns();
+        test_single_precision();
+        test_journal();
+        test_xml_reader();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/CameraSet.hpp>
+
+
+inline std::shared_ptr< cimg_library::CImg<uint8_t> > gradient_image( int width, int height )
+{
+    std::shared_ptr< cimg_library::CImg<uint8_t> > image( new cimg_library::CImg<uint8_t>( width, height, 1, 3 ) );
+    for( int y=0; y<height; y++ )
+        for( int x=0; x<width; x++ )
+            for( int c=0; c<3; c++ )
+                (*image)( x, y, 0, c ) = static_cast<uint8_t>( ( x + c*y ) % 256 );
+    return image;
+}
+
+
+inline size_t file_size( const std::string& filename )
+{
+    std::ifstream file( filename.c_str(), std::ios::binary | std::ios::ate );
+    return file ? static_cast<size_t>( file.tellg() ) : 0;
+}
+
+
+// two cameras, the second one distorted, with one rejected pose and one without an image
+inline iris::CameraSet_d export_set()
+{
+    iris::CameraSet_d cs;
+    cs.setProgressSink( std::make_shared<iris::Progress::NullSink>() );
+    for( size_t c=0; c<2; c++ )
+        for( size_t p=0; p<3; p++ )
+            cs.add( gradient_image( 160, 120 ), "camera" + iris::toString( c ) + "_" + iris::toString( p ) + ".png", c );
+
+    std::map< size_t, iris::Camera_d >& cameras = cs.cameras();
+    for( size_t c=0; c<2; c++ )
+    {
+        cameras[c].intrinsic << 150, 0, 80,
+                                0, 150, 60,
+                                0, 0, 1;
+        cameras[c].distortion = std::vector<double>( 5, 0.0 );
+        for( size_t p=0; p<3; p++ )
+            cameras[c].poses[p].rejected = false;
+    }
+    cameras[1].distortion[0] = -0.2;
+    cameras[0].poses[2].rejected = true;
+    cameras[1].poses[1].image.reset();
+
+    return cs;
+}
+
+
+inline std::string undistorted_name( const std::string& set, size_t camera, size_t pose, const std::string& extension )
+{
+    return set + "-camera" + iris::toString( camera ) + "_" + iris::toString( pose ) + "-undistorted" + extension;
+}
+
+
+inline void remove_exported( const std::string& set, const std::string& extension )
+{
+    for( size_t c=0; c<2; c++ )
+        for( size_t p=0; p<3; p++ )
+            std::remove( undistorted_name( set, c, p, extension ).c_str() );
+    std::remove( ( set + ".xml" ).c_str() );
+}
+
+
+inline void test_export()
+{
+    iris::CameraSet_d cs = export_set();
+
+    // the memory bound limits the workers, each holds three images
+    size_t imageBytes = 160*120*3;
+    cs.setExportMemory( 2*3*imageBytes );
+    cs.save( "test_export.xml", true );
+    const iris::CameraSet_d::ExportReport& report = cs.exportReport();
+    assert( report.images == 4 );
+    assert( report.workers >= 1 && report.workers <= 2 );
+    assert( report.totalTime >= report.mapTime );
+
+    // rejected poses and poses without an image are skipped
+    assert( file_size( undistorted_name( "test_export", 0, 0, ".png" ) ) > 0 );
+    assert( file_size( undistorted_name( "test_export", 0, 1, ".png" ) ) > 0 );
+    assert( file_size( undistorted_name( "test_export", 0, 2, ".png" ) ) == 0 );
+    assert( file_size( undistorted_name( "test_export", 1, 0, ".png" ) ) > 0 );
+    assert( file_size( undistorted_name( "test_export", 1, 1, ".png" ) ) == 0 );
+    assert( file_size( undistorted_name( "test_export", 1, 2, ".png" ) ) > 0 );
+
+    // without distortion the image comes back unchanged, in RGB order
+    cv::Mat undistorted = cv::imread( undistorted_name( "test_export", 0, 0, ".png" ) );
+    assert( undistorted.cols == 160 && undistorted.rows == 120 && undistorted.channels() == 3 );
+    assert( undistorted.at<cv::Vec3b>( 50, 70 )[2] == 70 && undistorted.at<cv::Vec3b>( 50, 70 )[1] == 120 );
+
+    // the distorted camera's images do change
+    cv::Mat distorted = cv::imread( undistorted_name( "test_export", 1, 0, ".png" ) );
+    cv::Mat original = cv::imread( undistorted_name( "test_export", 0, 0, ".png" ) );
+    assert( cv::norm( distorted, original ) > 0 );
+    remove_exported( "test_export", ".png" );
+
+    // one worker at least, however little memory there is
+    cs.setExportMemory( 1 );
+    cs.save( "test_export.xml", true );
+    assert( cs.exportReport().workers == 1 && cs.exportReport().images == 4 );
+    size_t defaultSize = file_size( undistorted_name( "test_export", 0, 0, ".png" ) );
+    remove_exported( "test_export", ".png" );
+
+    // the compression level shows in the files
+    cs.setPngCompression( 0 );
+    cs.save( "test_export.xml", true );
+    size_t uncompressedSize = file_size( undistorted_name( "test_export", 0, 0, ".png" ) );
+    assert( uncompressedSize > defaultSize );
+    remove_exported( "test_export", ".png" );
+
+    // and so does the format
+    cs.setImageFormat( iris::CameraSet_d::BMP );
+    cs.save( "test_export.xml", true );
+    assert( cs.exportReport().images == 4 );
+    assert( file_size( undistorted_name( "test_export", 1, 2, ".bmp" ) ) >= imageBytes );
+    assert( file_size( undistorted_name( "test_export", 1, 2, ".png" ) ) == 0 );
+    remove_exported( "test_export", ".bmp" );
+
+    // invalid levels are refused
+    bool thrown = false;
+    try
+    {
+        cs.setPngCompression( 10 );
+    }
+    catch( std::exception& )
+    {
+        thrown = true;
+    }
+    assert( thrown );
+}
+
+
+inline void test_mismatch()
+{
+    // an image that does not match its camera fails before anything is written
+    iris::CameraSet_d cs = export_set();
+    cs.cameras()[1].poses[2].image = gradient_image( 80, 60 );
+    bool thrown = false;
+    try
+    {
+        cs.save( "test_export.xml", true );
+    }
+    catch( std::exception& )
+    {
+        thrown = true;
+    }
+    assert( thrown );
+    assert( file_size( undistorted_name( "test_export", 0, 0, ".png" ) ) == 0 );
+    remove_exported( "test_export", ".png" );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_export();
+        test_mismatch();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <atomic>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <iris/CameraSetIngest.hpp>
+
+
+inline void test_concurrent_ingest()
+{
+    typedef std::shared_ptr< cimg_library::CImg<uint8_t> > Image;
+    Image image( new cimg_library::CImg<uint8_t>( 8, 6, 1, 1, 0 ) );
+
+    // a set with some poses, ingestion continues its ids
+    iris::CameraSet_d cs;
+    for( size_t i=0; i<3; i++ )
+        cs.add( image, "existing_" + iris::toString( i ) + ".png" );
+    iris::CameraSetIngest<double> ingest( cs, 3 );
+    std::shared_ptr< const iris::CameraSetIngest<double>::Snapshot > initial = ingest.snapshot();
+
+    // one capture thread per camera, more cameras than shards
+    size_t cameraCount = 4;
+    size_t frameCount = 500;
+    std::atomic<size_t> capturing( cameraCount );
+    std::vector<std::thread> threads;
+    for( size_t c=0; c<cameraCount; c++ )
+    {
+        threads.push_back( std::thread( [&, c]()
+        {
+            for( size_t f=0; f<frameCount; f++ )
+                ingest.push( image, "cam" + iris::toString( c ) + "_" + iris::toString( f ) + ".png", c );
+            capturing--;
+        } ) );
+    }
+
+    // detection workers mark each pose with its own id
+    for( size_t w=0; w<2; w++ )
+    {
+        threads.push_back( std::thread( [&]()
+        {
+            std::vector< iris::CameraSetIngest<double>::Frame > frames;
+            while( capturing > 0 || ingest.queued() > 0 )
+            {
+                ingest.take( frames, 16 );
+                for( size_t i=0; i<frames.size(); i++ )
+                    frames[i].pose.correspondences.push_back( Eigen::Vector2d( 1, 2 ), frames[i].pose.id );
+                ingest.commit( frames );
+            }
+        } ) );
+    }
+
+    // publish while capturing, a snapshot never changes once taken
+    while( capturing > 0 || ingest.queued() > 0 || ingest.processing() > 0 )
+    {
+        ingest.publish();
+        std::shared_ptr< const iris::CameraSetIngest<double>::Snapshot > snapshot = ingest.snapshot();
+        size_t count = snapshot->poseCount();
+        std::this_thread::yield();
+        assert( snapshot->poseCount() == count );
+    }
+    for( size_t t=0; t<threads.size(); t++ )
+        threads[t].join();
+    ingest.publish();
+
+    // every frame made it, with a unique id after the existing ones
+    std::shared_ptr< const iris::CameraSetIngest<double>::Snapshot > snapshot = ingest.snapshot();
+    assert( initial->poseCount() == 3 );
+    assert( snapshot->poseCount() == 3 + cameraCount*frameCount );
+    assert( snapshot->nextPoseId() == 3 + cameraCount*frameCount );
+    for( auto it=snapshot->cameras().begin(); it != snapshot->cameras().end(); it++ )
+        assert( it->second->chunks.size() <= 12 );
+    iris::CameraSet_d result = snapshot->cameraSet();
+    assert( result.poseCount() == snapshot->poseCount() && result.nextPoseId() == snapshot->nextPoseId() );
+    std::set<size_t> ids;
+    for( auto it=result.cameras().begin(); it != result.cameras().end(); it++ )
+    {
+        const std::vector<iris::Pose_d>& poses = it->second.poses;
+        assert( poses.size() == ( it->first == 0 ? 3 : 0 ) + frameCount );
+        for( size_t p=0; p<poses.size(); p++ )
+        {
+            assert( ids.insert( poses[p].id ).second );
+            assert( p < 3 || poses[p].correspondences.index( 0 ) == poses[p].id );
+        }
+    }
+    assert( *ids.begin() == 0 && *ids.rbegin() == 2 + cameraCount*frameCount );
+    assert( result.pose( "cam2_17.png" ).correspondences.size() == 1 );
+    assert( snapshot->cameras().at( 2 )->pose( 17 ).name == "cam2_17.png" );
+
+    // frames of a camera have to agree on the image size
+    bool thrown = false;
+    try
+    {
+        ingest.push( Image( new cimg_library::CImg<uint8_t>( 4, 4, 1, 1, 0 ) ), "small.png", 1 );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown && ingest.queued() == 0 );
+
+    // and a frame needs an image
+    thrown = false;
+    try
+    {
+        ingest.push( Image(), "missing.png", 1 );
+    }
+    catch( std::exception& e )
+    {
+        thrown = true;
+    }
+    assert( thrown && ingest.queued() == 0 );
+
+    // a publication only replaces the cameras it changed
+    std::vector< iris::CameraSetIngest<double>::Frame > frames;
+    ingest.push( image, "late.png", 3 );
+    ingest.take( frames, 1 );
+    ingest.commit( frames );
+    assert( ingest.publish() == 1 );
+    std::shared_ptr< const iris::CameraSetIngest<double>::Snapshot > next = ingest.snapshot();
+    assert( next->poseCount() == snapshot->poseCount() + 1 );
+    assert( next->cameras().at( 0 ) == snapshot->cameras().at( 0 ) );
+    assert( next->cameras().at( 3 ) != snapshot->cameras().at( 3 ) );
+    assert( next->cameras().at( 3 )->pose( frameCount ).name == "late.png" );
+    assert( snapshot->cameras().at( 3 )->poseCount == frameCount );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_concurrent_ingest();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
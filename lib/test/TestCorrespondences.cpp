@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/util.hpp>
+#include <iris/OutlierRejection.hpp>
+
+
+template <typename T>
+inline bool is_aligned( const T* ptr )
+{
+    return reinterpret_cast<uintptr_t>( ptr ) % 16 == 0;
+}
+
+
+template <typename T>
+inline void test_columns()
+{
+    typedef iris::Correspondences<T> C;
+    C c;
+    assert( c.empty() && c.points().cols() == 0 && c.mat().empty() );
+
+    // grow past a few reallocations
+    for( size_t i=0; i<100; i++ )
+        c.push_back( typename C::Point( static_cast<T>( i ), static_cast<T>( 2*i ) ), 3*i, static_cast<T>( 0.5 ) );
+    assert( c.size() == 100 && c.capacity() >= 100 && c.capacity() % C::Alignment == 0 );
+    assert( c.index( 7 ) == 21 && c.weight( 7 ) == static_cast<T>( 0.5 ) );
+    assert( c.point( 7 ) == typename C::Point( 7, 14 ) );
+
+    // the columns are aligned, unless Eigen does not align, and contiguous
+    assert( C::MapAlignment == Eigen::Unaligned || ( is_aligned( c.x().data() ) && is_aligned( c.y().data() ) && is_aligned( c.weights().data() ) ) );
+    assert( c.x()( 99 ) == 99 && c.y()( 99 ) == 198 && c.x().size() == 100 );
+
+    // the views share the memory
+    c.points()( 1, 5 ) = 42;
+    assert( c.point( 5 )(1) == 42 );
+    cv::Mat m = c.mat();
+    assert( m.rows == 2 && m.cols == 100 && m.type() == cv::DataType<T>::type );
+    m.at<T>( 0, 6 ) = 17;
+    assert( c.point( 6 )(0) == 17 );
+
+    // residuals against projections of the same layout
+    typename C::Points projected = c.points();
+    projected.row( 0 ).array() += 3;
+    projected.row( 1 ).array() += 4;
+    assert( ( ( projected - c.points() ).colwise().norm().array() - 5 ).abs().maxCoeff() < 1e-4 );
+
+    // compaction keeps the order
+    std::vector<bool> keep( c.size(), false );
+    keep[3] = keep[50] = keep[99] = true;
+    C copy = c;
+    assert( copy == c );
+    assert( c.compact( keep ) == 3 );
+    assert( c.index( 1 ) == 150 && c.point( 2 ) == typename C::Point( 99, 198 ) && c.weight( 2 ) == static_cast<T>( 0.5 ) );
+    assert( copy != c && copy.size() == 100 );
+
+    // new entries have full weight
+    c.resize( 5 );
+    assert( c.weight( 4 ) == 1 && c.point( 4 ).isZero() && c.index( 1 ) == 150 );
+
+    // moving leaves an empty, usable source
+    C moved( std::move( copy ) );
+    assert( moved.size() == 100 && moved.index( 50 ) == 150 );
+    assert( copy.empty() && copy.capacity() == 0 && copy.indices().empty() );
+    assert( copy.x().size() == 0 && copy.points().cols() == 0 && copy.mat().empty() );
+    copy.push_back( typename C::Point( 1, 2 ), 3 );
+    assert( copy.size() == 1 && copy.point( 0 ) == typename C::Point( 1, 2 ) );
+    copy = std::move( moved );
+    assert( copy.size() == 100 && moved.empty() && moved.capacity() == 0 && moved.indices().empty() );
+    assert( copy.point( 99 ) == typename C::Point( 99, 198 ) );
+}
+
+
+inline void test_pose()
+{
+    // correspondences to a pattern
+    std::shared_ptr<iris::Pattern_d> pattern( new iris::Pattern_d() );
+    for( int i=0; i<10; i++ )
+        pattern->points.push_back( Eigen::Vector3d( i, -i, 0 ) );
+
+    iris::Pose_d pose;
+    pose.pattern = pattern;
+    std::vector<Eigen::Vector2d> points( 4, Eigen::Vector2d( 1, 2 ) );
+    std::vector<size_t> indices = { 9, 0, 4, 2 };
+    pose.correspondences.assign( points, indices );
+    assert( pose.hasPoints3D() && pose.point3D( 0 ) == Eigen::Vector3d( 9, -9, 0 ) );
+    std::vector<cv::Point2f> cvPoints = iris::eigen2cv<float>( pose.correspondences );
+    assert( cvPoints.size() == 4 && cvPoints[3].x == 1 && cvPoints[3].y == 2 );
+
+    // projections
+    assert( !pose.hasProjections() && pose.residuals().size() == 0 );
+    pose.projected2D = iris::eigen2points( std::vector<Eigen::Vector2d>( 4, Eigen::Vector2d( 4, 6 ) ) );
+    assert( pose.hasProjections() && pose.residuals().isApproxToConstant( 5 ) );
+
+    // rejected points keep their detection, only the weighted ones go to the solvers
+    std::vector<bool> keep( 4, true );
+    keep[1] = false;
+    assert( pose.correspondences.weightedCount() == 4 );
+    assert( iris::OutlierRejection::rejectPoints( pose, keep ) == 1 );
+    assert( iris::OutlierRejection::rejectPoints( pose, keep ) == 0 );
+    assert( pose.correspondences.size() == 4 && pose.correspondences.weightedCount() == 3 && pose.hasProjections() );
+    assert( iris::eigen2cv<float>( pose.correspondences, true ).size() == 3 );
+    std::vector<cv::Point3f> cvPoints3D = iris::pattern2cv<float>( pose, true );
+    assert( cvPoints3D.size() == 3 && cvPoints3D[1].x == 4 );
+
+    // single precision copy, the pattern is converted once
+    std::map< const iris::Pattern_d*, std::shared_ptr<const iris::Pattern_f> > patterns;
+    iris::Pose_f single = iris::cast_pose<float>( pose, patterns );
+    assert( single.correspondences.indices() == pose.correspondences.indices() );
+    assert( single.correspondences.point( 2 ) == Eigen::Vector2f( 1, 2 ) );
+    assert( single.hasPoints3D() && single.point3D( 0 ) == Eigen::Vector3f( 9, -9, 0 ) );
+    assert( single.residuals().isApproxToConstant( 5 ) );
+    assert( iris::cast_pose<float>( pose, patterns ).pattern == single.pattern );
+
+    // an index outside the pattern
+    pose.correspondences.setIndex( 1, 10 );
+    assert( !pose.hasPoints3D() );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_columns<float>();
+        test_columns<double>();
+        test_pose();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iris/FrameSource.hpp>
+
+
+/////
+// Finder which detects the gray value of the image, black images have no pattern
+///
+class GrayFinder : public iris::Finder
+{
+public:
+    GrayFinder()
+    {
+        std::shared_ptr<iris::Pattern_d> pattern( new iris::Pattern_d() );
+        for( size_t i=0; i<4; i++ )
+            pattern->points.push_back( Eigen::Vector3d( static_cast<double>( i ), 0, 0 ) );
+        setPattern( pattern );
+        m_configured = true;
+    }
+
+    using iris::Finder::find;
+
+    virtual bool find( iris::Pose_d& pose )
+    {
+        double value = static_cast<double>( (*pose.image)( 0, 0, 0, 0 ) );
+        pose.correspondences.clear();
+        if( value == 0 )
+            return false;
+
+        // the points move with the gray value
+        for( size_t i=0; i<4; i++ )
+            pose.correspondences.push_back( Eigen::Vector2d( value + static_cast<double>( i ), value ), i );
+        pose.pattern = m_pattern;
+        return true;
+    }
+};
+
+
+inline std::string write_frame( const std::string& directory, size_t index, int width, int height, int value )
+{
+    char name[32];
+    std::sprintf( name, "frame_%02lu.png", static_cast<unsigned long>( index ) );
+    cv::Mat frame( height, width, CV_8UC3, cv::Scalar( value, value, value ) );
+    cv::imwrite( directory + "/" + name, frame );
+    return directory + "/" + name;
+}
+
+
+inline void test_directory()
+{
+    // each view is held for two frames, otherwise it counts as motion
+    std::string directory = "test_frame_source";
+    mkdir( directory.c_str(), 0755 );
+    std::vector<std::string> files;
+    files.push_back( write_frame( directory, 0, 64, 48, 200 ) );  // candidate, detected
+    files.push_back( write_frame( directory, 1, 64, 48, 200 ) );  // duplicate
+    files.push_back( write_frame( directory, 2, 64, 48, 0 ) );    // motion
+    files.push_back( write_frame( directory, 3, 64, 48, 0 ) );    // candidate, nothing detected
+    files.push_back( write_frame( directory, 4, 96, 48, 100 ) );  // other size, candidate, detected
+    files.push_back( write_frame( directory, 5, 96, 48, 100 ) );  // duplicate
+
+    // process the whole sequence into camera 1
+    iris::FrameSource source;
+    source.open( directory );
+    iris::CameraSet_d cs;
+    GrayFinder finder;
+    size_t added = source.process( cs, finder, 1 );
+
+    assert( source.decodedFrames() == 6 );
+    assert( source.candidateFrames() == 3 );
+    assert( added == 2 && cs.poseCount() == 2 );
+
+    // the poses keep their detections
+    const std::vector<iris::Pose_d>& poses = cs.camera( 1 ).poses;
+    assert( poses[0].name == "frame_00.png" && poses[1].name == "frame_04.png" );
+    assert( poses[0].id == 0 && poses[1].id == 1 );
+    assert( poses[0].correspondences.size() == 4 && poses[0].pattern == finder.pattern() );
+    assert( poses[1].correspondences.point( 0 )(0) == 100.0 );
+    assert( poses[1].image->width() == 96 );
+
+    for( size_t i=0; i<files.size(); i++ )
+        std::remove( files[i].c_str() );
+    rmdir( directory.c_str() );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_directory();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
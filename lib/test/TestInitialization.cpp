@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/Initialization.hpp>
+#include <iris/Projection.hpp>
+
+#include "SyntheticCamera.hpp"
+
+
+inline void test_exact()
+{
+    // without noise the closed form is exact
+    iris::Camera_d truth = synthetic_camera( 12, 0 );
+    iris::Camera_d cam = truth;
+    cam.intrinsic.setIdentity();
+
+    iris::Initialization init;
+    assert( init.initialize( cam ) );
+    assert( (cam.intrinsic - truth.intrinsic).norm() < 1e-6 );
+    for( size_t p=0; p<cam.poses.size(); p++ )
+        assert( (cam.poses[p].transformation - truth.poses[p].transformation).norm() < 1e-6 );
+}
+
+
+inline void test_noise()
+{
+    // with noise the estimate is close and the refined poses fit the points
+    iris::Camera_d truth = synthetic_camera( 20, 0.5 );
+    iris::Camera_d cam = truth;
+
+    iris::Initialization init;
+    assert( init.initialize( cam ) );
+    assert( std::fabs( cam.intrinsic(0,0) - truth.intrinsic(0,0) ) < 0.05 * truth.intrinsic(0,0) );
+    assert( std::fabs( cam.intrinsic(1,1) - truth.intrinsic(1,1) ) < 0.05 * truth.intrinsic(1,1) );
+    for( size_t p=0; p<cam.poses.size(); p++ )
+    {
+        iris::Correspondences<double>::Points projected = iris::project< iris::PinholeModel<double> >( cam, cam.poses[p] );
+        double error = ( projected - cam.poses[p].correspondences.points() ).squaredNorm();
+        assert( std::sqrt( error / projected.cols() ) < 2.0 );
+    }
+
+    // the constraints are honored
+    init.setFixAspectRatio( true );
+    init.setFixPrincipalPoint( true );
+    assert( init.initialize( cam ) );
+    assert( std::fabs( cam.intrinsic(0,0) - cam.intrinsic(1,1) ) < 1e-6 );
+    assert( std::fabs( cam.intrinsic(0,2) - 320 ) < 1e-6 );
+    assert( std::fabs( cam.intrinsic(1,2) - 240 ) < 1e-6 );
+}
+
+
+inline void test_degenerate()
+{
+    // a single view is not enough for a free principal point
+    iris::Camera_d cam = synthetic_camera( 1, 0 );
+    Eigen::Matrix3d K = cam.intrinsic;
+
+    iris::Initialization init;
+    assert( !init.initialize( cam ) );
+    assert( cam.intrinsic == K );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_exact();
+        test_noise();
+        test_degenerate();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
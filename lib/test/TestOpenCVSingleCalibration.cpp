@@ -1,4 +1,6 @@
+#include <assert.h>
 #include <iostream>
+#include <map>
 
 #include <iris/util.hpp>
 
@@ -9,6 +11,47 @@
 #include <iris/OpenCVSingleCalibration.hpp>
 #include <iris/OpenCVStereoCalibration.hpp>
 
+#include "SyntheticCamera.hpp"
+
+
+/////
+// Finder that hands out the detections of synthetic poses by name
+///
+class SyntheticFinder : public iris::Finder
+{
+public:
+    SyntheticFinder( std::shared_ptr<iris::Pattern_d> pattern )
+    {
+        setPattern( pattern );
+        m_configured = true;
+    }
+
+    void add( const iris::Pose_d& pose )
+    {
+        m_detections[ pose.name ] = pose.correspondences;
+    }
+
+    using iris::Finder::find;
+
+    virtual bool find( iris::Pose_d& pose )
+    {
+        std::map< std::string, iris::Correspondences<double> >::const_iterator it = m_detections.find( pose.name );
+        if( it == m_detections.end() )
+            return false;
+        pose.correspondences = it->second;
+        pose.pattern = m_pattern;
+        return true;
+    }
+
+    virtual std::shared_ptr<iris::Finder> clone() const
+    {
+        return std::make_shared<SyntheticFinder>( *this );
+    }
+
+protected:
+    std::map< std::string, iris::Correspondences<double> > m_detections;
+};
+
 
 void showPose( const iris::Pose_d& pose )
 {
@@ -24,10 +67,10 @@ void showPose( const iris::Pose_d& pose )
     std::string name = ss.str();
 
     // render the points
-    for( size_t i=0; i<pose.points2D.size(); i++ )
-        cv::circle( img, cv::Point( pose.points2D[i](0), pose.points2D[i](1) ), 5, cv::Scalar(0,255,0), -1, 8, 0 );
-    for( size_t i=0; i<pose.projected2D.size(); i++ )
-        cv::circle( img, cv::Point( pose.projected2D[i](0), pose.projected2D[i](1) ), 3, cv::Scalar(0,0,255), -1, 8, 0 );
+    for( size_t i=0; i<pose.correspondences.size(); i++ )
+        cv::circle( img, cv::Point( pose.correspondences.point(i)(0), pose.correspondences.point(i)(1) ), 5, cv::Scalar(0,255,0), -1, 8, 0 );
+    for( int i=0; i<pose.projected2D.cols(); i++ )
+        cv::circle( img, cv::Point( pose.projected2D(0,i), pose.projected2D(1,i) ), 3, cv::Scalar(0,0,255), -1, 8, 0 );
 
     // show the image
     cv::namedWindow( name, 0 );
@@ -84,6 +127,55 @@ void testCalibration( int argc, char** argv )
 }
 
 
+void testParallelCameras()
+{
+    // three cameras with their own focal lengths, seeing the same checkerboard
+    std::shared_ptr<iris::Pattern_d> pattern = synthetic_checkerboard( 9, 6, 0.03 );
+    std::shared_ptr<SyntheticFinder> finder( new SyntheticFinder( pattern ) );
+    std::shared_ptr< cimg_library::CImg<uint8_t> > image( new cimg_library::CImg<uint8_t>( 640, 480, 1, 1, 0 ) );
+    std::vector<iris::Camera_d> truth( 3, synthetic_camera( 0, 0 ) );
+    iris::CameraSet_d cs;
+    for( size_t c=0; c<truth.size(); c++ )
+    {
+        truth[c].intrinsic(0,0) = 600 + 200*c;
+        truth[c].intrinsic(1,1) = 600 + 200*c;
+        for( size_t p=0; p<12; p++ )
+        {
+            double a = 6.283185307179586 * p / 12;
+            iris::Pose_d pose = synthetic_pose( truth[c], pattern, synthetic_view( a, 0.4, 0.4 + 0.15*c + 0.05*p/12, 0.02, a ), 0.1 );
+            pose.name = "camera" + iris::toString( c ) + "_" + iris::toString( p ) + ".png";
+            finder->add( pose );
+            cs.add( image, pose.name, c );
+        }
+    }
+
+    // solve the cameras concurrently and one after the other
+    iris::CameraSet_d serial( cs );
+    iris::OpenCVSingleCalibration parallelCalibration;
+    parallelCalibration.setFinder( finder );
+    parallelCalibration.setProgressSink( std::make_shared<iris::Progress::NullSink>() );
+    parallelCalibration.setTaskPool( std::make_shared<iris::TaskPool>( 3 ) );
+    parallelCalibration.calibrate( cs );
+    iris::OpenCVSingleCalibration serialCalibration;
+    serialCalibration.setFinder( finder );
+    serialCalibration.setProgressSink( std::make_shared<iris::Progress::NullSink>() );
+    serialCalibration.setTaskPool( std::make_shared<iris::TaskPool>( 1 ) );
+    serialCalibration.calibrate( serial );
+
+    // each camera gets its own solution, the same either way
+    for( size_t c=0; c<truth.size(); c++ )
+    {
+        const iris::Camera_d& cam = cs.camera( c );
+        assert( cam.poses.size() == 12 && !cam.poses[5].rejected );
+        assert( std::fabs( cam.intrinsic(0,0) - truth[c].intrinsic(0,0) ) < 0.02 * truth[c].intrinsic(0,0) );
+        assert( std::fabs( cam.intrinsic(1,1) - truth[c].intrinsic(1,1) ) < 0.02 * truth[c].intrinsic(1,1) );
+        assert( cam.error < 0.5 );
+        assert( ( cam.intrinsic - serial.camera( c ).intrinsic ).norm() < 1e-9 );
+        assert( cam.error == serial.camera( c ).error );
+    }
+}
+
+
 void testLoadXML( const std::string& filename )
 {
     iris::CameraSet_d cs;
@@ -94,17 +186,13 @@ void testLoadXML( const std::string& filename )
 
 int main(int argc, char** argv)
 {
-    // check
-    if( argc == 1 )
-    {
-        std::cerr << "IrisTest: No Input." << std::endl;
-        return -1;
-    }
-
     // do the work
     try
     {
-        if( argc == 2 )
+        // without input, check the calibration on synthetic data
+        if( argc == 1 )
+            testParallelCameras();
+        else if( argc == 2 )
         {
             // try to identify the file
             std::string filename( argv[1] );
@@ -124,6 +212,7 @@ int main(int argc, char** argv)
     catch( std::exception& e )
     {
         std::cerr << e.what() << std::endl;
+        return 1;
     }
 
     return 0;
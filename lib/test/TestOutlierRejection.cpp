@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/OutlierRejection.hpp>
+
+#include "SyntheticCamera.hpp"
+
+
+// move a detection far off its true position
+inline void plant_outlier( iris::Pose_d& pose, size_t i )
+{
+    iris::Correspondences<double>::ColumnMap x = pose.correspondences.x();
+    iris::Correspondences<double>::ColumnMap y = pose.correspondences.y();
+    x(i) += 40;
+    y(i) -= 25;
+}
+
+
+inline void test_verify()
+{
+    // two outliers in the first pose, six in the last
+    iris::Camera_d cam = synthetic_camera( 6, 0 );
+    plant_outlier( cam.poses[0], 3 );
+    plant_outlier( cam.poses[0], 40 );
+    for( size_t i=0; i<6; i++ )
+        plant_outlier( cam.poses[5], 7*i + 1 );
+    iris::CameraView_d view( cam );
+    view.addAll();
+
+    // nothing happens unless the check is on
+    iris::OutlierRejection rejection;
+    iris::OutlierRejection::Report report = rejection.verify( view );
+    assert( report.pointsRemoved == 0 && report.posesRemoved == 0 );
+    assert( cam.poses[0].correspondences.weightedCount() == 54 );
+
+    // the planted points lose their weight, the last pose falls below the minimum
+    rejection.setHomographyCheck( true );
+    rejection.setMinPoints( 50 );
+    report = rejection.verify( view );
+    assert( report.pointsRemoved == 8 );
+    assert( report.posesRemoved == 1 );
+    assert( cam.poses[0].correspondences.weight( 3 ) == 0.0 && cam.poses[0].correspondences.weight( 40 ) == 0.0 );
+    assert( cam.poses[0].correspondences.weightedCount() == 52 );
+    assert( cam.poses[5].correspondences.weightedCount() == 48 );
+    for( size_t p=1; p<5; p++ )
+        assert( cam.poses[p].correspondences.weightedCount() == 54 );
+
+    // only the view forgets the pose, the detections stay
+    assert( view.size() == 5 && view.poses.back() == 4 );
+    assert( cam.poses.size() == 6 && cam.poses[5].correspondences.size() == 54 );
+
+    // points rejected before are not counted again
+    report = rejection.verify( view );
+    assert( report.pointsRemoved == 0 && report.posesRemoved == 0 );
+}
+
+
+inline void test_trim()
+{
+    // solved poses project onto the true positions, the planted points are far off
+    iris::Camera_d cam = synthetic_camera( 4, 0.2 );
+    for( size_t p=0; p<cam.poses.size(); p++ )
+        cam.poses[p].projected2D = iris::project< iris::PinholeModel<double> >( cam, cam.poses[p] );
+    plant_outlier( cam.poses[1], 0 );
+    plant_outlier( cam.poses[2], 20 );
+    plant_outlier( cam.poses[2], 21 );
+    iris::CameraView_d view( cam );
+    view.addAll();
+
+    // the threshold follows the median residual, which the outliers barely move
+    iris::OutlierRejection rejection;
+    double threshold = rejection.threshold( view );
+    assert( threshold >= 0.5 && threshold < 1.0 );
+
+    iris::OutlierRejection::Report report = rejection.trim( view );
+    assert( report.pointsRemoved == 3 && report.posesRemoved == 0 );
+    assert( cam.poses[1].correspondences.weight( 0 ) == 0.0 );
+    assert( cam.poses[2].correspondences.weight( 20 ) == 0.0 && cam.poses[2].correspondences.weight( 21 ) == 0.0 );
+    assert( cam.poses[2].correspondences.weightedCount() == 52 );
+    assert( view.size() == 4 );
+
+    // poses below the minimum leave the view, the reports add up
+    rejection.setMinPoints( 53 );
+    iris::OutlierRejection::Report total = report;
+    total += rejection.trim( view );
+    assert( total.pointsRemoved == 3 && total.posesRemoved == 1 );
+    assert( view.size() == 3 && view.poses[1] == 1 && view.poses[2] == 3 );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_verify();
+        test_trim();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
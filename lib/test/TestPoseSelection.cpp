@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/PoseSelection.hpp>
+
+#include "SyntheticCamera.hpp"
+
+
+// a camera seeing the checkerboard from the given views, in that order
+inline iris::Camera_d camera_with_views( const std::vector<Eigen::Matrix4d>& views )
+{
+    iris::Camera_d cam = synthetic_camera( 0, 0 );
+    std::shared_ptr<iris::Pattern_d> pattern = synthetic_checkerboard( 9, 6, 0.03 );
+    for( size_t p=0; p<views.size(); p++ )
+    {
+        cam.poses.push_back( synthetic_pose( cam, pattern, views[p], 0 ) );
+        cam.poses.back().id = p;
+    }
+    return cam;
+}
+
+
+inline void test_bound()
+{
+    iris::Camera_d cam = synthetic_camera( 10, 0.1 );
+    iris::CameraView_d view( cam );
+    view.addAll();
+
+    // everything without a bound or with enough room
+    iris::PoseSelection selection;
+    assert( selection.select( view ).size() == 10 );
+    selection.setMaxPoses( 10 );
+    assert( selection.select( view ).size() == 10 );
+
+    // otherwise exactly the bound, sorted and without duplicates
+    selection.setMaxPoses( 4 );
+    std::vector<size_t> selected = selection.select( view );
+    assert( selected.size() == 4 );
+    for( size_t i=1; i<selected.size(); i++ )
+        assert( selected[i-1] < selected[i] );
+    assert( selected.back() < view.size() );
+
+    // the same on every run and with any number of threads
+    assert( selection.select( view ) == selected );
+    selection.setTaskPool( std::make_shared<iris::TaskPool>( 1 ) );
+    assert( selection.select( view ) == selected );
+    selection.setTaskPool( std::make_shared<iris::TaskPool>( 7 ) );
+    assert( selection.select( view ) == selected );
+}
+
+
+inline void test_coverage()
+{
+    // three views of the center and one off to the side, with the same tilt
+    std::vector<Eigen::Matrix4d> views;
+    views.push_back( synthetic_view( 0, 0, 1.0, 0, 0 ) );
+    views.push_back( synthetic_view( 0, 0, 1.0, 0, 0 ) );
+    views.push_back( synthetic_view( 0, 0, 1.0, 0.25, 0 ) );
+    views.push_back( synthetic_view( 0, 0, 1.0, 0, 0 ) );
+    iris::Camera_d cam = camera_with_views( views );
+    iris::CameraView_d view( cam );
+    view.addAll();
+
+    // the side view adds more image area than a repeated one
+    iris::PoseSelection selection;
+    selection.setMaxPoses( 2 );
+    std::vector<size_t> selected = selection.select( view );
+    assert( selected.size() == 2 && selected[0] == 0 && selected[1] == 2 );
+
+    // rejected points cover nothing, a side view without weighted points adds nothing
+    for( size_t i=0; i<cam.poses[2].correspondences.size(); i++ )
+        cam.poses[2].correspondences.setWeight( i, 0.0 );
+    selection.setTiltWeight( 0 );
+    selection.setCountWeight( 0 );
+    selected = selection.select( view );
+    assert( selected.size() == 2 && selected[0] == 0 && selected[1] != 2 );
+}
+
+
+inline void test_tilt()
+{
+    // frontal views of the center and one tilted view
+    std::vector<Eigen::Matrix4d> views;
+    views.push_back( synthetic_view( 0, 0, 1.0, 0, 0 ) );
+    views.push_back( synthetic_view( 0, 0, 1.0, 0, 0 ) );
+    views.push_back( synthetic_view( 0, 0, 1.0, 0, 0 ) );
+    views.push_back( synthetic_view( 0.3, 0.6, 1.0, 0, 0 ) );
+    iris::Camera_d cam = camera_with_views( views );
+    iris::CameraView_d view( cam );
+    view.addAll();
+
+    // by tilt alone the tilted view comes next
+    iris::PoseSelection selection;
+    selection.setMaxPoses( 2 );
+    selection.setCoverageWeight( 0 );
+    selection.setCountWeight( 0 );
+    std::vector<size_t> selected = selection.select( view );
+    assert( selected.size() == 2 && selected[1] == 3 );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_bound();
+        test_coverage();
+        test_tilt();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/Progress.hpp>
+#include <iris/TaskPool.hpp>
+
+
+// counts the reports and checks they never overlap
+class CountingSink : public iris::Progress::Sink
+{
+public:
+    CountingSink() : reports(0), finished(0), busy(false), lastDone(0) {}
+
+    virtual void report( const iris::Progress& progress )
+    {
+        assert( !busy.exchange( true ) );
+        reports++;
+        lastDone = progress.done();
+        busy = false;
+    }
+
+    virtual void finish( const iris::Progress& progress )
+    {
+        assert( !busy.exchange( true ) );
+        finished++;
+        lastDone = progress.done();
+        busy = false;
+    }
+
+    size_t reports;
+    size_t finished;
+    std::atomic<bool> busy;
+    size_t lastDone;
+};
+
+
+inline void test_concurrent_steps()
+{
+    std::shared_ptr<CountingSink> sink( new CountingSink() );
+    iris::Progress progress( sink, std::chrono::milliseconds( 0 ) );
+    iris::TaskPool pool( 4 );
+
+    // workers count steps and metrics
+    size_t steps = 100000;
+    progress.begin( "test", steps );
+    pool.parallel_for( 0, steps, [&]( size_t i )
+    {
+        progress.step();
+        if( i % 2 == 0 )
+            progress.add( iris::Progress::PosesFound, 1 );
+    } );
+    progress.finish();
+
+    // nothing lost, the sink only looked at the clock now and then
+    assert( progress.done() == steps );
+    assert( progress.metric( iris::Progress::PosesFound ) == steps / 2 );
+    assert( progress.metric( iris::Progress::PosesDetected ) == 0 );
+    assert( sink->reports >= 1 && sink->reports <= 2*128 + 1 );
+    assert( sink->finished == 1 && sink->lastDone == steps );
+
+    // a new stage keeps the metrics, a reset clears them
+    progress.begin( "again", 10 );
+    assert( progress.stage() == "again" && progress.steps() == 10 && progress.done() == 0 );
+    assert( progress.metric( iris::Progress::PosesFound ) == steps / 2 );
+    progress.reset();
+    assert( progress.metric( iris::Progress::PosesFound ) == 0 );
+}
+
+
+inline void test_throttle()
+{
+    // with a long interval only the beginning is reported
+    std::shared_ptr<CountingSink> sink( new CountingSink() );
+    iris::Progress progress( sink, std::chrono::milliseconds( 60000 ) );
+    progress.begin( "throttled", 1000 );
+    for( size_t i=0; i<1000; i++ )
+        progress.step();
+    progress.finish();
+    assert( sink->reports == 1 && sink->finished == 1 );
+
+    // polling works without a sink
+    iris::Progress polled;
+    polled.begin( "polled", 3 );
+    polled.step( 2 );
+    polled.finish();
+    assert( polled.done() == 2 && polled.steps() == 3 );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        test_concurrent_steps();
+        test_throttle();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/Projection.hpp>
+
+
+template <typename Model>
+inline void test_jacobians( const typename Model::Scalar* params, typename Model::Scalar eps, typename Model::Scalar tol )
+{
+    typedef typename Model::Scalar T;
+    typedef Eigen::Matrix<T,2,1> Vector2;
+    typedef Eigen::Matrix<T,3,1> Vector3;
+    typedef Eigen::Matrix<T,4,4> Matrix4;
+    typedef typename iris::Correspondences<T>::Points Points;
+
+    // a pose looking at the points from a distance
+    Eigen::Transform<T,3,Eigen::Affine> trans;
+    trans.setIdentity();
+    trans.translate( Vector3( 0.05, -0.02, 0.8 ) );
+    trans.rotate( Eigen::AngleAxis<T>( 0.3, Vector3( 1, 2, 0.5 ).normalized() ) );
+    Matrix4 P = trans.matrix();
+
+    // a few points on a plane
+    std::vector<Vector3> points;
+    for( int y=-2; y<=2; y++ )
+        for( int x=-2; x<=2; x++ )
+            points.push_back( Vector3( 0.05*x, 0.05*y, 0 ) );
+
+    // analytic
+    size_t n = points.size();
+    Points projected( 2, n );
+    std::vector< Eigen::Matrix<T,2,Model::ParamCount>, Eigen::aligned_allocator< Eigen::Matrix<T,2,Model::ParamCount> > > dParams( n );
+    std::vector< Eigen::Matrix<T,2,6>, Eigen::aligned_allocator< Eigen::Matrix<T,2,6> > > dPose( n );
+    std::vector< Eigen::Matrix<T,2,3>, Eigen::aligned_allocator< Eigen::Matrix<T,2,3> > > dPoints( n );
+    iris::project<Model>( params, P, iris::pointsMap( points ), projected.row(0).transpose(), projected.row(1).transpose(), &dParams[0], &dPose[0], &dPoints[0] );
+
+    // the plain projection has to agree, also when written into correspondences
+    Points plain( 2, n );
+    iris::project<Model>( params, P, iris::pointsMap( points ), plain.row(0).transpose(), plain.row(1).transpose() );
+    assert( (plain - projected).norm() < tol );
+
+    iris::Correspondences<T> c;
+    c.resize( n );
+    iris::project<Model>( params, P, iris::pointsMap( points ), c.x(), c.y() );
+    for( size_t i=0; i<n; i++ )
+        assert( (c.point( i ) - projected.col( i )).norm() < tol );
+
+    // and so does the model applied point by point
+    for( size_t i=0; i<n; i++ )
+    {
+        Vector3 Xc = P.template topLeftCorner<3,3>() * points[i] + P.template topRightCorner<3,1>();
+        Vector2 single;
+        Model::project( params, Xc(0) / Xc(2), Xc(1) / Xc(2), single(0), single(1) );
+        assert( (single - projected.col( i )).norm() < tol );
+    }
+
+    // numeric w.r.t. the parameters
+    for( int k=0; k<Model::ParamCount; k++ )
+    {
+        T p[Model::ParamCount];
+        for( int j=0; j<Model::ParamCount; j++ )
+            p[j] = params[j];
+        p[k] += eps;
+
+        Points moved( 2, n );
+        iris::project<Model>( p, P, iris::pointsMap( points ), moved.row(0).transpose(), moved.row(1).transpose() );
+        for( size_t i=0; i<n; i++ )
+            assert( ( (moved.col(i) - projected.col(i)) / eps - dParams[i].col(k) ).norm() < tol * (1 + dParams[i].col(k).norm()) );
+    }
+
+    // numeric w.r.t. the pose
+    for( int k=0; k<6; k++ )
+    {
+        Matrix4 Q = P;
+        if( k < 3 )
+            Q.template topLeftCorner<3,3>() = Eigen::AngleAxis<T>( eps, Vector3::Unit(k) ).toRotationMatrix() * P.template topLeftCorner<3,3>();
+        else
+            Q(k-3,3) += eps;
+
+        Points moved( 2, n );
+        iris::project<Model>( params, Q, iris::pointsMap( points ), moved.row(0).transpose(), moved.row(1).transpose() );
+        for( size_t i=0; i<n; i++ )
+            assert( ( (moved.col(i) - projected.col(i)) / eps - dPose[i].col(k) ).norm() < tol * (1 + dPose[i].col(k).norm()) );
+    }
+
+    // numeric w.r.t. the points
+    for( int k=0; k<3; k++ )
+    {
+        std::vector<Vector3> movedPoints = points;
+        for( size_t i=0; i<n; i++ )
+            movedPoints[i](k) += eps;
+
+        Points moved( 2, n );
+        iris::project<Model>( params, P, iris::pointsMap( movedPoints ), moved.row(0).transpose(), moved.row(1).transpose() );
+        for( size_t i=0; i<n; i++ )
+            assert( ( (moved.col(i) - projected.col(i)) / eps - dPoints[i].col(k) ).norm() < tol * (1 + dPoints[i].col(k).norm()) );
+    }
+}
+
+
+template <typename T>
+inline void test_pinhole()
+{
+    // without distortion both models are a plain pinhole projection
+    iris::Camera<T> cam;
+    cam.intrinsic << 800, 0, 320,
+                     0, 780, 240,
+                     0, 0, 1;
+    Eigen::Matrix<T,4,4> P = Eigen::Matrix<T,4,4>::Identity();
+    P(2,3) = 2.0;
+
+    std::vector< Eigen::Matrix<T,3,1> > points;
+    for( int i=0; i<16; i++ )
+        points.push_back( Eigen::Matrix<T,3,1>::Random() );
+
+    typename iris::Correspondences<T>::Points pinhole = iris::project< iris::PinholeModel<T> >( cam, P, points );
+    typename iris::Correspondences<T>::Points radial = iris::project< iris::RadialTangentialModel<T> >( cam, P, points );
+    for( size_t i=0; i<points.size(); i++ )
+    {
+        Eigen::Matrix<T,3,1> p = cam.intrinsic * (P.template topLeftCorner<3,3>() * points[i] + P.template topRightCorner<3,1>());
+        assert( (pinhole.col(i) - p.hnormalized()).norm() < 1e-3 );
+        assert( (radial.col(i) - p.hnormalized()).norm() < 1e-3 );
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        // plain pinhole
+        test_pinhole<float>();
+        test_pinhole<double>();
+
+        // jacobians
+        double pinhole[4] = { 800, 780, 320, 240 };
+        double radial[9] = { 800, 780, 320, 240, -0.2, 0.05, 0.001, -0.002, 0.01 };
+        test_jacobians< iris::PinholeModel<double> >( pinhole, 1e-7, 1e-4 );
+        test_jacobians< iris::RadialTangentialModel<double> >( radial, 1e-7, 1e-4 );
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
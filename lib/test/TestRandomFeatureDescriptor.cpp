@@ -42,8 +42,9 @@ inline void test_rfd()
     pattern.match( image, pose );
 
     // check the reprojection error
-    for( size_t i=0; i<pose.points2D.size(); i++ )
-        assert( (pose.points2D[i]-pose.projected2D[i]).norm() < 5.0 );
+    assert( pose.hasProjections() );
+    for( size_t i=0; i<pose.correspondences.size(); i++ )
+        assert( pose.residuals()(i) < 5.0 );
 }
 
 
@@ -42,6 +42,16 @@ void test_rff( const std::string& path )
 
     // run the finder
     finder.find( pose );
+
+    // a clone shares the pattern and finds the same
+    std::shared_ptr<iris::Finder> clone = finder.clone();
+    iris::Pose_d clonePose;
+    clonePose.image = pose.image;
+    clone->find( clonePose );
+    assert( clone->pattern() == finder.pattern() );
+    assert( clonePose.correspondences.size() == pose.correspondences.size() );
+    for( size_t i=0; i<pose.correspondences.size(); i++ )
+        assert( clonePose.correspondences.index( i ) == pose.correspondences.index( i ) );
 }
 
 
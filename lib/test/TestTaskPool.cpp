@@ -0,0 +1,150 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <iris/TaskPool.hpp>
+
+
+inline void test_coverage( iris::TaskPool& pool )
+{
+    // every index exactly once, whatever the grain
+    size_t grains[] = { 1, 3, 1000, 5000 };
+    for( size_t g=0; g<4; g++ )
+    {
+        std::vector< std::atomic<int> > hits( 1000 );
+        for( size_t i=0; i<hits.size(); i++ )
+            hits[i] = 0;
+
+        pool.parallel_for( 0, hits.size(), [&]( size_t i ) { hits[i]++; }, grains[g] );
+
+        for( size_t i=0; i<hits.size(); i++ )
+            assert( hits[i] == 1 );
+    }
+
+    // empty ranges do nothing
+    pool.parallel_for( 5, 5, []( size_t ) { assert( false ); } );
+}
+
+
+inline void test_nested( iris::TaskPool& pool )
+{
+    // loops inside of loops must not deadlock
+    std::atomic<size_t> sum( 0 );
+    pool.parallel_for( 0, 32, [&]( size_t )
+    {
+        pool.parallel_for( 0, 100, [&]( size_t j ) { sum += j; } );
+    } );
+    assert( sum == 32 * 4950 );
+}
+
+
+inline void test_exception( iris::TaskPool& pool )
+{
+    // the first failure is rethrown once the loop is done
+    std::atomic<size_t> calls( 0 );
+    bool thrown = false;
+    try
+    {
+        pool.parallel_for( 0, 10000, [&]( size_t i )
+        {
+            calls++;
+            if( i == 17 )
+                throw std::runtime_error( "test_exception: failed." );
+        } );
+    }
+    catch( std::runtime_error& e )
+    {
+        thrown = true;
+    }
+    assert( thrown && calls <= 10000 );
+
+    // the pool is still usable
+    test_coverage( pool );
+}
+
+
+inline void test_external_threads( iris::TaskPool& pool )
+{
+    // threads of a host application share the pool
+    std::atomic<size_t> sum( 0 );
+    std::vector<std::thread> threads;
+    for( size_t t=0; t<4; t++ )
+        threads.push_back( std::thread( [&]()
+        {
+            pool.parallel_for( 0, 1000, [&]( size_t i ) { sum += i; } );
+        } ) );
+    for( size_t t=0; t<threads.size(); t++ )
+        threads[t].join();
+    assert( sum == 4 * 499500 );
+}
+
+
+inline void test_pool( size_t threadCount )
+{
+    iris::TaskPool pool( threadCount );
+    assert( threadCount == 0 || pool.threadCount() == threadCount );
+
+    test_coverage( pool );
+    test_nested( pool );
+    test_exception( pool );
+    test_external_threads( pool );
+}
+
+
+inline void test_shared()
+{
+    // one pool for the whole process, whoever asks first
+    std::vector< std::shared_ptr<iris::TaskPool> > pools( 4 );
+    std::vector<std::thread> threads;
+    for( size_t t=0; t<pools.size(); t++ )
+        threads.push_back( std::thread( [&pools, t]() { pools[t] = iris::TaskPool::shared(); } ) );
+    for( size_t t=0; t<threads.size(); t++ )
+        threads[t].join();
+    for( size_t t=0; t<pools.size(); t++ )
+        assert( pools[t] && pools[t] == iris::TaskPool::shared() );
+    test_coverage( *iris::TaskPool::shared() );
+}
+
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        // in place, a few threads and all of them
+        test_pool( 1 );
+        test_pool( 4 );
+        test_pool( 0 );
+        test_shared();
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
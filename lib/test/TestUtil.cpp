@@ -24,6 +24,7 @@
 #include <stdexcept>
 
 #include <iris/util.hpp>
+#include <iris/UndistortionMap.hpp>
 
 
 
@@ -245,6 +246,127 @@ inline void test_generate_points()
 }
 
 
+template <int Ch>
+inline void test_image_conversion()
+{
+    // random image
+    cimg_library::CImg<uint8_t> image( 67, 41, 1, Ch );
+    cimg_forXYC( image, x, y, c )
+        image( x, y, 0, c ) = static_cast<uint8_t>( rand() % 256 );
+
+    // the layout has to be preserved
+    cv::Mat imageCV;
+    iris::cimg2cv( image, imageCV );
+    assert( imageCV.rows == image.height() && imageCV.cols == image.width() && imageCV.channels() == Ch );
+    for( int y=0; y<imageCV.rows; y++ )
+        for( int x=0; x<imageCV.cols; x++ )
+            for( int c=0; c<Ch; c++ )
+                assert( imageCV.ptr<uint8_t>(y)[x*Ch+c] == image( x, y, 0, c ) );
+
+    // and the way back
+    cimg_library::CImg<uint8_t> back;
+    iris::cv2cimg( imageCV, back );
+    assert( back == image );
+}
+
+
+inline void test_undistortion_map()
+{
+    // a camera with some distortion
+    iris::Camera_d cam;
+    cam.imageSize = Eigen::Vector2i( 320, 240 );
+    cam.intrinsic << 300, 0, 161,
+                     0, 300, 119,
+                     0, 0, 1;
+    cam.distortion.push_back( -0.25 );
+    cam.distortion.push_back( 0.08 );
+    cam.distortion.push_back( 0.001 );
+    cam.distortion.push_back( -0.001 );
+    cam.distortion.push_back( 0.0 );
+
+    // the map is only rebuilt if the camera changes
+    iris::UndistortionMap map;
+    assert( map.empty() );
+    assert( map.update( cam ) );
+    assert( !map.update( cam ) );
+    cam.distortion[0] = -0.2;
+    assert( map.update( cam ) );
+
+    // smooth test image
+    cv::Mat image( cam.imageSize(1), cam.imageSize(0), CV_8UC1 );
+    for( int y=0; y<image.rows; y++ )
+        for( int x=0; x<image.cols; x++ )
+            image.at<uint8_t>(y,x) = static_cast<uint8_t>( 127.5 + 127.0*std::sin( 0.05*x ) * std::cos( 0.07*y ) );
+
+    // same result as cv::undistort up to the fixed-point rounding
+    cv::Mat K, reference, undistorted;
+    cv::eigen2cv( cam.intrinsic, K );
+    cv::undistort( image, reference, K, cv::Mat( cam.distortion ) );
+    map.remap( image, undistorted );
+    assert( cv::norm( reference, undistorted, cv::NORM_INF ) <= 2 );
+
+    // batches give the same result
+    std::vector<cv::Mat> batch( 4, image ), batchUndistorted;
+    map.remap( batch, batchUndistorted );
+    for( size_t i=0; i<batch.size(); i++ )
+        assert( cv::norm( undistorted, batchUndistorted[i], cv::NORM_INF ) == 0 );
+}
+
+
+template <typename T>
+inline void test_number_round_trip()
+{
+    // random values over many magnitudes come back bit for bit
+    std::string str;
+    for( int i=0; i<10000; i++ )
+    {
+        T val = static_cast<T>( std::ldexp( static_cast<double>( std::rand() ) / RAND_MAX - 0.5, i % 200 - 100 ) );
+        str.clear();
+        iris::appendNumber( str, val );
+        T back = 0;
+        const char* pos = str.c_str();
+        assert( iris::parseNumber( pos, back ) && *pos == 0 );
+        assert( back == val );
+    }
+
+    // the same text as a stream with full precision
+    std::stringstream ss;
+    ss.precision( std::numeric_limits<T>::max_digits10 );
+    ss << static_cast<T>( 0.1 ) << " " << static_cast<T>( -1e-30 ) << " " << static_cast<T>( 12345.5 ) << " ";
+    std::vector<T> vec = { static_cast<T>( 0.1 ), static_cast<T>( -1e-30 ), static_cast<T>( 12345.5 ) };
+    assert( iris::toString( vec ) == ss.str() );
+}
+
+
+inline void test_text_conversion()
+{
+    // integers, including the wrapped default id
+    assert( iris::toString( 0 ) == "0" );
+    assert( iris::toString( -42 ) == "-42" );
+    assert( iris::toString( static_cast<size_t>( -1 ) ) == "18446744073709551615" );
+    size_t id = 0;
+    iris::str2scalar( "18446744073709551615", id );
+    assert( id == static_cast<size_t>( -1 ) );
+
+    // matrices and vectors of matrices
+    Eigen::Matrix<double,2,2> mat;
+    mat << 1, 2.5, -3, 4e-3;
+    assert( iris::toString( mat ) == "1 -3 2.5 0.0040000000000000001 " );
+    std::vector< Eigen::Vector2d > points = { Eigen::Vector2d( 1, 2 ), Eigen::Vector2d( 3.5, -4 ) };
+    std::vector< Eigen::Vector2d > parsed;
+    iris::str2eigenVector( iris::toString( points ), parsed );
+    assert( parsed == points );
+
+    // parsing stops at anything that is not a number
+    std::vector<int> ints;
+    iris::str2vector( " 1 2\n3 x 4", ints );
+    assert( ints.size() == 3 && ints[2] == 3 );
+    Eigen::Vector3d vec( 7, 7, 7 );
+    iris::str2eigen( "1 2", vec );
+    assert( vec == Eigen::Vector3d( 1, 2, 7 ) );
+}
+
+
 int main(int argc, char** argv)
 {
     try
@@ -271,6 +393,18 @@ int main(int argc, char** argv)
         // test generate points
         test_generate_points<float>();
         test_generate_points<double>();
+
+        // test image conversion
+        test_image_conversion<1>();
+        test_image_conversion<3>();
+
+        // test the undistortion map
+        test_undistortion_map();
+
+        // test the text conversion
+        test_number_round_trip<float>();
+        test_number_round_trip<double>();
+        test_text_conversion();
     }
     catch( std::exception &e )
     {
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+// This file is part of iris, a lightweight C++ camera calibration library    //
+//                                                                            //
+// Copyright (C) 2012 Alexandru Duliu                                         //
+//                                                                            //
+// iris is free software; you can redistribute it and/or                      //
+// modify it under the terms of the GNU Lesser General Public                 //
+// License as published by the Free Software Foundation; either               //
+// version 3 of the License, or (at your option) any later version.           //
+//                                                                            //
+// iris is distributed in the hope that it will be useful, but WITHOUT ANY    //
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS  //
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the //
+// GNU General Public License for more details.                               //
+//                                                                            //
+// You should have received a copy of the GNU Lesser General Public           //
+// License along with iris. If not, see <http://www.gnu.org/licenses/>.       //
+//                                                                            //
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * ConvertCameraSet.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include <iostream>
+#include <stdexcept>
+
+#include <iris/CameraSet.hpp>
+
+
+int main(int argc, char** argv)
+{
+    if( argc != 3 )
+    {
+        std::cerr << "usage: " << argv[0] << " <input> <output>" << std::endl;
+        std::cerr << "  converts camera sets between XML and the binary format," << std::endl;
+        std::cerr << "  the output is binary if its name ends in \".iris\"." << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        iris::CameraSet_d cs;
+        cs.load( argv[1] );
+        cs.save( argv[2] );
+    }
+    catch( std::exception &e )
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}